@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <string.h>
+
+#include "gupnp-dlna-arena.h"
+
+/* A simple bump allocator. Everything allocated from an arena stays
+ * alive until the arena itself is freed, which releases all the
+ * blocks at once. Resources that cannot live in the arena (like hash
+ * tables) can be tied to its lifetime with cleanup functions. The
+ * arena is not thread-safe - it is meant to be filled by a single
+ * loader and only read afterwards. Objects pointing into a shared
+ * arena keep it alive with gupnp_dlna_arena_ref(), the only part of
+ * it that is thread-safe.
+ */
+
+#define DEFAULT_BLOCK_SIZE 16384
+#define ALIGNMENT (2 * sizeof (gpointer))
+#define ALIGN(size) (((size) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+
+typedef struct _GUPnPDLNAArenaBlock GUPnPDLNAArenaBlock;
+typedef struct _GUPnPDLNAArenaCleanup GUPnPDLNAArenaCleanup;
+
+struct _GUPnPDLNAArenaBlock {
+        GUPnPDLNAArenaBlock *next;
+        gsize                size;
+        gsize                used;
+};
+
+struct _GUPnPDLNAArenaCleanup {
+        GUPnPDLNAArenaCleanup *next;
+        GDestroyNotify         func;
+        gpointer               data;
+};
+
+struct _GUPnPDLNAArena {
+        GUPnPDLNAArenaBlock   *blocks;
+        GUPnPDLNAArenaCleanup *cleanups;
+        gsize                  block_size;
+        gsize                  size;
+        gsize                  used;
+        gint                   ref_count;
+};
+
+#define BLOCK_HEADER_SIZE ALIGN (sizeof (GUPnPDLNAArenaBlock))
+#define BLOCK_DATA(block) (((guint8 *) (block)) + BLOCK_HEADER_SIZE)
+
+GUPnPDLNAArena *
+gupnp_dlna_arena_new (gsize block_size)
+{
+        GUPnPDLNAArena *arena = g_slice_new (GUPnPDLNAArena);
+
+        arena->blocks = NULL;
+        arena->cleanups = NULL;
+        arena->block_size = (block_size > 0 ? block_size : DEFAULT_BLOCK_SIZE);
+        arena->size = 0;
+        arena->used = 0;
+        arena->ref_count = 1;
+
+        return arena;
+}
+
+GUPnPDLNAArena *
+gupnp_dlna_arena_ref (GUPnPDLNAArena *arena)
+{
+        g_return_val_if_fail (arena != NULL, NULL);
+
+        g_atomic_int_inc (&arena->ref_count);
+
+        return arena;
+}
+
+/* Frees the arena once the last reference is dropped. */
+void
+gupnp_dlna_arena_unref (GUPnPDLNAArena *arena)
+{
+        if (arena == NULL || !g_atomic_int_dec_and_test (&arena->ref_count))
+                return;
+
+        gupnp_dlna_arena_free (arena);
+}
+
+static GUPnPDLNAArenaBlock *
+arena_block_new (GUPnPDLNAArena *arena,
+                 gsize           size)
+{
+        GUPnPDLNAArenaBlock *block = g_malloc0 (BLOCK_HEADER_SIZE + size);
+
+        block->size = size;
+        block->used = 0;
+        arena->size += BLOCK_HEADER_SIZE + size;
+
+        return block;
+}
+
+gpointer
+gupnp_dlna_arena_alloc (GUPnPDLNAArena *arena,
+                        gsize           size)
+{
+        GUPnPDLNAArenaBlock *block;
+        gpointer mem;
+
+        g_return_val_if_fail (arena != NULL, NULL);
+
+        size = ALIGN (MAX (size, 1));
+        block = arena->blocks;
+        if (block == NULL || block->size - block->used < size) {
+                if (size > arena->block_size / 4) {
+                        /* Big chunks get a block of their own, which
+                         * is kept behind the current one, so its free
+                         * space does not go to waste. */
+                        GUPnPDLNAArenaBlock *big = arena_block_new (arena,
+                                                                    size);
+
+                        if (block != NULL) {
+                                big->next = block->next;
+                                block->next = big;
+                        } else {
+                                big->next = NULL;
+                                arena->blocks = big;
+                        }
+                        big->used = size;
+                        arena->used += size;
+
+                        return BLOCK_DATA (big);
+                }
+
+                block = arena_block_new (arena, arena->block_size);
+                block->next = arena->blocks;
+                arena->blocks = block;
+        }
+
+        mem = BLOCK_DATA (block) + block->used;
+        block->used += size;
+        arena->used += size;
+
+        return mem;
+}
+
+gchar *
+gupnp_dlna_arena_strdup (GUPnPDLNAArena *arena,
+                         const gchar    *str)
+{
+        gsize len;
+        gchar *dup;
+
+        if (str == NULL)
+                return NULL;
+
+        len = strlen (str) + 1;
+        dup = gupnp_dlna_arena_alloc (arena, len);
+        memcpy (dup, str, len);
+
+        return dup;
+}
+
+GList *
+gupnp_dlna_arena_list_prepend (GUPnPDLNAArena *arena,
+                               GList          *list,
+                               gpointer        data)
+{
+        GList *node = gupnp_dlna_arena_alloc (arena, sizeof (GList));
+
+        node->data = data;
+        node->prev = NULL;
+        node->next = list;
+        if (list != NULL)
+                list->prev = node;
+
+        return node;
+}
+
+void
+gupnp_dlna_arena_add_cleanup (GUPnPDLNAArena *arena,
+                              GDestroyNotify  func,
+                              gpointer        data)
+{
+        GUPnPDLNAArenaCleanup *cleanup;
+
+        g_return_if_fail (arena != NULL);
+        g_return_if_fail (func != NULL);
+
+        cleanup = gupnp_dlna_arena_alloc (arena,
+                                          sizeof (GUPnPDLNAArenaCleanup));
+        cleanup->func = func;
+        cleanup->data = data;
+        cleanup->next = arena->cleanups;
+        arena->cleanups = cleanup;
+}
+
+gsize
+gupnp_dlna_arena_get_size (GUPnPDLNAArena *arena)
+{
+        g_return_val_if_fail (arena != NULL, 0);
+
+        return arena->size;
+}
+
+gsize
+gupnp_dlna_arena_get_used (GUPnPDLNAArena *arena)
+{
+        g_return_val_if_fail (arena != NULL, 0);
+
+        return arena->used;
+}
+
+/* Frees the arena regardless of references, for arenas with a
+ * single owner. */
+void
+gupnp_dlna_arena_free (GUPnPDLNAArena *arena)
+{
+        GUPnPDLNAArenaCleanup *cleanup;
+        GUPnPDLNAArenaBlock *block;
+
+        if (arena == NULL)
+                return;
+
+        /* Cleanup records live in the arena too, so run them all
+         * before releasing any block. */
+        for (cleanup = arena->cleanups;
+             cleanup != NULL;
+             cleanup = cleanup->next)
+                cleanup->func (cleanup->data);
+
+        block = arena->blocks;
+        while (block != NULL) {
+                GUPnPDLNAArenaBlock *next = block->next;
+
+                g_free (block);
+                block = next;
+        }
+        g_slice_free (GUPnPDLNAArena, arena);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GUPNP_DLNA_ARENA_H__
+#define __GUPNP_DLNA_ARENA_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GUPnPDLNAArena GUPnPDLNAArena;
+
+GUPnPDLNAArena *
+gupnp_dlna_arena_new (gsize block_size);
+
+GUPnPDLNAArena *
+gupnp_dlna_arena_ref (GUPnPDLNAArena *arena);
+
+void
+gupnp_dlna_arena_unref (GUPnPDLNAArena *arena);
+
+gpointer
+gupnp_dlna_arena_alloc (GUPnPDLNAArena *arena,
+                        gsize           size);
+
+gchar *
+gupnp_dlna_arena_strdup (GUPnPDLNAArena *arena,
+                         const gchar    *str);
+
+GList *
+gupnp_dlna_arena_list_prepend (GUPnPDLNAArena *arena,
+                               GList          *list,
+                               gpointer        data);
+
+void
+gupnp_dlna_arena_add_cleanup (GUPnPDLNAArena *arena,
+                              GDestroyNotify  func,
+                              gpointer        data);
+
+gsize
+gupnp_dlna_arena_get_size (GUPnPDLNAArena *arena);
+
+gsize
+gupnp_dlna_arena_get_used (GUPnPDLNAArena *arena);
+
+void
+gupnp_dlna_arena_free (GUPnPDLNAArena *arena);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_ARENA_H__ */
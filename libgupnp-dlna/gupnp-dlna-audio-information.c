@@ -46,9 +46,11 @@
  */
 
 #include "gupnp-dlna-audio-information.h"
+#include "gupnp-dlna-string-cache-private.h"
 
 struct _GUPnPDLNAAudioInformationPrivate {
-        gpointer placeholder;
+        /* owned strings handed out by the default peek_* */
+        GUPnPDLNAStringCache strings;
 };
 typedef struct _GUPnPDLNAAudioInformationPrivate
         GUPnPDLNAAudioInformationPrivate;
@@ -57,10 +59,27 @@ G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GUPnPDLNAAudioInformation,
                         gupnp_dlna_audio_information,
                         G_TYPE_OBJECT)
 
+static void
+gupnp_dlna_audio_information_finalize (GObject *object)
+{
+        GUPnPDLNAAudioInformation *info = GUPNP_DLNA_AUDIO_INFORMATION (object);
+        GUPnPDLNAAudioInformationPrivate *priv =
+                gupnp_dlna_audio_information_get_instance_private (info);
+        GObjectClass *parent_class =
+                G_OBJECT_CLASS (gupnp_dlna_audio_information_parent_class);
+
+        gupnp_dlna_string_cache_clear (&priv->strings);
+        parent_class->finalize (object);
+}
+
 static void
 gupnp_dlna_audio_information_class_init
                                     (GUPnPDLNAAudioInformationClass *info_class)
 {
+        GObjectClass *object_class = G_OBJECT_CLASS (info_class);
+
+        object_class->finalize = gupnp_dlna_audio_information_finalize;
+
         info_class->get_bitrate = NULL;
         info_class->get_channels = NULL;
         info_class->get_depth = NULL;
@@ -73,11 +92,19 @@ gupnp_dlna_audio_information_class_init
         info_class->get_stream_format = NULL;
         info_class->get_wma_version = NULL;
         info_class->get_mime = NULL;
+        info_class->peek_level = NULL;
+        info_class->peek_profile = NULL;
+        info_class->peek_stream_format = NULL;
+        info_class->peek_mime = NULL;
 }
 
 static void
 gupnp_dlna_audio_information_init (GUPnPDLNAAudioInformation *info)
 {
+        GUPnPDLNAAudioInformationPrivate *priv =
+                gupnp_dlna_audio_information_get_instance_private (info);
+
+        gupnp_dlna_string_cache_init (&priv->strings);
 }
 
 /**
@@ -380,3 +407,157 @@ gupnp_dlna_audio_information_get_mime (GUPnPDLNAAudioInformation *info)
 
         return info_class->get_mime (info);
 }
+
+/**
+ * gupnp_dlna_audio_information_peek_level: (skip)
+ * @info: A #GUPnPDLNAAudioInformation object.
+ *
+ * Gets the same value as gupnp_dlna_audio_information_get_level(),
+ * but without copying the string. The string is owned by @info and
+ * stays valid for its lifetime.
+ *
+ * Returns: A level.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_audio_information_peek_level (GUPnPDLNAAudioInformation *info)
+{
+        GUPnPDLNAAudioInformationClass *info_class;
+        GUPnPDLNAAudioInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_AUDIO_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_AUDIO_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                            (GUPNP_DLNA_IS_AUDIO_INFORMATION_CLASS (info_class),
+                             GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_level != NULL)
+                return info_class->peek_level (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_level;
+        priv = gupnp_dlna_audio_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "level",
+                                             get,
+                                             info);
+}
+
+/**
+ * gupnp_dlna_audio_information_peek_profile: (skip)
+ * @info: A #GUPnPDLNAAudioInformation object.
+ *
+ * Gets the same value as gupnp_dlna_audio_information_get_profile(),
+ * but without copying the string. The string is owned by @info and
+ * stays valid for its lifetime.
+ *
+ * Returns: A profile.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_audio_information_peek_profile (GUPnPDLNAAudioInformation *info)
+{
+        GUPnPDLNAAudioInformationClass *info_class;
+        GUPnPDLNAAudioInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_AUDIO_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_AUDIO_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                            (GUPNP_DLNA_IS_AUDIO_INFORMATION_CLASS (info_class),
+                             GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_profile != NULL)
+                return info_class->peek_profile (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_profile;
+        priv = gupnp_dlna_audio_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "profile",
+                                             get,
+                                             info);
+}
+
+/**
+ * gupnp_dlna_audio_information_peek_stream_format: (skip)
+ * @info: A #GUPnPDLNAAudioInformation object.
+ *
+ * Gets the same value as
+ * gupnp_dlna_audio_information_get_stream_format(), but without
+ * copying the string. The string is owned by @info and stays valid
+ * for its lifetime.
+ *
+ * Returns: A stream format.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_audio_information_peek_stream_format
+                                        (GUPnPDLNAAudioInformation *info)
+{
+        GUPnPDLNAAudioInformationClass *info_class;
+        GUPnPDLNAAudioInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_AUDIO_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_AUDIO_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                            (GUPNP_DLNA_IS_AUDIO_INFORMATION_CLASS (info_class),
+                             GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_stream_format != NULL)
+                return info_class->peek_stream_format (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_stream_format;
+        priv = gupnp_dlna_audio_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "stream_format",
+                                             get,
+                                             info);
+}
+
+/**
+ * gupnp_dlna_audio_information_peek_mime: (skip)
+ * @info: A #GUPnPDLNAAudioInformation object.
+ *
+ * Gets the same value as gupnp_dlna_audio_information_get_mime(), but
+ * without copying the string. The string is owned by @info and stays
+ * valid for its lifetime.
+ *
+ * Returns: A MIME type.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_audio_information_peek_mime (GUPnPDLNAAudioInformation *info)
+{
+        GUPnPDLNAAudioInformationClass *info_class;
+        GUPnPDLNAAudioInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_AUDIO_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_AUDIO_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                            (GUPNP_DLNA_IS_AUDIO_INFORMATION_CLASS (info_class),
+                             GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_mime != NULL)
+                return info_class->peek_mime (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_mime;
+        priv = gupnp_dlna_audio_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "mime",
+                                             get,
+                                             info);
+}
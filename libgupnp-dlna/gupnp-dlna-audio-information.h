@@ -73,6 +73,18 @@ G_DECLARE_DERIVABLE_TYPE (GUPnPDLNAAudioInformation,
  * a WMA version.
  * @get_mime: This is called by #GUPnPDLNAProfileGuesser to get a MIME
  * type.
+ * @peek_level: This is called by #GUPnPDLNAProfileGuesser to get
+ * a level without copying it. Optional, by default the result of
+ * @get_level is cached.
+ * @peek_profile: This is called by #GUPnPDLNAProfileGuesser to get
+ * a profile without copying it. Optional, by default the result of
+ * @get_profile is cached.
+ * @peek_stream_format: This is called by #GUPnPDLNAProfileGuesser to get
+ * a stream format without copying it. Optional, by default the result of
+ * @get_stream_format is cached.
+ * @peek_mime: This is called by #GUPnPDLNAProfileGuesser to get
+ * a MIME type without copying it. Optional, by default the result of
+ * @get_mime is cached.
  * @_reserved: Padding. Ignore it.
  */
 struct _GUPnPDLNAAudioInformationClass {
@@ -114,7 +126,19 @@ struct _GUPnPDLNAAudioInformationClass {
         GUPnPDLNAStringValue
         (* get_mime) (GUPnPDLNAAudioInformation *info);
 
-        gpointer _reserved[12];
+        GUPnPDLNAConstStringValue
+        (* peek_level) (GUPnPDLNAAudioInformation *info);
+
+        GUPnPDLNAConstStringValue
+        (* peek_profile) (GUPnPDLNAAudioInformation *info);
+
+        GUPnPDLNAConstStringValue
+        (* peek_stream_format) (GUPnPDLNAAudioInformation *info);
+
+        GUPnPDLNAConstStringValue
+        (* peek_mime) (GUPnPDLNAAudioInformation *info);
+
+        gpointer _reserved[8];
 };
 
 GUPnPDLNAIntValue
@@ -155,6 +179,19 @@ gupnp_dlna_audio_information_get_wma_version (GUPnPDLNAAudioInformation *info);
 GUPnPDLNAStringValue
 gupnp_dlna_audio_information_get_mime (GUPnPDLNAAudioInformation *info);
 
+GUPnPDLNAConstStringValue
+gupnp_dlna_audio_information_peek_level (GUPnPDLNAAudioInformation *info);
+
+GUPnPDLNAConstStringValue
+gupnp_dlna_audio_information_peek_profile (GUPnPDLNAAudioInformation *info);
+
+GUPnPDLNAConstStringValue
+gupnp_dlna_audio_information_peek_stream_format
+                                        (GUPnPDLNAAudioInformation *info);
+
+GUPnPDLNAConstStringValue
+gupnp_dlna_audio_information_peek_mime (GUPnPDLNAAudioInformation *info);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_AUDIO_INFORMATION_H__ */
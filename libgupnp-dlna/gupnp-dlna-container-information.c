@@ -47,9 +47,11 @@
  */
 
 #include "gupnp-dlna-container-information.h"
+#include "gupnp-dlna-string-cache-private.h"
 
 struct _GUPnPDLNAContainerInformationPrivate {
-        gpointer placeholder;
+        /* owned strings handed out by the default peek_* */
+        GUPnPDLNAStringCache strings;
 };
 typedef struct _GUPnPDLNAContainerInformationPrivate
         GUPnPDLNAContainerInformationPrivate;
@@ -58,21 +60,46 @@ G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GUPnPDLNAContainerInformation,
                                      gupnp_dlna_container_information,
                                      G_TYPE_OBJECT)
 
+static void
+gupnp_dlna_container_information_finalize (GObject *object)
+{
+        GUPnPDLNAContainerInformation *info =
+                                  GUPNP_DLNA_CONTAINER_INFORMATION (object);
+        GUPnPDLNAContainerInformationPrivate *priv =
+                gupnp_dlna_container_information_get_instance_private (info);
+        GObjectClass *parent_class =
+                G_OBJECT_CLASS (gupnp_dlna_container_information_parent_class);
+
+        gupnp_dlna_string_cache_clear (&priv->strings);
+        parent_class->finalize (object);
+}
+
 static void
 gupnp_dlna_container_information_class_init
                                 (GUPnPDLNAContainerInformationClass *info_class)
 {
+        GObjectClass *object_class = G_OBJECT_CLASS (info_class);
+
+        object_class->finalize = gupnp_dlna_container_information_finalize;
+
         info_class->get_mpeg_version = NULL;
         info_class->get_packet_size = NULL;
         info_class->get_profile = NULL;
         info_class->is_system_stream = NULL;
         info_class->get_variant = NULL;
         info_class->get_mime = NULL;
+        info_class->peek_profile = NULL;
+        info_class->peek_variant = NULL;
+        info_class->peek_mime = NULL;
 }
 
 static void
 gupnp_dlna_container_information_init (GUPnPDLNAContainerInformation *info)
 {
+        GUPnPDLNAContainerInformationPrivate *priv =
+                gupnp_dlna_container_information_get_instance_private (info);
+
+        gupnp_dlna_string_cache_init (&priv->strings);
 }
 
 /**
@@ -229,3 +256,121 @@ gupnp_dlna_container_information_get_mime (GUPnPDLNAContainerInformation *info)
 
         return info_class->get_mime (info);
 }
+
+/**
+ * gupnp_dlna_container_information_peek_profile: (skip)
+ * @info: A #GUPnPDLNAContainerInformation object.
+ *
+ * Gets the same value as
+ * gupnp_dlna_container_information_get_profile(), but without copying
+ * the string. The string is owned by @info and stays valid for its
+ * lifetime.
+ *
+ * Returns: A profile.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_container_information_peek_profile
+                                        (GUPnPDLNAContainerInformation *info)
+{
+        GUPnPDLNAContainerInformationClass *info_class;
+        GUPnPDLNAContainerInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_CONTAINER_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_CONTAINER_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                        (GUPNP_DLNA_IS_CONTAINER_INFORMATION_CLASS (info_class),
+                         GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_profile != NULL)
+                return info_class->peek_profile (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_profile;
+        priv = gupnp_dlna_container_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "profile",
+                                             get,
+                                             info);
+}
+
+/**
+ * gupnp_dlna_container_information_peek_variant: (skip)
+ * @info: A #GUPnPDLNAContainerInformation object.
+ *
+ * Gets the same value as
+ * gupnp_dlna_container_information_get_variant(), but without copying
+ * the string. The string is owned by @info and stays valid for its
+ * lifetime.
+ *
+ * Returns: A variant.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_container_information_peek_variant
+                                        (GUPnPDLNAContainerInformation *info)
+{
+        GUPnPDLNAContainerInformationClass *info_class;
+        GUPnPDLNAContainerInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_CONTAINER_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_CONTAINER_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                        (GUPNP_DLNA_IS_CONTAINER_INFORMATION_CLASS (info_class),
+                         GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_variant != NULL)
+                return info_class->peek_variant (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_variant;
+        priv = gupnp_dlna_container_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "variant",
+                                             get,
+                                             info);
+}
+
+/**
+ * gupnp_dlna_container_information_peek_mime: (skip)
+ * @info: A #GUPnPDLNAContainerInformation object.
+ *
+ * Gets the same value as gupnp_dlna_container_information_get_mime(),
+ * but without copying the string. The string is owned by @info and
+ * stays valid for its lifetime.
+ *
+ * Returns: A MIME type.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_container_information_peek_mime (GUPnPDLNAContainerInformation *info)
+{
+        GUPnPDLNAContainerInformationClass *info_class;
+        GUPnPDLNAContainerInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_CONTAINER_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_CONTAINER_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                        (GUPNP_DLNA_IS_CONTAINER_INFORMATION_CLASS (info_class),
+                         GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_mime != NULL)
+                return info_class->peek_mime (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_mime;
+        priv = gupnp_dlna_container_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "mime",
+                                             get,
+                                             info);
+}
@@ -61,6 +61,15 @@ G_DECLARE_DERIVABLE_TYPE (GUPnPDLNAContainerInformation,
  * variant.
  * @get_mime: This is called by #GUPnPDLNAProfileGuesser to get a MIME
  * type.
+ * @peek_profile: This is called by #GUPnPDLNAProfileGuesser to get
+ * a profile without copying it. Optional, by default the result of
+ * @get_profile is cached.
+ * @peek_variant: This is called by #GUPnPDLNAProfileGuesser to get
+ * a variant without copying it. Optional, by default the result of
+ * @get_variant is cached.
+ * @peek_mime: This is called by #GUPnPDLNAProfileGuesser to get
+ * a MIME type without copying it. Optional, by default the result of
+ * @get_mime is cached.
  * @_reserved: Padding. Ignore it.
  */
 struct _GUPnPDLNAContainerInformationClass {
@@ -84,7 +93,16 @@ struct _GUPnPDLNAContainerInformationClass {
         GUPnPDLNAStringValue
         (* get_mime) (GUPnPDLNAContainerInformation *info);
 
-        gpointer _reserved[12];
+        GUPnPDLNAConstStringValue
+        (* peek_profile) (GUPnPDLNAContainerInformation *info);
+
+        GUPnPDLNAConstStringValue
+        (* peek_variant) (GUPnPDLNAContainerInformation *info);
+
+        GUPnPDLNAConstStringValue
+        (* peek_mime) (GUPnPDLNAContainerInformation *info);
+
+        gpointer _reserved[9];
 };
 
 GUPnPDLNAIntValue
@@ -110,6 +128,18 @@ gupnp_dlna_container_information_get_variant
 GUPnPDLNAStringValue
 gupnp_dlna_container_information_get_mime (GUPnPDLNAContainerInformation *info);
 
+GUPnPDLNAConstStringValue
+gupnp_dlna_container_information_peek_profile
+                                        (GUPnPDLNAContainerInformation *info);
+
+GUPnPDLNAConstStringValue
+gupnp_dlna_container_information_peek_variant
+                                        (GUPnPDLNAContainerInformation *info);
+
+GUPnPDLNAConstStringValue
+gupnp_dlna_container_information_peek_mime
+                                        (GUPnPDLNAContainerInformation *info);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_CONTAINER_INFORMATION_H__ */
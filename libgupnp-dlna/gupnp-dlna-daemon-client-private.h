@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GUPNP_DLNA_DAEMON_CLIENT_PRIVATE_H__
+#define __GUPNP_DLNA_DAEMON_CLIENT_PRIVATE_H__
+
+#include <glib.h>
+#include "gupnp-dlna-information.h"
+#include "gupnp-dlna-profile.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GUPnPDLNADaemonClient GUPnPDLNADaemonClient;
+
+GUPnPDLNADaemonClient *
+gupnp_dlna_daemon_client_new (const gchar *socket_path);
+
+void
+gupnp_dlna_daemon_client_free (GUPnPDLNADaemonClient *client);
+
+const gchar *
+gupnp_dlna_daemon_client_get_socket_path (GUPnPDLNADaemonClient *client);
+
+GList *
+gupnp_dlna_daemon_client_list_profiles (GUPnPDLNADaemonClient  *client,
+                                        gboolean                relaxed_mode,
+                                        gboolean                extended_mode,
+                                        GError                **error);
+
+gboolean
+gupnp_dlna_daemon_client_guess (GUPnPDLNADaemonClient  *client,
+                                gboolean                relaxed_mode,
+                                gboolean                extended_mode,
+                                const gchar            *uri,
+                                guint                   timeout_in_ms,
+                                GUPnPDLNAInformation   *info,
+                                GUPnPDLNAProfile      **profile,
+                                GUPnPDLNAInformation  **extracted_info,
+                                GError                **error);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_DAEMON_CLIENT_PRIVATE_H__ */
@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gio/gio.h>
+#ifdef G_OS_UNIX
+#include <gio/gunixsocketaddress.h>
+#endif
+
+#include "gupnp-dlna-daemon-client-private.h"
+#include "gupnp-dlna-daemon-protocol-private.h"
+#include "gupnp-dlna-profile-private.h"
+
+/* Client side of gupnp-dlna-daemon. Connections are kept open
+ * between requests, and one is opened for each request running at
+ * the same time. A reply is waited for no longer than the extraction
+ * timeout of the request plus a grace period.
+ *
+ * The daemon only tells the name, MIME type, digest and extended
+ * flag of a profile, so the profiles handed out here have no
+ * restrictions. A profile is created once for each digest, so
+ * guesses and the listed profiles share the same objects. They live
+ * as long as the client. The list of profiles is fetched again once
+ * a guess returns a profile it does not hold, the replaced list is
+ * kept until the next fetch.
+ */
+
+#define REPLY_GRACE_MS 5000
+
+struct _GUPnPDLNADaemonClient {
+        gchar      *socket_path;
+        /* guards everything below */
+        GMutex      lock;
+        GQueue      idle;     /* <GSocketConnection *> */
+        GHashTable *profiles; /* <digest, GUPnPDLNAProfile *> */
+        GList      *profile_list; /* NULL until listed */
+        GList      *previous_profile_list;
+        gboolean    profile_list_stale;
+};
+
+GUPnPDLNADaemonClient *
+gupnp_dlna_daemon_client_new (const gchar *socket_path)
+{
+        GUPnPDLNADaemonClient *client = g_slice_new0 (GUPnPDLNADaemonClient);
+
+        client->socket_path =
+                   (socket_path != NULL ?
+                    g_strdup (socket_path) :
+                    gupnp_dlna_daemon_get_default_socket_path ());
+        g_mutex_init (&client->lock);
+        g_queue_init (&client->idle);
+        client->profiles = g_hash_table_new_full (g_str_hash,
+                                                  g_str_equal,
+                                                  g_free,
+                                                  g_object_unref);
+
+        return client;
+}
+
+void
+gupnp_dlna_daemon_client_free (GUPnPDLNADaemonClient *client)
+{
+        g_return_if_fail (client != NULL);
+
+        g_queue_clear_full (&client->idle, g_object_unref);
+        g_list_free (client->previous_profile_list);
+        g_list_free (client->profile_list);
+        g_hash_table_unref (client->profiles);
+        g_mutex_clear (&client->lock);
+        g_free (client->socket_path);
+        g_slice_free (GUPnPDLNADaemonClient, client);
+}
+
+const gchar *
+gupnp_dlna_daemon_client_get_socket_path (GUPnPDLNADaemonClient *client)
+{
+        g_return_val_if_fail (client != NULL, NULL);
+
+        return client->socket_path;
+}
+
+static GSocketConnection *
+connect_to_daemon (GUPnPDLNADaemonClient  *client,
+                   GError                **error)
+{
+#ifdef G_OS_UNIX
+        GSocketClient *socket_client = g_socket_client_new ();
+        GSocketAddress *address =
+                           g_unix_socket_address_new (client->socket_path);
+        GSocketConnection *connection;
+
+        connection = g_socket_client_connect (socket_client,
+                                              G_SOCKET_CONNECTABLE (address),
+                                              NULL,
+                                              error);
+        g_object_unref (address);
+        g_object_unref (socket_client);
+
+        return connection;
+#else
+        g_set_error_literal (error,
+                             G_IO_ERROR,
+                             G_IO_ERROR_NOT_SUPPORTED,
+                             "Guessing daemon is not supported on this "
+                             "platform");
+
+        return NULL;
+#endif
+}
+
+/* Called with the lock held. */
+static GUPnPDLNAProfile *
+get_profile (GUPnPDLNADaemonClient *client,
+             GVariant              *description)
+{
+        const gchar *name;
+        const gchar *mime;
+        const gchar *digest;
+        gboolean extended;
+        GUPnPDLNAProfile *profile;
+
+        g_variant_get (description,
+                       "(&s&s&sb)",
+                       &name,
+                       &mime,
+                       &digest,
+                       &extended);
+        if (name[0] == '\0')
+                return NULL;
+
+        profile = g_hash_table_lookup (client->profiles, digest);
+        if (profile == NULL) {
+                profile = gupnp_dlna_profile_new (name,
+                                                  mime,
+                                                  NULL,
+                                                  NULL,
+                                                  NULL,
+                                                  NULL,
+                                                  extended);
+                gupnp_dlna_profile_set_digest (profile, digest);
+                g_hash_table_insert (client->profiles,
+                                     g_strdup (digest),
+                                     profile);
+                /* the daemon reloaded its profiles */
+                if (client->profile_list != NULL)
+                        client->profile_list_stale = TRUE;
+        }
+
+        return profile;
+}
+
+/* A timed out request is not sent again, the daemon is busy with it
+ * rather than gone. */
+static GVariant *
+exchange (GSocketConnection  *connection,
+          GVariant           *request,
+          guint               timeout_in_ms,
+          GError            **error)
+{
+        GIOStream *stream = G_IO_STREAM (connection);
+        GVariant *reply;
+        GError *read_error = NULL;
+
+        g_socket_set_timeout (g_socket_connection_get_socket (connection),
+                              (timeout_in_ms + REPLY_GRACE_MS + 999) / 1000);
+        if (!gupnp_dlna_daemon_write_frame
+                                        (g_io_stream_get_output_stream (stream),
+                                         request,
+                                         error))
+                return NULL;
+
+        reply = gupnp_dlna_daemon_read_frame
+                                (g_io_stream_get_input_stream (stream),
+                                 G_VARIANT_TYPE (GUPNP_DLNA_DAEMON_REPLY_TYPE),
+                                 &read_error);
+        if (reply == NULL && read_error == NULL)
+                g_set_error_literal (&read_error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_CONNECTION_CLOSED,
+                                     "Guessing daemon closed the "
+                                     "connection");
+        if (read_error != NULL)
+                g_propagate_error (error, read_error);
+
+        return reply;
+}
+
+/* Sends @request on an idle connection, or on a new one if there is
+ * none. An idle connection might have been closed by a restarted
+ * daemon, in such case the request is sent again on a new one. The
+ * reply is checked for an error of the daemon. */
+static GVariant *
+send_request (GUPnPDLNADaemonClient  *client,
+              GVariant               *request,
+              guint                   timeout_in_ms,
+              GError                **error)
+{
+        GSocketConnection *connection;
+        GVariant *reply;
+        gboolean ok;
+        const gchar *domain;
+        gint code;
+        const gchar *message;
+
+        for (;;) {
+                GError *request_error = NULL;
+
+                g_mutex_lock (&client->lock);
+                connection = g_queue_pop_head (&client->idle);
+                g_mutex_unlock (&client->lock);
+                if (connection == NULL)
+                        break;
+
+                reply = exchange (connection,
+                                  request,
+                                  timeout_in_ms,
+                                  &request_error);
+                if (reply != NULL)
+                        goto done;
+                g_object_unref (connection);
+                if (g_error_matches (request_error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_TIMED_OUT)) {
+                        g_propagate_error (error, request_error);
+
+                        return NULL;
+                }
+                g_debug ("Dropping stale daemon connection: %s",
+                         request_error->message);
+                g_error_free (request_error);
+        }
+
+        connection = connect_to_daemon (client, error);
+        if (connection == NULL)
+                return NULL;
+        reply = exchange (connection, request, timeout_in_ms, error);
+        if (reply == NULL) {
+                g_object_unref (connection);
+
+                return NULL;
+        }
+
+ done:
+        g_mutex_lock (&client->lock);
+        g_queue_push_head (&client->idle, connection);
+        g_mutex_unlock (&client->lock);
+
+        g_variant_get_child (reply, 0, "b", &ok);
+        if (ok)
+                return reply;
+
+        g_variant_get_child (reply, 1, "&s", &domain);
+        g_variant_get_child (reply, 2, "i", &code);
+        g_variant_get_child (reply, 3, "&s", &message);
+        if (domain[0] != '\0')
+                g_set_error_literal (error,
+                                     g_quark_from_string (domain),
+                                     code,
+                                     message);
+        else
+                g_set_error_literal (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_FAILED,
+                                     message);
+        g_variant_unref (reply);
+
+        return NULL;
+}
+
+static GVariant *
+new_request (GUPnPDLNADaemonRequestKind  kind,
+             gboolean                    relaxed_mode,
+             gboolean                    extended_mode,
+             guint                       timeout_in_ms,
+             const gchar                *uri,
+             GVariant                   *data)
+{
+        return g_variant_ref_sink (g_variant_new ("(ybbus@ay)",
+                                                  kind,
+                                                  relaxed_mode,
+                                                  extended_mode,
+                                                  timeout_in_ms,
+                                                  uri != NULL ? uri : "",
+                                                  data));
+}
+
+static GVariant *
+empty_data (void)
+{
+        return g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, NULL, 0, 1);
+}
+
+/* Lists the profiles of the daemon. The list stays valid until it is
+ * fetched again twice, see above. On failure, the last fetched list
+ * is returned along with the error. */
+GList *
+gupnp_dlna_daemon_client_list_profiles (GUPnPDLNADaemonClient  *client,
+                                        gboolean                relaxed_mode,
+                                        gboolean                extended_mode,
+                                        GError                **error)
+{
+        GVariant *request;
+        GVariant *reply;
+        GVariant *descriptions;
+        GList *profiles = NULL;
+        gsize count;
+        gsize index;
+
+        g_return_val_if_fail (client != NULL, NULL);
+
+        g_mutex_lock (&client->lock);
+        if (client->profile_list != NULL && !client->profile_list_stale) {
+                profiles = client->profile_list;
+                g_mutex_unlock (&client->lock);
+
+                return profiles;
+        }
+        g_mutex_unlock (&client->lock);
+
+        request = new_request (GUPNP_DLNA_DAEMON_REQUEST_LIST_PROFILES,
+                               relaxed_mode,
+                               extended_mode,
+                               0,
+                               NULL,
+                               empty_data ());
+        reply = send_request (client, request, 0, error);
+        g_variant_unref (request);
+
+        g_mutex_lock (&client->lock);
+        if (reply != NULL) {
+                descriptions = g_variant_get_child_value (reply, 6);
+                count = g_variant_n_children (descriptions);
+                for (index = count; index-- > 0;) {
+                        GVariant *description = g_variant_get_child_value
+                                        (descriptions,
+                                         index);
+
+                        profiles = g_list_prepend (profiles,
+                                                   get_profile (client,
+                                                                description));
+                        g_variant_unref (description);
+                }
+                g_variant_unref (descriptions);
+                g_variant_unref (reply);
+
+                g_list_free (client->previous_profile_list);
+                client->previous_profile_list = client->profile_list;
+                client->profile_list = profiles;
+                client->profile_list_stale = FALSE;
+        }
+        profiles = client->profile_list;
+        g_mutex_unlock (&client->lock);
+
+        return profiles;
+}
+
+/* Guesses a profile of @info, or of @uri if @info is NULL, in which
+ * case the daemon extracts the information and stores it in
+ * @extracted_info. Returns FALSE if the daemon could not be reached
+ * or failed to extract the information. */
+gboolean
+gupnp_dlna_daemon_client_guess (GUPnPDLNADaemonClient  *client,
+                                gboolean                relaxed_mode,
+                                gboolean                extended_mode,
+                                const gchar            *uri,
+                                guint                   timeout_in_ms,
+                                GUPnPDLNAInformation   *info,
+                                GUPnPDLNAProfile      **profile,
+                                GUPnPDLNAInformation  **extracted_info,
+                                GError                **error)
+{
+        GVariant *data;
+        GVariant *request;
+        GVariant *reply;
+        GVariant *description;
+        gboolean guessed = TRUE;
+
+        g_return_val_if_fail (client != NULL, FALSE);
+        g_return_val_if_fail (uri != NULL || info != NULL, FALSE);
+        g_return_val_if_fail (profile != NULL, FALSE);
+
+        if (info != NULL) {
+                GBytes *serialized = gupnp_dlna_information_serialize (info,
+                                                                       NULL);
+
+                data = g_variant_new_from_bytes (G_VARIANT_TYPE_BYTESTRING,
+                                                 serialized,
+                                                 TRUE);
+                g_bytes_unref (serialized);
+                uri = gupnp_dlna_information_get_uri (info);
+        } else {
+                data = empty_data ();
+        }
+        request = new_request (GUPNP_DLNA_DAEMON_REQUEST_GUESS,
+                               relaxed_mode,
+                               extended_mode,
+                               timeout_in_ms,
+                               uri,
+                               data);
+        reply = send_request (client, request, timeout_in_ms, error);
+        g_variant_unref (request);
+        if (reply == NULL)
+                return FALSE;
+
+        description = g_variant_get_child_value (reply, 4);
+        g_mutex_lock (&client->lock);
+        *profile = get_profile (client, description);
+        g_mutex_unlock (&client->lock);
+        g_variant_unref (description);
+
+        data = g_variant_get_child_value (reply, 5);
+        if (extracted_info != NULL && g_variant_get_size (data) > 0) {
+                GBytes *serialized = g_variant_get_data_as_bytes (data);
+
+                *extracted_info = gupnp_dlna_information_deserialize
+                                        (serialized,
+                                         NULL,
+                                         error);
+                g_bytes_unref (serialized);
+                guessed = (*extracted_info != NULL);
+        }
+        g_variant_unref (data);
+        g_variant_unref (reply);
+
+        return guessed;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GUPNP_DLNA_DAEMON_PROTOCOL_PRIVATE_H__
+#define __GUPNP_DLNA_DAEMON_PROTOCOL_PRIVATE_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+/* Protocol spoken between gupnp-dlna-daemon and guessers created
+ * with gupnp_dlna_profile_guesser_new_for_daemon() over a Unix
+ * socket.
+ *
+ * Every message is a frame - a 32-bit big endian payload size
+ * followed by the payload, which is a serialized GVariant. A client
+ * sends requests one by one on a connection, each answered with a
+ * reply.
+ *
+ * A request holds its kind, relaxed mode, extended mode, the
+ * extraction timeout, the URI and information serialized with
+ * gupnp_dlna_information_serialize(). A guess request with empty
+ * information makes the daemon extract it from the URI, otherwise
+ * the daemon only matches the information. A request listing the
+ * profiles uses only the modes.
+ *
+ * A reply holds a success flag, the domain (as a quark string), code
+ * and message of the error, the matched profile (an empty name if
+ * none matched), the serialized information if the daemon extracted
+ * it and the listed profiles. A profile is described by its name,
+ * MIME type, digest and extended flag.
+ */
+
+typedef enum {
+        GUPNP_DLNA_DAEMON_REQUEST_GUESS,
+        GUPNP_DLNA_DAEMON_REQUEST_LIST_PROFILES
+} GUPnPDLNADaemonRequestKind;
+
+#define GUPNP_DLNA_DAEMON_PROFILE_TYPE "(sssb)"
+#define GUPNP_DLNA_DAEMON_PROFILE_LIST_TYPE "a(sssb)"
+#define GUPNP_DLNA_DAEMON_REQUEST_TYPE "(ybbusay)"
+#define GUPNP_DLNA_DAEMON_REPLY_TYPE "(bsis(sssb)aya(sssb))"
+
+/* Frames bigger than this are treated as garbage. */
+#define GUPNP_DLNA_DAEMON_MAX_FRAME_SIZE (16 * 1024 * 1024)
+
+gchar *
+gupnp_dlna_daemon_get_default_socket_path (void);
+
+gboolean
+gupnp_dlna_daemon_write_frame (GOutputStream  *stream,
+                               GVariant       *message,
+                               GError        **error);
+
+GVariant *
+gupnp_dlna_daemon_read_frame (GInputStream        *stream,
+                              const GVariantType  *type,
+                              GError             **error);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_DAEMON_PROTOCOL_PRIVATE_H__ */
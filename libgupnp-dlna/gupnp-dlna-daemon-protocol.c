@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "gupnp-dlna-daemon-protocol-private.h"
+
+#define HEADER_SIZE 4
+
+/* Path of the daemon socket, taken from GUPNP_DLNA_DAEMON_SOCKET
+ * environment variable or put in the user's runtime directory. */
+gchar *
+gupnp_dlna_daemon_get_default_socket_path (void)
+{
+        const gchar *path = g_getenv ("GUPNP_DLNA_DAEMON_SOCKET");
+
+        if (path != NULL)
+                return g_strdup (path);
+
+        return g_build_filename (g_get_user_runtime_dir (),
+                                 "gupnp-dlna-2.0.socket",
+                                 NULL);
+}
+
+gboolean
+gupnp_dlna_daemon_write_frame (GOutputStream  *stream,
+                               GVariant       *message,
+                               GError        **error)
+{
+        gsize size = g_variant_get_size (message);
+        guint32 header = GUINT32_TO_BE (size);
+
+        return (g_output_stream_write_all (stream,
+                                           &header,
+                                           HEADER_SIZE,
+                                           NULL,
+                                           NULL,
+                                           error) &&
+                g_output_stream_write_all (stream,
+                                           g_variant_get_data (message),
+                                           size,
+                                           NULL,
+                                           NULL,
+                                           error));
+}
+
+/* Returns NULL without setting @error if the stream ended before a
+ * new frame. */
+GVariant *
+gupnp_dlna_daemon_read_frame (GInputStream        *stream,
+                              const GVariantType  *type,
+                              GError             **error)
+{
+        guint32 header;
+        gsize count;
+        gsize size;
+        guint8 *data;
+        GBytes *bytes;
+        GVariant *message;
+
+        if (!g_input_stream_read_all (stream,
+                                      &header,
+                                      HEADER_SIZE,
+                                      &count,
+                                      NULL,
+                                      error))
+                return NULL;
+        if (count == 0)
+                return NULL;
+        size = GUINT32_FROM_BE (header);
+        if (count < HEADER_SIZE || size > GUPNP_DLNA_DAEMON_MAX_FRAME_SIZE) {
+                g_set_error_literal (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_INVALID_DATA,
+                                     "Invalid frame header");
+
+                return NULL;
+        }
+
+        data = g_malloc (size);
+        if (!g_input_stream_read_all (stream,
+                                      data,
+                                      size,
+                                      &count,
+                                      NULL,
+                                      error)) {
+                g_free (data);
+
+                return NULL;
+        }
+        if (count < size) {
+                g_free (data);
+                g_set_error_literal (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_CONNECTION_CLOSED,
+                                     "Connection closed in the middle of "
+                                     "a frame");
+
+                return NULL;
+        }
+
+        bytes = g_bytes_new_take (data, size);
+        message = g_variant_new_from_bytes (type, bytes, FALSE);
+        g_bytes_unref (bytes);
+
+        return g_variant_ref_sink (message);
+}
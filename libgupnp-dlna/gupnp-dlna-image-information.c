@@ -46,9 +46,11 @@
  */
 
 #include "gupnp-dlna-image-information.h"
+#include "gupnp-dlna-string-cache-private.h"
 
 struct _GUPnPDLNAImageInformationPrivate {
-        gpointer placeholder;
+        /* owned strings handed out by the default peek_* */
+        GUPnPDLNAStringCache strings;
 };
 typedef struct _GUPnPDLNAImageInformationPrivate
         GUPnPDLNAImageInformationPrivate;
@@ -57,19 +59,41 @@ G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GUPnPDLNAImageInformation,
                                      gupnp_dlna_image_information,
                                      G_TYPE_OBJECT)
 
+static void
+gupnp_dlna_image_information_finalize (GObject *object)
+{
+        GUPnPDLNAImageInformation *info = GUPNP_DLNA_IMAGE_INFORMATION (object);
+        GUPnPDLNAImageInformationPrivate *priv =
+                gupnp_dlna_image_information_get_instance_private (info);
+        GObjectClass *parent_class =
+                G_OBJECT_CLASS (gupnp_dlna_image_information_parent_class);
+
+        gupnp_dlna_string_cache_clear (&priv->strings);
+        parent_class->finalize (object);
+}
+
 static void
 gupnp_dlna_image_information_class_init
                                     (GUPnPDLNAImageInformationClass *info_class)
 {
+        GObjectClass *object_class = G_OBJECT_CLASS (info_class);
+
+        object_class->finalize = gupnp_dlna_image_information_finalize;
+
         info_class->get_depth = NULL;
         info_class->get_height = NULL;
         info_class->get_width = NULL;
         info_class->get_mime = NULL;
+        info_class->peek_mime = NULL;
 }
 
 static void
 gupnp_dlna_image_information_init (GUPnPDLNAImageInformation *info)
 {
+        GUPnPDLNAImageInformationPrivate *priv =
+                gupnp_dlna_image_information_get_instance_private (info);
+
+        gupnp_dlna_string_cache_init (&priv->strings);
 }
 
 /**
@@ -171,3 +195,41 @@ gupnp_dlna_image_information_get_mime (GUPnPDLNAImageInformation *info)
 
         return info_class->get_mime (info);
 }
+
+/**
+ * gupnp_dlna_image_information_peek_mime: (skip)
+ * @info: A #GUPnPDLNAImageInformation object.
+ *
+ * Gets the same value as gupnp_dlna_image_information_get_mime(), but
+ * without copying the string. The string is owned by @info and stays
+ * valid for its lifetime.
+ *
+ * Returns: A MIME type of an image.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_image_information_peek_mime (GUPnPDLNAImageInformation *info)
+{
+        GUPnPDLNAImageInformationClass *info_class;
+        GUPnPDLNAImageInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_IMAGE_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_IMAGE_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                            (GUPNP_DLNA_IS_IMAGE_INFORMATION_CLASS (info_class),
+                             GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_mime != NULL)
+                return info_class->peek_mime (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_mime;
+        priv = gupnp_dlna_image_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "mime",
+                                             get,
+                                             info);
+}
@@ -58,6 +58,9 @@ G_DECLARE_DERIVABLE_TYPE(GUPnPDLNAImageInformation,
  * width.
  * @get_mime: This is called by #GUPnPDLNAProfileGuesser to get a MIME
  * type.
+ * @peek_mime: This is called by #GUPnPDLNAProfileGuesser to get
+ * a MIME type without copying it. Optional, by default the result of
+ * @get_mime is cached.
  * @_reserved: Padding. Ignore it.
  */
 struct _GUPnPDLNAImageInformationClass {
@@ -75,7 +78,10 @@ struct _GUPnPDLNAImageInformationClass {
         GUPnPDLNAStringValue
         (* get_mime) (GUPnPDLNAImageInformation *info);
 
-        gpointer _reserved[12];
+        GUPnPDLNAConstStringValue
+        (* peek_mime) (GUPnPDLNAImageInformation *info);
+
+        gpointer _reserved[11];
 };
 
 GUPnPDLNAIntValue
@@ -90,6 +96,9 @@ gupnp_dlna_image_information_get_width (GUPnPDLNAImageInformation *info);
 GUPnPDLNAStringValue
 gupnp_dlna_image_information_get_mime (GUPnPDLNAImageInformation *info);
 
+GUPnPDLNAConstStringValue
+gupnp_dlna_image_information_peek_mime (GUPnPDLNAImageInformation *info);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_IMAGE_INFORMATION_H__ */
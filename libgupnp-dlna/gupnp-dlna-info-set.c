@@ -23,11 +23,29 @@
 
 #include "gupnp-dlna-info-set.h"
 #include "gupnp-dlna-info-value.h"
+#include "gupnp-dlna-restriction-private.h"
 #include "gupnp-dlna-value-list-private.h"
 
+typedef struct _GUPnPDLNAInfoEntry GUPnPDLNAInfoEntry;
+
+/* An info set holds at most a dozen of entries, so a plain list in
+ * insertion order is cheaper to build and to search than a hash
+ * table. It also makes it possible to put the whole set in an arena.
+ */
+struct _GUPnPDLNAInfoEntry {
+        GUPnPDLNAInfoEntry *next;
+        gchar              *name;
+        /* %NULL if a lazy set fetched the field and it had no value */
+        GUPnPDLNAInfoValue *value;
+};
+
 struct _GUPnPDLNAInfoSet {
         gchar *mime;
-        GHashTable *entries; /* <gchar *, GUPnPDLNAInfoValue *> */
+        GUPnPDLNAInfoEntry *entries;
+        GUPnPDLNAInfoEntry *last;
+        GUPnPDLNAArena *arena;
+        GUPnPDLNAInfoSetFetchFunc fetch;
+        gpointer fetch_data;
 };
 
 GUPnPDLNAInfoSet *
@@ -37,13 +55,54 @@ gupnp_dlna_info_set_new (const gchar *mime)
 
         g_return_val_if_fail (mime != NULL, NULL);
 
-        info_set = g_slice_new (GUPnPDLNAInfoSet);
+        info_set = g_slice_new0 (GUPnPDLNAInfoSet);
         info_set->mime = g_strdup (mime);
-        info_set->entries = g_hash_table_new_full
-                           (g_str_hash,
-                            g_str_equal,
-                            g_free,
-                            (GDestroyNotify) gupnp_dlna_info_value_free);
+
+        return info_set;
+}
+
+/* Everything (the set, its entries and values) is allocated from
+ * @arena, so gupnp_dlna_info_set_free() does nothing for such set -
+ * it goes away together with the arena.
+ */
+GUPnPDLNAInfoSet *
+gupnp_dlna_info_set_new_in_arena (const gchar    *mime,
+                                  GUPnPDLNAArena *arena)
+{
+        GUPnPDLNAInfoSet *info_set;
+
+        g_return_val_if_fail (mime != NULL, NULL);
+        g_return_val_if_fail (arena != NULL, NULL);
+
+        info_set = gupnp_dlna_arena_alloc (arena, sizeof (GUPnPDLNAInfoSet));
+        info_set->mime = gupnp_dlna_arena_strdup (arena, mime);
+        info_set->arena = arena;
+
+        return info_set;
+}
+
+/* Only the mime is known upfront. Any other field is fetched with
+ * @fetch the first time it is looked up, so fields of a stream
+ * rejected early on are never read from the backend.
+ */
+GUPnPDLNAInfoSet *
+gupnp_dlna_info_set_new_lazy (const gchar               *mime,
+                              GUPnPDLNAArena            *arena,
+                              GUPnPDLNAInfoSetFetchFunc  fetch,
+                              gpointer                   user_data)
+{
+        GUPnPDLNAInfoSet *info_set;
+
+        g_return_val_if_fail (fetch != NULL, NULL);
+
+        if (arena != NULL)
+                info_set = gupnp_dlna_info_set_new_in_arena (mime, arena);
+        else
+                info_set = gupnp_dlna_info_set_new (mime);
+        if (info_set != NULL) {
+                info_set->fetch = fetch;
+                info_set->fetch_data = user_data;
+        }
 
         return info_set;
 }
@@ -51,13 +110,61 @@ gupnp_dlna_info_set_new (const gchar *mime)
 void
 gupnp_dlna_info_set_free (GUPnPDLNAInfoSet *info_set)
 {
-        if (info_set == NULL)
+        GUPnPDLNAInfoEntry *entry;
+
+        if (info_set == NULL || info_set->arena != NULL)
                 return;
+
+        entry = info_set->entries;
+        while (entry != NULL) {
+                GUPnPDLNAInfoEntry *next = entry->next;
+
+                g_free (entry->name);
+                gupnp_dlna_info_value_free (entry->value);
+                g_slice_free (GUPnPDLNAInfoEntry, entry);
+                entry = next;
+        }
         g_free (info_set->mime);
-        g_hash_table_unref (info_set->entries);
         g_slice_free (GUPnPDLNAInfoSet, info_set);
 }
 
+static GUPnPDLNAInfoEntry *
+lookup_entry (GUPnPDLNAInfoSet *info_set,
+              const gchar      *name)
+{
+        GUPnPDLNAInfoEntry *entry;
+
+        for (entry = info_set->entries; entry != NULL; entry = entry->next)
+                if (!g_strcmp0 (entry->name, name))
+                        return entry;
+
+        return NULL;
+}
+
+static void
+append_entry (GUPnPDLNAInfoSet   *info_set,
+              const gchar        *name,
+              GUPnPDLNAInfoValue *value)
+{
+        GUPnPDLNAInfoEntry *entry;
+
+        if (info_set->arena != NULL) {
+                entry = gupnp_dlna_arena_alloc (info_set->arena,
+                                                sizeof (GUPnPDLNAInfoEntry));
+                entry->name = gupnp_dlna_arena_strdup (info_set->arena, name);
+        } else {
+                entry = g_slice_new (GUPnPDLNAInfoEntry);
+                entry->name = g_strdup (name);
+        }
+        entry->value = value;
+        entry->next = NULL;
+        if (info_set->last != NULL)
+                info_set->last->next = entry;
+        else
+                info_set->entries = entry;
+        info_set->last = entry;
+}
+
 static gboolean
 insert_value (GUPnPDLNAInfoSet   *info_set,
               const gchar        *name,
@@ -69,17 +176,52 @@ insert_value (GUPnPDLNAInfoSet   *info_set,
                 return FALSE;
         }
 
-        if (g_hash_table_contains (info_set->entries, name)) {
+        if (lookup_entry (info_set, name) != NULL) {
                 g_debug ("Info set: value '%s' already exists.", name);
                 gupnp_dlna_info_value_free (value);
 
                 return FALSE;
         }
-        g_hash_table_insert (info_set->entries, g_strdup (name), value);
+
+        append_entry (info_set, name, value);
 
         return TRUE;
 }
 
+/* Returns the value of @name, fetching it first if @info_set is lazy
+ * and did not try to do it yet. A field without a value is
+ * remembered as such, so it is fetched at most once. */
+static GUPnPDLNAInfoValue *
+lookup_value (GUPnPDLNAInfoSet *info_set,
+              const gchar      *name)
+{
+        GUPnPDLNAInfoEntry *entry = lookup_entry (info_set, name);
+
+        if (entry != NULL)
+                return entry->value;
+        if (info_set->fetch == NULL)
+                return NULL;
+
+        info_set->fetch (info_set, name, info_set->fetch_data);
+        entry = lookup_entry (info_set, name);
+        if (entry != NULL)
+                return entry->value;
+        append_entry (info_set, name, NULL);
+
+        return NULL;
+}
+
+/* Makes sure that a lazy @info_set tried to fetch @name. */
+void
+gupnp_dlna_info_set_fetch (GUPnPDLNAInfoSet *info_set,
+                           const gchar      *name)
+{
+        g_return_if_fail (info_set != NULL);
+        g_return_if_fail (name != NULL);
+
+        lookup_value (info_set, name);
+}
+
 gboolean
 gupnp_dlna_info_set_add_bool (GUPnPDLNAInfoSet *info_set,
                               const gchar      *name,
@@ -90,7 +232,9 @@ gupnp_dlna_info_set_add_bool (GUPnPDLNAInfoSet *info_set,
 
         return insert_value (info_set,
                              name,
-                             gupnp_dlna_info_value_new_bool (value));
+                             gupnp_dlna_info_value_new_bool
+                                        (value,
+                                         info_set->arena));
 }
 
 gboolean
@@ -102,7 +246,8 @@ gupnp_dlna_info_set_add_unsupported_bool (GUPnPDLNAInfoSet *info_set,
 
         return insert_value (info_set,
                              name,
-                             gupnp_dlna_info_value_new_unsupported_bool ());
+                             gupnp_dlna_info_value_new_unsupported_bool
+                                        (info_set->arena));
 }
 
 gboolean
@@ -116,8 +261,10 @@ gupnp_dlna_info_set_add_fraction (GUPnPDLNAInfoSet *info_set,
 
         return insert_value (info_set,
                              name,
-                             gupnp_dlna_info_value_new_fraction (numerator,
-                                                                 denominator));
+                             gupnp_dlna_info_value_new_fraction
+                                        (numerator,
+                                         denominator,
+                                         info_set->arena));
 }
 
 gboolean
@@ -129,7 +276,8 @@ gupnp_dlna_info_set_add_unsupported_fraction (GUPnPDLNAInfoSet *info_set,
 
         return insert_value (info_set,
                              name,
-                             gupnp_dlna_info_value_new_unsupported_fraction ());
+                             gupnp_dlna_info_value_new_unsupported_fraction
+                                        (info_set->arena));
 }
 
 gboolean
@@ -142,7 +290,9 @@ gupnp_dlna_info_set_add_int (GUPnPDLNAInfoSet *info_set,
 
         return insert_value (info_set,
                              name,
-                             gupnp_dlna_info_value_new_int (value));
+                             gupnp_dlna_info_value_new_int
+                                        (value,
+                                         info_set->arena));
 }
 
 gboolean
@@ -154,7 +304,8 @@ gupnp_dlna_info_set_add_unsupported_int (GUPnPDLNAInfoSet *info_set,
 
         return insert_value (info_set,
                              name,
-                             gupnp_dlna_info_value_new_unsupported_int ());
+                             gupnp_dlna_info_value_new_unsupported_int
+                                        (info_set->arena));
 }
 
 gboolean
@@ -168,7 +319,9 @@ gupnp_dlna_info_set_add_string (GUPnPDLNAInfoSet *info_set,
 
         return insert_value (info_set,
                              name,
-                             gupnp_dlna_info_value_new_string (value));
+                             gupnp_dlna_info_value_new_string
+                                        (value,
+                                         info_set->arena));
 }
 
 gboolean
@@ -180,53 +333,111 @@ gupnp_dlna_info_set_add_unsupported_string (GUPnPDLNAInfoSet *info_set,
 
         return insert_value (info_set,
                              name,
-                             gupnp_dlna_info_value_new_unsupported_string ());
+                             gupnp_dlna_info_value_new_unsupported_string
+                                        (info_set->arena));
 }
 
+static gboolean
+fits_value_list (GUPnPDLNAInfoSet   *info_set,
+                 const gchar        *name,
+                 GUPnPDLNAValueList *value_list,
+                 gboolean           *unsupported_match)
+{
+        GUPnPDLNAInfoValue *info_value = lookup_value (info_set, name);
+        gboolean value_unsupported;
+
+        if (info_value == NULL)
+                return FALSE;
+        if (!gupnp_dlna_value_list_is_superset (value_list,
+                                                info_value,
+                                                &value_unsupported))
+                return FALSE;
+        if (value_unsupported)
+                *unsupported_match = TRUE;
+
+        return TRUE;
+}
+
+/* Like gupnp_dlna_info_set_fits_restriction(), but instead of
+ * warning about a match involving unsupported values it sets
+ * @unsupported to %TRUE. If @comparisons is not %NULL, the number of
+ * performed checks (the mime one included) is added to it. */
 gboolean
-gupnp_dlna_info_set_fits_restriction (GUPnPDLNAInfoSet     *info_set,
-                                      GUPnPDLNARestriction *restriction)
+gupnp_dlna_info_set_fits_restriction_full
+                                        (GUPnPDLNAInfoSet     *info_set,
+                                         GUPnPDLNARestriction *restriction,
+                                         gboolean             *unsupported,
+                                         guint                *comparisons)
 {
-        GHashTableIter iter;
-        gpointer key;
-        gpointer value;
+        GUPnPDLNARestrictionField *fields;
+        guint field_count;
+        guint done;
         gboolean unsupported_match;
+        gboolean fits;
 
         g_return_val_if_fail (info_set != NULL, FALSE);
         g_return_val_if_fail (restriction != NULL, FALSE);
+        g_return_val_if_fail (unsupported != NULL, FALSE);
 
-        if (g_strcmp0 (info_set->mime,
-                       gupnp_dlna_restriction_get_mime (restriction)))
-                return FALSE;
-
+        *unsupported = FALSE;
+        done = 1;
         unsupported_match = FALSE;
-        g_hash_table_iter_init (&iter,
-                                gupnp_dlna_restriction_get_entries
+        fits = !g_strcmp0 (info_set->mime,
+                           gupnp_dlna_restriction_get_mime (restriction));
+        fields = gupnp_dlna_restriction_get_ordered_fields (restriction,
+                                                            &field_count);
+
+        if (fields != NULL) {
+                guint index;
+
+                for (index = 0; fits && index < field_count; ++index) {
+                        ++done;
+                        fits = fits_value_list (info_set,
+                                                fields[index].name,
+                                                fields[index].list,
+                                                &unsupported_match);
+                }
+        } else {
+                GHashTableIter iter;
+                gpointer key;
+                gpointer value;
+
+                g_hash_table_iter_init (&iter,
+                                        gupnp_dlna_restriction_get_entries
                                         (restriction));
-        while (g_hash_table_iter_next (&iter, &key, &value)) {
-                GUPnPDLNAInfoValue *info_value;
-                GUPnPDLNAValueList *value_list;
-                gboolean unsupported;
-
-                if (!g_hash_table_lookup_extended (info_set->entries,
-                                                   key,
-                                                   NULL,
-                                                   (gpointer *) &info_value))
-                        return FALSE;
-                value_list = (GUPnPDLNAValueList *) value;
-                if (!gupnp_dlna_value_list_is_superset (value_list,
-                                                        info_value,
-                                                        &unsupported))
-                        return FALSE;
-                else if (unsupported)
-                        unsupported_match = TRUE;
+                while (fits && g_hash_table_iter_next (&iter, &key, &value)) {
+                        ++done;
+                        fits = fits_value_list (info_set,
+                                                key,
+                                                value,
+                                                &unsupported_match);
+                }
         }
 
-        if (unsupported_match)
+        if (comparisons != NULL)
+                *comparisons += done;
+        if (fits)
+                *unsupported = unsupported_match;
+
+        return fits;
+}
+
+gboolean
+gupnp_dlna_info_set_fits_restriction (GUPnPDLNAInfoSet     *info_set,
+                                      GUPnPDLNARestriction *restriction)
+{
+        gboolean unsupported;
+        gboolean fits = gupnp_dlna_info_set_fits_restriction_full
+                                        (info_set,
+                                         restriction,
+                                         &unsupported,
+                                         NULL);
+
+        if (fits && unsupported)
                 g_warning ("Info set matched restriction, but it has an "
                            "unsupported value.");
 
-        return TRUE;
+        return fits;
 }
 
 static gboolean
@@ -234,17 +445,14 @@ gupnp_dlna_info_set_is_empty (GUPnPDLNAInfoSet *info_set)
 {
         g_return_val_if_fail (info_set != NULL, TRUE);
 
-        return (info_set->mime == NULL &&
-                g_hash_table_size (info_set->entries) == 0);
+        return (info_set->mime == NULL && info_set->entries == NULL);
 }
 
 gchar *
 gupnp_dlna_info_set_to_string (GUPnPDLNAInfoSet *info_set)
 {
         GString *str;
-        GHashTableIter iter;
-        gpointer key;
-        gpointer value;
+        GUPnPDLNAInfoEntry *entry;
 
         g_return_val_if_fail (info_set != NULL, NULL);
 
@@ -252,11 +460,13 @@ gupnp_dlna_info_set_to_string (GUPnPDLNAInfoSet *info_set)
                 return g_strdup ("EMPTY");
 
         str = g_string_new (info_set->mime ? info_set->mime : "(null)");
-        g_hash_table_iter_init (&iter, info_set->entries);
-        while (g_hash_table_iter_next (&iter, &key, &value)) {
-                gchar *raw = gupnp_dlna_info_value_to_string (value);
+        for (entry = info_set->entries; entry != NULL; entry = entry->next) {
+                gchar *raw;
 
-                g_string_append_printf (str, ", %s=%s", (gchar *) key, raw);
+                if (entry->value == NULL)
+                        continue;
+                raw = gupnp_dlna_info_value_to_string (entry->value);
+                g_string_append_printf (str, ", %s=%s", entry->name, raw);
                 g_free (raw);
         }
 
@@ -23,18 +23,39 @@
 #define __GUPNP_DLNA_INFO_SET_H__
 
 #include <glib.h>
+#include "gupnp-dlna-arena.h"
 #include "gupnp-dlna-restriction.h"
 
 G_BEGIN_DECLS
 
 typedef struct _GUPnPDLNAInfoSet GUPnPDLNAInfoSet;
 
+/* Expected to add @name to @info_set with one of
+ * gupnp_dlna_info_set_add_*() functions, unless it has no value. */
+typedef void (* GUPnPDLNAInfoSetFetchFunc) (GUPnPDLNAInfoSet *info_set,
+                                            const gchar      *name,
+                                            gpointer          user_data);
+
 GUPnPDLNAInfoSet *
 gupnp_dlna_info_set_new (const gchar *mime);
 
+GUPnPDLNAInfoSet *
+gupnp_dlna_info_set_new_in_arena (const gchar    *mime,
+                                  GUPnPDLNAArena *arena);
+
+GUPnPDLNAInfoSet *
+gupnp_dlna_info_set_new_lazy (const gchar               *mime,
+                              GUPnPDLNAArena            *arena,
+                              GUPnPDLNAInfoSetFetchFunc  fetch,
+                              gpointer                   user_data);
+
 void
 gupnp_dlna_info_set_free (GUPnPDLNAInfoSet *info_set);
 
+void
+gupnp_dlna_info_set_fetch (GUPnPDLNAInfoSet *info_set,
+                           const gchar      *name);
+
 gboolean
 gupnp_dlna_info_set_add_bool (GUPnPDLNAInfoSet *info_set,
                               const gchar      *name,
@@ -76,6 +97,13 @@ gboolean
 gupnp_dlna_info_set_fits_restriction (GUPnPDLNAInfoSet     *info_set,
                                       GUPnPDLNARestriction *restriction);
 
+gboolean
+gupnp_dlna_info_set_fits_restriction_full
+                                        (GUPnPDLNAInfoSet     *info_set,
+                                         GUPnPDLNARestriction *restriction,
+                                         gboolean             *unsupported,
+                                         guint                *comparisons);
+
 gchar *
 gupnp_dlna_info_set_to_string (GUPnPDLNAInfoSet *info_set);
 
@@ -19,8 +19,6 @@
  * Boston, MA 02110-1301, USA.
  */
 
-#include <string.h> /* for memset */
-
 #include "gupnp-dlna-info-value.h"
 
 /* private */
@@ -28,96 +26,130 @@ struct _GUPnPDLNAInfoValue {
         GUPnPDLNAValueType  *type;
         GUPnPDLNAValueUnion  value;
         gboolean             unsupported;
+        gboolean             in_arena;
 };
 
+/* Info values are built straight from the values the information
+ * objects hand us, so there is no need to go through the raw string
+ * representation the value types parse. When an arena is passed the
+ * value lives in it and gupnp_dlna_info_value_free() is a no-op.
+ */
 static GUPnPDLNAInfoValue *
-value_new (GUPnPDLNAValueType *type,
-           gchar *raw)
+value_alloc (GUPnPDLNAValueType *type,
+             GUPnPDLNAArena     *arena)
 {
-        GUPnPDLNAInfoValue *info_value = g_slice_new (GUPnPDLNAInfoValue);
+        GUPnPDLNAInfoValue *info_value;
 
-        info_value->type = type;
-        if (!gupnp_dlna_value_type_init (type, &info_value->value, raw)) {
-                g_slice_free (GUPnPDLNAInfoValue, info_value);
-                info_value = NULL;
-        }
+        if (arena != NULL)
+                info_value = gupnp_dlna_arena_alloc
+                                        (arena,
+                                         sizeof (GUPnPDLNAInfoValue));
         else
-                info_value->unsupported = FALSE;
-        g_free (raw);
+                info_value = g_slice_new0 (GUPnPDLNAInfoValue);
+        info_value->type = type;
+        info_value->in_arena = (arena != NULL);
 
         return info_value;
 }
 
 static GUPnPDLNAInfoValue *
-value_unsupported (GUPnPDLNAValueType *type)
+value_unsupported (GUPnPDLNAValueType *type,
+                   GUPnPDLNAArena     *arena)
 {
-        GUPnPDLNAInfoValue *info_value = g_slice_new0 (GUPnPDLNAInfoValue);
+        GUPnPDLNAInfoValue *info_value = value_alloc (type, arena);
 
-        info_value->type = type;
         info_value->unsupported = TRUE;
 
         return info_value;
 }
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_bool (gboolean value)
+gupnp_dlna_info_value_new_bool (gboolean        value,
+                                GUPnPDLNAArena *arena)
 {
-        return value_new (gupnp_dlna_value_type_bool (),
-                          g_strdup (value ? "true" : "false"));
+        GUPnPDLNAInfoValue *info_value =
+                         value_alloc (gupnp_dlna_value_type_bool (), arena);
+
+        info_value->value.bool_value = (value ? TRUE : FALSE);
+
+        return info_value;
 }
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_unsupported_bool (void)
+gupnp_dlna_info_value_new_unsupported_bool (GUPnPDLNAArena *arena)
 {
-        return value_unsupported (gupnp_dlna_value_type_bool ());
+        return value_unsupported (gupnp_dlna_value_type_bool (), arena);
 }
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_fraction (gint numerator,
-                                    gint denominator)
+gupnp_dlna_info_value_new_fraction (gint            numerator,
+                                    gint            denominator,
+                                    GUPnPDLNAArena *arena)
 {
-        return value_new (gupnp_dlna_value_type_fraction (),
-                          g_strdup_printf ("%d/%d",
-                                           numerator,
-                                           denominator));
+        GUPnPDLNAInfoValue *info_value;
+
+        if (!denominator)
+                return NULL;
+
+        info_value = value_alloc (gupnp_dlna_value_type_fraction (), arena);
+        info_value->value.fraction_value.numerator = numerator;
+        info_value->value.fraction_value.denominator = denominator;
+
+        return info_value;
 }
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_unsupported_fraction (void)
+gupnp_dlna_info_value_new_unsupported_fraction (GUPnPDLNAArena *arena)
 {
-        return value_unsupported (gupnp_dlna_value_type_fraction ());
+        return value_unsupported (gupnp_dlna_value_type_fraction (), arena);
 }
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_int (gint value)
+gupnp_dlna_info_value_new_int (gint            value,
+                               GUPnPDLNAArena *arena)
 {
-        return value_new (gupnp_dlna_value_type_int (),
-                          g_strdup_printf ("%d", value));
+        GUPnPDLNAInfoValue *info_value =
+                          value_alloc (gupnp_dlna_value_type_int (), arena);
+
+        info_value->value.int_value = value;
+
+        return info_value;
 }
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_unsupported_int (void)
+gupnp_dlna_info_value_new_unsupported_int (GUPnPDLNAArena *arena)
 {
-        return value_unsupported (gupnp_dlna_value_type_int ());
+        return value_unsupported (gupnp_dlna_value_type_int (), arena);
 }
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_string (const gchar *value)
+gupnp_dlna_info_value_new_string (const gchar    *value,
+                                  GUPnPDLNAArena *arena)
 {
-        return value_new (gupnp_dlna_value_type_string (),
-                          g_strdup (value));
+        GUPnPDLNAInfoValue *info_value;
+
+        g_return_val_if_fail (value != NULL, NULL);
+
+        info_value = value_alloc (gupnp_dlna_value_type_string (), arena);
+        if (arena != NULL)
+                info_value->value.string_value =
+                                       gupnp_dlna_arena_strdup (arena, value);
+        else
+                info_value->value.string_value = g_strdup (value);
+
+        return info_value;
 }
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_unsupported_string (void)
+gupnp_dlna_info_value_new_unsupported_string (GUPnPDLNAArena *arena)
 {
-        return value_unsupported (gupnp_dlna_value_type_string ());
+        return value_unsupported (gupnp_dlna_value_type_string (), arena);
 }
 
 void
 gupnp_dlna_info_value_free (GUPnPDLNAInfoValue *info_value)
 {
-        if (info_value == NULL)
+        if (info_value == NULL || info_value->in_arena)
                 return;
 
         if (!info_value->unsupported)
@@ -24,6 +24,7 @@
 
 #include <glib.h>
 
+#include "gupnp-dlna-arena.h"
 #include "gupnp-dlna-value-type.h"
 #include "gupnp-dlna-value-union.h"
 
@@ -32,29 +33,33 @@ G_BEGIN_DECLS
 typedef struct _GUPnPDLNAInfoValue GUPnPDLNAInfoValue;
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_bool (gboolean value);
+gupnp_dlna_info_value_new_bool (gboolean        value,
+                                GUPnPDLNAArena *arena);
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_unsupported_bool (void);
+gupnp_dlna_info_value_new_unsupported_bool (GUPnPDLNAArena *arena);
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_fraction (gint numerator,
-                                    gint denominator);
+gupnp_dlna_info_value_new_fraction (gint            numerator,
+                                    gint            denominator,
+                                    GUPnPDLNAArena *arena);
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_unsupported_fraction (void);
+gupnp_dlna_info_value_new_unsupported_fraction (GUPnPDLNAArena *arena);
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_int (gint value);
+gupnp_dlna_info_value_new_int (gint            value,
+                               GUPnPDLNAArena *arena);
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_unsupported_int (void);
+gupnp_dlna_info_value_new_unsupported_int (GUPnPDLNAArena *arena);
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_string (const gchar *value);
+gupnp_dlna_info_value_new_string (const gchar    *value,
+                                  GUPnPDLNAArena *arena);
 
 GUPnPDLNAInfoValue *
-gupnp_dlna_info_value_new_unsupported_string (void);
+gupnp_dlna_info_value_new_unsupported_string (GUPnPDLNAArena *arena);
 
 void
 gupnp_dlna_info_value_free (GUPnPDLNAInfoValue *info_value);
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GUPNP_DLNA_INFORMATION_FIELDS_PRIVATE_H__
+#define __GUPNP_DLNA_INFORMATION_FIELDS_PRIVATE_H__
+
+#include <glib-object.h>
+
+#include "gupnp-dlna-values.h"
+
+G_BEGIN_DECLS
+
+typedef enum {
+        GUPNP_DLNA_FIELD_BOOL,
+        GUPNP_DLNA_FIELD_FRACTION,
+        GUPNP_DLNA_FIELD_INT,
+        GUPNP_DLNA_FIELD_STRING
+} GUPnPDLNAFieldKind;
+
+/* A restriction field and the information getter providing its
+ * value. String fields use the borrowing peek getters. Tables of
+ * fields are terminated with an entry with %NULL name. */
+typedef struct {
+        const gchar        *name;
+        GUPnPDLNAFieldKind  kind;
+        GCallback           getter;
+} GUPnPDLNAField;
+
+typedef GUPnPDLNABoolValue
+(* GUPnPDLNAFieldGetBoolFunc) (gpointer info);
+
+typedef GUPnPDLNAFractionValue
+(* GUPnPDLNAFieldGetFractionFunc) (gpointer info);
+
+typedef GUPnPDLNAIntValue
+(* GUPnPDLNAFieldGetIntFunc) (gpointer info);
+
+typedef GUPnPDLNAConstStringValue
+(* GUPnPDLNAFieldPeekStringFunc) (gpointer info);
+
+extern const GUPnPDLNAField gupnp_dlna_audio_fields[];
+
+extern const GUPnPDLNAField gupnp_dlna_container_fields[];
+
+extern const GUPnPDLNAField gupnp_dlna_image_fields[];
+
+extern const GUPnPDLNAField gupnp_dlna_video_fields[];
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_INFORMATION_FIELDS_PRIVATE_H__ */
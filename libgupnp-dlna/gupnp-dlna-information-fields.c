@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "gupnp-dlna-information-fields-private.h"
+#include "gupnp-dlna-audio-information.h"
+#include "gupnp-dlna-container-information.h"
+#include "gupnp-dlna-image-information.h"
+#include "gupnp-dlna-video-information.h"
+
+#define FIELD(name, kind, getter) { name, kind, G_CALLBACK (getter) }
+
+const GUPnPDLNAField gupnp_dlna_audio_fields[] = {
+        FIELD ("bitrate",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_audio_information_get_bitrate),
+        FIELD ("channels",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_audio_information_get_channels),
+        FIELD ("depth",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_audio_information_get_depth),
+        FIELD ("layer",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_audio_information_get_layer),
+        FIELD ("level",
+               GUPNP_DLNA_FIELD_STRING,
+               gupnp_dlna_audio_information_peek_level),
+        FIELD ("mpegaudioversion",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_audio_information_get_mpeg_audio_version),
+        FIELD ("mpegversion",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_audio_information_get_mpeg_version),
+        FIELD ("profile",
+               GUPNP_DLNA_FIELD_STRING,
+               gupnp_dlna_audio_information_peek_profile),
+        FIELD ("rate",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_audio_information_get_rate),
+        FIELD ("stream-format",
+               GUPNP_DLNA_FIELD_STRING,
+               gupnp_dlna_audio_information_peek_stream_format),
+        FIELD ("wmaversion",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_audio_information_get_wma_version),
+        { NULL, 0, NULL }
+};
+
+const GUPnPDLNAField gupnp_dlna_container_fields[] = {
+        FIELD ("mpegversion",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_container_information_get_mpeg_version),
+        FIELD ("packetsize",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_container_information_get_packet_size),
+        FIELD ("profile",
+               GUPNP_DLNA_FIELD_STRING,
+               gupnp_dlna_container_information_peek_profile),
+        FIELD ("systemstream",
+               GUPNP_DLNA_FIELD_BOOL,
+               gupnp_dlna_container_information_is_system_stream),
+        FIELD ("variant",
+               GUPNP_DLNA_FIELD_STRING,
+               gupnp_dlna_container_information_peek_variant),
+        { NULL, 0, NULL }
+};
+
+const GUPnPDLNAField gupnp_dlna_image_fields[] = {
+        FIELD ("depth",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_image_information_get_depth),
+        FIELD ("height",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_image_information_get_height),
+        FIELD ("width",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_image_information_get_width),
+        { NULL, 0, NULL }
+};
+
+const GUPnPDLNAField gupnp_dlna_video_fields[] = {
+        FIELD ("bitrate",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_video_information_get_bitrate),
+        FIELD ("framerate",
+               GUPNP_DLNA_FIELD_FRACTION,
+               gupnp_dlna_video_information_get_framerate),
+        FIELD ("height",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_video_information_get_height),
+        FIELD ("interlaced",
+               GUPNP_DLNA_FIELD_BOOL,
+               gupnp_dlna_video_information_is_interlaced),
+        FIELD ("level",
+               GUPNP_DLNA_FIELD_STRING,
+               gupnp_dlna_video_information_peek_level),
+        FIELD ("mpegversion",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_video_information_get_mpeg_version),
+        FIELD ("pixel-aspect-ratio",
+               GUPNP_DLNA_FIELD_FRACTION,
+               gupnp_dlna_video_information_get_pixel_aspect_ratio),
+        FIELD ("profile",
+               GUPNP_DLNA_FIELD_STRING,
+               gupnp_dlna_video_information_peek_profile),
+        FIELD ("systemstream",
+               GUPNP_DLNA_FIELD_BOOL,
+               gupnp_dlna_video_information_is_system_stream),
+        FIELD ("width",
+               GUPNP_DLNA_FIELD_INT,
+               gupnp_dlna_video_information_get_width),
+        { NULL, 0, NULL }
+};
+
+#undef FIELD
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GUPNP_DLNA_INFORMATION_PRIVATE_H__
+#define __GUPNP_DLNA_INFORMATION_PRIVATE_H__
+
+#include <glib-object.h>
+#include "gupnp-dlna-information.h"
+
+G_BEGIN_DECLS
+
+void
+gupnp_dlna_information_set_match_stats (GUPnPDLNAInformation *info,
+                                        gint64                time,
+                                        guint                 profiles,
+                                        guint                 restrictions,
+                                        guint                 rejection_comparisons);
+
+GUPnPDLNAInformation *
+gupnp_dlna_stored_information_new_empty (const gchar *uri);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_INFORMATION_PRIVATE_H__ */
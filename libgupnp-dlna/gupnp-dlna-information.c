@@ -30,9 +30,20 @@
  *
  * When instantiating a subclass of #GUPnPDLNAInformation make sure
  * that "uri" with a URI to media file is passed to g_object_new().
+ *
+ * The stream information getters may be called from several threads
+ * at once - each virtual function is called only once per object and
+ * its result is cached. The returned stream information objects
+ * should be safe to query concurrently too.
+ *
+ * Each information object also records how long the phases of
+ * guessing its DLNA profile took and how many profiles and
+ * restrictions were evaluated. The profile guesser and the metadata
+ * backend fill these in, see gupnp_dlna_information_get_phase_time().
  */
 
 #include "gupnp-dlna-information.h"
+#include "gupnp-dlna-information-private.h"
 
 struct _GUPnPDLNAInformationPrivate {
         gchar* uri;
@@ -44,6 +55,13 @@ struct _GUPnPDLNAInformationPrivate {
         GUPnPDLNAContainerInformation *container_info;
         GUPnPDLNAImageInformation *image_info;
         GUPnPDLNAVideoInformation *video_info;
+        gint64 phase_times[GUPNP_DLNA_GUESS_PHASE_COUNT];
+        guint profiles_evaluated;
+        guint restrictions_evaluated;
+        guint rejection_comparisons;
+        /* guards lazily initialized stream information and the guess
+         * statistics above */
+        GRecMutex lock;
 };
 typedef struct _GUPnPDLNAInformationPrivate GUPnPDLNAInformationPrivate;
 
@@ -89,6 +107,7 @@ gupnp_dlna_information_finalize (GObject *object)
                 gupnp_dlna_information_get_instance_private (info);
 
         g_free (priv->uri);
+        g_rec_mutex_clear (&priv->lock);
         G_OBJECT_CLASS (gupnp_dlna_information_parent_class)->finalize (object);
 }
 
@@ -244,6 +263,14 @@ gupnp_dlna_information_class_init (GUPnPDLNAInformationClass *info_class)
 static void
 gupnp_dlna_information_init (GUPnPDLNAInformation *info)
 {
+        GUPnPDLNAInformationPrivate *priv =
+                gupnp_dlna_information_get_instance_private (info);
+
+        guint iter;
+
+        for (iter = 0; iter < GUPNP_DLNA_GUESS_PHASE_COUNT; ++iter)
+                priv->phase_times[iter] = -1;
+        g_rec_mutex_init (&priv->lock);
 }
 
 /**
@@ -258,26 +285,29 @@ gupnp_dlna_information_init (GUPnPDLNAInformation *info)
 GUPnPDLNAAudioInformation *
 gupnp_dlna_information_get_audio_information (GUPnPDLNAInformation *info)
 {
-        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
-        GUPnPDLNAInformationPrivate *priv =
-                gupnp_dlna_information_get_instance_private (info);
+        GUPnPDLNAInformationPrivate *priv;
+        GUPnPDLNAInformationClass *info_class;
+        GUPnPDLNAAudioInformation *audio_info;
 
-        if (!priv->got_audio_info) {
-                GUPnPDLNAInformationClass *info_class;
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
 
-                info_class = GUPNP_DLNA_INFORMATION_GET_CLASS (info);
+        priv = gupnp_dlna_information_get_instance_private (info);
+        info_class = GUPNP_DLNA_INFORMATION_GET_CLASS (info);
 
-                g_return_val_if_fail
-                                  (GUPNP_DLNA_IS_INFORMATION_CLASS (info_class),
-                                   NULL);
-                g_return_val_if_fail (info_class->get_audio_information != NULL,
-                                      NULL);
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION_CLASS (info_class),
+                              NULL);
+        g_return_val_if_fail (info_class->get_audio_information != NULL,
+                              NULL);
 
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->got_audio_info) {
                 priv->audio_info = info_class->get_audio_information (info);
                 priv->got_audio_info = TRUE;
         }
+        audio_info = priv->audio_info;
+        g_rec_mutex_unlock (&priv->lock);
 
-        return priv->audio_info;
+        return audio_info;
 }
 
 /**
@@ -292,28 +322,29 @@ gupnp_dlna_information_get_audio_information (GUPnPDLNAInformation *info)
 GUPnPDLNAContainerInformation *
 gupnp_dlna_information_get_container_information (GUPnPDLNAInformation *info)
 {
-        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
-        GUPnPDLNAInformationPrivate *priv =
-                gupnp_dlna_information_get_instance_private (info);
+        GUPnPDLNAInformationPrivate *priv;
+        GUPnPDLNAInformationClass *info_class;
+        GUPnPDLNAContainerInformation *container_info;
 
-        if (!priv->got_container_info) {
-                GUPnPDLNAInformationClass *info_class;
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
 
-                info_class = GUPNP_DLNA_INFORMATION_GET_CLASS (info);
+        priv = gupnp_dlna_information_get_instance_private (info);
+        info_class = GUPNP_DLNA_INFORMATION_GET_CLASS (info);
 
-                g_return_val_if_fail
-                                  (GUPNP_DLNA_IS_INFORMATION_CLASS (info_class),
-                                   NULL);
-                g_return_val_if_fail
-                                 (info_class->get_container_information != NULL,
-                                  NULL);
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION_CLASS (info_class),
+                              NULL);
+        g_return_val_if_fail (info_class->get_container_information != NULL,
+                              NULL);
 
-                priv->container_info =
-                                   info_class->get_container_information (info);
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->got_container_info) {
+                priv->container_info = info_class->get_container_information (info);
                 priv->got_container_info = TRUE;
         }
+        container_info = priv->container_info;
+        g_rec_mutex_unlock (&priv->lock);
 
-        return priv->container_info;
+        return container_info;
 }
 
 /**
@@ -328,27 +359,29 @@ gupnp_dlna_information_get_container_information (GUPnPDLNAInformation *info)
 GUPnPDLNAImageInformation *
 gupnp_dlna_information_get_image_information (GUPnPDLNAInformation *info)
 {
-        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
-
-        GUPnPDLNAInformationPrivate *priv =
-                gupnp_dlna_information_get_instance_private (info);
+        GUPnPDLNAInformationPrivate *priv;
+        GUPnPDLNAInformationClass *info_class;
+        GUPnPDLNAImageInformation *image_info;
 
-        if (!priv->got_image_info) {
-                GUPnPDLNAInformationClass *info_class;
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
 
-                info_class = GUPNP_DLNA_INFORMATION_GET_CLASS (info);
+        priv = gupnp_dlna_information_get_instance_private (info);
+        info_class = GUPNP_DLNA_INFORMATION_GET_CLASS (info);
 
-                g_return_val_if_fail
-                                  (GUPNP_DLNA_IS_INFORMATION_CLASS (info_class),
-                                   NULL);
-                g_return_val_if_fail (info_class->get_image_information != NULL,
-                                      NULL);
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION_CLASS (info_class),
+                              NULL);
+        g_return_val_if_fail (info_class->get_image_information != NULL,
+                              NULL);
 
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->got_image_info) {
                 priv->image_info = info_class->get_image_information (info);
                 priv->got_image_info = TRUE;
         }
+        image_info = priv->image_info;
+        g_rec_mutex_unlock (&priv->lock);
 
-        return priv->image_info;
+        return image_info;
 }
 
 /**
@@ -363,27 +396,29 @@ gupnp_dlna_information_get_image_information (GUPnPDLNAInformation *info)
 GUPnPDLNAVideoInformation *
 gupnp_dlna_information_get_video_information (GUPnPDLNAInformation *info)
 {
-        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
-
-        GUPnPDLNAInformationPrivate *priv =
-                gupnp_dlna_information_get_instance_private (info);
+        GUPnPDLNAInformationPrivate *priv;
+        GUPnPDLNAInformationClass *info_class;
+        GUPnPDLNAVideoInformation *video_info;
 
-        if (!priv->got_video_info) {
-                GUPnPDLNAInformationClass *info_class;
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
 
-                info_class = GUPNP_DLNA_INFORMATION_GET_CLASS (info);
+        priv = gupnp_dlna_information_get_instance_private (info);
+        info_class = GUPNP_DLNA_INFORMATION_GET_CLASS (info);
 
-                g_return_val_if_fail
-                                  (GUPNP_DLNA_IS_INFORMATION_CLASS (info_class),
-                                   NULL);
-                g_return_val_if_fail (info_class->get_video_information != NULL,
-                                      NULL);
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION_CLASS (info_class),
+                              NULL);
+        g_return_val_if_fail (info_class->get_video_information != NULL,
+                              NULL);
 
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->got_video_info) {
                 priv->video_info = info_class->get_video_information (info);
                 priv->got_video_info = TRUE;
         }
+        video_info = priv->video_info;
+        g_rec_mutex_unlock (&priv->lock);
 
-        return priv->video_info;
+        return video_info;
 }
 
 /**
@@ -417,3 +452,147 @@ gupnp_dlna_information_get_uri (GUPnPDLNAInformation *info)
 
         return priv->uri;
 }
+
+/**
+ * gupnp_dlna_information_get_phase_time:
+ * @info: A #GUPnPDLNAInformation object.
+ * @phase: A phase of guessing.
+ *
+ * Gets the time spent in @phase while guessing a DLNA profile of
+ * @info. Times are measured with the monotonic clock.
+ *
+ * Returns: Time in microseconds or -1 if @phase was not measured.
+ */
+gint64
+gupnp_dlna_information_get_phase_time (GUPnPDLNAInformation *info,
+                                       GUPnPDLNAGuessPhase   phase)
+{
+        GUPnPDLNAInformationPrivate *priv;
+        gint64 time;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), -1);
+        g_return_val_if_fail (phase < GUPNP_DLNA_GUESS_PHASE_COUNT, -1);
+
+        priv = gupnp_dlna_information_get_instance_private (info);
+        g_rec_mutex_lock (&priv->lock);
+        time = priv->phase_times[phase];
+        g_rec_mutex_unlock (&priv->lock);
+
+        return time;
+}
+
+/**
+ * gupnp_dlna_information_set_phase_time:
+ * @info: A #GUPnPDLNAInformation object.
+ * @phase: A phase of guessing.
+ * @time: Time in microseconds.
+ *
+ * Records the time spent in @phase. This is meant to be used by
+ * metadata backends for the phases happening inside them.
+ */
+void
+gupnp_dlna_information_set_phase_time (GUPnPDLNAInformation *info,
+                                       GUPnPDLNAGuessPhase   phase,
+                                       gint64                time)
+{
+        GUPnPDLNAInformationPrivate *priv;
+
+        g_return_if_fail (GUPNP_DLNA_IS_INFORMATION (info));
+        g_return_if_fail (phase < GUPNP_DLNA_GUESS_PHASE_COUNT);
+
+        priv = gupnp_dlna_information_get_instance_private (info);
+        g_rec_mutex_lock (&priv->lock);
+        priv->phase_times[phase] = time;
+        g_rec_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gupnp_dlna_information_get_profiles_evaluated:
+ * @info: A #GUPnPDLNAInformation object.
+ *
+ * Returns: The number of DLNA profiles tried by the last profile
+ * matching of @info.
+ */
+guint
+gupnp_dlna_information_get_profiles_evaluated (GUPnPDLNAInformation *info)
+{
+        GUPnPDLNAInformationPrivate *priv;
+        guint count;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), 0);
+
+        priv = gupnp_dlna_information_get_instance_private (info);
+        g_rec_mutex_lock (&priv->lock);
+        count = priv->profiles_evaluated;
+        g_rec_mutex_unlock (&priv->lock);
+
+        return count;
+}
+
+/**
+ * gupnp_dlna_information_get_restrictions_evaluated:
+ * @info: A #GUPnPDLNAInformation object.
+ *
+ * Returns: The number of restrictions checked by the last profile
+ * matching of @info.
+ */
+guint
+gupnp_dlna_information_get_restrictions_evaluated
+                                        (GUPnPDLNAInformation *info)
+{
+        GUPnPDLNAInformationPrivate *priv;
+        guint count;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), 0);
+
+        priv = gupnp_dlna_information_get_instance_private (info);
+        g_rec_mutex_lock (&priv->lock);
+        count = priv->restrictions_evaluated;
+        g_rec_mutex_unlock (&priv->lock);
+
+        return count;
+}
+
+/**
+ * gupnp_dlna_information_get_rejection_comparisons:
+ * @info: A #GUPnPDLNAInformation object.
+ *
+ * Returns: The number of mime and field comparisons the last profile
+ * matching of @info spent on profiles that did not match.
+ */
+guint
+gupnp_dlna_information_get_rejection_comparisons
+                                        (GUPnPDLNAInformation *info)
+{
+        GUPnPDLNAInformationPrivate *priv;
+        guint count;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), 0);
+
+        priv = gupnp_dlna_information_get_instance_private (info);
+        g_rec_mutex_lock (&priv->lock);
+        count = priv->rejection_comparisons;
+        g_rec_mutex_unlock (&priv->lock);
+
+        return count;
+}
+
+void
+gupnp_dlna_information_set_match_stats (GUPnPDLNAInformation *info,
+                                        gint64                time,
+                                        guint                 profiles,
+                                        guint                 restrictions,
+                                        guint                 rejection_comparisons)
+{
+        GUPnPDLNAInformationPrivate *priv;
+
+        g_return_if_fail (GUPNP_DLNA_IS_INFORMATION (info));
+
+        priv = gupnp_dlna_information_get_instance_private (info);
+        g_rec_mutex_lock (&priv->lock);
+        priv->phase_times[GUPNP_DLNA_GUESS_PHASE_PROFILE_MATCHING] = time;
+        priv->profiles_evaluated = profiles;
+        priv->restrictions_evaluated = restrictions;
+        priv->rejection_comparisons = rejection_comparisons;
+        g_rec_mutex_unlock (&priv->lock);
+}
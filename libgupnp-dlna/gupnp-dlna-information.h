@@ -30,6 +30,34 @@
 
 G_BEGIN_DECLS
 
+/**
+ * GUPnPDLNAGuessPhase:
+ * @GUPNP_DLNA_GUESS_PHASE_BACKEND_LOADING: Loading the metadata
+ * backend module. Only the first guess in a process spends time here.
+ * @GUPNP_DLNA_GUESS_PHASE_EXTRACTOR_CREATION: Creating the metadata
+ * extractor.
+ * @GUPNP_DLNA_GUESS_PHASE_DISCOVERER_CREATION: Creating the
+ * backend's own discovery machinery, like a #GstDiscoverer.
+ * @GUPNP_DLNA_GUESS_PHASE_PREROLL: Reading the media file until its
+ * metadata is known.
+ * @GUPNP_DLNA_GUESS_PHASE_INFORMATION_WRAPPING: Wrapping the
+ * backend's metadata into a #GUPnPDLNAInformation.
+ * @GUPNP_DLNA_GUESS_PHASE_PROFILE_MATCHING: Matching the metadata
+ * against DLNA profiles.
+ * @GUPNP_DLNA_GUESS_PHASE_COUNT: Number of phases. Not a phase.
+ *
+ * Phases of guessing a DLNA profile of a media file.
+ */
+typedef enum {
+        GUPNP_DLNA_GUESS_PHASE_BACKEND_LOADING,
+        GUPNP_DLNA_GUESS_PHASE_EXTRACTOR_CREATION,
+        GUPNP_DLNA_GUESS_PHASE_DISCOVERER_CREATION,
+        GUPNP_DLNA_GUESS_PHASE_PREROLL,
+        GUPNP_DLNA_GUESS_PHASE_INFORMATION_WRAPPING,
+        GUPNP_DLNA_GUESS_PHASE_PROFILE_MATCHING,
+        GUPNP_DLNA_GUESS_PHASE_COUNT
+} GUPnPDLNAGuessPhase;
+
 G_DECLARE_DERIVABLE_TYPE (GUPnPDLNAInformation,
                           gupnp_dlna_information,
                           GUPNP_DLNA,
@@ -102,6 +130,35 @@ gupnp_dlna_information_get_profile_name (GUPnPDLNAInformation *info);
 const gchar *
 gupnp_dlna_information_get_uri (GUPnPDLNAInformation *info);
 
+gint64
+gupnp_dlna_information_get_phase_time (GUPnPDLNAInformation *info,
+                                       GUPnPDLNAGuessPhase   phase);
+
+void
+gupnp_dlna_information_set_phase_time (GUPnPDLNAInformation *info,
+                                       GUPnPDLNAGuessPhase   phase,
+                                       gint64                time);
+
+guint
+gupnp_dlna_information_get_profiles_evaluated (GUPnPDLNAInformation *info);
+
+guint
+gupnp_dlna_information_get_restrictions_evaluated
+                                        (GUPnPDLNAInformation *info);
+
+guint
+gupnp_dlna_information_get_rejection_comparisons
+                                        (GUPnPDLNAInformation *info);
+
+GBytes *
+gupnp_dlna_information_serialize (GUPnPDLNAInformation *info,
+                                  const gchar          *profile_name);
+
+GUPnPDLNAInformation *
+gupnp_dlna_information_deserialize (GBytes  *bytes,
+                                    gchar  **profile_name,
+                                    GError **error);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_INFORMATION_H__ */
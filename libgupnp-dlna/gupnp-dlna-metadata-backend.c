@@ -34,11 +34,12 @@ struct {
 } metadata_backend;
 
 static gboolean
-load_metadata_backend (void)
+load_metadata_backend (gint64 *load_time)
 {
         static gsize backend_chosen = 0;
 
         if (g_once_init_enter (&backend_chosen)) {
+                gint64 start = g_get_monotonic_time ();
                 gchar **environment = g_get_environ ();
                 const gchar *backend =
                                g_environ_getenv (environment,
@@ -92,16 +93,27 @@ load_metadata_backend (void)
                 if (module)
                         g_module_close (module);
                 g_strfreev (environment);
+                if (load_time)
+                        *load_time = g_get_monotonic_time () - start;
                 g_once_init_leave (&backend_chosen, loaded);
         }
 
+        /* backend_chosen and metadata_backend are not written after
+         * g_once_init_leave(), which also publishes them to other
+         * threads, so reading them here is safe. */
         return (backend_chosen == 2);
 }
 
+/* @load_time, if not NULL, gets the time spent on loading the
+ * backend module, which is 0 for all calls but the first one. */
 GUPnPDLNAMetadataExtractor *
-gupnp_dlna_metadata_backend_get_extractor (void)
+gupnp_dlna_metadata_backend_get_extractor (gint64 *load_time)
 {
-        gboolean metadata_backend_loaded = load_metadata_backend ();
+        gboolean metadata_backend_loaded;
+
+        if (load_time)
+                *load_time = 0;
+        metadata_backend_loaded = load_metadata_backend (load_time);
 
         g_return_val_if_fail (metadata_backend_loaded == TRUE, NULL);
 
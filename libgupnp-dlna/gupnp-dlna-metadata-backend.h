@@ -28,7 +28,7 @@
 G_BEGIN_DECLS
 
 GUPnPDLNAMetadataExtractor *
-gupnp_dlna_metadata_backend_get_extractor (void);
+gupnp_dlna_metadata_backend_get_extractor (gint64 *load_time);
 
 G_END_DECLS
 
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GUPNP_DLNA_PROFILE_CHANGES_PRIVATE_H__
+#define __GUPNP_DLNA_PROFILE_CHANGES_PRIVATE_H__
+
+#include "gupnp-dlna-profile-changes.h"
+#include "gupnp-dlna-profile-db.h"
+
+G_BEGIN_DECLS
+
+GUPnPDLNAProfileChanges *
+gupnp_dlna_profile_changes_new (GUPnPDLNAProfileDB *db,
+                                gchar             **old_digests);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_PROFILE_CHANGES_PRIVATE_H__ */
@@ -0,0 +1,314 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "gupnp-dlna-profile-changes-private.h"
+#include "gupnp-dlna-profile-guesser-impl.h"
+#include "gupnp-dlna-profile-private.h"
+
+/**
+ * SECTION:gupnp-dlna-profile-changes
+ * @short_description: Guesses affected by a change of the DLNA
+ * profiles.
+ *
+ * #GUPnPDLNAProfileChanges compares the DLNA profiles of a guesser
+ * with profiles saved earlier with
+ * gupnp_dlna_profile_guesser_save_digests(), see
+ * gupnp_dlna_profile_guesser_get_changes(). It tells which results of
+ * guesses done with the earlier profiles may be different now, so
+ * only those need to be guessed again.
+ *
+ * A guess returns the first matching profile, so its result can only
+ * change if its profile changed, or if a new or changed profile,
+ * which is tried before it, matches the media. Profiles which can
+ * never match the same media as the guessed one are not taken into
+ * account. When the information of the media is available, the new
+ * and changed profiles are checked against it, which is cheap.
+ */
+
+struct _GUPnPDLNAProfileChanges {
+        GUPnPDLNAProfileDB *db;
+        GUPnPDLNAProfile  **profiles;
+        guint               count;
+        gchar             **old_strv;
+        /* index of each profile among the old profiles or -1 for new
+         * and changed ones */
+        gint               *old_indices;
+        GHashTable         *old_digests; /* <digest, index + 1> */
+        GHashTable         *new_digests; /* <digest, index + 1> */
+        guint               changed_count;
+        guint               removed_count;
+        gint                ref_count;
+};
+
+G_DEFINE_BOXED_TYPE (GUPnPDLNAProfileChanges,
+                     gupnp_dlna_profile_changes,
+                     gupnp_dlna_profile_changes_ref,
+                     gupnp_dlna_profile_changes_unref)
+
+/* Profiles with the same digest cannot be told apart, but they also
+ * match the same media, so only the first one is ever guessed. */
+static void
+index_digest (GHashTable  *indices,
+              const gchar *digest,
+              guint        index)
+{
+        if (digest != NULL && !g_hash_table_contains (indices, digest))
+                g_hash_table_insert (indices,
+                                     (gpointer) digest,
+                                     GUINT_TO_POINTER (index + 1));
+}
+
+/* @old_digests are the digests of the old profiles in their order. */
+GUPnPDLNAProfileChanges *
+gupnp_dlna_profile_changes_new (GUPnPDLNAProfileDB *db,
+                                gchar             **old_digests)
+{
+        GUPnPDLNAProfileChanges *changes;
+        GList *iter;
+        guint index;
+
+        g_return_val_if_fail (old_digests != NULL, NULL);
+
+        changes = g_slice_new0 (GUPnPDLNAProfileChanges);
+        changes->ref_count = 1;
+        changes->old_strv = g_strdupv (old_digests);
+        changes->old_digests = g_hash_table_new (g_str_hash, g_str_equal);
+        changes->new_digests = g_hash_table_new (g_str_hash, g_str_equal);
+        for (index = 0; changes->old_strv[index] != NULL; ++index)
+                index_digest (changes->old_digests,
+                              changes->old_strv[index],
+                              index);
+
+        if (db != NULL) {
+                changes->db = gupnp_dlna_profile_db_ref (db);
+                changes->count = g_list_length
+                                   (gupnp_dlna_profile_db_get_profiles (db));
+        }
+        changes->profiles = g_new (GUPnPDLNAProfile *, changes->count);
+        changes->old_indices = g_new (gint, changes->count);
+        index = 0;
+        for (iter = (db != NULL ? gupnp_dlna_profile_db_get_profiles (db) :
+                                  NULL);
+             iter != NULL;
+             iter = iter->next, ++index) {
+                const gchar *digest = gupnp_dlna_profile_get_digest
+                                        (iter->data);
+                guint old_index = GPOINTER_TO_UINT (g_hash_table_lookup
+                                        (changes->old_digests,
+                                         digest));
+
+                changes->profiles[index] = iter->data;
+                changes->old_indices[index] = (gint) old_index - 1;
+                if (old_index == 0)
+                        ++changes->changed_count;
+                index_digest (changes->new_digests, digest, index);
+        }
+        for (index = 0; old_digests[index] != NULL; ++index)
+                if (!g_hash_table_contains (changes->new_digests,
+                                            old_digests[index]))
+                        ++changes->removed_count;
+
+        return changes;
+}
+
+/**
+ * gupnp_dlna_profile_changes_ref:
+ * @changes: A #GUPnPDLNAProfileChanges.
+ *
+ * Returns: (transfer full): @changes.
+ */
+GUPnPDLNAProfileChanges *
+gupnp_dlna_profile_changes_ref (GUPnPDLNAProfileChanges *changes)
+{
+        g_return_val_if_fail (changes != NULL, NULL);
+
+        g_atomic_int_inc (&changes->ref_count);
+
+        return changes;
+}
+
+/**
+ * gupnp_dlna_profile_changes_unref:
+ * @changes: A #GUPnPDLNAProfileChanges.
+ *
+ * Releases a reference to @changes.
+ */
+void
+gupnp_dlna_profile_changes_unref (GUPnPDLNAProfileChanges *changes)
+{
+        if (changes == NULL ||
+            !g_atomic_int_dec_and_test (&changes->ref_count))
+                return;
+
+        g_hash_table_unref (changes->new_digests);
+        g_hash_table_unref (changes->old_digests);
+        g_strfreev (changes->old_strv);
+        g_free (changes->old_indices);
+        g_free (changes->profiles);
+        gupnp_dlna_profile_db_unref (changes->db);
+        g_slice_free (GUPnPDLNAProfileChanges, changes);
+}
+
+/**
+ * gupnp_dlna_profile_changes_get_changed_count:
+ * @changes: A #GUPnPDLNAProfileChanges.
+ *
+ * Returns: A number of profiles which were added or changed.
+ */
+guint
+gupnp_dlna_profile_changes_get_changed_count
+                                        (GUPnPDLNAProfileChanges *changes)
+{
+        g_return_val_if_fail (changes != NULL, 0);
+
+        return changes->changed_count;
+}
+
+/**
+ * gupnp_dlna_profile_changes_get_removed_count:
+ * @changes: A #GUPnPDLNAProfileChanges.
+ *
+ * Returns: A number of old profiles which were removed or changed.
+ */
+guint
+gupnp_dlna_profile_changes_get_removed_count
+                                        (GUPnPDLNAProfileChanges *changes)
+{
+        g_return_val_if_fail (changes != NULL, 0);
+
+        return changes->removed_count;
+}
+
+static gboolean
+backend_profile_changed (GUPnPDLNAProfileChanges *changes,
+                         const gchar             *digest,
+                         const gchar             *profile_name)
+{
+        guint index;
+
+        /* the guess takes the first profile of this name, see
+         * guess_profile_from_info() */
+        for (index = 0; index < changes->count; ++index) {
+                GUPnPDLNAProfile *profile = changes->profiles[index];
+
+                if (!g_ascii_strcasecmp (gupnp_dlna_profile_get_name
+                                        (profile),
+                                         profile_name))
+                        return g_strcmp0 (gupnp_dlna_profile_get_digest
+                                        (profile),
+                                          digest) != 0;
+        }
+
+        return TRUE;
+}
+
+/**
+ * gupnp_dlna_profile_changes_affects:
+ * @changes: A #GUPnPDLNAProfileChanges.
+ * @digest: (allow-none): The digest of the profile guessed with the
+ * old profiles, see gupnp_dlna_profile_get_digest(), or %NULL if no
+ * profile matched.
+ * @info: (allow-none): The information the guess was done with or
+ * %NULL if it is not available.
+ *
+ * Finds out whether guessing the profile again could give a
+ * different result than the one guessed with the old profiles. Given
+ * @info, the answer is exact, otherwise it errs on the side of
+ * guessing again. This function can be called from several threads at
+ * once.
+ *
+ * Returns: %TRUE if the profile should be guessed again, %FALSE if
+ * the result would be the same.
+ */
+gboolean
+gupnp_dlna_profile_changes_affects (GUPnPDLNAProfileChanges *changes,
+                                    const gchar             *digest,
+                                    GUPnPDLNAInformation    *info)
+{
+        GUPnPDLNAGuessCounts counts = { 0, 0, FALSE, 0, 0 };
+        GList *candidates = NULL;
+        guint old_index;
+        guint new_index;
+        guint index;
+        gboolean affected;
+
+        g_return_val_if_fail (changes != NULL, TRUE);
+        g_return_val_if_fail (info == NULL || GUPNP_DLNA_IS_INFORMATION (info),
+                              TRUE);
+
+        if (info != NULL &&
+            gupnp_dlna_information_get_profile_name (info) != NULL)
+                return backend_profile_changed
+                                (changes,
+                                 digest,
+                                 gupnp_dlna_information_get_profile_name
+                                        (info));
+
+        if (digest != NULL) {
+                old_index = GPOINTER_TO_UINT (g_hash_table_lookup
+                                        (changes->old_digests,
+                                         digest));
+                new_index = GPOINTER_TO_UINT (g_hash_table_lookup
+                                        (changes->new_digests,
+                                         digest));
+                /* the profile itself changed or is unknown */
+                if (old_index-- == 0 || new_index-- == 0)
+                        return TRUE;
+        } else {
+                /* every profile is tried before giving up */
+                old_index = 0;
+                new_index = changes->count;
+        }
+
+        /* Profiles tried before the guessed one which were not tried
+         * before it with the old profiles. With no match, the old
+         * profiles did not match, so only new ones count. */
+        for (index = new_index; index-- > 0;) {
+                gint previous = changes->old_indices[index];
+
+                if (previous >= 0 &&
+                    (digest == NULL || (guint) previous < old_index))
+                        continue;
+                /* computed on the profiles themselves, an analysis
+                 * read from disk may predate the change */
+                if (digest != NULL &&
+                    !gupnp_dlna_profile_may_overlap
+                                        (changes->profiles[index],
+                                         changes->profiles[new_index]))
+                        continue;
+                candidates = g_list_prepend (candidates,
+                                             changes->profiles[index]);
+        }
+
+        if (candidates == NULL)
+                affected = FALSE;
+        else if (info == NULL)
+                affected = TRUE;
+        else
+                affected = (gupnp_dlna_profile_guesser_impl_guess_profile
+                                        (info,
+                                         candidates,
+                                         NULL,
+                                         &counts) != NULL);
+        g_list_free (candidates);
+
+        return affected;
+}
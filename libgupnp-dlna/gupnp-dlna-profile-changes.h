@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GUPNP_DLNA_PROFILE_CHANGES_H__
+#define __GUPNP_DLNA_PROFILE_CHANGES_H__
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <libgupnp-dlna/gupnp-dlna-information.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GUPnPDLNAProfileChanges GUPnPDLNAProfileChanges;
+
+/**
+ * GUPNP_TYPE_DLNA_PROFILE_CHANGES:
+ *
+ * The #GType for #GUPnPDLNAProfileChanges.
+ */
+#define GUPNP_TYPE_DLNA_PROFILE_CHANGES \
+        (gupnp_dlna_profile_changes_get_type ())
+
+GType
+gupnp_dlna_profile_changes_get_type (void) G_GNUC_CONST;
+
+GUPnPDLNAProfileChanges *
+gupnp_dlna_profile_changes_ref (GUPnPDLNAProfileChanges *changes);
+
+void
+gupnp_dlna_profile_changes_unref (GUPnPDLNAProfileChanges *changes);
+
+guint
+gupnp_dlna_profile_changes_get_changed_count
+                                        (GUPnPDLNAProfileChanges *changes);
+
+guint
+gupnp_dlna_profile_changes_get_removed_count
+                                        (GUPnPDLNAProfileChanges *changes);
+
+gboolean
+gupnp_dlna_profile_changes_affects (GUPnPDLNAProfileChanges *changes,
+                                    const gchar             *digest,
+                                    GUPnPDLNAInformation    *info);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_PROFILE_CHANGES_H__ */
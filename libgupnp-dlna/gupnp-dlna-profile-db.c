@@ -0,0 +1,563 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <string.h>
+
+#include "gupnp-dlna-profile-db.h"
+#include "gupnp-dlna-profile-loader.h"
+#include "gupnp-dlna-profile-private.h"
+#include "gupnp-dlna-restriction-private.h"
+#include "gupnp-dlna-arena.h"
+
+/* A set of profiles loaded for one relaxed/extended mode
+ * combination. Restrictions, value lists and values of all the
+ * profiles are allocated in a single arena, so tearing the database
+ * down does not have to walk and free them one by one. Every profile
+ * holds a reference to the arena, so profiles still referenced
+ * elsewhere stay valid after the database is gone.
+ *
+ * Guessing returns the first matching profile, so profiles may be
+ * tried in another order only if every two of them that may match the
+ * same media keep their relative order. Which ones may do that is
+ * worked out once, when the profiles are loaded.
+ */
+struct _GUPnPDLNAProfileDB {
+        gboolean           relaxed_mode;
+        gboolean           extended_mode;
+        GList             *profiles; /* <GUPnPDLNAProfile *> */
+        GUPnPDLNAProfile **profile_array;
+        guint              count;
+        /* count x count, overlaps[i * count + j] is TRUE if profiles i
+         * and j may match the same media */
+        gboolean          *overlaps;
+        GUPnPDLNAArena    *arena;
+        gint               ref_count;
+};
+
+static void
+compute_overlaps (GUPnPDLNAProfileDB *db)
+{
+        guint i;
+        guint j;
+        guint overlapping = 0;
+
+        for (i = 0; i < db->count; ++i) {
+                db->overlaps[i * db->count + i] = TRUE;
+                for (j = i + 1; j < db->count; ++j) {
+                        gboolean overlap = gupnp_dlna_profile_may_overlap
+                                        (db->profile_array[i],
+                                         db->profile_array[j]);
+
+                        db->overlaps[i * db->count + j] = overlap;
+                        db->overlaps[j * db->count + i] = overlap;
+                        if (overlap)
+                                ++overlapping;
+                }
+        }
+
+        g_debug ("%u pairs of %u profiles may match the same media",
+                 overlapping,
+                 db->count);
+}
+
+static const gchar *
+get_analysis_group (gboolean relaxed_mode,
+                    gboolean extended_mode)
+{
+        if (relaxed_mode && extended_mode)
+                return "relaxed+extended";
+        else if (relaxed_mode)
+                return "relaxed";
+        else if (extended_mode)
+                return "extended";
+        else
+                return "strict";
+}
+
+/* The digests of the analysed profiles are kept in a group of their
+ * own, so the profile names cannot clash with other keys. */
+static gchar *
+get_digest_group (gboolean relaxed_mode,
+                  gboolean extended_mode)
+{
+        return g_strconcat (get_analysis_group (relaxed_mode, extended_mode),
+                            " digests",
+                            NULL);
+}
+
+/* Profiles are identified in the analysis by their names. Profiles
+ * sharing a name come from the same file, so they are always loaded
+ * in the same order and the second one gets "@2" appended to its
+ * name, the third one "@3" and so on. */
+static gchar **
+get_profile_ids (GUPnPDLNAProfileDB *db)
+{
+        GHashTable *seen = g_hash_table_new (g_str_hash, g_str_equal);
+        gchar **ids = g_new0 (gchar *, db->count + 1);
+        guint i;
+
+        for (i = 0; i < db->count; ++i) {
+                const gchar *name =
+                             gupnp_dlna_profile_get_name (db->profile_array[i]);
+                guint occurrence = GPOINTER_TO_UINT (g_hash_table_lookup
+                                        (seen,
+                                         name)) + 1;
+
+                g_hash_table_insert (seen,
+                                     (gpointer) name,
+                                     GUINT_TO_POINTER (occurrence));
+                if (occurrence == 1)
+                        ids[i] = g_strdup (name);
+                else
+                        ids[i] = g_strdup_printf ("%s@%u", name, occurrence);
+        }
+        g_hash_table_unref (seen);
+
+        return ids;
+}
+
+/* The analysis holds a key for each profile, listing the profiles it
+ * may overlap with, and the digest of each profile. It is used only if
+ * it describes exactly the loaded profiles, otherwise the overlaps are
+ * computed again. Comparing the digests catches profiles whose
+ * restrictions were edited after the analysis was written. */
+static gboolean
+digests_match (GUPnPDLNAProfileDB *db,
+               GKeyFile           *analysis,
+               gchar             **ids)
+{
+        gchar *group = get_digest_group (db->relaxed_mode, db->extended_mode);
+        gboolean match = TRUE;
+        guint i;
+
+        for (i = 0; match && i < db->count; ++i) {
+                gchar *digest = g_key_file_get_string (analysis,
+                                                       group,
+                                                       ids[i],
+                                                       NULL);
+
+                match = (digest != NULL &&
+                         !g_strcmp0 (digest,
+                                     gupnp_dlna_profile_get_digest
+                                        (db->profile_array[i])));
+                g_free (digest);
+        }
+        g_free (group);
+
+        return match;
+}
+
+static gboolean
+read_overlaps (GUPnPDLNAProfileDB *db,
+               GKeyFile           *analysis)
+{
+        const gchar *group = get_analysis_group (db->relaxed_mode,
+                                                 db->extended_mode);
+        gchar **ids = get_profile_ids (db);
+        GHashTable *indices = g_hash_table_new (g_str_hash, g_str_equal);
+        gchar **keys;
+        gsize key_count = 0;
+        gboolean valid;
+        guint i;
+
+        for (i = 0; i < db->count; ++i)
+                g_hash_table_insert (indices,
+                                     ids[i],
+                                     GUINT_TO_POINTER (i + 1));
+
+        keys = g_key_file_get_keys (analysis, group, &key_count, NULL);
+        valid = (keys != NULL &&
+                 key_count == db->count &&
+                 digests_match (db, analysis, ids));
+        for (i = 0; valid && i < db->count; ++i) {
+                gchar **overlapping;
+                gsize length;
+                guint index = GPOINTER_TO_UINT (g_hash_table_lookup
+                                        (indices,
+                                         keys[i]));
+                guint iter;
+
+                if (index-- == 0) {
+                        valid = FALSE;
+
+                        break;
+                }
+                db->overlaps[index * db->count + index] = TRUE;
+                overlapping = g_key_file_get_string_list (analysis,
+                                                          group,
+                                                          keys[i],
+                                                          &length,
+                                                          NULL);
+                for (iter = 0; valid && iter < length; ++iter) {
+                        guint other = GPOINTER_TO_UINT (g_hash_table_lookup
+                                        (indices,
+                                         overlapping[iter]));
+
+                        if (other-- == 0) {
+                                valid = FALSE;
+
+                                break;
+                        }
+                        db->overlaps[index * db->count + other] = TRUE;
+                        db->overlaps[other * db->count + index] = TRUE;
+                }
+                g_strfreev (overlapping);
+        }
+
+        if (!valid) {
+                g_debug ("Profile analysis for %s mode is missing or stale.",
+                         group);
+                memset (db->overlaps,
+                        0,
+                        sizeof (gboolean) * db->count * db->count);
+        }
+
+        g_strfreev (keys);
+        g_hash_table_unref (indices);
+        g_strfreev (ids);
+
+        return valid;
+}
+
+static void
+order_restriction_fields (GList *restrictions)
+{
+        GList *iter;
+
+        for (iter = restrictions; iter != NULL; iter = iter->next)
+                if (iter->data != NULL)
+                        gupnp_dlna_restriction_order_fields (iter->data);
+}
+
+/* Restrictions are complete once loaded, so their fields are ordered
+ * here, before any guess can read them from another thread. */
+static void
+order_fields (GUPnPDLNAProfileDB *db)
+{
+        guint index;
+
+        for (index = 0; index < db->count; ++index) {
+                GUPnPDLNAProfile *profile = db->profile_array[index];
+
+                order_restriction_fields
+                        (gupnp_dlna_profile_get_audio_restrictions (profile));
+                order_restriction_fields
+                        (gupnp_dlna_profile_get_container_restrictions
+                                        (profile));
+                order_restriction_fields
+                        (gupnp_dlna_profile_get_image_restrictions (profile));
+                order_restriction_fields
+                        (gupnp_dlna_profile_get_video_restrictions (profile));
+        }
+}
+
+/* Unless @read_analysis is %FALSE, overlaps of the profiles are
+ * taken from the analysis in the profile directory if it is up to
+ * date. */
+GUPnPDLNAProfileDB *
+gupnp_dlna_profile_db_new_full (gboolean relaxed_mode,
+                                gboolean extended_mode,
+                                gboolean read_analysis)
+{
+        GUPnPDLNAProfileDB *db = g_slice_new (GUPnPDLNAProfileDB);
+        GUPnPDLNAProfileLoader *loader = gupnp_dlna_profile_loader_new
+                                        (relaxed_mode,
+                                         extended_mode);
+        GKeyFile *analysis = NULL;
+        GList *iter;
+        guint index = 0;
+
+        db->relaxed_mode = relaxed_mode;
+        db->extended_mode = extended_mode;
+        db->arena = gupnp_dlna_arena_new (0);
+        db->ref_count = 1;
+        gupnp_dlna_profile_loader_set_arena (loader, db->arena);
+        db->profiles = gupnp_dlna_profile_loader_get_from_disk (loader);
+        if (read_analysis)
+                analysis = gupnp_dlna_profile_loader_load_analysis (loader);
+        g_object_unref (loader);
+
+        db->count = g_list_length (db->profiles);
+        db->profile_array = g_new (GUPnPDLNAProfile *, db->count);
+        db->overlaps = g_new0 (gboolean, db->count * db->count);
+        for (iter = db->profiles; iter != NULL; iter = iter->next)
+                db->profile_array[index++] = iter->data;
+        order_fields (db);
+        if (analysis == NULL || !read_overlaps (db, analysis))
+                compute_overlaps (db);
+        if (analysis != NULL)
+                g_key_file_unref (analysis);
+
+        g_debug ("Profile database (relaxed: %d, extended: %d) uses %"
+                 G_GSIZE_FORMAT " bytes for %u profiles",
+                 relaxed_mode,
+                 extended_mode,
+                 gupnp_dlna_arena_get_size (db->arena),
+                 g_list_length (db->profiles));
+
+        return db;
+}
+
+GUPnPDLNAProfileDB *
+gupnp_dlna_profile_db_new (gboolean relaxed_mode,
+                           gboolean extended_mode)
+{
+        return gupnp_dlna_profile_db_new_full (relaxed_mode,
+                                               extended_mode,
+                                               TRUE);
+}
+
+GUPnPDLNAProfileDB *
+gupnp_dlna_profile_db_ref (GUPnPDLNAProfileDB *db)
+{
+        g_return_val_if_fail (db != NULL, NULL);
+
+        g_atomic_int_inc (&db->ref_count);
+
+        return db;
+}
+
+void
+gupnp_dlna_profile_db_unref (GUPnPDLNAProfileDB *db)
+{
+        if (db == NULL)
+                return;
+        if (!g_atomic_int_dec_and_test (&db->ref_count))
+                return;
+
+        /* the arena goes with the last profile using it */
+        g_list_free_full (db->profiles, g_object_unref);
+        g_free (db->profile_array);
+        g_free (db->overlaps);
+        gupnp_dlna_arena_unref (db->arena);
+        g_slice_free (GUPnPDLNAProfileDB, db);
+}
+
+GList *
+gupnp_dlna_profile_db_get_profiles (GUPnPDLNAProfileDB *db)
+{
+        g_return_val_if_fail (db != NULL, NULL);
+
+        return db->profiles;
+}
+
+/* Only the arena is counted, restriction entry tables live on the
+ * heap. */
+gsize
+gupnp_dlna_profile_db_get_memory_usage (GUPnPDLNAProfileDB *db)
+{
+        g_return_val_if_fail (db != NULL, 0);
+
+        return gupnp_dlna_arena_get_size (db->arena);
+}
+
+/* Returns TRUE if profiles at @index and @other_index of the profile
+ * list may match the same media. */
+gboolean
+gupnp_dlna_profile_db_may_overlap (GUPnPDLNAProfileDB *db,
+                                   guint               index,
+                                   guint               other_index)
+{
+        g_return_val_if_fail (db != NULL, TRUE);
+        g_return_val_if_fail (index < db->count, TRUE);
+        g_return_val_if_fail (other_index < db->count, TRUE);
+
+        return db->overlaps[index * db->count + other_index];
+}
+
+/* Orders the profiles so the ones with most @hits (indexed like the
+ * profile list) come first, without changing which profile a guess
+ * returns. Among the profiles whose all overlapping predecessors
+ * are already placed the one with most hits is taken next, the
+ * earlier one on a tie.
+ *
+ * Returns: A new list, free it with g_list_free().
+ */
+GList *
+gupnp_dlna_profile_db_order_by_hits (GUPnPDLNAProfileDB *db,
+                                     const gint         *hits)
+{
+        guint *blockers;
+        gboolean *placed;
+        GList *ordered = NULL;
+        guint step;
+        guint i;
+        guint j;
+
+        g_return_val_if_fail (db != NULL, NULL);
+        g_return_val_if_fail (hits != NULL, NULL);
+
+        /* blockers[i] is the number of unplaced earlier profiles
+         * overlapping with profile i */
+        blockers = g_new0 (guint, db->count);
+        placed = g_new0 (gboolean, db->count);
+        for (i = 0; i < db->count; ++i)
+                for (j = 0; j < i; ++j)
+                        if (db->overlaps[i * db->count + j])
+                                ++blockers[i];
+
+        for (step = 0; step < db->count; ++step) {
+                guint best = db->count;
+
+                for (i = 0; i < db->count; ++i)
+                        if (!placed[i] &&
+                            blockers[i] == 0 &&
+                            (best == db->count ||
+                             g_atomic_int_get (&hits[i]) >
+                             g_atomic_int_get (&hits[best])))
+                                best = i;
+
+                /* the first unplaced profile is never blocked */
+                g_assert (best < db->count);
+                placed[best] = TRUE;
+                ordered = g_list_prepend (ordered, db->profile_array[best]);
+                for (j = best + 1; j < db->count; ++j)
+                        if (db->overlaps[best * db->count + j])
+                                --blockers[j];
+        }
+
+        g_free (blockers);
+        g_free (placed);
+
+        return g_list_reverse (ordered);
+}
+
+/* Returns TRUE and sets @index of the earliest profile that matches
+ * every media the profile at @index matches, so the latter is never
+ * returned by a guess. */
+gboolean
+gupnp_dlna_profile_db_is_shadowed (GUPnPDLNAProfileDB *db,
+                                   guint               index,
+                                   guint              *shadowing_index)
+{
+        guint i;
+
+        g_return_val_if_fail (db != NULL, FALSE);
+        g_return_val_if_fail (index < db->count, FALSE);
+
+        for (i = 0; i < index; ++i)
+                if (db->overlaps[i * db->count + index] &&
+                    gupnp_dlna_profile_covers (db->profile_array[i],
+                                               db->profile_array[index])) {
+                        if (shadowing_index != NULL)
+                                *shadowing_index = i;
+
+                        return TRUE;
+                }
+
+        return FALSE;
+}
+
+/* Splits the profiles into groups such that profiles from different
+ * groups never match the same media.
+ *
+ * Returns: An array of group numbers, starting with 0, indexed like
+ * the profile list. Free it with g_free().
+ */
+guint *
+gupnp_dlna_profile_db_get_groups (GUPnPDLNAProfileDB *db,
+                                  guint              *group_count)
+{
+        guint *groups;
+        guint *stack;
+        guint count = 0;
+        guint i;
+
+        g_return_val_if_fail (db != NULL, NULL);
+
+        groups = g_new (guint, db->count);
+        stack = g_new (guint, db->count);
+        for (i = 0; i < db->count; ++i)
+                groups[i] = G_MAXUINT;
+
+        for (i = 0; i < db->count; ++i) {
+                guint depth = 0;
+
+                if (groups[i] != G_MAXUINT)
+                        continue;
+
+                groups[i] = count;
+                stack[depth++] = i;
+                while (depth > 0) {
+                        guint current = stack[--depth];
+                        guint j;
+
+                        for (j = 0; j < db->count; ++j)
+                                if (groups[j] == G_MAXUINT &&
+                                    db->overlaps[current * db->count + j]) {
+                                        groups[j] = count;
+                                        stack[depth++] = j;
+                                }
+                }
+                ++count;
+        }
+        g_free (stack);
+
+        if (group_count != NULL)
+                *group_count = count;
+
+        return groups;
+}
+
+/* Stores overlaps of the profiles in @analysis, so the loader can
+ * read them instead of computing them again. */
+void
+gupnp_dlna_profile_db_save_analysis (GUPnPDLNAProfileDB *db,
+                                     GKeyFile           *analysis)
+{
+        const gchar *group;
+        gchar *digest_group;
+        gchar **ids;
+        GPtrArray *overlapping;
+        guint i;
+        guint j;
+
+        g_return_if_fail (db != NULL);
+        g_return_if_fail (analysis != NULL);
+
+        group = get_analysis_group (db->relaxed_mode, db->extended_mode);
+        digest_group = get_digest_group (db->relaxed_mode, db->extended_mode);
+        ids = get_profile_ids (db);
+        overlapping = g_ptr_array_new ();
+        g_key_file_remove_group (analysis, group, NULL);
+        g_key_file_remove_group (analysis, digest_group, NULL);
+        for (i = 0; i < db->count; ++i) {
+                g_key_file_set_string (analysis,
+                                       digest_group,
+                                       ids[i],
+                                       gupnp_dlna_profile_get_digest
+                                        (db->profile_array[i]));
+                g_ptr_array_set_size (overlapping, 0);
+                for (j = 0; j < db->count; ++j)
+                        if (i != j && db->overlaps[i * db->count + j])
+                                g_ptr_array_add (overlapping, ids[j]);
+                g_key_file_set_string_list
+                                    (analysis,
+                                     group,
+                                     ids[i],
+                                     (const gchar * const *) overlapping->pdata,
+                                     overlapping->len);
+        }
+        g_ptr_array_unref (overlapping);
+        g_strfreev (ids);
+        g_free (digest_group);
+}
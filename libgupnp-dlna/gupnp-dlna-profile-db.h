@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GUPNP_DLNA_PROFILE_DB_H__
+#define __GUPNP_DLNA_PROFILE_DB_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GUPnPDLNAProfileDB GUPnPDLNAProfileDB;
+
+GUPnPDLNAProfileDB *
+gupnp_dlna_profile_db_new (gboolean relaxed_mode,
+                           gboolean extended_mode);
+
+GUPnPDLNAProfileDB *
+gupnp_dlna_profile_db_new_full (gboolean relaxed_mode,
+                                gboolean extended_mode,
+                                gboolean read_analysis);
+
+GUPnPDLNAProfileDB *
+gupnp_dlna_profile_db_ref (GUPnPDLNAProfileDB *db);
+
+void
+gupnp_dlna_profile_db_unref (GUPnPDLNAProfileDB *db);
+
+GList *
+gupnp_dlna_profile_db_get_profiles (GUPnPDLNAProfileDB *db);
+
+gsize
+gupnp_dlna_profile_db_get_memory_usage (GUPnPDLNAProfileDB *db);
+
+gboolean
+gupnp_dlna_profile_db_may_overlap (GUPnPDLNAProfileDB *db,
+                                   guint               index,
+                                   guint               other_index);
+
+GList *
+gupnp_dlna_profile_db_order_by_hits (GUPnPDLNAProfileDB *db,
+                                     const gint         *hits);
+
+gboolean
+gupnp_dlna_profile_db_is_shadowed (GUPnPDLNAProfileDB *db,
+                                   guint               index,
+                                   guint              *shadowing_index);
+
+guint *
+gupnp_dlna_profile_db_get_groups (GUPnPDLNAProfileDB *db,
+                                  guint              *group_count);
+
+void
+gupnp_dlna_profile_db_save_analysis (GUPnPDLNAProfileDB *db,
+                                     GKeyFile           *analysis);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_PROFILE_DB_H__ */
@@ -21,6 +21,7 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <string.h>
 #include <glib.h>
 
 #include "gupnp-dlna-profile.h"
@@ -32,6 +33,61 @@
 #include "gupnp-dlna-video-information.h"
 #include "gupnp-dlna-utils.h"
 #include "gupnp-dlna-info-set.h"
+#include "gupnp-dlna-arena.h"
+#include "gupnp-dlna-information-fields-private.h"
+
+/* Size of the scratch arena holding info sets built for a single
+ * guess. It is big enough to fit audio, container and video info
+ * sets in one block. */
+#define GUESS_ARENA_BLOCK_SIZE 4096
+
+/* g_debug() formats its message even if it is dropped afterwards,
+ * so messages printed for every tried profile are guarded with this
+ * check to keep a guess from allocating per profile. */
+static gboolean
+debug_enabled (void)
+{
+#if GLIB_CHECK_VERSION (2, 68, 0)
+        return !g_log_writer_default_would_drop (G_LOG_LEVEL_DEBUG,
+                                                 G_LOG_DOMAIN);
+#else
+        return TRUE;
+#endif
+}
+
+#define GUESS_DEBUG(...)                                \
+        G_STMT_START {                                  \
+                if (debug_enabled ())                   \
+                        g_debug (__VA_ARGS__);          \
+        } G_STMT_END
+
+/* Stream information backing a lazy info set. */
+typedef struct {
+        gpointer              info;
+        const GUPnPDLNAField *fields;
+        const gchar          *type;
+} GUPnPDLNAFieldSource;
+
+/* Info sets of all streams in a media file. They are created once per
+ * guess and then matched against every profile. Only their mimes are
+ * read upfront, other fields are read from the backend when some
+ * restriction asks for them. */
+typedef struct {
+        GUPnPDLNAArena       *arena;
+        GUPnPDLNAInfoSet     *audio;
+        GUPnPDLNAInfoSet     *container;
+        GUPnPDLNAInfoSet     *image;
+        GUPnPDLNAInfoSet     *video;
+        GUPnPDLNAFieldSource  audio_source;
+        GUPnPDLNAFieldSource  container_source;
+        GUPnPDLNAFieldSource  image_source;
+        GUPnPDLNAFieldSource  video_source;
+        gboolean              has_container;
+        GUPnPDLNAGuessCounts *counts;
+} GUPnPDLNAStreamInfoSets;
+
+typedef gboolean (* CheckProfileFunc) (GUPnPDLNAStreamInfoSets *sets,
+                                       GUPnPDLNAProfile        *profile);
 
 static gboolean
 is_video_profile (GUPnPDLNAProfile *profile)
@@ -44,15 +100,33 @@ is_video_profile (GUPnPDLNAProfile *profile)
         return (container_restrictions != NULL && video_restrictions != NULL);
 }
 
+/* Fetches all the fields, so the dump shows the whole stream. */
+static void
+dump_info_set (GUPnPDLNAInfoSet     *info_set,
+               GUPnPDLNAFieldSource *source,
+               const gchar          *type)
+{
+        const GUPnPDLNAField *field;
+        gchar *stream_dump;
+
+        if (info_set == NULL || !debug_enabled ())
+                return;
+
+        for (field = source->fields; field->name != NULL; ++field)
+                gupnp_dlna_info_set_fetch (info_set, field->name);
+        stream_dump = gupnp_dlna_info_set_to_string (info_set);
+        g_debug ("%s stream: %s", type, stream_dump);
+        g_free (stream_dump);
+}
+
 static gboolean
-match_profile (GUPnPDLNAProfile *profile,
-               GUPnPDLNAInfoSet *stream_info_set,
-               GList            *profile_restrictions)
+match_profile (GUPnPDLNAProfile     *profile,
+               GUPnPDLNAInfoSet     *stream_info_set,
+               GList                *profile_restrictions,
+               GUPnPDLNAGuessCounts *counts)
 {
         const gchar *name = gupnp_dlna_profile_get_name (profile);
         GList *iter;
-        gchar *stream_dump;
-        gchar *restrictions_dump;
 
         /* Profiles with an empty name are used only for inheritance
          * and should not be matched against. */
@@ -64,23 +138,38 @@ match_profile (GUPnPDLNAProfile *profile,
                 return FALSE;
         }
 
-        stream_dump = gupnp_dlna_info_set_to_string (stream_info_set);
-        restrictions_dump = gupnp_dlna_utils_restrictions_list_to_string
+        if (stream_info_set == NULL)
+                return FALSE;
+
+        if (debug_enabled ()) {
+                gchar *restrictions_dump =
+                                  gupnp_dlna_utils_restrictions_list_to_string
                                         (profile_restrictions);
-        g_debug ("Stream: %s\nRestrictions: %s",
-                 stream_dump,
-                 restrictions_dump);
-        g_free (stream_dump);
-        g_free (restrictions_dump);
+
+                g_debug ("Restrictions: %s", restrictions_dump);
+                g_free (restrictions_dump);
+        }
 
         for (iter = profile_restrictions; iter != NULL; iter = iter->next) {
                 GUPnPDLNARestriction *restriction =
                                         GUPNP_DLNA_RESTRICTION (iter->data);
+                gboolean unsupported;
 
+                ++counts->restrictions;
                 if (restriction != NULL &&
-                    gupnp_dlna_info_set_fits_restriction (stream_info_set,
-                                                          restriction))
+                    gupnp_dlna_info_set_fits_restriction_full
+                                        (stream_info_set,
+                                         restriction,
+                                         &unsupported,
+                                         &counts->comparisons)) {
+                        if (unsupported) {
+                                GUESS_DEBUG ("Matched restriction with an "
+                                             "unsupported value.");
+                                counts->unsupported_match = TRUE;
+                        }
+
                         return TRUE;
+                }
         }
 
         return FALSE;
@@ -185,10 +274,10 @@ add_int (GUPnPDLNAInfoSet   *info_set,
 }
 
 static void
-add_string (GUPnPDLNAInfoSet     *info_set,
-            const gchar          *name,
-            GUPnPDLNAStringValue  value,
-            const gchar          *type)
+add_string (GUPnPDLNAInfoSet          *info_set,
+            const gchar               *name,
+            GUPnPDLNAConstStringValue  value,
+            const gchar               *type)
 {
         switch (value.state) {
         case GUPNP_DLNA_VALUE_STATE_SET:
@@ -200,7 +289,6 @@ add_string (GUPnPDLNAInfoSet     *info_set,
                                    name,
                                    value.value,
                                    type);
-                g_free (value.value);
 
                 break;
         case GUPNP_DLNA_VALUE_STATE_UNSET:
@@ -219,364 +307,370 @@ add_string (GUPnPDLNAInfoSet     *info_set,
         }
 }
 
+static void
+fetch_field (GUPnPDLNAInfoSet *info_set,
+             const gchar      *name,
+             gpointer          user_data)
+{
+        GUPnPDLNAFieldSource *source = user_data;
+        gpointer info = source->info;
+        const GUPnPDLNAField *field;
+
+        for (field = source->fields; field->name != NULL; ++field) {
+                if (strcmp (field->name, name))
+                        continue;
+
+                switch (field->kind) {
+                case GUPNP_DLNA_FIELD_BOOL:
+                        add_bool (info_set,
+                                  name,
+                                  ((GUPnPDLNAFieldGetBoolFunc)
+                                        field->getter) (info),
+                                  source->type);
+
+                        break;
+                case GUPNP_DLNA_FIELD_FRACTION:
+                        add_fraction (info_set,
+                                      name,
+                                      ((GUPnPDLNAFieldGetFractionFunc)
+                                        field->getter) (info),
+                                      source->type);
+
+                        break;
+                case GUPNP_DLNA_FIELD_INT:
+                        add_int (info_set,
+                                 name,
+                                 ((GUPnPDLNAFieldGetIntFunc)
+                                        field->getter) (info),
+                                 source->type);
+
+                        break;
+                case GUPNP_DLNA_FIELD_STRING:
+                        add_string (info_set,
+                                    name,
+                                    ((GUPnPDLNAFieldPeekStringFunc)
+                                        field->getter) (info),
+                                    source->type);
+
+                        break;
+                default:
+                        g_critical ("Wrong field kind (%d).", field->kind);
+                }
+
+                return;
+        }
+}
+
 static GUPnPDLNAInfoSet *
-create_info_set (GUPnPDLNAStringValue  value,
-                 const gchar          *type)
+create_info_set (GUPnPDLNAConstStringValue  value,
+                 const gchar               *type,
+                 GUPnPDLNAFieldSource      *source,
+                 GUPnPDLNAArena            *arena)
 {
-        gchar *mime;
-        gchar *lctype;
         GUPnPDLNAInfoSet *info_set;
 
         if (value.state == GUPNP_DLNA_VALUE_STATE_SET) {
-                mime = value.value;
-                lctype = g_ascii_strdown (type, -1);
+                info_set = gupnp_dlna_info_set_new_lazy (value.value,
+                                                         arena,
+                                                         fetch_field,
+                                                         source);
         } else {
+                gchar *mime = g_ascii_strdown (type, -1);
+
                 g_warning ("%s information holds no mime type, expect it"
                            "to match to no DLNA profile.",
                            type);
-                mime = g_ascii_strdown (type, -1);
-                lctype = g_strdup (mime);
+                info_set = gupnp_dlna_info_set_new_lazy (mime,
+                                                         arena,
+                                                         fetch_field,
+                                                         source);
+                g_free (mime);
         }
 
-        info_set = gupnp_dlna_info_set_new (mime);
         if (info_set == NULL)
-                g_warning ("Failed to create %s info set with mime '%s'.",
-                           lctype,
-                           mime);
-        g_free (mime);
-        g_free (lctype);
+                g_warning ("Failed to create %s info set.", type);
 
         return info_set;
 }
 
-static GUPnPDLNAInfoSet *
-info_set_from_container_information (GUPnPDLNAContainerInformation *info)
+static void
+field_source_init (GUPnPDLNAFieldSource *source,
+                   gpointer              info,
+                   const GUPnPDLNAField *fields,
+                   const gchar          *type)
 {
-        static const gchar *const type = "container";
-        GUPnPDLNAInfoSet *info_set = create_info_set
-                              (gupnp_dlna_container_information_get_mime (info),
-                               "Container");
-
-        if (info_set == NULL)
-                return NULL;
-
-        add_int (info_set,
-                 "mpegversion",
-                 gupnp_dlna_container_information_get_mpeg_version (info),
-                 type);
-
-        add_int (info_set,
-                 "packetsize",
-                 gupnp_dlna_container_information_get_packet_size (info),
-                 type);
-
-        add_string (info_set,
-                    "profile",
-                    gupnp_dlna_container_information_get_profile (info),
-                    type);
-
-        add_bool (info_set,
-                  "systemstream",
-                  gupnp_dlna_container_information_is_system_stream (info),
-                  type);
-
-        add_string (info_set,
-                    "variant",
-                    gupnp_dlna_container_information_get_variant (info),
-                    type);
-
-        return info_set;
+        source->info = info;
+        source->fields = fields;
+        source->type = type;
 }
 
 static gboolean
-check_container_profile (GUPnPDLNAInformation *info,
-                         GUPnPDLNAProfile     *profile)
+check_container_profile (GUPnPDLNAStreamInfoSets *sets,
+                         GUPnPDLNAProfile        *profile)
 {
-        GUPnPDLNAContainerInformation *container_info =
-                        gupnp_dlna_information_get_container_information (info);
         gboolean matched = FALSE;
         GList *profile_restrictions =
                  gupnp_dlna_profile_get_container_restrictions (profile);
 
-        if (profile_restrictions != NULL && container_info != NULL) {
-                GUPnPDLNAInfoSet *stream_info_set =
-                           info_set_from_container_information (container_info);
-
+        if (profile_restrictions != NULL && sets->has_container) {
                 if (match_profile (profile,
-                                   stream_info_set,
-                                   profile_restrictions))
+                                   sets->container,
+                                   profile_restrictions,
+                                   sets->counts))
                         matched = TRUE;
                 else
-                        g_debug ("Container did not match.");
-                gupnp_dlna_info_set_free (stream_info_set);
-        } else if (profile_restrictions == NULL && container_info == NULL)
+                        GUESS_DEBUG ("Container did not match.");
+        } else if (profile_restrictions == NULL && !sets->has_container)
                 matched = TRUE;
 
         return matched;
 }
 
-static GUPnPDLNAInfoSet *
-info_set_from_audio_information (GUPnPDLNAAudioInformation *info)
+static gboolean
+check_audio_profile (GUPnPDLNAStreamInfoSets *sets,
+                     GUPnPDLNAProfile        *profile)
 {
-        static const gchar *const type = "audio";
-        GUPnPDLNAInfoSet *info_set = create_info_set
-                                  (gupnp_dlna_audio_information_get_mime (info),
-                                   "Audio");
+        GList *restrictions;
 
-        if (info_set == NULL)
-                return NULL;
+        if (is_video_profile (profile))
+                return FALSE;
 
-        add_int (info_set,
-                 "bitrate",
-                 gupnp_dlna_audio_information_get_bitrate (info),
-                 type);
-
-        add_int (info_set,
-                 "channels",
-                 gupnp_dlna_audio_information_get_channels (info),
-                 type);
-
-        add_int (info_set,
-                 "depth",
-                 gupnp_dlna_audio_information_get_depth (info),
-                 type);
-
-        add_int (info_set,
-                 "layer",
-                 gupnp_dlna_audio_information_get_layer (info),
-                 type);
-
-        add_string (info_set,
-                    "level",
-                    gupnp_dlna_audio_information_get_level (info),
-                    type);
-
-        add_int (info_set,
-                 "mpegaudioversion",
-                 gupnp_dlna_audio_information_get_mpeg_audio_version (info),
-                 type);
-
-        add_int (info_set,
-                 "mpegversion",
-                 gupnp_dlna_audio_information_get_mpeg_version (info),
-                 type);
-
-        add_string (info_set,
-                    "profile",
-                    gupnp_dlna_audio_information_get_profile (info),
-                    type);
-
-        add_int (info_set,
-                 "rate",
-                 gupnp_dlna_audio_information_get_rate (info),
-                 type);
-
-        add_string (info_set,
-                    "stream-format",
-                    gupnp_dlna_audio_information_get_stream_format (info),
-                    type);
-
-        add_int (info_set,
-                 "wmaversion",
-                 gupnp_dlna_audio_information_get_wma_version (info),
-                 type);
+        /* The container is checked first - most audio profiles differ
+         * in it or in having one at all. */
+        if (!check_container_profile (sets, profile))
+                return FALSE;
 
-        return info_set;
+        restrictions = gupnp_dlna_profile_get_audio_restrictions (profile);
+        if (!match_profile (profile,
+                            sets->audio,
+                            restrictions,
+                            sets->counts)) {
+                GUESS_DEBUG ("Audio did not match.");
+
+                return FALSE;
+        }
+
+        return TRUE;
 }
 
 static gboolean
-check_audio_profile (GUPnPDLNAInformation *info,
-                     GUPnPDLNAProfile     *profile)
+check_video_profile (GUPnPDLNAStreamInfoSets *sets,
+                     GUPnPDLNAProfile        *profile)
 {
-        GUPnPDLNAInfoSet *info_set;
-        gboolean matched;
-        GUPnPDLNAAudioInformation *audio_info;
         GList *restrictions;
 
-        if (is_video_profile (profile))
+        if (sets->video == NULL || sets->audio == NULL)
                 return FALSE;
 
-        matched = FALSE;
-        audio_info = gupnp_dlna_information_get_audio_information (info);
-        info_set = info_set_from_audio_information (audio_info);
+        /* Categories go from the most selective one, so a rejected
+         * profile usually costs a single comparison. All of them have
+         * to match anyway, so the order does not change the result. */
+        if (!check_container_profile (sets, profile))
+                return FALSE;
+
+        restrictions = gupnp_dlna_profile_get_video_restrictions (profile);
+        if (!match_profile (profile,
+                            sets->video,
+                            restrictions,
+                            sets->counts)) {
+                GUESS_DEBUG ("Video did not match");
+
+                return FALSE;
+        }
+
         restrictions = gupnp_dlna_profile_get_audio_restrictions (profile);
-        if (match_profile (profile, info_set, restrictions))
-                matched = TRUE;
-        else
-                g_debug ("Audio did not match.");
-        gupnp_dlna_info_set_free (info_set);
+        if (!match_profile (profile,
+                            sets->audio,
+                            restrictions,
+                            sets->counts)) {
+                GUESS_DEBUG ("Audio did not match");
 
-        return matched;
+                return FALSE;
+        }
+
+        return TRUE;
 }
 
-static GUPnPDLNAInfoSet *
-info_set_from_video_information (GUPnPDLNAVideoInformation *info)
+static gboolean
+check_image_profile (GUPnPDLNAStreamInfoSets *sets,
+                     GUPnPDLNAProfile        *profile)
 {
-        static const gchar *const type = "video";
-        GUPnPDLNAInfoSet *info_set = create_info_set
-                                  (gupnp_dlna_video_information_get_mime (info),
-                                   "Video");
+        GList *restrictions =
+                            gupnp_dlna_profile_get_image_restrictions (profile);
 
-        if (info_set == NULL)
-                return NULL;
+        if (!match_profile (profile, sets->image, restrictions, sets->counts)) {
+                GUESS_DEBUG ("Image did not match");
 
-        add_int (info_set,
-                 "bitrate",
-                 gupnp_dlna_video_information_get_bitrate (info),
-                 type);
-
-        add_fraction (info_set,
-                      "framerate",
-                      gupnp_dlna_video_information_get_framerate (info),
-                      type);
-
-        add_int (info_set,
-                 "height",
-                 gupnp_dlna_video_information_get_height (info),
-                 type);
-
-        add_bool (info_set,
-                  "interlaced",
-                  gupnp_dlna_video_information_is_interlaced (info),
-                  type);
-
-        add_string (info_set,
-                    "level",
-                    gupnp_dlna_video_information_get_level (info),
-                    type);
-
-        add_int (info_set,
-                 "mpegversion",
-                 gupnp_dlna_video_information_get_mpeg_version (info),
-                 type);
-
-        add_fraction
-                    (info_set,
-                     "pixel-aspect-ratio",
-                     gupnp_dlna_video_information_get_pixel_aspect_ratio (info),
-                     type);
-
-        add_string (info_set,
-                    "profile",
-                    gupnp_dlna_video_information_get_profile (info),
-                    type);
-
-        add_bool (info_set,
-                  "systemstream",
-                  gupnp_dlna_video_information_is_system_stream (info),
-                  type);
-
-        add_int (info_set,
-                 "width",
-                 gupnp_dlna_video_information_get_width (info),
-                 type);
+                return FALSE;
+        }
 
-        return info_set;
+        return TRUE;
 }
 
-static gboolean
-check_video_profile (GUPnPDLNAInformation *info,
-                     GUPnPDLNAProfile     *profile)
+static void
+stream_info_sets_init (GUPnPDLNAStreamInfoSets *sets,
+                       GUPnPDLNAInformation    *info,
+                       GUPnPDLNAGuessCounts    *counts)
 {
-        GUPnPDLNAVideoInformation *video_info =
-                            gupnp_dlna_information_get_video_information (info);
         GUPnPDLNAAudioInformation *audio_info =
                             gupnp_dlna_information_get_audio_information (info);
-        GUPnPDLNAInfoSet *info_set = NULL;
-        GList *restrictions;
-        gboolean result = FALSE;
-
-        if (video_info == NULL || audio_info == NULL)
-                goto out;
+        GUPnPDLNAContainerInformation *container_info =
+                        gupnp_dlna_information_get_container_information (info);
+        GUPnPDLNAImageInformation *image_info =
+                            gupnp_dlna_information_get_image_information (info);
+        GUPnPDLNAVideoInformation *video_info =
+                            gupnp_dlna_information_get_video_information (info);
 
-        restrictions = gupnp_dlna_profile_get_video_restrictions (profile);
-        info_set = info_set_from_video_information (video_info);
-        if (!match_profile (profile, info_set, restrictions)) {
-                g_debug ("Video did not match");
+        sets->arena = gupnp_dlna_arena_new (GUESS_ARENA_BLOCK_SIZE);
+        sets->audio = NULL;
+        sets->container = NULL;
+        sets->image = NULL;
+        sets->video = NULL;
+        sets->has_container = (container_info != NULL);
+        sets->counts = counts;
+        field_source_init (&sets->audio_source,
+                           audio_info,
+                           gupnp_dlna_audio_fields,
+                           "audio");
+        field_source_init (&sets->container_source,
+                           container_info,
+                           gupnp_dlna_container_fields,
+                           "container");
+        field_source_init (&sets->image_source,
+                           image_info,
+                           gupnp_dlna_image_fields,
+                           "image");
+        field_source_init (&sets->video_source,
+                           video_info,
+                           gupnp_dlna_video_fields,
+                           "video");
+
+        if (audio_info != NULL)
+                sets->audio = create_info_set
+                                  (gupnp_dlna_audio_information_peek_mime
+                                        (audio_info),
+                                   "Audio",
+                                   &sets->audio_source,
+                                   sets->arena);
+        if (container_info != NULL)
+                sets->container = create_info_set
+                              (gupnp_dlna_container_information_peek_mime
+                                        (container_info),
+                               "Container",
+                               &sets->container_source,
+                               sets->arena);
+        if (image_info != NULL)
+                sets->image = create_info_set
+                                  (gupnp_dlna_image_information_peek_mime
+                                        (image_info),
+                                   "Image",
+                                   &sets->image_source,
+                                   sets->arena);
+        if (video_info != NULL)
+                sets->video = create_info_set
+                                  (gupnp_dlna_video_information_peek_mime
+                                        (video_info),
+                                   "Video",
+                                   &sets->video_source,
+                                   sets->arena);
+
+        dump_info_set (sets->audio, &sets->audio_source, "Audio");
+        dump_info_set (sets->container, &sets->container_source, "Container");
+        dump_info_set (sets->image, &sets->image_source, "Image");
+        dump_info_set (sets->video, &sets->video_source, "Video");
+}
 
-                goto out;
-        }
-        gupnp_dlna_info_set_free (info_set);
+static void
+stream_info_sets_clear (GUPnPDLNAStreamInfoSets *sets)
+{
+        g_clear_pointer (&sets->arena, gupnp_dlna_arena_free);
+        sets->audio = NULL;
+        sets->container = NULL;
+        sets->image = NULL;
+        sets->video = NULL;
+}
 
-        restrictions = gupnp_dlna_profile_get_audio_restrictions (profile);
-        info_set = info_set_from_audio_information (audio_info);
-        if (!match_profile (profile, info_set, restrictions)) {
-                g_debug ("Audio did not match");
+static GUPnPDLNAProfile *
+find_profile (GUPnPDLNAStreamInfoSets *sets,
+              GList                   *profiles,
+              CheckProfileFunc         check,
+              const gchar             *type)
+{
+        GUPnPDLNAGuessCounts *counts = sets->counts;
+        GList *iter;
 
-                goto out;
+        for (iter = profiles; iter != NULL; iter = iter->next) {
+                GUPnPDLNAProfile *profile = GUPNP_DLNA_PROFILE (iter->data);
+                guint comparisons;
+
+                GUESS_DEBUG ("Matching %s against profile: %s",
+                             type,
+                             gupnp_dlna_profile_get_name (profile));
+
+                ++counts->profiles;
+                counts->unsupported_match = FALSE;
+                comparisons = counts->comparisons;
+                if (check (sets, profile))
+                        return profile;
+                counts->rejected_comparisons += counts->comparisons -
+                                                comparisons;
         }
 
-        if (check_container_profile (info, profile))
-                result = TRUE;
- out:
-        gupnp_dlna_info_set_free (info_set);
-
-        return result;
+        return NULL;
 }
 
-static GUPnPDLNAInfoSet *
-info_set_from_image_information (GUPnPDLNAImageInformation *info)
+/* @reordered gives the same result as @profiles, unless an
+ * unsupported value is involved - it fits any restriction, so
+ * profiles that otherwise never match the same media might both
+ * match and only the original order gives the right one. Fields are
+ * fetched lazily, so whether there are any unsupported values is not
+ * known upfront. It does not matter as long as the matched profile
+ * did not accept one: it rejects every profile not overlapping with
+ * it and the overlapping ones keep their relative order. Otherwise
+ * the guess is redone in the original order.
+ */
+static GUPnPDLNAProfile *
+guess_profile (GUPnPDLNAStreamInfoSets *sets,
+               GList                   *profiles,
+               GList                   *reordered,
+               CheckProfileFunc         check,
+               const gchar             *type)
 {
-        static const gchar *const type = "image";
-        GUPnPDLNAInfoSet *info_set = create_info_set
-                                  (gupnp_dlna_image_information_get_mime (info),
-                                   "Image");
+        GUPnPDLNAProfile *profile;
 
-        if (info_set == NULL)
-                return NULL;
-
-        add_int (info_set,
-                 "depth",
-                 gupnp_dlna_image_information_get_depth (info),
-                 type);
-
-        add_int (info_set,
-                 "height",
-                 gupnp_dlna_image_information_get_height (info),
-                 type);
+        if (reordered == NULL)
+                return find_profile (sets, profiles, check, type);
 
-        add_int (info_set,
-                 "width",
-                 gupnp_dlna_image_information_get_width (info),
-                 type);
+        profile = find_profile (sets, reordered, check, type);
+        if (profile != NULL && sets->counts->unsupported_match) {
+                GUESS_DEBUG ("Matched with an unsupported value, trying "
+                             "profiles in the original order.");
+                profile = find_profile (sets, profiles, check, type);
+        }
 
-        return info_set;
+        return profile;
 }
 
 GUPnPDLNAProfile *
 gupnp_dlna_profile_guesser_impl_guess_image_profile
                                         (GUPnPDLNAInformation *info,
-                                         GList                *profiles)
+                                         GList                *profiles,
+                                         GList                *reordered,
+                                         GUPnPDLNAGuessCounts *counts)
 {
-        GList *iter;
-        GUPnPDLNAImageInformation *image_info =
-                            gupnp_dlna_information_get_image_information (info);
-        GUPnPDLNAInfoSet *info_set;
+        GUPnPDLNAStreamInfoSets sets;
         GUPnPDLNAProfile *found_profile;
 
-        if (!image_info)
+        if (!gupnp_dlna_information_get_image_information (info))
                 return NULL;
 
-        info_set = info_set_from_image_information (image_info);
-        found_profile = NULL;
-
-        for (iter = profiles; iter; iter = iter->next) {
-                GUPnPDLNAProfile *profile = GUPNP_DLNA_PROFILE (iter->data);
-                GList *restrictions =
-                            gupnp_dlna_profile_get_image_restrictions (profile);
-
-                g_debug ("Matching image against profile: %s",
-                         gupnp_dlna_profile_get_name (profile));
-
-                if (match_profile (profile, info_set, restrictions)) {
-                        found_profile = profile;
-
-                        break;
-                } else
-                        g_debug ("Image did not match");
-        }
-
-        gupnp_dlna_info_set_free (info_set);
+        stream_info_sets_init (&sets, info, counts);
+        found_profile = guess_profile (&sets,
+                                       profiles,
+                                       reordered,
+                                       check_image_profile,
+                                       "image");
+        stream_info_sets_clear (&sets);
 
         return found_profile;
 }
@@ -584,48 +678,157 @@ gupnp_dlna_profile_guesser_impl_guess_image_profile
 GUPnPDLNAProfile *
 gupnp_dlna_profile_guesser_impl_guess_video_profile
                                         (GUPnPDLNAInformation *info,
-                                         GList                *profiles)
+                                         GList                *profiles,
+                                         GList                *reordered,
+                                         GUPnPDLNAGuessCounts *counts)
 {
-        GUPnPDLNAProfile *found_profile = NULL;
-        GList *iter;
+        GUPnPDLNAStreamInfoSets sets;
+        GUPnPDLNAProfile *found_profile;
 
-        for (iter = profiles; iter; iter = iter->next) {
-                GUPnPDLNAProfile *profile = GUPNP_DLNA_PROFILE (iter->data);
+        stream_info_sets_init (&sets, info, counts);
+        found_profile = guess_profile (&sets,
+                                       profiles,
+                                       reordered,
+                                       check_video_profile,
+                                       "video");
+        stream_info_sets_clear (&sets);
 
-                g_debug ("Matching video against profile: %s",
-                         gupnp_dlna_profile_get_name (profile));
+        return found_profile;
+}
 
-                if (check_video_profile (info, profile)) {
-                        found_profile = profile;
+GUPnPDLNAProfile *
+gupnp_dlna_profile_guesser_impl_guess_audio_profile
+                                        (GUPnPDLNAInformation *info,
+                                         GList                *profiles,
+                                         GList                *reordered,
+                                         GUPnPDLNAGuessCounts *counts)
+{
+        GUPnPDLNAStreamInfoSets sets;
+        GUPnPDLNAProfile *found_profile;
 
-                        break;
-                }
-        }
+        stream_info_sets_init (&sets, info, counts);
+        found_profile = guess_profile (&sets,
+                                       profiles,
+                                       reordered,
+                                       check_audio_profile,
+                                       "audio");
+        stream_info_sets_clear (&sets);
 
         return found_profile;
 }
 
+/* Guesses with the function fitting the kind of media described by
+ * @info. */
 GUPnPDLNAProfile *
-gupnp_dlna_profile_guesser_impl_guess_audio_profile
+gupnp_dlna_profile_guesser_impl_guess_profile
                                         (GUPnPDLNAInformation *info,
-                                         GList                *profiles)
+                                         GList                *profiles,
+                                         GList                *reordered,
+                                         GUPnPDLNAGuessCounts *counts)
 {
-        GList *iter;
-        GUPnPDLNAProfile *found_profile = NULL;
+        if (gupnp_dlna_information_get_image_information (info) != NULL)
+                return gupnp_dlna_profile_guesser_impl_guess_image_profile
+                                        (info,
+                                         profiles,
+                                         reordered,
+                                         counts);
+        if (gupnp_dlna_information_get_video_information (info) != NULL)
+                return gupnp_dlna_profile_guesser_impl_guess_video_profile
+                                        (info,
+                                         profiles,
+                                         reordered,
+                                         counts);
+        if (gupnp_dlna_information_get_audio_information (info) != NULL)
+                return gupnp_dlna_profile_guesser_impl_guess_audio_profile
+                                        (info,
+                                         profiles,
+                                         reordered,
+                                         counts);
+
+        return NULL;
+}
 
-        for (iter = profiles; iter != NULL; iter = iter->next) {
-                GUPnPDLNAProfile *profile = GUPNP_DLNA_PROFILE (iter->data);
+/* Whether @profile can still match the media, once the rest of its
+ * streams is known. Streams in @sets are final and the container is
+ * known before any stream, see GUPnPDLNAMetadataExtractor::progress.
+ * Media with a container is taken not to be a still image. */
+static gboolean
+may_match (GUPnPDLNAStreamInfoSets *sets,
+           GUPnPDLNAProfile        *profile)
+{
+        if (gupnp_dlna_profile_get_image_restrictions (profile) != NULL) {
+                if (sets->has_container || sets->video != NULL)
+                        return FALSE;
 
-                g_debug ("Matching audio against profile: %s",
-                         gupnp_dlna_profile_get_name (profile));
+                return (sets->image == NULL ||
+                        check_image_profile (sets, profile));
+        }
 
-                if (check_audio_profile (info, profile) &&
-                    check_container_profile (info, profile)) {
-                        found_profile = profile;
+        if (!check_container_profile (sets, profile))
+                return FALSE;
+        /* an audio or image stream may still be followed by a video
+         * one, but a video stream rules out audio profiles */
+        if (sets->video != NULL &&
+            (!is_video_profile (profile) ||
+             !match_profile (profile,
+                             sets->video,
+                             gupnp_dlna_profile_get_video_restrictions
+                                        (profile),
+                             sets->counts)))
+                return FALSE;
+        if (sets->audio != NULL &&
+            !match_profile (profile,
+                            sets->audio,
+                            gupnp_dlna_profile_get_audio_restrictions
+                                        (profile),
+                            sets->counts))
+                return FALSE;
 
-                        break;
-                }
+        return TRUE;
+}
+
+/* Narrows @candidates down to the profiles which can still match
+ * media described by the partial @info. Returns a new list, keeping
+ * the order of @candidates. If the final guess is already known,
+ * @decided is set to %TRUE and the list holds only the guessed
+ * profile, or nothing. */
+GList *
+gupnp_dlna_profile_guesser_impl_narrow_candidates
+                                        (GUPnPDLNAInformation *info,
+                                         GList                *candidates,
+                                         gboolean             *decided)
+{
+        GUPnPDLNAGuessCounts counts = { 0, 0, FALSE, 0, 0 };
+        GUPnPDLNAStreamInfoSets sets;
+        GList *remaining = NULL;
+        GList *iter;
+
+        *decided = FALSE;
+        stream_info_sets_init (&sets, info, &counts);
+
+        if (!sets.has_container && sets.audio == NULL &&
+            sets.image == NULL && sets.video == NULL) {
+                remaining = g_list_copy (candidates);
+        } else if (sets.video != NULL && sets.audio != NULL) {
+                /* the first video and audio streams are all a video
+                 * guess looks at, so later streams cannot change it */
+                GUPnPDLNAProfile *profile = find_profile
+                                        (&sets,
+                                         candidates,
+                                         check_video_profile,
+                                         "video");
+
+                *decided = TRUE;
+                if (profile != NULL)
+                        remaining = g_list_prepend (NULL, profile);
+        } else {
+                for (iter = candidates; iter != NULL; iter = iter->next)
+                        if (may_match (&sets, iter->data))
+                                remaining = g_list_prepend (remaining,
+                                                            iter->data);
+                remaining = g_list_reverse (remaining);
         }
+        stream_info_sets_clear (&sets);
 
-        return found_profile;
+        return remaining;
 }
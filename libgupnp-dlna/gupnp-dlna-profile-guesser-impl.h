@@ -32,19 +32,56 @@
 
 G_BEGIN_DECLS
 
+/* Work done by a single guess. */
+typedef struct {
+        guint    profiles;
+        guint    restrictions;
+        /* the matched profile accepted an unsupported value */
+        gboolean unsupported_match;
+        /* mime and field checks, all and the ones spent on profiles
+         * that did not match */
+        guint    comparisons;
+        guint    rejected_comparisons;
+} GUPnPDLNAGuessCounts;
+
+/* @reordered, if not %NULL, holds @profiles in an order which gives
+ * the same results as long as the media has no unsupported values,
+ * see gupnp_dlna_profile_db_order_by_hits(). It is used whenever
+ * that holds. */
+
 GUPnPDLNAProfile *
 gupnp_dlna_profile_guesser_impl_guess_image_profile
                                         (GUPnPDLNAInformation *info,
-                                         GList                *profiles);
+                                         GList                *profiles,
+                                         GList                *reordered,
+                                         GUPnPDLNAGuessCounts *counts);
 
 GUPnPDLNAProfile *
 gupnp_dlna_profile_guesser_impl_guess_video_profile
                                         (GUPnPDLNAInformation *info,
-                                         GList                *profiles);
+                                         GList                *profiles,
+                                         GList                *reordered,
+                                         GUPnPDLNAGuessCounts *counts);
+
 GUPnPDLNAProfile *
 gupnp_dlna_profile_guesser_impl_guess_audio_profile
                                         (GUPnPDLNAInformation *info,
-                                         GList                *profiles);
+                                         GList                *profiles,
+                                         GList                *reordered,
+                                         GUPnPDLNAGuessCounts *counts);
+
+GUPnPDLNAProfile *
+gupnp_dlna_profile_guesser_impl_guess_profile
+                                        (GUPnPDLNAInformation *info,
+                                         GList                *profiles,
+                                         GList                *reordered,
+                                         GUPnPDLNAGuessCounts *counts);
+
+GList *
+gupnp_dlna_profile_guesser_impl_narrow_candidates
+                                        (GUPnPDLNAInformation *info,
+                                         GList                *candidates,
+                                         gboolean             *decided);
 
 G_END_DECLS
 
@@ -23,9 +23,14 @@
 
 #include "gupnp-dlna-profile-guesser.h"
 #include "gupnp-dlna-profile-guesser-impl.h"
+#include "gupnp-dlna-information-private.h"
+#include "gupnp-dlna-profile-db.h"
+#include "gupnp-dlna-profile-changes-private.h"
 #include "gupnp-dlna-profile-loader.h"
 #include "gupnp-dlna-metadata-extractor.h"
 #include "gupnp-dlna-metadata-backend.h"
+#include "gupnp-dlna-daemon-client-private.h"
+#include "gupnp-dlna-daemon-protocol-private.h"
 
 /**
  * SECTION:gupnp-dlna-profile-guesser
@@ -35,6 +40,73 @@
  * The API provides synchronous and asynchronous guessing of DLNA
  * profile. The asynchronous mode requires a running #GMainLoop in the
  * default #GMainContext.
+ *
+ * Asynchronous guesses match the extracted information against the
+ * profiles in a pool of worker threads, so the #GMainContext the
+ * extraction finished in is not held up by matching. Only the
+ * results are passed back to it, and ::done is emitted there. With
+ * #GUPnPDLNAProfileGuesser:result-batch-size the results are passed
+ * back in batches, so a burst of results costs the context one
+ * dispatch per batch instead of one per result.
+ *
+ * Asynchronous guesses belong to one of the #GUPnPDLNAGuessPriority
+ * classes. Once #GUPnPDLNAProfileGuesser:bulk-slots is set, only so
+ * many bulk guesses run at once and the rest wait in a queue, while
+ * interactive guesses jump that queue and can always use the slots
+ * reserved by #GUPnPDLNAProfileGuesser:interactive-slots.
+ *
+ * Guessing from #GUPnPDLNAInformation is thread-safe.
+ * gupnp_dlna_profile_guesser_guess_profile_from_info(),
+ * gupnp_dlna_profile_guesser_get_profile() and
+ * gupnp_dlna_profile_guesser_list_profiles() can be called from many
+ * threads at once, also with the same guesser and the same
+ * information object. The DLNA profiles of a mode are loaded when the
+ * first guesser of that mode is created. A loaded set of profiles is
+ * a snapshot which is never modified - a reload builds a new one -
+ * and every guess keeps its intermediate data to itself. The only
+ * exception is gupnp_dlna_profile_guesser_cleanup(), which must not
+ * run concurrently with anything else.
+ *
+ * The profiles can be replaced while guessing with
+ * gupnp_dlna_profile_guesser_reload_profiles(), or whenever the
+ * profile directory changes after
+ * gupnp_dlna_profile_guesser_enable_reload(). A reload builds new
+ * profiles next to the old ones and then switches to them at once -
+ * guesses already running finish with the old profiles. A guesser
+ * switches to the new profiles on its first use after the reload.
+ * The old profiles are released once the guesses using them are done
+ * and the guesser switched to newer profiles again, so profiles
+ * returned by a guesser stay valid across one reload. Take a
+ * reference to a profile to keep it longer.
+ *
+ * Every guess records how long its phases took in the
+ * #GUPnPDLNAInformation it used, see
+ * gupnp_dlna_information_get_phase_time().
+ *
+ * Each guesser also keeps statistics of all its guesses - how many
+ * times each profile matched, how many guesses matched nothing or
+ * failed, and histograms of extraction and matching latencies. They
+ * are updated and read with atomic operations only, so reading them
+ * is cheap and never blocks guessing.
+ *
+ * A guess returns the first profile that matches, so the order in
+ * which the profiles are tried decides how long it takes. Unless
+ * #GUPnPDLNAProfileGuesser:adaptive-ordering is disabled, the guesser
+ * periodically reorders the profiles so the most often matched ones
+ * are tried first. Only profiles which can never match the same
+ * media are moved past each other, so the result of a guess stays
+ * the same. The learned hits can be kept between runs with
+ * gupnp_dlna_profile_guesser_save_stats() and
+ * gupnp_dlna_profile_guesser_load_stats().
+ *
+ * A guesser created with gupnp_dlna_profile_guesser_new_for_daemon()
+ * does not load any profiles or metadata backend - it forwards its
+ * guesses to a running gupnp-dlna-daemon-2.0, which keeps both
+ * loaded. Profiles returned by such a guesser carry only their name,
+ * MIME type, extended flag and digest. Its guesses return the same
+ * profile objects as gupnp_dlna_profile_guesser_list_profiles() and
+ * gupnp_dlna_profile_guesser_get_profile(), which list the profiles
+ * of the daemon.
  */
 enum {
         DONE,
@@ -43,9 +115,82 @@ enum {
 
 static guint signals[SIGNAL_LAST];
 
+/* Profiles are reordered after this many matches. */
+#define REORDER_INTERVAL 256
+
+/* Key file group holding profile hits in saved statistics. */
+#define STATS_HITS_GROUP "Profile hits"
+
+/* Key file group and key holding saved profile digests. */
+#define DIGESTS_GROUP "Profile digests"
+#define DIGESTS_KEY "Digests"
+
+/* Changes in the profile directory are collected for this long
+ * before the profiles are reloaded, so replacing several files at
+ * once causes a single reload. */
+#define RELOAD_DELAY_MS 500
+
+/* A reordered profile list. Guesses hold a reference to the list
+ * they use, so it can be replaced while they run. */
+typedef struct {
+        GList *profiles;
+        gint   ref_count;
+} GUPnPDLNAProfileOrder;
+
+/* A guesser's view of one version of the profiles - the profile
+ * database and the statistics of its profiles. When the profiles are
+ * reloaded, the guesser switches to a new view on its next use.
+ * Every guess holds a reference to the view it started with, so it
+ * finishes with it. The guesser keeps the view it switched away from
+ * until the next switch, so profiles returned without a reference
+ * stay valid for a while, and every other old view is freed with its
+ * last guess. */
+typedef struct {
+        GUPnPDLNAProfileDB    *db; /* NULL after cleanup */
+        guint                  generation;
+        /* <GUPnPDLNAProfile *, index + 1>, only read after creation */
+        GHashTable            *profile_slots;
+        gint                  *profile_hits; /* atomic operations only */
+        guint                  profile_count;
+        GUPnPDLNAProfileOrder *order; /* NULL until first reordering */
+        gint                   ref_count;
+} GUPnPDLNAProfileView;
+
 struct _GUPnPDLNAProfileGuesserPrivate {
         gboolean relaxed_mode;
         gboolean extended_mode;
+
+        /* statistics, accessed only with atomic operations */
+        gint no_matches;
+        gint errors;
+        gint unsupported_matches;
+        gint latencies[GUPNP_DLNA_PROFILE_GUESSER_LATENCY_COUNT]
+                      [GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS];
+
+        gboolean adaptive_ordering;
+        gint matches_since_reorder;
+
+        GMutex view_lock;
+        GUPnPDLNAProfileView *view; /* NULL until first use */
+        GUPnPDLNAProfileView *previous_view; /* NULL until a reload */
+
+        gchar *daemon_socket;
+        GUPnPDLNADaemonClient *daemon; /* NULL unless daemon_socket set */
+
+        /* results of asynchronous guesses waiting to be delivered */
+        GMutex results_lock;
+        /* <GMainContext *, GUPnPDLNAResultBatch *> */
+        GHashTable *result_batches;
+        guint result_batch_serial;
+        gint result_batch_size; /* atomic operations only */
+        gint result_batch_delay; /* atomic operations only */
+
+        /* asynchronous guesses waiting for a slot, by priority */
+        GMutex queue_lock;
+        GQueue queued_guesses[GUPNP_DLNA_GUESS_PRIORITY_COUNT];
+        guint running_guesses[GUPNP_DLNA_GUESS_PRIORITY_COUNT];
+        guint bulk_slots; /* 0 for no limit */
+        guint interactive_slots;
 };
 typedef struct _GUPnPDLNAProfileGuesserPrivate GUPnPDLNAProfileGuesserPrivate;
 
@@ -57,9 +202,524 @@ enum {
         PROP_0,
         PROP_DLNA_RELAXED_MODE,
         PROP_DLNA_EXTENDED_MODE,
+        PROP_ADAPTIVE_ORDERING,
+        PROP_DAEMON_SOCKET,
+        PROP_RESULT_BATCH_SIZE,
+        PROP_RESULT_BATCH_DELAY,
+        PROP_BULK_SLOTS,
+        PROP_INTERACTIVE_SLOTS
+};
+
+/* Loaded on first use, so processes using one mode, or only the
+ * daemon, do not pay for the others. A reload replaces the loaded
+ * databases and bumps the generation, which guessers check on every
+ * use. The generation is only changed with the lock held, but it is
+ * read without it. */
+static GMutex profile_dbs_lock;
+static GUPnPDLNAProfileDB *profile_dbs[2][2];
+static gint profile_dbs_generation;
+static gboolean profile_dbs_released;
+
+/* Serializes reloads. */
+static GMutex profile_reload_lock;
+
+/* Watching of the profile directory, see
+ * gupnp_dlna_profile_guesser_enable_reload(). The reload source is
+ * used only in the monitor thread. */
+static GMutex profile_monitor_lock;
+static GThread *profile_monitor_thread;
+static GMainLoop *profile_monitor_loop;
+static GFileMonitor *profile_monitor;
+static GSource *profile_reload_source;
+
+/* Inclusive upper limits of latency histogram buckets in
+ * microseconds. */
+static const gint64
+latency_bucket_limits[GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS] = {
+        1,
+        10,
+        100,
+        1000,
+        10000,
+        100000,
+        1000000,
+        10000000,
+        G_MAXINT64
 };
 
-static GList *profiles_list[2][2];
+static GUPnPDLNAProfileDB *
+acquire_profile_db (gboolean  relaxed_mode,
+                    gboolean  extended_mode,
+                    guint    *generation)
+{
+        guint rel_index = (relaxed_mode ? 1 : 0);
+        guint ext_index = (extended_mode ? 1 : 0);
+        GUPnPDLNAProfileDB *db;
+        gboolean loaded = FALSE;
+
+        g_mutex_lock (&profile_dbs_lock);
+        db = profile_dbs[rel_index][ext_index];
+        if (db == NULL && !profile_dbs_released) {
+                db = gupnp_dlna_profile_db_new (relaxed_mode, extended_mode);
+                profile_dbs[rel_index][ext_index] = db;
+                loaded = TRUE;
+        }
+        if (db != NULL)
+                gupnp_dlna_profile_db_ref (db);
+        *generation = (guint) profile_dbs_generation;
+        g_mutex_unlock (&profile_dbs_lock);
+
+        if (loaded && g_getenv ("GUPNP_DLNA_PROFILE_RELOAD") != NULL)
+                gupnp_dlna_profile_guesser_enable_reload ();
+
+        return db;
+}
+
+/* Loads the profiles of all the modes in use again and publishes
+ * them. Guessing goes on with the old profiles meanwhile. */
+static gboolean
+reload_profile_dbs (void)
+{
+        GUPnPDLNAProfileDB *dbs[2][2] = { { NULL, NULL }, { NULL, NULL } };
+        gboolean in_use[2][2];
+        gboolean replaced = FALSE;
+        guint rel_index;
+        guint ext_index;
+
+        g_mutex_lock (&profile_reload_lock);
+
+        g_mutex_lock (&profile_dbs_lock);
+        for (rel_index = 0; rel_index < 2; ++rel_index)
+                for (ext_index = 0; ext_index < 2; ++ext_index)
+                        in_use[rel_index][ext_index] =
+                                  (profile_dbs[rel_index][ext_index] != NULL);
+        g_mutex_unlock (&profile_dbs_lock);
+
+        for (rel_index = 0; rel_index < 2; ++rel_index)
+                for (ext_index = 0; ext_index < 2; ++ext_index) {
+                        GUPnPDLNAProfileDB *db;
+
+                        if (!in_use[rel_index][ext_index])
+                                continue;
+
+                        db = gupnp_dlna_profile_db_new (rel_index != 0,
+                                                        ext_index != 0);
+                        /* most likely a file is just being replaced */
+                        if (gupnp_dlna_profile_db_get_profiles (db) == NULL) {
+                                g_warning ("No DLNA profiles could be "
+                                           "reloaded (relaxed: %u, "
+                                           "extended: %u), keeping the "
+                                           "old ones.",
+                                           rel_index,
+                                           ext_index);
+                                gupnp_dlna_profile_db_unref (db);
+
+                                continue;
+                        }
+                        dbs[rel_index][ext_index] = db;
+                }
+
+        g_mutex_lock (&profile_dbs_lock);
+        for (rel_index = 0; rel_index < 2; ++rel_index)
+                for (ext_index = 0; ext_index < 2; ++ext_index) {
+                        GUPnPDLNAProfileDB *old_db =
+                                          profile_dbs[rel_index][ext_index];
+
+                        /* NULL if cleaned up meanwhile */
+                        if (dbs[rel_index][ext_index] == NULL ||
+                            old_db == NULL)
+                                continue;
+
+                        profile_dbs[rel_index][ext_index] =
+                                          dbs[rel_index][ext_index];
+                        dbs[rel_index][ext_index] = old_db;
+                        replaced = TRUE;
+                }
+        if (replaced)
+                g_atomic_int_inc (&profile_dbs_generation);
+        g_mutex_unlock (&profile_dbs_lock);
+
+        /* guessers using the old databases keep their references */
+        for (rel_index = 0; rel_index < 2; ++rel_index)
+                for (ext_index = 0; ext_index < 2; ++ext_index)
+                        gupnp_dlna_profile_db_unref
+                                        (dbs[rel_index][ext_index]);
+
+        g_mutex_unlock (&profile_reload_lock);
+
+        g_debug ("DLNA profiles %s.", replaced ? "reloaded" : "unchanged");
+
+        return replaced;
+}
+
+static gboolean
+reload_in_monitor (gpointer user_data G_GNUC_UNUSED)
+{
+        g_clear_pointer (&profile_reload_source, g_source_unref);
+        reload_profile_dbs ();
+
+        return G_SOURCE_REMOVE;
+}
+
+static gboolean
+is_profile_file (GFile *file)
+{
+        gchar *name;
+        gboolean profile_file;
+
+        if (file == NULL)
+                return FALSE;
+
+        name = g_file_get_basename (file);
+        profile_file = (g_str_has_suffix (name, ".xml") ||
+                        g_str_has_suffix (name, ".rng") ||
+                        !g_strcmp0 (name, GUPNP_DLNA_PROFILE_ANALYSIS_FILE));
+        g_free (name);
+
+        return profile_file;
+}
+
+static void
+profile_dir_changed_cb (GFileMonitor      *monitor G_GNUC_UNUSED,
+                        GFile             *file,
+                        GFile             *other_file,
+                        GFileMonitorEvent  event G_GNUC_UNUSED,
+                        gpointer           user_data)
+{
+        GMainContext *context = user_data;
+
+        /* a file renamed over a profile file has it in other_file */
+        if (!is_profile_file (file) && !is_profile_file (other_file))
+                return;
+
+        if (profile_reload_source != NULL) {
+                g_source_destroy (profile_reload_source);
+                g_source_unref (profile_reload_source);
+        }
+        profile_reload_source = g_timeout_source_new (RELOAD_DELAY_MS);
+        g_source_set_callback (profile_reload_source,
+                               reload_in_monitor,
+                               NULL,
+                               NULL);
+        g_source_attach (profile_reload_source, context);
+}
+
+static gpointer
+profile_monitor_run (gpointer user_data)
+{
+        GMainLoop *loop = user_data;
+        GMainContext *context = g_main_loop_get_context (loop);
+
+        g_main_context_push_thread_default (context);
+        g_main_loop_run (loop);
+        if (profile_reload_source != NULL) {
+                g_source_destroy (profile_reload_source);
+                g_clear_pointer (&profile_reload_source, g_source_unref);
+        }
+        g_main_context_pop_thread_default (context);
+
+        return NULL;
+}
+
+static void
+disable_reload (void)
+{
+        g_mutex_lock (&profile_monitor_lock);
+        if (profile_monitor_thread != NULL) {
+                g_main_loop_quit (profile_monitor_loop);
+                g_thread_join (profile_monitor_thread);
+                profile_monitor_thread = NULL;
+                g_file_monitor_cancel (profile_monitor);
+                g_clear_object (&profile_monitor);
+                g_clear_pointer (&profile_monitor_loop, g_main_loop_unref);
+        }
+        g_mutex_unlock (&profile_monitor_lock);
+}
+
+static GUPnPDLNAProfileOrder *
+profile_order_ref (GUPnPDLNAProfileOrder *order)
+{
+        g_atomic_int_inc (&order->ref_count);
+
+        return order;
+}
+
+static void
+profile_order_unref (GUPnPDLNAProfileOrder *order)
+{
+        if (order == NULL || !g_atomic_int_dec_and_test (&order->ref_count))
+                return;
+
+        g_list_free (order->profiles);
+        g_slice_free (GUPnPDLNAProfileOrder, order);
+}
+
+static GUPnPDLNAProfileOrder *
+profile_order_new (GUPnPDLNAProfileView *view)
+{
+        GUPnPDLNAProfileOrder *order;
+
+        if (view->db == NULL)
+                return NULL;
+
+        order = g_slice_new (GUPnPDLNAProfileOrder);
+        order->profiles = gupnp_dlna_profile_db_order_by_hits
+                                        (view->db,
+                                         view->profile_hits);
+        order->ref_count = 1;
+
+        return order;
+}
+
+/* Takes over the reference to @db. */
+static GUPnPDLNAProfileView *
+profile_view_new (GUPnPDLNAProfileDB *db,
+                  guint               generation)
+{
+        GUPnPDLNAProfileView *view = g_slice_new0 (GUPnPDLNAProfileView);
+        GList *iter;
+
+        view->db = db;
+        view->generation = generation;
+        view->profile_slots = g_hash_table_new (g_direct_hash,
+                                                g_direct_equal);
+        for (iter = (db != NULL ? gupnp_dlna_profile_db_get_profiles (db) :
+                                  NULL);
+             iter != NULL;
+             iter = iter->next)
+                g_hash_table_insert (view->profile_slots,
+                                     iter->data,
+                                     GUINT_TO_POINTER (++view->profile_count));
+        view->profile_hits = g_new0 (gint, view->profile_count);
+        view->ref_count = 1;
+
+        return view;
+}
+
+static GUPnPDLNAProfileView *
+profile_view_ref (GUPnPDLNAProfileView *view)
+{
+        g_atomic_int_inc (&view->ref_count);
+
+        return view;
+}
+
+static void
+profile_view_unref (GUPnPDLNAProfileView *view)
+{
+        if (view == NULL || !g_atomic_int_dec_and_test (&view->ref_count))
+                return;
+
+        g_hash_table_unref (view->profile_slots);
+        g_free (view->profile_hits);
+        profile_order_unref (view->order);
+        gupnp_dlna_profile_db_unref (view->db);
+        g_slice_free (GUPnPDLNAProfileView, view);
+}
+
+static GList *
+profile_view_get_profiles (GUPnPDLNAProfileView *view)
+{
+        if (view->db == NULL)
+                return NULL;
+
+        return gupnp_dlna_profile_db_get_profiles (view->db);
+}
+
+/* Several profiles may share a name (e.g. with and without a
+ * container), so hits are kept as a list per name, in the order of
+ * the profile list. This way they survive a reload of the profiles
+ * or a restart. */
+static GHashTable *
+profile_view_get_hits (GUPnPDLNAProfileView *view)
+{
+        GHashTable *hits; /* <profile name, GArray of gint> */
+        GList *iter;
+        guint slot = 0;
+
+        hits = g_hash_table_new_full (g_str_hash,
+                                      g_str_equal,
+                                      NULL,
+                                      (GDestroyNotify) g_array_unref);
+        for (iter = profile_view_get_profiles (view);
+             iter != NULL;
+             iter = iter->next, ++slot) {
+                const gchar *name = gupnp_dlna_profile_get_name (iter->data);
+                GArray *array = g_hash_table_lookup (hits, name);
+                gint profile_hits = g_atomic_int_get
+                                        (&view->profile_hits[slot]);
+
+                if (array == NULL) {
+                        array = g_array_new (FALSE, FALSE, sizeof (gint));
+                        g_hash_table_insert (hits, (gpointer) name, array);
+                }
+                g_array_append_val (array, profile_hits);
+        }
+
+        return hits;
+}
+
+/* Replaces the hits of the profiles in @hits, as returned by
+ * profile_view_get_hits(). Other profiles keep their hits. */
+static void
+profile_view_set_hits (GUPnPDLNAProfileView *view,
+                       GHashTable           *hits)
+{
+        GHashTable *seen; /* <profile name, number of profiles so far> */
+        GList *iter;
+        guint slot = 0;
+
+        seen = g_hash_table_new (g_str_hash, g_str_equal);
+        for (iter = profile_view_get_profiles (view);
+             iter != NULL;
+             iter = iter->next, ++slot) {
+                const gchar *name = gupnp_dlna_profile_get_name (iter->data);
+                guint occurrence = GPOINTER_TO_UINT (g_hash_table_lookup
+                                        (seen,
+                                         name));
+                GArray *array = g_hash_table_lookup (hits, name);
+
+                g_hash_table_insert (seen,
+                                     (gpointer) name,
+                                     GUINT_TO_POINTER (occurrence + 1));
+                if (array != NULL && occurrence < array->len &&
+                    g_array_index (array, gint, occurrence) >= 0)
+                        g_atomic_int_set (&view->profile_hits[slot],
+                                          g_array_index (array,
+                                                         gint,
+                                                         occurrence));
+        }
+        g_hash_table_unref (seen);
+}
+
+/* Called with the view lock held. */
+static void
+switch_profile_view (GUPnPDLNAProfileGuesser *guesser)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        GUPnPDLNAProfileView *old_view = priv->view;
+        GUPnPDLNAProfileView *view;
+        GUPnPDLNAProfileDB *db;
+        guint generation;
+
+        db = acquire_profile_db (priv->relaxed_mode,
+                                 priv->extended_mode,
+                                 &generation);
+        /* another mode was reloaded */
+        if (old_view != NULL && old_view->db == db) {
+                gupnp_dlna_profile_db_unref (db);
+                old_view->generation = generation;
+
+                return;
+        }
+
+        view = profile_view_new (db, generation);
+        if (old_view != NULL) {
+                GHashTable *hits = profile_view_get_hits (old_view);
+
+                profile_view_set_hits (view, hits);
+                g_hash_table_unref (hits);
+                if (priv->adaptive_ordering)
+                        view->order = profile_order_new (view);
+        }
+        /* the guesser's reference to the current view moves along */
+        profile_view_unref (priv->previous_view);
+        priv->previous_view = old_view;
+        priv->view = view;
+}
+
+/* Gets a reference to the view of the current profiles. If @order is
+ * not %NULL, it is set to a reference to the reordered profiles of
+ * the view or to %NULL. */
+static GUPnPDLNAProfileView *
+get_profile_view (GUPnPDLNAProfileGuesser  *guesser,
+                  GUPnPDLNAProfileOrder   **order)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        guint generation = (guint) g_atomic_int_get (&profile_dbs_generation);
+        GUPnPDLNAProfileView *view;
+
+        g_mutex_lock (&priv->view_lock);
+        if (priv->view == NULL || priv->view->generation != generation)
+                switch_profile_view (guesser);
+        view = profile_view_ref (priv->view);
+        if (order != NULL)
+                *order = (view->order != NULL ?
+                          profile_order_ref (view->order) :
+                          NULL);
+        g_mutex_unlock (&priv->view_lock);
+
+        return view;
+}
+
+static void
+reorder_profiles (GUPnPDLNAProfileGuesser *guesser,
+                  GUPnPDLNAProfileView    *view)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        GUPnPDLNAProfileOrder *order;
+        GUPnPDLNAProfileOrder *old_order;
+
+        if (!priv->adaptive_ordering || view->db == NULL)
+                return;
+
+        order = profile_order_new (view);
+
+        g_mutex_lock (&priv->view_lock);
+        old_order = view->order;
+        view->order = order;
+        g_mutex_unlock (&priv->view_lock);
+
+        profile_order_unref (old_order);
+}
+
+/* Asynchronous guesses are started as long as their priority has a
+ * free slot, otherwise they are queued. Bulk guesses may take up to
+ * bulk-slots slots, interactive guesses may take any slot up to
+ * bulk-slots plus interactive-slots, so the interactive-slots ones are
+ * always left to them. Whenever a slot is freed, queued interactive
+ * guesses are started before queued bulk ones. */
+typedef struct {
+        GUPnPDLNAProfileGuesser *guesser; /* only set once dequeued */
+        gchar                   *uri;
+        guint                    timeout_in_ms;
+        GUPnPDLNAGuessPriority   priority;
+        GMainContext            *context;
+} GUPnPDLNAGuessRequest;
+
+static GUPnPDLNAGuessRequest *
+guess_request_new (const gchar            *uri,
+                   guint                   timeout_in_ms,
+                   GUPnPDLNAGuessPriority  priority)
+{
+        GUPnPDLNAGuessRequest *request = g_slice_new0 (GUPnPDLNAGuessRequest);
+
+        request->uri = g_strdup (uri);
+        request->timeout_in_ms = timeout_in_ms;
+        request->priority = priority;
+        request->context = g_main_context_ref_thread_default ();
+
+        return request;
+}
+
+static void
+guess_request_free (GUPnPDLNAGuessRequest *request)
+{
+        g_clear_object (&request->guesser);
+        g_free (request->uri);
+        g_main_context_unref (request->context);
+        g_slice_free (GUPnPDLNAGuessRequest, request);
+}
+
+static void
+start_queued_guesses (GUPnPDLNAProfileGuesser *guesser);
+
+static void
+release_guess_slot (GUPnPDLNAProfileGuesser *guesser,
+                    GUPnPDLNAGuessPriority   priority);
 
 static void
 gupnp_dlna_profile_guesser_set_property (GObject      *object,
@@ -80,6 +740,39 @@ gupnp_dlna_profile_guesser_set_property (GObject      *object,
                 priv->extended_mode = g_value_get_boolean (value);
                 break;
 
+        case PROP_ADAPTIVE_ORDERING:
+                priv->adaptive_ordering = g_value_get_boolean (value);
+                break;
+
+        case PROP_DAEMON_SOCKET:
+                g_free (priv->daemon_socket);
+                priv->daemon_socket = g_value_dup_string (value);
+                break;
+
+        case PROP_RESULT_BATCH_SIZE:
+                g_atomic_int_set (&priv->result_batch_size,
+                                  (gint) g_value_get_uint (value));
+                break;
+
+        case PROP_RESULT_BATCH_DELAY:
+                g_atomic_int_set (&priv->result_batch_delay,
+                                  (gint) g_value_get_uint (value));
+                break;
+
+        case PROP_BULK_SLOTS:
+                g_mutex_lock (&priv->queue_lock);
+                priv->bulk_slots = g_value_get_uint (value);
+                g_mutex_unlock (&priv->queue_lock);
+                start_queued_guesses (self);
+                break;
+
+        case PROP_INTERACTIVE_SLOTS:
+                g_mutex_lock (&priv->queue_lock);
+                priv->interactive_slots = g_value_get_uint (value);
+                g_mutex_unlock (&priv->queue_lock);
+                start_queued_guesses (self);
+                break;
+
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object,
                                                    property_id,
@@ -107,6 +800,38 @@ gupnp_dlna_profile_guesser_get_property (GObject    *object,
                 g_value_set_boolean (value, priv->extended_mode);
                 break;
 
+        case PROP_ADAPTIVE_ORDERING:
+                g_value_set_boolean (value, priv->adaptive_ordering);
+                break;
+
+        case PROP_DAEMON_SOCKET:
+                g_value_set_string (value, priv->daemon_socket);
+                break;
+
+        case PROP_RESULT_BATCH_SIZE:
+                g_value_set_uint (value,
+                                  (guint) g_atomic_int_get
+                                        (&priv->result_batch_size));
+                break;
+
+        case PROP_RESULT_BATCH_DELAY:
+                g_value_set_uint (value,
+                                  (guint) g_atomic_int_get
+                                        (&priv->result_batch_delay));
+                break;
+
+        case PROP_BULK_SLOTS:
+                g_mutex_lock (&priv->queue_lock);
+                g_value_set_uint (value, priv->bulk_slots);
+                g_mutex_unlock (&priv->queue_lock);
+                break;
+
+        case PROP_INTERACTIVE_SLOTS:
+                g_mutex_lock (&priv->queue_lock);
+                g_value_set_uint (value, priv->interactive_slots);
+                g_mutex_unlock (&priv->queue_lock);
+                break;
+
         default:
                 G_OBJECT_WARN_INVALID_PROPERTY_ID (object,
                                                    property_id,
@@ -115,16 +840,67 @@ gupnp_dlna_profile_guesser_get_property (GObject    *object,
         }
 }
 
+static void
+gupnp_dlna_profile_guesser_constructed (GObject *object)
+{
+        GUPnPDLNAProfileGuesser *self = GUPNP_DLNA_PROFILE_GUESSER (object);
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (self);
+
+        G_OBJECT_CLASS (gupnp_dlna_profile_guesser_parent_class)->constructed
+                                        (object);
+
+        /* the daemon keeps the statistics of its profiles itself */
+        if (priv->daemon_socket != NULL) {
+                priv->daemon = gupnp_dlna_daemon_client_new
+                                        (priv->daemon_socket);
+                priv->adaptive_ordering = FALSE;
+
+                return;
+        }
+        /* load the profiles now rather than on the first guess */
+        profile_view_unref (get_profile_view (self, NULL));
+}
+
+static void
+gupnp_dlna_profile_guesser_finalize (GObject *object)
+{
+        GUPnPDLNAProfileGuesser *self = GUPNP_DLNA_PROFILE_GUESSER (object);
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (self);
+        guint priority;
+
+        g_clear_pointer (&priv->view, profile_view_unref);
+        g_clear_pointer (&priv->previous_view, profile_view_unref);
+        g_mutex_clear (&priv->view_lock);
+        g_clear_pointer (&priv->daemon, gupnp_dlna_daemon_client_free);
+        g_clear_pointer (&priv->daemon_socket, g_free);
+        /* every pending result holds a reference to the guesser */
+        g_hash_table_unref (priv->result_batches);
+        g_mutex_clear (&priv->results_lock);
+        for (priority = 0;
+             priority < GUPNP_DLNA_GUESS_PRIORITY_COUNT;
+             ++priority)
+                while (!g_queue_is_empty (&priv->queued_guesses[priority]))
+                        guess_request_free (g_queue_pop_head
+                                        (&priv->queued_guesses[priority]));
+        g_mutex_clear (&priv->queue_lock);
+
+        G_OBJECT_CLASS (gupnp_dlna_profile_guesser_parent_class)->finalize
+                                        (object);
+}
+
 static void
 gupnp_dlna_profile_guesser_class_init
                                    (GUPnPDLNAProfileGuesserClass *guesser_class)
 {
         GObjectClass *object_class = G_OBJECT_CLASS (guesser_class);
         GParamSpec *pspec;
-        guint iter;
 
         object_class->get_property = gupnp_dlna_profile_guesser_get_property;
         object_class->set_property = gupnp_dlna_profile_guesser_set_property;
+        object_class->constructed = gupnp_dlna_profile_guesser_constructed;
+        object_class->finalize = gupnp_dlna_profile_guesser_finalize;
 
         /**
          * GUPnPDLNAProfileGuesser:relaxed-mode:
@@ -162,6 +938,118 @@ gupnp_dlna_profile_guesser_class_init
                                          PROP_DLNA_EXTENDED_MODE,
                                          pspec);
 
+        /**
+         * GUPnPDLNAProfileGuesser:adaptive-ordering:
+         *
+         * Whether the profiles matched most often should be tried
+         * first. This never changes the result of a guess.
+         */
+        pspec = g_param_spec_boolean ("adaptive-ordering",
+                                      "Adaptive ordering property",
+                                      "Indicates that profiles should be "
+                                      "tried in order of their match "
+                                      "frequency",
+                                      TRUE,
+                                      G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT_ONLY);
+        g_object_class_install_property (object_class,
+                                         PROP_ADAPTIVE_ORDERING,
+                                         pspec);
+
+        /**
+         * GUPnPDLNAProfileGuesser:daemon-socket:
+         *
+         * Path of the socket of gupnp-dlna-daemon-2.0 to forward
+         * the guesses to, or %NULL to guess in this process.
+         */
+        pspec = g_param_spec_string ("daemon-socket",
+                                     "Daemon socket property",
+                                     "Path of the guessing daemon socket",
+                                     NULL,
+                                     G_PARAM_READWRITE |
+                                     G_PARAM_CONSTRUCT_ONLY);
+        g_object_class_install_property (object_class,
+                                         PROP_DAEMON_SOCKET,
+                                         pspec);
+
+        /**
+         * GUPnPDLNAProfileGuesser:result-batch-size:
+         *
+         * The number of asynchronous guess results passed back to a
+         * #GMainContext at once. ::done is emitted for all of them
+         * in a single dispatch. A batch which does not fill up is
+         * passed back after
+         * #GUPnPDLNAProfileGuesser:result-batch-delay.
+         */
+        pspec = g_param_spec_uint ("result-batch-size",
+                                   "Result batch size property",
+                                   "Number of asynchronous results "
+                                   "delivered at once",
+                                   1,
+                                   G_MAXINT,
+                                   1,
+                                   G_PARAM_READWRITE);
+        g_object_class_install_property (object_class,
+                                         PROP_RESULT_BATCH_SIZE,
+                                         pspec);
+
+        /**
+         * GUPnPDLNAProfileGuesser:result-batch-delay:
+         *
+         * The longest time in milliseconds an asynchronous guess
+         * result waits for its batch to fill up.
+         */
+        pspec = g_param_spec_uint ("result-batch-delay",
+                                   "Result batch delay property",
+                                   "Longest time in milliseconds a result "
+                                   "waits for its batch",
+                                   0,
+                                   G_MAXINT,
+                                   50,
+                                   G_PARAM_READWRITE);
+        g_object_class_install_property (object_class,
+                                         PROP_RESULT_BATCH_DELAY,
+                                         pspec);
+
+        /**
+         * GUPnPDLNAProfileGuesser:bulk-slots:
+         *
+         * The number of asynchronous guesses of
+         * %GUPNP_DLNA_GUESS_PRIORITY_BULK which may run at once, or 0
+         * for no limit. Further ones are queued.
+         */
+        pspec = g_param_spec_uint ("bulk-slots",
+                                   "Bulk slots property",
+                                   "Number of bulk guesses running at "
+                                   "once or 0 for no limit",
+                                   0,
+                                   G_MAXINT,
+                                   0,
+                                   G_PARAM_READWRITE);
+        g_object_class_install_property (object_class,
+                                         PROP_BULK_SLOTS,
+                                         pspec);
+
+        /**
+         * GUPnPDLNAProfileGuesser:interactive-slots:
+         *
+         * The number of slots reserved for asynchronous guesses of
+         * %GUPNP_DLNA_GUESS_PRIORITY_INTERACTIVE. They may also use
+         * the slots of bulk guesses. Only used if
+         * #GUPnPDLNAProfileGuesser:bulk-slots is not 0.
+         */
+        pspec = g_param_spec_uint ("interactive-slots",
+                                   "Interactive slots property",
+                                   "Number of slots reserved for "
+                                   "interactive guesses",
+                                   0,
+                                   G_MAXINT,
+                                   1,
+                                   G_PARAM_READWRITE);
+        g_object_class_install_property (object_class,
+                                         PROP_INTERACTIVE_SLOTS,
+                                         pspec);
+
         /**
          * GUPnPDLNAProfileGuesser::done:
          * @profile_guesser: The #GUPnPDLNAProfileGuesser.
@@ -185,26 +1073,27 @@ gupnp_dlna_profile_guesser_class_init
                               GUPNP_TYPE_DLNA_INFORMATION,
                               GUPNP_TYPE_DLNA_PROFILE,
                               G_TYPE_ERROR);
-
-        /* Load DLNA profiles from disk */
-        for (iter = 0; iter < 4; ++iter) {
-                gboolean relaxed = (iter > 1); /* F,F,T,T */
-                gboolean extended = ((iter) % 2 != 0); /* F,T,F,T */
-                guint rel_index = (relaxed ? 1 : 0);
-                guint ext_index = (extended ? 1 : 0);
-                GUPnPDLNAProfileLoader *loader = gupnp_dlna_profile_loader_new
-                                        (relaxed,
-                                         extended);
-
-                profiles_list[rel_index][ext_index] =
-                               gupnp_dlna_profile_loader_get_from_disk (loader);
-                g_object_unref (loader);
-        }
 }
 
 static void
 gupnp_dlna_profile_guesser_init (GUPnPDLNAProfileGuesser *self)
 {
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (self);
+        guint priority;
+
+        g_mutex_init (&priv->view_lock);
+        g_mutex_init (&priv->results_lock);
+        priv->result_batches = g_hash_table_new (g_direct_hash,
+                                                 g_direct_equal);
+        priv->result_batch_size = 1;
+        priv->result_batch_delay = 50;
+        g_mutex_init (&priv->queue_lock);
+        for (priority = 0;
+             priority < GUPNP_DLNA_GUESS_PRIORITY_COUNT;
+             ++priority)
+                g_queue_init (&priv->queued_guesses[priority]);
+        priv->interactive_slots = 1;
 }
 
 /**
@@ -229,33 +1118,871 @@ gupnp_dlna_profile_guesser_new (gboolean relaxed_mode,
                                             NULL));
 }
 
-static gboolean
-unref_extractor_in_idle (GUPnPDLNAMetadataExtractor *extractor)
+/**
+ * gupnp_dlna_profile_guesser_new_for_daemon:
+ * @relaxed_mode: %TRUE to enable relaxed mode support. %FALSE otherwise.
+ * @extended_mode: %TRUE to enable extended mode support. %FALSE otherwise.
+ * @socket_path: (allow-none): Path of the daemon socket or %NULL for
+ * the default one.
+ *
+ * Creates a new guesser forwarding its guesses to
+ * gupnp-dlna-daemon-2.0 listening on @socket_path. The default
+ * socket is taken from GUPNP_DLNA_DAEMON_SOCKET environment variable
+ * or lives in the user runtime directory. The daemon is connected
+ * to on the first guess.
+ *
+ * Returns: A new #GUPnPDLNAProfileGuesser object.
+ */
+GUPnPDLNAProfileGuesser *
+gupnp_dlna_profile_guesser_new_for_daemon (gboolean     relaxed_mode,
+                                           gboolean     extended_mode,
+                                           const gchar *socket_path)
 {
-        if (extractor)
-                g_object_unref (extractor);
+        gchar *default_path = NULL;
+        GUPnPDLNAProfileGuesser *guesser;
 
-        return FALSE;
+        if (socket_path == NULL) {
+                default_path = gupnp_dlna_daemon_get_default_socket_path ();
+                socket_path = default_path;
+        }
+        guesser = GUPNP_DLNA_PROFILE_GUESSER (g_object_new
+                                        (GUPNP_TYPE_DLNA_PROFILE_GUESSER,
+                                         "relaxed-mode", relaxed_mode,
+                                         "extended-mode", extended_mode,
+                                         "daemon-socket", socket_path,
+                                         NULL));
+        g_free (default_path);
+
+        return guesser;
 }
 
 static void
-gupnp_dlna_discovered_cb (GUPnPDLNAProfileGuesser *guesser,
-                          GUPnPDLNAInformation    *info,
-                          GError                  *error,
-                          gpointer                 user_data)
+record_latency (GUPnPDLNAProfileGuesser        *guesser,
+                GUPnPDLNAProfileGuesserLatency  latency,
+                gint64                          time)
 {
-        GUPnPDLNAProfile *profile = NULL;
-        GUPnPDLNAMetadataExtractor *extractor =
-                                      GUPNP_DLNA_METADATA_EXTRACTOR (user_data);
-
-        if (!error) {
-                profile = gupnp_dlna_profile_guesser_guess_profile_from_info
-                                        (guesser,
-                                         info);
-        }
-        g_signal_emit (guesser, signals[DONE], 0, info, profile, error);
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        guint bucket = 0;
 
-        g_idle_add ((GSourceFunc) unref_extractor_in_idle, extractor);
+        while (time > latency_bucket_limits[bucket])
+                ++bucket;
+        g_atomic_int_inc (&priv->latencies[latency][bucket]);
+}
+
+static void
+record_error (GUPnPDLNAProfileGuesser *guesser)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+
+        g_atomic_int_inc (&priv->errors);
+}
+
+static void
+record_match (GUPnPDLNAProfileGuesser *guesser,
+              GUPnPDLNAProfileView    *view,
+              GUPnPDLNAProfile        *profile,
+              gboolean                 unsupported_match)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        guint slot;
+
+        if (profile == NULL) {
+                g_atomic_int_inc (&priv->no_matches);
+
+                return;
+        }
+
+        /* profiles of the daemon have no view */
+        slot = (view != NULL ?
+                GPOINTER_TO_UINT (g_hash_table_lookup (view->profile_slots,
+                                                       profile)) :
+                0);
+        if (slot > 0)
+                g_atomic_int_inc (&view->profile_hits[slot - 1]);
+        if (unsupported_match)
+                g_atomic_int_inc (&priv->unsupported_matches);
+
+        if (priv->adaptive_ordering &&
+            g_atomic_int_add (&priv->matches_since_reorder, 1) ==
+            REORDER_INTERVAL - 1) {
+                g_atomic_int_set (&priv->matches_since_reorder, 0);
+                reorder_profiles (guesser, view);
+        }
+}
+
+/* Times of phases done before extraction, kept on the extractor until
+ * the information object exists. */
+#define EXTRACTOR_TIMES_KEY "gupnp-dlna-extractor-times"
+
+typedef struct {
+        gint64 load_time;
+        gint64 creation_time;
+        gint64 extraction_start;
+} GUPnPDLNAExtractorTimes;
+
+/* Priority of an asynchronous guess, kept on its extractor until the
+ * extraction is done. */
+#define EXTRACTOR_PRIORITY_KEY "gupnp-dlna-extractor-priority"
+
+static GUPnPDLNAMetadataExtractor *
+get_extractor (GUPnPDLNAExtractorTimes *times)
+{
+        gint64 start = g_get_monotonic_time ();
+        GUPnPDLNAMetadataExtractor *extractor =
+                gupnp_dlna_metadata_backend_get_extractor (&times->load_time);
+
+        times->extraction_start = g_get_monotonic_time ();
+        times->creation_time =
+                       times->extraction_start - start - times->load_time;
+
+        return extractor;
+}
+
+static void
+set_extractor_times (GUPnPDLNAInformation    *info,
+                     GUPnPDLNAExtractorTimes *times)
+{
+        if (info == NULL || times == NULL)
+                return;
+
+        gupnp_dlna_information_set_phase_time
+                                        (info,
+                                         GUPNP_DLNA_GUESS_PHASE_BACKEND_LOADING,
+                                         times->load_time);
+        gupnp_dlna_information_set_phase_time
+                                     (info,
+                                      GUPNP_DLNA_GUESS_PHASE_EXTRACTOR_CREATION,
+                                      times->creation_time);
+}
+
+/* Candidate profiles of a guess whose extraction is still running,
+ * narrowed whenever the extractor reports partial information. Once
+ * no candidate is left or the guess is decided, the extraction is
+ * stopped and the remaining information is not matched at all. */
+#define EXTRACTOR_NARROWING_KEY "gupnp-dlna-extractor-narrowing"
+
+typedef struct {
+        GUPnPDLNAProfileGuesser *guesser;
+        GMutex                   lock;
+        gboolean                 narrowed;
+        gboolean                 decided;
+        /* the candidates come from this view, both only set if
+         * narrowed */
+        GUPnPDLNAProfileView    *view;
+        GList                   *candidates;
+} GUPnPDLNANarrowing;
+
+static void
+narrowing_free (GUPnPDLNANarrowing *narrowing)
+{
+        g_list_free (narrowing->candidates);
+        profile_view_unref (narrowing->view);
+        g_mutex_clear (&narrowing->lock);
+        g_slice_free (GUPnPDLNANarrowing, narrowing);
+}
+
+static gboolean
+extraction_progress_cb (GUPnPDLNAMetadataExtractor *extractor G_GNUC_UNUSED,
+                        GUPnPDLNAInformation       *info,
+                        GUPnPDLNANarrowing         *narrowing)
+{
+        GList *remaining;
+        gboolean decided;
+        gboolean stop;
+
+        /* the backend's own profile name beats any matching */
+        if (gupnp_dlna_information_get_profile_name (info) != NULL)
+                return FALSE;
+
+        g_mutex_lock (&narrowing->lock);
+        if (narrowing->view == NULL)
+                narrowing->view = get_profile_view (narrowing->guesser,
+                                                    NULL);
+        remaining = gupnp_dlna_profile_guesser_impl_narrow_candidates
+                                        (info,
+                                         (narrowing->narrowed ?
+                                          narrowing->candidates :
+                                          profile_view_get_profiles
+                                                (narrowing->view)),
+                                         &decided);
+        g_list_free (narrowing->candidates);
+        narrowing->candidates = remaining;
+        narrowing->narrowed = TRUE;
+        narrowing->decided = decided;
+        stop = (decided || remaining == NULL);
+        g_mutex_unlock (&narrowing->lock);
+
+        if (stop)
+                g_debug ("Stopping extraction of '%s', %s.",
+                         gupnp_dlna_information_get_uri (info),
+                         (remaining != NULL ?
+                          "the profile is already known" :
+                          "no profile can match"));
+
+        return stop;
+}
+
+static void
+watch_extraction (GUPnPDLNAProfileGuesser    *guesser,
+                  GUPnPDLNAMetadataExtractor *extractor)
+{
+        GUPnPDLNANarrowing *narrowing = g_slice_new0 (GUPnPDLNANarrowing);
+
+        narrowing->guesser = guesser;
+        g_mutex_init (&narrowing->lock);
+        g_object_set_data_full (G_OBJECT (extractor),
+                                EXTRACTOR_NARROWING_KEY,
+                                narrowing,
+                                (GDestroyNotify) narrowing_free);
+        g_signal_connect (extractor,
+                          "progress",
+                          G_CALLBACK (extraction_progress_cb),
+                          narrowing);
+}
+
+/* Matches the information of a finished extraction, unless the
+ * narrowing already decided the guess. */
+static GUPnPDLNAProfile *
+guess_extracted_profile (GUPnPDLNAProfileGuesser    *guesser,
+                         GUPnPDLNAMetadataExtractor *extractor,
+                         GUPnPDLNAInformation       *info)
+{
+        GUPnPDLNANarrowing *narrowing = g_object_get_data
+                                        (G_OBJECT (extractor),
+                                         EXTRACTOR_NARROWING_KEY);
+        GUPnPDLNAProfileView *view = NULL;
+        GUPnPDLNAProfile *profile = NULL;
+        gboolean final = FALSE;
+
+        if (narrowing != NULL) {
+                g_mutex_lock (&narrowing->lock);
+                final = (narrowing->narrowed &&
+                         (narrowing->decided ||
+                          narrowing->candidates == NULL));
+                if (final && narrowing->candidates != NULL)
+                        profile = narrowing->candidates->data;
+                if (final)
+                        view = profile_view_ref (narrowing->view);
+                g_mutex_unlock (&narrowing->lock);
+        }
+
+        if (!final)
+                return gupnp_dlna_profile_guesser_guess_profile_from_info
+                                        (guesser,
+                                         info);
+
+        gupnp_dlna_information_set_match_stats (info, 0, 0, 0, 0);
+        record_match (guesser, view, profile, FALSE);
+        profile_view_unref (view);
+
+        return profile;
+}
+
+/* Profiles of asynchronous guesses are matched in a pool shared by
+ * all guessers, so a burst of extraction results does not hold up
+ * the main context they arrive in. Only the results are passed back
+ * there, in batches of up to result-batch-size. */
+typedef struct {
+        GUPnPDLNAProfileGuesser    *guesser;
+        GUPnPDLNAMetadataExtractor *extractor;
+        GMainContext               *context;
+        GUPnPDLNAInformation       *info;
+        GError                     *error;
+        GUPnPDLNAProfile           *profile;
+} GUPnPDLNAMatchJob;
+
+/* Results waiting to be passed back to a main context. Each batch
+ * gets a new id, so a delay started for a batch which filled up
+ * meanwhile does not flush a later one early. */
+typedef struct {
+        GPtrArray *jobs;
+        guint      id;
+} GUPnPDLNAResultBatch;
+
+/* A result batch of a main context waiting for its delay to run
+ * out. */
+typedef struct {
+        GUPnPDLNAProfileGuesser *guesser;
+        GMainContext            *context;
+        guint                    batch_id;
+} GUPnPDLNAResultFlush;
+
+static void
+match_job_free (GUPnPDLNAMatchJob *job)
+{
+        /* the extractor is released only once it is done emitting */
+        g_object_unref (job->extractor);
+        g_main_context_unref (job->context);
+        g_object_unref (job->info);
+        g_clear_error (&job->error);
+        g_clear_object (&job->profile);
+        g_object_unref (job->guesser);
+        g_slice_free (GUPnPDLNAMatchJob, job);
+}
+
+static void
+result_flush_free (GUPnPDLNAResultFlush *flush)
+{
+        g_object_unref (flush->guesser);
+        g_main_context_unref (flush->context);
+        g_slice_free (GUPnPDLNAResultFlush, flush);
+}
+
+static gboolean
+deliver_results (GPtrArray *jobs)
+{
+        guint iter;
+
+        for (iter = 0; iter < jobs->len; ++iter) {
+                GUPnPDLNAMatchJob *job = g_ptr_array_index (jobs, iter);
+
+                g_signal_emit (job->guesser,
+                               signals[DONE],
+                               0,
+                               job->info,
+                               job->profile,
+                               job->error);
+        }
+
+        return G_SOURCE_REMOVE;
+}
+
+/* Called with the results lock held. */
+static GPtrArray *
+take_result_batch (GUPnPDLNAProfileGuesserPrivate *priv,
+                   GMainContext                   *context,
+                   GUPnPDLNAResultBatch           *batch)
+{
+        GPtrArray *jobs = batch->jobs;
+
+        g_hash_table_remove (priv->result_batches, context);
+        g_slice_free (GUPnPDLNAResultBatch, batch);
+
+        return jobs;
+}
+
+static gboolean
+flush_result_batch (GUPnPDLNAResultFlush *flush)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private
+                                        (flush->guesser);
+        GUPnPDLNAResultBatch *batch;
+        GPtrArray *jobs = NULL;
+
+        g_mutex_lock (&priv->results_lock);
+        batch = g_hash_table_lookup (priv->result_batches, flush->context);
+        if (batch != NULL && batch->id == flush->batch_id)
+                jobs = take_result_batch (priv, flush->context, batch);
+        g_mutex_unlock (&priv->results_lock);
+
+        /* NULL if the batch filled up meanwhile */
+        if (jobs != NULL) {
+                deliver_results (jobs);
+                g_ptr_array_unref (jobs);
+        }
+
+        return G_SOURCE_REMOVE;
+}
+
+/* Called in a matching thread. */
+static void
+queue_result (GUPnPDLNAMatchJob *job)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (job->guesser);
+        GMainContext *context = g_main_context_ref (job->context);
+        guint batch_size = (guint) g_atomic_int_get
+                                        (&priv->result_batch_size);
+        GUPnPDLNAResultBatch *batch;
+        GUPnPDLNAResultFlush *flush = NULL;
+        GPtrArray *jobs = NULL;
+
+        g_mutex_lock (&priv->results_lock);
+        batch = g_hash_table_lookup (priv->result_batches, context);
+        if (batch == NULL) {
+                batch = g_slice_new (GUPnPDLNAResultBatch);
+                batch->jobs = g_ptr_array_new_with_free_func
+                                        ((GDestroyNotify) match_job_free);
+                batch->id = ++priv->result_batch_serial;
+                /* the jobs keep the context alive while it is a key */
+                g_hash_table_insert (priv->result_batches, context, batch);
+        }
+        g_ptr_array_add (batch->jobs, job);
+        if (batch->jobs->len >= batch_size) {
+                jobs = take_result_batch (priv, context, batch);
+        } else if (batch->jobs->len == 1) {
+                /* taken while @job cannot be delivered yet */
+                flush = g_slice_new (GUPnPDLNAResultFlush);
+                flush->guesser = g_object_ref (job->guesser);
+                flush->context = g_main_context_ref (context);
+                flush->batch_id = batch->id;
+        }
+        g_mutex_unlock (&priv->results_lock);
+
+        /* results are always delivered from a source of their own,
+         * never from within the extractor's ::done emission */
+        if (jobs != NULL) {
+                GSource *source = g_idle_source_new ();
+
+                g_source_set_priority (source, G_PRIORITY_DEFAULT);
+                g_source_set_callback (source,
+                                       (GSourceFunc) deliver_results,
+                                       jobs,
+                                       (GDestroyNotify) g_ptr_array_unref);
+                g_source_attach (source, context);
+                g_source_unref (source);
+        } else if (flush != NULL) {
+                GSource *source = g_timeout_source_new
+                                        ((guint) g_atomic_int_get
+                                        (&priv->result_batch_delay));
+
+                g_source_set_callback (source,
+                                       (GSourceFunc) flush_result_batch,
+                                       flush,
+                                       (GDestroyNotify) result_flush_free);
+                g_source_attach (source, context);
+                g_source_unref (source);
+        }
+        g_main_context_unref (context);
+}
+
+static void
+match_in_thread (gpointer data,
+                 gpointer user_data G_GNUC_UNUSED)
+{
+        GUPnPDLNAMatchJob *job = data;
+
+        /* the profile has to outlive a reload until ::done is
+         * emitted */
+        if (job->error == NULL)
+                job->profile = guess_extracted_profile (job->guesser,
+                                                        job->extractor,
+                                                        job->info);
+        if (job->profile != NULL)
+                g_object_ref (job->profile);
+        queue_result (job);
+}
+
+static GThreadPool *
+get_match_pool (void)
+{
+        static gsize pool = 0;
+
+        if (g_once_init_enter (&pool)) {
+                GThreadPool *new_pool = g_thread_pool_new
+                                        (match_in_thread,
+                                         NULL,
+                                         g_get_num_processors (),
+                                         FALSE,
+                                         NULL);
+
+                g_once_init_leave (&pool, (gsize) new_pool);
+        }
+
+        return (GThreadPool *) pool;
+}
+
+static void
+gupnp_dlna_discovered_cb (GUPnPDLNAProfileGuesser *guesser,
+                          GUPnPDLNAInformation    *info,
+                          GError                  *error,
+                          gpointer                 user_data)
+{
+        GUPnPDLNAMatchJob *job = g_slice_new0 (GUPnPDLNAMatchJob);
+        GUPnPDLNAExtractorTimes *times;
+
+        /* takes over the reference from the guess */
+        job->extractor = GUPNP_DLNA_METADATA_EXTRACTOR (user_data);
+        job->guesser = g_object_ref (guesser);
+        job->context = g_main_context_ref_thread_default ();
+        job->info = g_object_ref (info);
+        job->error = (error != NULL ? g_error_copy (error) : NULL);
+
+        /* matching does not take a slot, only extraction does */
+        release_guess_slot (guesser,
+                            GPOINTER_TO_UINT (g_object_get_data
+                                        (G_OBJECT (job->extractor),
+                                         EXTRACTOR_PRIORITY_KEY)));
+
+        times = g_object_get_data (G_OBJECT (job->extractor),
+                                   EXTRACTOR_TIMES_KEY);
+        if (times != NULL)
+                record_latency (guesser,
+                                GUPNP_DLNA_PROFILE_GUESSER_LATENCY_EXTRACTION,
+                                g_get_monotonic_time () -
+                                times->extraction_start);
+        set_extractor_times (info, times);
+        if (error != NULL)
+                record_error (guesser);
+
+        /* the job is not queued if no thread could be started */
+        if (!g_thread_pool_push (get_match_pool (), job, NULL))
+                match_in_thread (job, NULL);
+}
+
+/* Guessing through the daemon. */
+
+typedef struct {
+        gchar                  *uri;
+        guint                   timeout_in_ms;
+        GUPnPDLNAGuessPriority  priority;
+        GUPnPDLNAInformation   *info;
+        GUPnPDLNAProfile       *profile;
+} GUPnPDLNADaemonGuess;
+
+static void
+daemon_guess_free (GUPnPDLNADaemonGuess *guess)
+{
+        g_free (guess->uri);
+        g_clear_object (&guess->info);
+        g_slice_free (GUPnPDLNADaemonGuess, guess);
+}
+
+/* Either matches @info or extracts the information from @uri and
+ * matches it. */
+static GUPnPDLNAProfile *
+daemon_guess (GUPnPDLNAProfileGuesser  *guesser,
+              const gchar              *uri,
+              guint                     timeout_in_ms,
+              GUPnPDLNAInformation     *info,
+              GUPnPDLNAInformation    **extracted_info,
+              GError                  **error)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        GUPnPDLNAProfile *profile = NULL;
+        gint64 start = g_get_monotonic_time ();
+        gboolean guessed;
+
+        guessed = gupnp_dlna_daemon_client_guess (priv->daemon,
+                                                  priv->relaxed_mode,
+                                                  priv->extended_mode,
+                                                  uri,
+                                                  timeout_in_ms,
+                                                  info,
+                                                  &profile,
+                                                  extracted_info,
+                                                  error);
+        record_latency (guesser,
+                        (info != NULL ?
+                         GUPNP_DLNA_PROFILE_GUESSER_LATENCY_MATCHING :
+                         GUPNP_DLNA_PROFILE_GUESSER_LATENCY_EXTRACTION),
+                        g_get_monotonic_time () - start);
+        if (guessed)
+                record_match (guesser, NULL, profile, FALSE);
+        else
+                record_error (guesser);
+
+        return profile;
+}
+
+static void
+daemon_guess_in_thread (gpointer data,
+                        gpointer user_data G_GNUC_UNUSED)
+{
+        GTask *task = G_TASK (data);
+        GUPnPDLNADaemonGuess *guess = g_task_get_task_data (task);
+        GError *error = NULL;
+
+        guess->profile = daemon_guess (GUPNP_DLNA_PROFILE_GUESSER
+                                        (g_task_get_source_object (task)),
+                                       guess->uri,
+                                       guess->timeout_in_ms,
+                                       NULL,
+                                       &guess->info,
+                                       &error);
+        /* ::done is emitted in the context the guess was started in */
+        if (error != NULL)
+                g_task_return_error (task, error);
+        else
+                g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+}
+
+/* Daemon guesses wait for the daemon for the whole extraction, so
+ * they get their own pool instead of the one shared by GIO. Otherwise
+ * a big rescan with unlimited slots could starve every other
+ * asynchronous operation of the application. */
+static GThreadPool *
+get_daemon_pool (void)
+{
+        static gsize pool = 0;
+
+        if (g_once_init_enter (&pool)) {
+                GThreadPool *new_pool = g_thread_pool_new
+                                        (daemon_guess_in_thread,
+                                         NULL,
+                                         g_get_num_processors (),
+                                         FALSE,
+                                         NULL);
+
+                g_once_init_leave (&pool, (gsize) new_pool);
+        }
+
+        return (GThreadPool *) pool;
+}
+
+static void
+daemon_guess_done (GObject      *source_object,
+                   GAsyncResult *result,
+                   gpointer      user_data G_GNUC_UNUSED)
+{
+        GUPnPDLNADaemonGuess *guess = g_task_get_task_data (G_TASK (result));
+        GError *error = NULL;
+
+        g_task_propagate_boolean (G_TASK (result), &error);
+        release_guess_slot (GUPNP_DLNA_PROFILE_GUESSER (source_object),
+                            guess->priority);
+        if (guess->info == NULL)
+                guess->info = gupnp_dlna_stored_information_new_empty
+                                        (guess->uri);
+        g_signal_emit (source_object,
+                       signals[DONE],
+                       0,
+                       guess->info,
+                       guess->profile,
+                       error);
+        g_clear_error (&error);
+}
+
+static void
+daemon_guess_async (GUPnPDLNAProfileGuesser *guesser,
+                    const gchar             *uri,
+                    guint                    timeout_in_ms,
+                    GUPnPDLNAGuessPriority   priority)
+{
+        GUPnPDLNADaemonGuess *guess = g_slice_new0 (GUPnPDLNADaemonGuess);
+        GTask *task = g_task_new (guesser, NULL, daemon_guess_done, NULL);
+
+        guess->uri = g_strdup (uri);
+        guess->timeout_in_ms = timeout_in_ms;
+        guess->priority = priority;
+        g_task_set_task_data (task,
+                              guess,
+                              (GDestroyNotify) daemon_guess_free);
+        /* the task is not queued if no thread could be started */
+        if (!g_thread_pool_push (get_daemon_pool (), task, NULL))
+                daemon_guess_in_thread (task, NULL);
+}
+
+/* Called with the queue lock held. */
+static gboolean
+has_free_slot (GUPnPDLNAProfileGuesserPrivate *priv,
+               GUPnPDLNAGuessPriority          priority)
+{
+        guint running;
+
+        if (priv->bulk_slots == 0)
+                return TRUE;
+        if (priority == GUPNP_DLNA_GUESS_PRIORITY_BULK)
+                return (priv->running_guesses[priority] < priv->bulk_slots);
+
+        running = (priv->running_guesses[GUPNP_DLNA_GUESS_PRIORITY_BULK] +
+                   priv->running_guesses[priority]);
+
+        return (running < priv->bulk_slots + priv->interactive_slots);
+}
+
+/* Called with the queue lock held. Takes the slots for the queued
+ * guesses it returns. */
+static GSList *
+dequeue_guesses (GUPnPDLNAProfileGuesserPrivate *priv)
+{
+        GSList *requests = NULL;
+        gint priority;
+
+        for (priority = GUPNP_DLNA_GUESS_PRIORITY_COUNT - 1;
+             priority >= 0;
+             --priority) {
+                GQueue *queue = &priv->queued_guesses[priority];
+
+                while (!g_queue_is_empty (queue) &&
+                       has_free_slot (priv, priority)) {
+                        requests = g_slist_prepend (requests,
+                                                    g_queue_pop_head (queue));
+                        ++priv->running_guesses[priority];
+                }
+        }
+
+        return g_slist_reverse (requests);
+}
+
+/* Starts a guess which already has a slot. On failure the caller has
+ * to release the slot. */
+static gboolean
+start_guess (GUPnPDLNAProfileGuesser  *guesser,
+             GUPnPDLNAGuessRequest    *request,
+             GError                  **error)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        GUPnPDLNAMetadataExtractor *extractor;
+        GUPnPDLNAExtractorTimes times;
+        GUPnPDLNAExtractorTimes *stored_times;
+        gboolean queued;
+        GError *extractor_error;
+        guint id;
+
+        if (priv->daemon != NULL) {
+                daemon_guess_async (guesser,
+                                    request->uri,
+                                    request->timeout_in_ms,
+                                    request->priority);
+
+                return TRUE;
+        }
+
+        extractor = get_extractor (&times);
+        if (extractor == NULL) {
+                g_set_error_literal (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_NOT_SUPPORTED,
+                                     "No metadata extractor is available");
+
+                return FALSE;
+        }
+
+        stored_times = g_new (GUPnPDLNAExtractorTimes, 1);
+        *stored_times = times;
+        g_object_set_data_full (G_OBJECT (extractor),
+                                EXTRACTOR_TIMES_KEY,
+                                stored_times,
+                                g_free);
+        g_object_set_data (G_OBJECT (extractor),
+                           EXTRACTOR_PRIORITY_KEY,
+                           GUINT_TO_POINTER (request->priority));
+        extractor_error = NULL;
+        id = g_signal_connect_swapped (extractor,
+                                       "done",
+                                       G_CALLBACK (gupnp_dlna_discovered_cb),
+                                       guesser);
+        watch_extraction (guesser, extractor);
+        queued = gupnp_dlna_metadata_extractor_extract_async
+                                        (extractor,
+                                         request->uri,
+                                         request->timeout_in_ms,
+                                         &extractor_error);
+        if (extractor_error) {
+                g_propagate_error (error, extractor_error);
+                g_signal_handler_disconnect (extractor, id);
+                g_object_unref (extractor);
+        }
+
+        return queued;
+}
+
+static gboolean
+start_dequeued_guess (GUPnPDLNAGuessRequest *request);
+
+/* Dequeued guesses are started from an idle source in the context
+ * they were requested in, never directly: a slot is often freed during
+ * the ::done emission of another guess, which must not start a guess,
+ * let alone emit ::done, before it returns. */
+static void
+schedule_guess (GUPnPDLNAProfileGuesser *guesser,
+                GUPnPDLNAGuessRequest   *request)
+{
+        GSource *source = g_idle_source_new ();
+
+        request->guesser = g_object_ref (guesser);
+        g_source_set_callback (source,
+                               (GSourceFunc) start_dequeued_guess,
+                               request,
+                               (GDestroyNotify) guess_request_free);
+        g_source_attach (source, request->context);
+        g_source_unref (source);
+}
+
+/* A failure can only be reported with ::done by now. The slot of a
+ * failed guess goes to the next queued guesses and those of the same
+ * context are started by this loop, so a run of failures does not
+ * recurse. */
+static gboolean
+start_dequeued_guess (GUPnPDLNAGuessRequest *request)
+{
+        GUPnPDLNAProfileGuesser *guesser = request->guesser;
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        GQueue pending = G_QUEUE_INIT;
+        GUPnPDLNAGuessRequest *current = request;
+
+        while (current != NULL) {
+                GError *error = NULL;
+                GUPnPDLNAInformation *info;
+                GSList *requests;
+                GSList *iter;
+
+                if (!start_guess (guesser, current, &error)) {
+                        g_mutex_lock (&priv->queue_lock);
+                        --priv->running_guesses[current->priority];
+                        requests = dequeue_guesses (priv);
+                        g_mutex_unlock (&priv->queue_lock);
+
+                        for (iter = requests; iter != NULL; iter = iter->next) {
+                                GUPnPDLNAGuessRequest *next = iter->data;
+
+                                if (next->context == request->context)
+                                        g_queue_push_tail (&pending, next);
+                                else
+                                        schedule_guess (guesser, next);
+                        }
+                        g_slist_free (requests);
+
+                        record_error (guesser);
+                        info = gupnp_dlna_stored_information_new_empty
+                                        (current->uri);
+                        g_signal_emit (guesser,
+                                       signals[DONE],
+                                       0,
+                                       info,
+                                       NULL,
+                                       error);
+                        g_object_unref (info);
+                        g_clear_error (&error);
+                }
+
+                /* @request is freed with the source */
+                if (current != request)
+                        guess_request_free (current);
+                current = g_queue_pop_head (&pending);
+        }
+
+        return G_SOURCE_REMOVE;
+}
+
+static void
+start_queued_guesses (GUPnPDLNAProfileGuesser *guesser)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        GSList *requests;
+        GSList *iter;
+
+        g_mutex_lock (&priv->queue_lock);
+        requests = dequeue_guesses (priv);
+        g_mutex_unlock (&priv->queue_lock);
+
+        for (iter = requests; iter != NULL; iter = iter->next)
+                schedule_guess (guesser, iter->data);
+        g_slist_free (requests);
+}
+
+static void
+release_guess_slot (GUPnPDLNAProfileGuesser *guesser,
+                    GUPnPDLNAGuessPriority   priority)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv =
+                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+
+        g_mutex_lock (&priv->queue_lock);
+        --priv->running_guesses[priority];
+        g_mutex_unlock (&priv->queue_lock);
+
+        start_queued_guesses (guesser);
 }
 
 /**
@@ -266,7 +1993,9 @@ gupnp_dlna_discovered_cb (GUPnPDLNAProfileGuesser *guesser,
  * @error: #GError object or %NULL.
  *
  * Asynchronously guesses DLNA profile for given @uri. When guessing
- * is done, ::done signal is emitted on @guesser.
+ * is done, ::done signal is emitted on @guesser. This is the same as
+ * gupnp_dlna_profile_guesser_guess_profile_async_full() with
+ * %GUPNP_DLNA_GUESS_PRIORITY_BULK.
  *
  * Returns: %TRUE if @uri was successfully queued, %FALSE otherwise.
  */
@@ -277,31 +2006,73 @@ gupnp_dlna_profile_guesser_guess_profile_async
                                         guint                     timeout_in_ms,
                                         GError                  **error)
 {
-        GUPnPDLNAMetadataExtractor *extractor;
-        gboolean queued;
-        GError *extractor_error;
-        guint id;
+        return gupnp_dlna_profile_guesser_guess_profile_async_full
+                                        (guesser,
+                                         uri,
+                                         timeout_in_ms,
+                                         GUPNP_DLNA_GUESS_PRIORITY_BULK,
+                                         error);
+}
+
+/**
+ * gupnp_dlna_profile_guesser_guess_profile_async_full:
+ * @guesser: #GUPnPDLNAProfileGuesser object to use for guessing.
+ * @uri: URI of media.
+ * @timeout_in_ms: Timeout of guessing in miliseconds.
+ * @priority: The priority class of the guess.
+ * @error: #GError object or %NULL.
+ *
+ * Asynchronously guesses DLNA profile for given @uri. When guessing
+ * is done, ::done signal is emitted on @guesser.
+ *
+ * If all the slots of @priority are taken (see
+ * #GUPnPDLNAProfileGuesser:bulk-slots and
+ * #GUPnPDLNAProfileGuesser:interactive-slots), the guess waits in a
+ * queue. Queued %GUPNP_DLNA_GUESS_PRIORITY_INTERACTIVE guesses are
+ * started before queued %GUPNP_DLNA_GUESS_PRIORITY_BULK ones. The
+ * timeout counts from the start of the guess. If a queued guess
+ * cannot be started, ::done is emitted with the error.
+ *
+ * Returns: %TRUE if @uri was successfully started or queued, %FALSE
+ * otherwise.
+ */
+gboolean
+gupnp_dlna_profile_guesser_guess_profile_async_full
+                                       (GUPnPDLNAProfileGuesser  *guesser,
+                                        const gchar              *uri,
+                                        guint                     timeout_in_ms,
+                                        GUPnPDLNAGuessPriority    priority,
+                                        GError                  **error)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv;
+        GUPnPDLNAGuessRequest *request;
+        gboolean start;
+        gboolean queued = TRUE;
 
         g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), FALSE);
         g_return_val_if_fail (uri != NULL, FALSE);
+        g_return_val_if_fail (priority < GUPNP_DLNA_GUESS_PRIORITY_COUNT,
+                              FALSE);
         g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-        extractor = gupnp_dlna_metadata_backend_get_extractor ();
-        g_return_val_if_fail (extractor != NULL, FALSE);
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        request = guess_request_new (uri, timeout_in_ms, priority);
 
-        extractor_error = NULL;
-        id = g_signal_connect_swapped (extractor,
-                                       "done",
-                                       G_CALLBACK (gupnp_dlna_discovered_cb),
-                                       guesser);
-        queued = gupnp_dlna_metadata_extractor_extract_async (extractor,
-                                                              uri,
-                                                              timeout_in_ms,
-                                                              &extractor_error);
-        if (extractor_error) {
-                g_propagate_error (error, extractor_error);
-                g_signal_handler_disconnect (extractor, id);
-                g_object_unref (extractor);
+        /* a guess never overtakes queued ones of its priority */
+        g_mutex_lock (&priv->queue_lock);
+        start = (g_queue_is_empty (&priv->queued_guesses[priority]) &&
+                 has_free_slot (priv, priority));
+        if (start)
+                ++priv->running_guesses[priority];
+        else
+                g_queue_push_tail (&priv->queued_guesses[priority], request);
+        g_mutex_unlock (&priv->queue_lock);
+
+        if (start) {
+                queued = start_guess (guesser, request, error);
+                if (!queued)
+                        release_guess_slot (guesser, priority);
+                guess_request_free (request);
         }
 
         return queued;
@@ -330,8 +2101,10 @@ gupnp_dlna_profile_guesser_guess_profile_sync
                                         GUPnPDLNAInformation    **dlna_info,
                                         GError                  **error)
 {
+        GUPnPDLNAProfileGuesserPrivate *priv;
         GError *extraction_error;
         GUPnPDLNAMetadataExtractor *extractor;
+        GUPnPDLNAExtractorTimes times;
         GUPnPDLNAInformation *info;
         GUPnPDLNAProfile *profile;
 
@@ -340,23 +2113,36 @@ gupnp_dlna_profile_guesser_guess_profile_sync
         g_return_val_if_fail (dlna_info == NULL || *dlna_info == NULL, NULL);
         g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        if (priv->daemon != NULL)
+                return daemon_guess (guesser,
+                                     uri,
+                                     timeout_in_ms,
+                                     NULL,
+                                     dlna_info,
+                                     error);
+
         extraction_error = NULL;
-        extractor = gupnp_dlna_metadata_backend_get_extractor ();
+        extractor = get_extractor (&times);
         g_return_val_if_fail (extractor != NULL, NULL);
 
+        watch_extraction (guesser, extractor);
         info = gupnp_dlna_metadata_extractor_extract_sync (extractor,
                                                            uri,
                                                            timeout_in_ms,
                                                            &extraction_error);
+        record_latency (guesser,
+                        GUPNP_DLNA_PROFILE_GUESSER_LATENCY_EXTRACTION,
+                        g_get_monotonic_time () - times.extraction_start);
+        set_extractor_times (info, &times);
         profile = NULL;
 
-        if (extraction_error)
+        if (extraction_error) {
+                record_error (guesser);
                 g_propagate_error (error,
                                    extraction_error);
-        else
-                profile = gupnp_dlna_profile_guesser_guess_profile_from_info
-                                        (guesser,
-                                         info);
+        } else
+                profile = guess_extracted_profile (guesser, extractor, info);
 
         if (info) {
                 if (dlna_info)
@@ -377,12 +2163,44 @@ compare_profile_name (GUPnPDLNAProfile *profile, const char *name)
                                    name);
 }
 
+static GUPnPDLNAProfile *
+guess_profile_from_info (GUPnPDLNAProfileView  *view,
+                         GUPnPDLNAProfileOrder *order,
+                         GUPnPDLNAInformation  *info,
+                         GUPnPDLNAGuessCounts  *counts)
+{
+        GList *profiles;
+        const gchar *profile_name;
+
+        profiles = profile_view_get_profiles (view);
+        profile_name = gupnp_dlna_information_get_profile_name (info);
+
+        if (profile_name) {
+                GList *it = NULL;
+                it = g_list_find_custom (profiles,
+                                         profile_name,
+                                         (GCompareFunc) compare_profile_name);
+                if (it != NULL)
+                        return it->data;
+                else
+                        g_warning ("Profile '%s' provided by back-end not known to GUPnP-DLNA",
+                                   profile_name);
+        }
+
+        return gupnp_dlna_profile_guesser_impl_guess_profile
+                                        (info,
+                                         profiles,
+                                         order != NULL ? order->profiles : NULL,
+                                         counts);
+}
+
 /**
  * gupnp_dlna_profile_guesser_guess_profile_from_info:
  * @guesser: The #GUPnPDLNAProfileGuesser object.
  * @info: The #GUPnPDLNAInformation object.
  *
- * Guesses the profile which fits to passed @info.
+ * Guesses the profile which fits to passed @info. This function
+ * can be called from several threads at once.
  *
  * Returns: (transfer none): A #GUPnPDLNAProfile object on success,
  * %NULL otherwise.
@@ -392,52 +2210,148 @@ gupnp_dlna_profile_guesser_guess_profile_from_info
                                         (GUPnPDLNAProfileGuesser *guesser,
                                          GUPnPDLNAInformation    *info)
 {
-        GList *profiles;
-        GUPnPDLNAVideoInformation *video_info;
-        GUPnPDLNAAudioInformation *audio_info;
-        GUPnPDLNAImageInformation *image_info;
+        GUPnPDLNAGuessCounts counts = { 0, 0, FALSE, 0, 0 };
+        GUPnPDLNAProfileGuesserPrivate *priv;
+        GUPnPDLNAProfileView *view;
+        GUPnPDLNAProfileOrder *order;
         GUPnPDLNAProfile *profile;
-        const gchar *profile_name;
+        gint64 start;
+        gint64 time;
 
         g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), NULL);
         g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
 
-        profiles = gupnp_dlna_profile_guesser_list_profiles (guesser);
-        video_info = gupnp_dlna_information_get_video_information (info);
-        audio_info = gupnp_dlna_information_get_audio_information (info);
-        image_info = gupnp_dlna_information_get_image_information (info);
-        profile_name = gupnp_dlna_information_get_profile_name (info);
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        if (priv->daemon != NULL) {
+                GError *error = NULL;
 
-        if (profile_name) {
-                GList *it = NULL;
-                it = g_list_find_custom (profiles,
-                                         profile_name,
-                                         (GCompareFunc) compare_profile_name);
-                if (it != NULL)
-                        return it->data;
-                else
-                        g_warning ("Profile '%s' provided by back-end not known to GUPnP-DLNA",
-                                   profile_name);
+                profile = daemon_guess (guesser, NULL, 0, info, NULL, &error);
+                if (error != NULL) {
+                        g_warning ("Could not guess the profile in the "
+                                   "daemon: %s",
+                                   error->message);
+                        g_error_free (error);
+                }
+
+                return profile;
         }
 
-        if (image_info)
-                profile = gupnp_dlna_profile_guesser_impl_guess_image_profile
-                                        (info,
-                                         profiles);
-        else if (video_info)
-                profile = gupnp_dlna_profile_guesser_impl_guess_video_profile
-                                        (info,
-                                         profiles);
-        else if (audio_info)
-                profile = gupnp_dlna_profile_guesser_impl_guess_audio_profile
-                                        (info,
-                                         profiles);
-        else
-                profile = NULL;
+        start = g_get_monotonic_time ();
+        view = get_profile_view (guesser, &order);
+        profile = guess_profile_from_info (view, order, info, &counts);
+        profile_order_unref (order);
+        time = g_get_monotonic_time () - start;
+
+        gupnp_dlna_information_set_match_stats (info,
+                                                time,
+                                                counts.profiles,
+                                                counts.restrictions,
+                                                counts.rejected_comparisons);
+        record_latency (guesser,
+                        GUPNP_DLNA_PROFILE_GUESSER_LATENCY_MATCHING,
+                        time);
+        record_match (guesser, view, profile, counts.unsupported_match);
+        profile_view_unref (view);
 
         return profile;
 }
 
+/* Guesses of a batch are handed out to the workers in chunks. A
+ * worker takes the next chunk whenever it is done with the previous
+ * one, so faster workers simply end up doing more chunks. */
+#define BATCH_CHUNK_SIZE 16
+
+typedef struct {
+        GUPnPDLNAProfileGuesser *guesser;
+        GPtrArray               *infos;
+        GPtrArray               *profiles;
+        gint                     next;
+} GUPnPDLNAGuessBatch;
+
+static gpointer
+guess_batch_worker (gpointer user_data)
+{
+        GUPnPDLNAGuessBatch *batch = user_data;
+        guint count = batch->infos->len;
+
+        for (;;) {
+                guint start = (guint) g_atomic_int_add (&batch->next,
+                                                        BATCH_CHUNK_SIZE);
+                guint end;
+                guint iter;
+
+                if (start >= count)
+                        break;
+
+                end = MIN (start + BATCH_CHUNK_SIZE, count);
+                for (iter = start; iter < end; ++iter)
+                        g_ptr_array_index (batch->profiles, iter) =
+                           gupnp_dlna_profile_guesser_guess_profile_from_info
+                                        (batch->guesser,
+                                         g_ptr_array_index (batch->infos,
+                                                            iter));
+        }
+
+        return NULL;
+}
+
+/**
+ * gupnp_dlna_profile_guesser_guess_profiles_from_infos:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ * @infos: (element-type GUPnPDLNAInformation): An array of
+ * #GUPnPDLNAInformation objects.
+ * @n_threads: A number of threads to use or 0 to use one thread per
+ * processor.
+ *
+ * Guesses profiles for all the objects in @infos, spreading the work
+ * over @n_threads threads, including the calling one. Each guess is
+ * done the same way as in
+ * gupnp_dlna_profile_guesser_guess_profile_from_info().
+ *
+ * Returns: (transfer container) (element-type GUPnPDLNAProfile): An
+ * array with a #GUPnPDLNAProfile (or %NULL if no profile fits) for
+ * each object in @infos, in the same order.
+ */
+GPtrArray *
+gupnp_dlna_profile_guesser_guess_profiles_from_infos
+                                        (GUPnPDLNAProfileGuesser *guesser,
+                                         GPtrArray               *infos,
+                                         guint                    n_threads)
+{
+        GUPnPDLNAGuessBatch batch;
+        GThread **threads;
+        guint thread_count;
+        guint iter;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), NULL);
+        g_return_val_if_fail (infos != NULL, NULL);
+
+        batch.guesser = guesser;
+        batch.infos = infos;
+        batch.profiles = g_ptr_array_sized_new (infos->len);
+        batch.next = 0;
+        g_ptr_array_set_size (batch.profiles, infos->len);
+
+        if (n_threads == 0)
+                n_threads = g_get_num_processors ();
+        thread_count = MIN (n_threads,
+                            (infos->len + BATCH_CHUNK_SIZE - 1) /
+                            BATCH_CHUNK_SIZE);
+
+        /* the calling thread is one of the workers */
+        threads = g_new (GThread *, MAX (thread_count, 1));
+        for (iter = 1; iter < thread_count; ++iter)
+                threads[iter] = g_thread_new ("gupnp-dlna-guess",
+                                              guess_batch_worker,
+                                              &batch);
+        guess_batch_worker (&batch);
+        for (iter = 1; iter < thread_count; ++iter)
+                g_thread_join (threads[iter]);
+        g_free (threads);
+
+        return batch.profiles;
+}
+
 /**
  * gupnp_dlna_profile_guesser_get_profile:
  * @guesser: The #GUPnPDLNAProfileGuesser object.
@@ -458,10 +2372,7 @@ gupnp_dlna_profile_guesser_get_profile (GUPnPDLNAProfileGuesser *guesser,
         g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), NULL);
         g_return_val_if_fail (name != NULL, NULL);
 
-        GUPnPDLNAProfileGuesserPrivate *priv =
-                gupnp_dlna_profile_guesser_get_instance_private (guesser);
-
-        for (iter = profiles_list[priv->relaxed_mode][priv->extended_mode];
+        for (iter = gupnp_dlna_profile_guesser_list_profiles (guesser);
              iter;
              iter = iter->next) {
                 GUPnPDLNAProfile *profile = GUPNP_DLNA_PROFILE (iter->data);
@@ -486,12 +2397,68 @@ gupnp_dlna_profile_guesser_get_profile (GUPnPDLNAProfileGuesser *guesser,
 GList *
 gupnp_dlna_profile_guesser_list_profiles (GUPnPDLNAProfileGuesser *guesser)
 {
+        GUPnPDLNAProfileGuesserPrivate *priv;
+        GUPnPDLNAProfileView *view;
+        GList *profiles;
+
         g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), NULL);
 
-        GUPnPDLNAProfileGuesserPrivate *priv =
-                gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        if (priv->daemon != NULL) {
+                GError *error = NULL;
+
+                profiles = gupnp_dlna_daemon_client_list_profiles
+                                        (priv->daemon,
+                                         priv->relaxed_mode,
+                                         priv->extended_mode,
+                                         &error);
+                if (error != NULL) {
+                        g_warning ("Failed to list profiles of the guessing "
+                                   "daemon: %s",
+                                   error->message);
+                        g_error_free (error);
+                }
+
+                return profiles;
+        }
+
+        /* the guesser keeps its own reference to the view */
+        view = get_profile_view (guesser, NULL);
+        profiles = profile_view_get_profiles (view);
+        profile_view_unref (view);
+
+        return profiles;
+}
+
+/**
+ * gupnp_dlna_profile_guesser_get_memory_usage:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ *
+ * Gets the size of the arena holding the restrictions, value lists
+ * and values of the DLNA profiles used by @guesser. Guessers with the
+ * same relaxed and extended modes share the profiles.
+ *
+ * The number covers only the arena. The profile objects and the hash
+ * table of each restriction, mapping field names to value lists, are
+ * allocated on the heap and are not counted.
+ *
+ * Returns: Number of bytes in the arena of the profiles, 0 after
+ * gupnp_dlna_profile_guesser_cleanup() was called.
+ */
+gsize
+gupnp_dlna_profile_guesser_get_memory_usage (GUPnPDLNAProfileGuesser *guesser)
+{
+        GUPnPDLNAProfileView *view;
+        gsize usage = 0;
 
-        return profiles_list[priv->relaxed_mode][priv->extended_mode];
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), 0);
+
+        view = get_profile_view (guesser, NULL);
+        if (view->db != NULL)
+                usage = gupnp_dlna_profile_db_get_memory_usage (view->db);
+        profile_view_unref (view);
+
+        return usage;
 }
 
 /**
@@ -527,26 +2494,531 @@ gupnp_dlna_profile_guesser_get_extended_mode (GUPnPDLNAProfileGuesser *guesser)
 }
 
 /**
- * gupnp_dlna_profile_guesser_cleanup:
+ * gupnp_dlna_profile_guesser_get_adaptive_ordering:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ *
+ * Returns: %TRUE if @guesser tries the profiles matched most often
+ * first, %FALSE otherwise.
+ */
+gboolean
+gupnp_dlna_profile_guesser_get_adaptive_ordering
+                                        (GUPnPDLNAProfileGuesser *guesser)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), FALSE);
+
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+
+        return priv->adaptive_ordering;
+}
+
+/**
+ * gupnp_dlna_profile_guesser_get_profile_hits:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ * @profile: A #GUPnPDLNAProfile from the list of @guesser's profiles.
+ *
+ * Returns: A number of guesses that matched @profile.
+ */
+guint
+gupnp_dlna_profile_guesser_get_profile_hits (GUPnPDLNAProfileGuesser *guesser,
+                                             GUPnPDLNAProfile        *profile)
+{
+        GUPnPDLNAProfileView *view;
+        guint slot;
+        guint hits;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), 0);
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE (profile), 0);
+
+        view = get_profile_view (guesser, NULL);
+        slot = GPOINTER_TO_UINT (g_hash_table_lookup (view->profile_slots,
+                                                      profile));
+        hits = (slot > 0 ?
+                (guint) g_atomic_int_get (&view->profile_hits[slot - 1]) :
+                0);
+        profile_view_unref (view);
+
+        return hits;
+}
+
+/**
+ * gupnp_dlna_profile_guesser_get_no_match_count:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ *
+ * Returns: A number of guesses that did not match any profile.
+ */
+guint
+gupnp_dlna_profile_guesser_get_no_match_count
+                                        (GUPnPDLNAProfileGuesser *guesser)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), 0);
+
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+
+        return (guint) g_atomic_int_get (&priv->no_matches);
+}
+
+/**
+ * gupnp_dlna_profile_guesser_get_error_count:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ *
+ * Returns: A number of guesses that failed because metadata of a
+ * media file could not be extracted.
+ */
+guint
+gupnp_dlna_profile_guesser_get_error_count (GUPnPDLNAProfileGuesser *guesser)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), 0);
+
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+
+        return (guint) g_atomic_int_get (&priv->errors);
+}
+
+/**
+ * gupnp_dlna_profile_guesser_get_unsupported_match_count:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ *
+ * Gets a number of guesses that matched a profile only because the
+ * metadata backend could not extract some of the values the profile
+ * restricts. Such matches may be wrong.
  *
- * Cleans up the DLNA profiles. Provided to remove Valgrind noise. Not
- * thread-safe. Do not call it if there is even a slightest chance
- * that profile guessing will be performed during process
- * lifetime. The profiles are not reloaded after cleanup.
+ * Returns: A number of matches involving unsupported values.
+ */
+guint
+gupnp_dlna_profile_guesser_get_unsupported_match_count
+                                        (GUPnPDLNAProfileGuesser *guesser)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), 0);
+
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+
+        return (guint) g_atomic_int_get (&priv->unsupported_matches);
+}
+
+/**
+ * gupnp_dlna_profile_guesser_get_latency_count:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ * @latency: A kind of latency.
+ * @bucket: A histogram bucket, less than
+ * #GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS.
+ *
+ * Gets a number of guesses whose @latency fell into @bucket. See
+ * gupnp_dlna_profile_guesser_get_latency_bucket_limit() for bucket
+ * ranges.
+ *
+ * Returns: A number of guesses.
+ */
+guint
+gupnp_dlna_profile_guesser_get_latency_count
+                                (GUPnPDLNAProfileGuesser        *guesser,
+                                 GUPnPDLNAProfileGuesserLatency  latency,
+                                 guint                           bucket)
+{
+        GUPnPDLNAProfileGuesserPrivate *priv;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), 0);
+        g_return_val_if_fail (latency < GUPNP_DLNA_PROFILE_GUESSER_LATENCY_COUNT,
+                              0);
+        g_return_val_if_fail (bucket < GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS,
+                              0);
+
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+
+        return (guint) g_atomic_int_get (&priv->latencies[latency][bucket]);
+}
+
+/**
+ * gupnp_dlna_profile_guesser_get_latency_bucket_limit:
+ * @bucket: A histogram bucket, less than
+ * #GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS.
+ *
+ * Gets the upper limit of latencies counted in @bucket. A bucket
+ * holds latencies greater than the limit of the previous bucket and
+ * less or equal to its own limit. The last bucket has no limit.
+ *
+ * Returns: A limit in microseconds or %G_MAXINT64 for the last
+ * bucket.
+ */
+gint64
+gupnp_dlna_profile_guesser_get_latency_bucket_limit (guint bucket)
+{
+        g_return_val_if_fail (bucket < GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS,
+                              G_MAXINT64);
+
+        return latency_bucket_limits[bucket];
+}
+
+/**
+ * gupnp_dlna_profile_guesser_reset_stats:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ *
+ * Zeroes all the statistics of @guesser. Guesses running at the same
+ * time may or may not be counted.
  */
 void
-gupnp_dlna_profile_guesser_cleanup (void)
+gupnp_dlna_profile_guesser_reset_stats (GUPnPDLNAProfileGuesser *guesser)
 {
+        GUPnPDLNAProfileGuesserPrivate *priv;
+        GUPnPDLNAProfileView *view;
         guint iter;
+        guint bucket;
+
+        g_return_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser));
+
+        priv = gupnp_dlna_profile_guesser_get_instance_private (guesser);
+        view = get_profile_view (guesser, NULL);
+        for (iter = 0; iter < view->profile_count; ++iter)
+                g_atomic_int_set (&view->profile_hits[iter], 0);
+        profile_view_unref (view);
+        g_atomic_int_set (&priv->no_matches, 0);
+        g_atomic_int_set (&priv->errors, 0);
+        g_atomic_int_set (&priv->unsupported_matches, 0);
+        for (iter = 0; iter < GUPNP_DLNA_PROFILE_GUESSER_LATENCY_COUNT; ++iter)
+                for (bucket = 0;
+                     bucket < GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS;
+                     ++bucket)
+                        g_atomic_int_set (&priv->latencies[iter][bucket], 0);
+}
+
+/**
+ * gupnp_dlna_profile_guesser_save_stats:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ * @filename: A file to save the statistics to.
+ * @error: (allow-none): #GError object or %NULL.
+ *
+ * Saves the numbers of matches of each profile, so they can be
+ * loaded with gupnp_dlna_profile_guesser_load_stats() in a later run.
+ *
+ * Returns: %TRUE on success, %FALSE otherwise.
+ */
+gboolean
+gupnp_dlna_profile_guesser_save_stats (GUPnPDLNAProfileGuesser  *guesser,
+                                       const gchar              *filename,
+                                       GError                  **error)
+{
+        GKeyFile *key_file;
+        GUPnPDLNAProfileView *view;
+        GHashTable *hits; /* <profile name, GArray of gint> */
+        GHashTableIter hits_iter;
+        gpointer name;
+        gpointer name_hits;
+        gboolean saved;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), FALSE);
+        g_return_val_if_fail (filename != NULL, FALSE);
+        g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+        view = get_profile_view (guesser, NULL);
+        hits = profile_view_get_hits (view);
+        profile_view_unref (view);
+
+        key_file = g_key_file_new ();
+        g_hash_table_iter_init (&hits_iter, hits);
+        while (g_hash_table_iter_next (&hits_iter, &name, &name_hits)) {
+                GArray *array = name_hits;
+
+                g_key_file_set_integer_list (key_file,
+                                             STATS_HITS_GROUP,
+                                             name,
+                                             (gint *) array->data,
+                                             array->len);
+        }
+        saved = g_key_file_save_to_file (key_file, filename, error);
+        g_key_file_unref (key_file);
+        g_hash_table_unref (hits);
+
+        return saved;
+}
+
+/**
+ * gupnp_dlna_profile_guesser_load_stats:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ * @filename: A file saved with gupnp_dlna_profile_guesser_save_stats().
+ * @error: (allow-none): #GError object or %NULL.
+ *
+ * Replaces the numbers of matches of the profiles listed in
+ * @filename with the saved ones and reorders the profiles
+ * accordingly, so the order learned in an earlier run is used from
+ * the first guess. Profiles missing in @filename keep their numbers.
+ *
+ * Returns: %TRUE on success, %FALSE otherwise.
+ */
+gboolean
+gupnp_dlna_profile_guesser_load_stats (GUPnPDLNAProfileGuesser  *guesser,
+                                       const gchar              *filename,
+                                       GError                  **error)
+{
+        GUPnPDLNAProfileView *view;
+        GKeyFile *key_file;
+        GHashTable *hits; /* <profile name, GArray of gint> */
+        gchar **names;
+        gchar **name;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), FALSE);
+        g_return_val_if_fail (filename != NULL, FALSE);
+        g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+        key_file = g_key_file_new ();
+        if (!g_key_file_load_from_file (key_file,
+                                        filename,
+                                        G_KEY_FILE_NONE,
+                                        error)) {
+                g_key_file_unref (key_file);
+
+                return FALSE;
+        }
 
-        for (iter = 0; iter < 4; ++iter) {
-                gboolean relaxed = (iter > 1); /* F,F,T,T */
-                gboolean extended = ((iter) % 2 != 0); /* F,T,F,T */
-                guint rel_index = (relaxed ? 1 : 0);
-                guint ext_index = (extended ? 1 : 0);
+        hits = g_hash_table_new_full (g_str_hash,
+                                      g_str_equal,
+                                      g_free,
+                                      (GDestroyNotify) g_array_unref);
+        names = g_key_file_get_keys (key_file, STATS_HITS_GROUP, NULL, NULL);
+        for (name = names; name != NULL && *name != NULL; ++name) {
+                gsize length;
+                gint *name_hits = g_key_file_get_integer_list
+                                        (key_file,
+                                         STATS_HITS_GROUP,
+                                         *name,
+                                         &length,
+                                         NULL);
+                GArray *array;
+
+                if (name_hits == NULL)
+                        continue;
+                array = g_array_sized_new (FALSE, FALSE, sizeof (gint), length);
+                g_array_append_vals (array, name_hits, length);
+                g_hash_table_insert (hits, g_strdup (*name), array);
+                g_free (name_hits);
+        }
+        g_strfreev (names);
+        g_key_file_unref (key_file);
+
+        view = get_profile_view (guesser, NULL);
+        profile_view_set_hits (view, hits);
+        g_hash_table_unref (hits);
+        reorder_profiles (guesser, view);
+        profile_view_unref (view);
+
+        return TRUE;
+}
+
+/**
+ * gupnp_dlna_profile_guesser_save_digests:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ * @filename: A file to save the digests to.
+ * @error: (allow-none): #GError object or %NULL.
+ *
+ * Saves the digests of the profiles of @guesser in their order, so
+ * that after the profiles change, gupnp_dlna_profile_guesser_get_changes()
+ * can tell which guesses are affected.
+ *
+ * Returns: %TRUE on success, %FALSE otherwise.
+ */
+gboolean
+gupnp_dlna_profile_guesser_save_digests (GUPnPDLNAProfileGuesser  *guesser,
+                                         const gchar              *filename,
+                                         GError                  **error)
+{
+        GKeyFile *key_file;
+        GPtrArray *digests;
+        GList *iter;
+        gboolean saved;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), FALSE);
+        g_return_val_if_fail (filename != NULL, FALSE);
+        g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+        digests = g_ptr_array_new ();
+        for (iter = gupnp_dlna_profile_guesser_list_profiles (guesser);
+             iter != NULL;
+             iter = iter->next)
+                g_ptr_array_add (digests,
+                                 (gpointer) gupnp_dlna_profile_get_digest
+                                        (iter->data));
+
+        key_file = g_key_file_new ();
+        g_key_file_set_string_list (key_file,
+                                    DIGESTS_GROUP,
+                                    DIGESTS_KEY,
+                                    (const gchar * const *) digests->pdata,
+                                    digests->len);
+        saved = g_key_file_save_to_file (key_file, filename, error);
+        g_key_file_unref (key_file);
+        g_ptr_array_unref (digests);
+
+        return saved;
+}
+
+/**
+ * gupnp_dlna_profile_guesser_get_changes:
+ * @guesser: The #GUPnPDLNAProfileGuesser object.
+ * @filename: A file saved with gupnp_dlna_profile_guesser_save_digests().
+ * @error: (allow-none): #GError object or %NULL.
+ *
+ * Compares the current profiles of @guesser with the ones saved in
+ * @filename. The result tells which guesses done with the saved
+ * profiles need to be done again, see
+ * gupnp_dlna_profile_changes_affects().
+ *
+ * Returns: (transfer full): A #GUPnPDLNAProfileChanges or %NULL if
+ * @filename could not be read. Free it with
+ * gupnp_dlna_profile_changes_unref().
+ */
+GUPnPDLNAProfileChanges *
+gupnp_dlna_profile_guesser_get_changes (GUPnPDLNAProfileGuesser  *guesser,
+                                        const gchar              *filename,
+                                        GError                  **error)
+{
+        GKeyFile *key_file;
+        gchar **digests;
+        GUPnPDLNAProfileView *view;
+        GUPnPDLNAProfileChanges *changes;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_GUESSER (guesser), NULL);
+        g_return_val_if_fail (filename != NULL, NULL);
+        g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+        key_file = g_key_file_new ();
+        if (!g_key_file_load_from_file (key_file,
+                                        filename,
+                                        G_KEY_FILE_NONE,
+                                        error)) {
+                g_key_file_unref (key_file);
 
-                g_list_free_full (profiles_list[rel_index][ext_index],
-                                  g_object_unref);
-                profiles_list[rel_index][ext_index] = NULL;
+                return NULL;
         }
+        digests = g_key_file_get_string_list (key_file,
+                                              DIGESTS_GROUP,
+                                              DIGESTS_KEY,
+                                              NULL,
+                                              error);
+        g_key_file_unref (key_file);
+        if (digests == NULL)
+                return NULL;
+
+        view = get_profile_view (guesser, NULL);
+        changes = gupnp_dlna_profile_changes_new (view->db, digests);
+        profile_view_unref (view);
+        g_strfreev (digests);
+
+        return changes;
+}
+
+/**
+ * gupnp_dlna_profile_guesser_reload_profiles:
+ *
+ * Loads the DLNA profiles of all the modes in use again. Guesses
+ * running meanwhile finish with the old profiles, every guess started
+ * after this returns uses the new ones. Numbers of matches of the
+ * profiles are carried over to the new profiles with the same names.
+ *
+ * If no profiles could be loaded for a mode, its old profiles are
+ * kept.
+ *
+ * Returns: %TRUE if any profiles were replaced, %FALSE otherwise.
+ */
+gboolean
+gupnp_dlna_profile_guesser_reload_profiles (void)
+{
+        return reload_profile_dbs ();
+}
+
+/**
+ * gupnp_dlna_profile_guesser_enable_reload:
+ *
+ * Starts watching the directory the DLNA profiles are loaded from.
+ * Whenever a file in it changes, the profiles are reloaded in a
+ * background thread as with
+ * gupnp_dlna_profile_guesser_reload_profiles(). Setting the
+ * GUPNP_DLNA_PROFILE_RELOAD environment variable does the same once
+ * the profiles are first loaded.
+ *
+ * Profiles returned by a guesser stay valid until the guesser is
+ * finalized, so every reload keeps the old profiles of a guesser in
+ * memory until then.
+ */
+void
+gupnp_dlna_profile_guesser_enable_reload (void)
+{
+        GMainContext *context;
+        GFile *dir;
+        gchar *path;
+        GError *error = NULL;
+
+        g_mutex_lock (&profile_monitor_lock);
+        if (profile_monitor_thread != NULL) {
+                g_mutex_unlock (&profile_monitor_lock);
+
+                return;
+        }
+
+        /* the monitor reports changes in the thread-default context
+         * of the thread creating it */
+        context = g_main_context_new ();
+        path = gupnp_dlna_profile_loader_get_profile_dir ();
+        dir = g_file_new_for_path (path);
+        g_main_context_push_thread_default (context);
+        profile_monitor = g_file_monitor_directory (dir,
+                                                    G_FILE_MONITOR_WATCH_MOVES,
+                                                    NULL,
+                                                    &error);
+        g_main_context_pop_thread_default (context);
+
+        if (profile_monitor != NULL) {
+                g_debug ("Watching DLNA profiles in %s", path);
+                g_signal_connect (profile_monitor,
+                                  "changed",
+                                  G_CALLBACK (profile_dir_changed_cb),
+                                  context);
+                profile_monitor_loop = g_main_loop_new (context, FALSE);
+                profile_monitor_thread = g_thread_new
+                                        ("gupnp-dlna-profile-monitor",
+                                         profile_monitor_run,
+                                         profile_monitor_loop);
+        } else {
+                g_warning ("Could not watch DLNA profiles in %s: %s",
+                           path,
+                           error->message);
+                g_error_free (error);
+        }
+
+        g_main_context_unref (context);
+        g_object_unref (dir);
+        g_free (path);
+        g_mutex_unlock (&profile_monitor_lock);
+}
+
+/**
+ * gupnp_dlna_profile_guesser_cleanup:
+ *
+ * Cleans up the DLNA profiles and stops watching them. Provided to
+ * remove Valgrind noise. Not thread-safe. Do not call it if there is
+ * even a slightest chance that profile guessing will be performed
+ * during process lifetime. The profiles are not reloaded after
+ * cleanup. Profiles still used by a guesser are released when it is
+ * finalized.
+ */
+void
+gupnp_dlna_profile_guesser_cleanup (void)
+{
+        guint rel_index;
+        guint ext_index;
+
+        disable_reload ();
+
+        g_mutex_lock (&profile_dbs_lock);
+        for (rel_index = 0; rel_index < 2; ++rel_index)
+                for (ext_index = 0; ext_index < 2; ++ext_index)
+                        g_clear_pointer (&profile_dbs[rel_index][ext_index],
+                                         gupnp_dlna_profile_db_unref);
+        profile_dbs_released = TRUE;
+        g_mutex_unlock (&profile_dbs_lock);
 }
@@ -27,11 +27,57 @@
 #include <glib-object.h>
 #include <libgupnp-dlna/gupnp-dlna-profile.h>
 #include <libgupnp-dlna/gupnp-dlna-information.h>
+#include <libgupnp-dlna/gupnp-dlna-profile-changes.h>
 
 G_BEGIN_DECLS
 
 #define GUPNP_TYPE_DLNA_PROFILE_GUESSER (gupnp_dlna_profile_guesser_get_type())
 
+/**
+ * GUPnPDLNAProfileGuesserLatency:
+ * @GUPNP_DLNA_PROFILE_GUESSER_LATENCY_EXTRACTION: Metadata extraction
+ * done by the backend.
+ * @GUPNP_DLNA_PROFILE_GUESSER_LATENCY_MATCHING: Matching metadata
+ * against DLNA profiles.
+ * @GUPNP_DLNA_PROFILE_GUESSER_LATENCY_COUNT: Number of latency
+ * kinds. Not a latency kind.
+ *
+ * Kinds of latencies gathered in histograms by
+ * #GUPnPDLNAProfileGuesser.
+ */
+typedef enum {
+        GUPNP_DLNA_PROFILE_GUESSER_LATENCY_EXTRACTION,
+        GUPNP_DLNA_PROFILE_GUESSER_LATENCY_MATCHING,
+        GUPNP_DLNA_PROFILE_GUESSER_LATENCY_COUNT
+} GUPnPDLNAProfileGuesserLatency;
+
+/**
+ * GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS:
+ *
+ * Number of buckets in latency histograms of
+ * #GUPnPDLNAProfileGuesser.
+ */
+#define GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS 9
+
+/**
+ * GUPnPDLNAGuessPriority:
+ * @GUPNP_DLNA_GUESS_PRIORITY_BULK: A guess nobody is waiting for, like
+ * those of a rescan.
+ * @GUPNP_DLNA_GUESS_PRIORITY_INTERACTIVE: A guess somebody is waiting
+ * for. It jumps the queue of bulk guesses and can use the slots
+ * reserved by #GUPnPDLNAProfileGuesser:interactive-slots.
+ * @GUPNP_DLNA_GUESS_PRIORITY_COUNT: Number of priority classes. Not a
+ * priority class.
+ *
+ * Priority classes of asynchronous guesses, see
+ * gupnp_dlna_profile_guesser_guess_profile_async_full().
+ */
+typedef enum {
+        GUPNP_DLNA_GUESS_PRIORITY_BULK,
+        GUPNP_DLNA_GUESS_PRIORITY_INTERACTIVE,
+        GUPNP_DLNA_GUESS_PRIORITY_COUNT
+} GUPnPDLNAGuessPriority;
+
 G_DECLARE_DERIVABLE_TYPE (GUPnPDLNAProfileGuesser,
                           gupnp_dlna_profile_guesser,
                           GUPNP_DLNA,
@@ -60,6 +106,11 @@ GUPnPDLNAProfileGuesser *
 gupnp_dlna_profile_guesser_new (gboolean relaxed_mode,
                                 gboolean extended_mode);
 
+GUPnPDLNAProfileGuesser *
+gupnp_dlna_profile_guesser_new_for_daemon (gboolean     relaxed_mode,
+                                           gboolean     extended_mode,
+                                           const gchar *socket_path);
+
 /* Asynchronous API */
 gboolean
 gupnp_dlna_profile_guesser_guess_profile_async
@@ -68,6 +119,14 @@ gupnp_dlna_profile_guesser_guess_profile_async
                                         guint                     timeout_in_ms,
                                         GError                  **error);
 
+gboolean
+gupnp_dlna_profile_guesser_guess_profile_async_full
+                                       (GUPnPDLNAProfileGuesser  *guesser,
+                                        const gchar              *uri,
+                                        guint                     timeout_in_ms,
+                                        GUPnPDLNAGuessPriority    priority,
+                                        GError                  **error);
+
 /* Synchronous API */
 GUPnPDLNAProfile *
 gupnp_dlna_profile_guesser_guess_profile_sync
@@ -82,6 +141,12 @@ gupnp_dlna_profile_guesser_guess_profile_from_info
                                         (GUPnPDLNAProfileGuesser *guesser,
                                          GUPnPDLNAInformation    *info);
 
+GPtrArray *
+gupnp_dlna_profile_guesser_guess_profiles_from_infos
+                                        (GUPnPDLNAProfileGuesser *guesser,
+                                         GPtrArray               *infos,
+                                         guint                    n_threads);
+
 /* Get a GUPnPDLNAProfile by name */
 GUPnPDLNAProfile *
 gupnp_dlna_profile_guesser_get_profile (GUPnPDLNAProfileGuesser *guesser,
@@ -91,12 +156,72 @@ gupnp_dlna_profile_guesser_get_profile (GUPnPDLNAProfileGuesser *guesser,
 GList *
 gupnp_dlna_profile_guesser_list_profiles (GUPnPDLNAProfileGuesser *guesser);
 
+gsize
+gupnp_dlna_profile_guesser_get_memory_usage (GUPnPDLNAProfileGuesser *guesser);
+
 gboolean
 gupnp_dlna_profile_guesser_get_relaxed_mode (GUPnPDLNAProfileGuesser *guesser);
 
 gboolean
 gupnp_dlna_profile_guesser_get_extended_mode (GUPnPDLNAProfileGuesser *guesser);
 
+gboolean
+gupnp_dlna_profile_guesser_get_adaptive_ordering
+                                        (GUPnPDLNAProfileGuesser *guesser);
+
+guint
+gupnp_dlna_profile_guesser_get_profile_hits (GUPnPDLNAProfileGuesser *guesser,
+                                             GUPnPDLNAProfile        *profile);
+
+guint
+gupnp_dlna_profile_guesser_get_no_match_count
+                                        (GUPnPDLNAProfileGuesser *guesser);
+
+guint
+gupnp_dlna_profile_guesser_get_error_count (GUPnPDLNAProfileGuesser *guesser);
+
+guint
+gupnp_dlna_profile_guesser_get_unsupported_match_count
+                                        (GUPnPDLNAProfileGuesser *guesser);
+
+guint
+gupnp_dlna_profile_guesser_get_latency_count
+                                (GUPnPDLNAProfileGuesser        *guesser,
+                                 GUPnPDLNAProfileGuesserLatency  latency,
+                                 guint                           bucket);
+
+gint64
+gupnp_dlna_profile_guesser_get_latency_bucket_limit (guint bucket);
+
+void
+gupnp_dlna_profile_guesser_reset_stats (GUPnPDLNAProfileGuesser *guesser);
+
+gboolean
+gupnp_dlna_profile_guesser_save_stats (GUPnPDLNAProfileGuesser  *guesser,
+                                       const gchar              *filename,
+                                       GError                  **error);
+
+gboolean
+gupnp_dlna_profile_guesser_load_stats (GUPnPDLNAProfileGuesser  *guesser,
+                                       const gchar              *filename,
+                                       GError                  **error);
+
+gboolean
+gupnp_dlna_profile_guesser_save_digests (GUPnPDLNAProfileGuesser  *guesser,
+                                         const gchar              *filename,
+                                         GError                  **error);
+
+GUPnPDLNAProfileChanges *
+gupnp_dlna_profile_guesser_get_changes (GUPnPDLNAProfileGuesser  *guesser,
+                                        const gchar              *filename,
+                                        GError                  **error);
+
+gboolean
+gupnp_dlna_profile_guesser_reload_profiles (void);
+
+void
+gupnp_dlna_profile_guesser_enable_reload (void);
+
 void
 gupnp_dlna_profile_guesser_cleanup (void);
 
@@ -47,6 +47,8 @@ struct _GUPnPDLNAProfileLoaderPrivate {
         GList      *dlna_profile_data_stack;
         GList      *restriction_data_stack;
         char       *dlna_profile_dir;
+        /* storage for loaded restrictions, may be NULL */
+        GUPnPDLNAArena *arena;
 };
 typedef struct _GUPnPDLNAProfileLoaderPrivate GUPnPDLNAProfileLoaderPrivate;
 
@@ -124,7 +126,7 @@ gupnp_dlna_name_value_list_pair_free (GUPnPDLNANameValueListPair *pair)
         if (pair == NULL)
                 return;
         g_free (pair->name);
-        gupnp_dlna_value_list_free (pair->list);
+        gupnp_dlna_value_list_unref (pair->list);
         g_slice_free (GUPnPDLNANameValueListPair, pair);
 }
 
@@ -146,7 +148,7 @@ gupnp_dlna_description_free (GUPnPDLNADescription *description)
         if (description == NULL)
                 return;
 
-        gupnp_dlna_restriction_free (description->restriction);
+        gupnp_dlna_restriction_unref (description->restriction);
         g_slice_free (GUPnPDLNADescription, description);
 }
 
@@ -198,8 +200,9 @@ gupnp_dlna_restriction_data_free (GUPnPDLNARestrictionData *data)
                  (data->name_list_pairs,
                   (GDestroyNotify) gupnp_dlna_name_value_list_pair_free);
         if (data->parents != NULL)
-                g_list_free_full (data->parents,
-                                  (GDestroyNotify) gupnp_dlna_restriction_free);
+                g_list_free_full
+                            (data->parents,
+                             (GDestroyNotify) gupnp_dlna_restriction_unref);
         g_slice_free (GUPnPDLNARestrictionData, data);
 }
 
@@ -339,7 +342,11 @@ post_field (GUPnPDLNAProfileLoader *loader,
                 gupnp_dlna_profile_loader_get_instance_private (loader);
         restriction_data =
                 (GUPnPDLNARestrictionData *) priv->restriction_data_stack->data;
-        value_list = gupnp_dlna_value_list_new (value_type);
+        if (priv->arena != NULL)
+                value_list = gupnp_dlna_value_list_new_in_arena (value_type,
+                                                                 priv->arena);
+        else
+                value_list = gupnp_dlna_value_list_new (value_type);
 
         for (iter = values; iter != NULL; iter = iter->next) {
                 GUPnPDLNAFieldValue *field_value =
@@ -363,7 +370,7 @@ merge_restrictions (GUPnPDLNAProfileLoader *loader,
         GUPnPDLNAProfileData* data =
                    (GUPnPDLNAProfileData *) priv->dlna_profile_data_stack->data;
         GList **target_list;
-        GUPnPDLNARestriction *copy;
+        GUPnPDLNARestriction *shared;
 
         if (description == NULL || description->restriction == NULL)
                 return;
@@ -390,8 +397,8 @@ merge_restrictions (GUPnPDLNAProfileLoader *loader,
                 g_assert_not_reached ();
         }
 
-        copy = gupnp_dlna_restriction_copy (description->restriction);
-        *target_list = g_list_prepend (*target_list, copy);
+        shared = gupnp_dlna_restriction_ref (description->restriction);
+        *target_list = g_list_prepend (*target_list, shared);
 }
 
 static void
@@ -416,10 +423,10 @@ collect_parents (GUPnPDLNAProfileLoader *loader,
         if (description != NULL && description->restriction != NULL) {
                 /* Collect parents in a list - we'll
                  * coalesce them later */
-                GUPnPDLNARestriction *copy =
-                         gupnp_dlna_restriction_copy (description->restriction);
+                GUPnPDLNARestriction *shared =
+                          gupnp_dlna_restriction_ref (description->restriction);
 
-                data->parents = g_list_prepend (data->parents, copy);
+                data->parents = g_list_prepend (data->parents, shared);
         }
 }
 
@@ -511,7 +518,11 @@ post_restriction (GUPnPDLNAProfileLoader *loader,
         if (restriction_type == NULL)
                 goto out;
 
-        restriction = gupnp_dlna_restriction_new (name);
+        if (priv->arena != NULL)
+                restriction = gupnp_dlna_restriction_new_in_arena (name,
+                                                                   priv->arena);
+        else
+                restriction = gupnp_dlna_restriction_new (name);
 
         for (iter = data->name_list_pairs; iter != NULL; iter = iter->next) {
                 GUPnPDLNANameValueListPair *pair =
@@ -584,7 +595,7 @@ pre_dlna_profile (GUPnPDLNAProfileLoader *loader)
 }
 
 static GList *
-copy_restrictions_list (GList *list)
+share_restrictions_list (GList *list)
 {
         GList *dup = NULL;
         GList *iter;
@@ -592,11 +603,11 @@ copy_restrictions_list (GList *list)
         for (iter = list; iter != NULL; iter = iter->next) {
                 GUPnPDLNARestriction *restriction =
                                         GUPNP_DLNA_RESTRICTION (iter->data);
-                GUPnPDLNARestriction *copy =
-                                      gupnp_dlna_restriction_copy (restriction);
 
-                if (copy)
-                        dup = g_list_prepend (dup, copy);
+                if (restriction)
+                        dup = g_list_prepend
+                                    (dup,
+                                     gupnp_dlna_restriction_ref (restriction));
         }
 
         return dup;
@@ -616,24 +627,25 @@ merge_base_restrictions (GUPnPDLNAProfileData *data,
                             gupnp_dlna_profile_get_video_restrictions (profile);
 
         if (audio_restrictions != NULL) {
-                GList *copy = copy_restrictions_list (audio_restrictions);
+                GList *shared = share_restrictions_list (audio_restrictions);
 
-                data->audios = g_list_concat (copy, data->audios);
+                data->audios = g_list_concat (shared, data->audios);
         }
         if (container_restrictions != NULL) {
-                GList *copy = copy_restrictions_list (container_restrictions);
+                GList *shared =
+                              share_restrictions_list (container_restrictions);
 
-                data->containers = g_list_concat (copy, data->containers);
+                data->containers = g_list_concat (shared, data->containers);
         }
         if (image_restrictions != NULL) {
-                GList *copy = copy_restrictions_list (image_restrictions);
+                GList *shared = share_restrictions_list (image_restrictions);
 
-                data->images = g_list_concat (copy, data->images);
+                data->images = g_list_concat (shared, data->images);
         }
         if (video_restrictions != NULL) {
-                GList *copy = copy_restrictions_list (video_restrictions);
+                GList *shared = share_restrictions_list (video_restrictions);
 
-                data->videos = g_list_concat (copy, data->videos);
+                data->videos = g_list_concat (shared, data->videos);
         }
 }
 
@@ -669,6 +681,7 @@ create_profile (GUPnPDLNAProfileLoader *loader,
         GList *container_restrictions = NULL;
         GList *image_restrictions = NULL;
         GList *video_restrictions = NULL;
+        GUPnPDLNAProfile *profile;
 
         /* Inherit from base profile, if it exists */
         if (base != NULL)
@@ -692,13 +705,16 @@ create_profile (GUPnPDLNAProfileLoader *loader,
                 data->videos = NULL;
         }
 
-        return gupnp_dlna_profile_new (name,
-                                       mime,
-                                       audio_restrictions,
-                                       container_restrictions,
-                                       image_restrictions,
-                                       video_restrictions,
-                                       extended);
+        profile = gupnp_dlna_profile_new (name,
+                                          mime,
+                                          audio_restrictions,
+                                          container_restrictions,
+                                          image_restrictions,
+                                          video_restrictions,
+                                          extended);
+        gupnp_dlna_profile_set_arena (profile, priv->arena);
+
+        return profile;
 }
 
 static void
@@ -716,6 +732,86 @@ post_dlna_profile (GUPnPDLNAProfileLoader *loader)
                                          priv->dlna_profile_data_stack);
 }
 
+static void
+append_restrictions (GString     *str,
+                     const gchar *kind,
+                     GList       *restrictions)
+{
+        GList *iter;
+
+        for (iter = restrictions; iter != NULL; iter = iter->next) {
+                GUPnPDLNARestriction *restriction = iter->data;
+                const gchar *mime;
+                GList *names;
+                GList *name;
+
+                if (restriction == NULL)
+                        continue;
+
+                mime = gupnp_dlna_restriction_get_mime (restriction);
+                g_string_append_printf (str,
+                                        "%s %s\n",
+                                        kind,
+                                        mime != NULL ? mime : "(null)");
+                /* the order of the entries in the table is arbitrary */
+                names = g_hash_table_get_keys
+                                (gupnp_dlna_restriction_get_entries
+                                        (restriction));
+                names = g_list_sort (names, (GCompareFunc) g_strcmp0);
+                for (name = names; name != NULL; name = name->next) {
+                        gchar *values = gupnp_dlna_value_list_to_string
+                                (g_hash_table_lookup
+                                        (gupnp_dlna_restriction_get_entries
+                                                (restriction),
+                                         name->data));
+
+                        g_string_append_printf (str,
+                                                " %s=%s\n",
+                                                (gchar *) name->data,
+                                                values);
+                        g_free (values);
+                }
+                g_list_free (names);
+        }
+}
+
+/* The digest covers everything deciding which media match the
+ * profile, so it only changes when its matching changes. */
+static void
+set_digest (GUPnPDLNAProfile *profile)
+{
+        GString *str = g_string_new (NULL);
+        gchar *digest;
+
+        g_string_append_printf (str,
+                                "%s\n%s\n%d\n",
+                                gupnp_dlna_profile_get_name (profile),
+                                gupnp_dlna_profile_get_mime (profile),
+                                gupnp_dlna_profile_get_extended (profile));
+        append_restrictions (str,
+                             "audio",
+                             gupnp_dlna_profile_get_audio_restrictions
+                                        (profile));
+        append_restrictions (str,
+                             "container",
+                             gupnp_dlna_profile_get_container_restrictions
+                                        (profile));
+        append_restrictions (str,
+                             "image",
+                             gupnp_dlna_profile_get_image_restrictions
+                                        (profile));
+        append_restrictions (str,
+                             "video",
+                             gupnp_dlna_profile_get_video_restrictions
+                                        (profile));
+        digest = g_compute_checksum_for_data (G_CHECKSUM_SHA256,
+                                              (const guchar *) str->str,
+                                              str->len);
+        gupnp_dlna_profile_set_digest (profile, digest);
+        g_free (digest);
+        g_string_free (str, TRUE);
+}
+
 static GList *
 cleanup (GUPnPDLNAProfileLoader *loader G_GNUC_UNUSED,
          GList *profiles)
@@ -753,6 +849,7 @@ cleanup (GUPnPDLNAProfileLoader *loader G_GNUC_UNUSED,
                 gchar *vcaps = gupnp_dlna_utils_restrictions_list_to_string
                           (gupnp_dlna_profile_get_video_restrictions (profile));
 
+                set_digest (profile);
                 g_debug ("Loaded profile: %s\nMIME: %s\naudio caps: %s\n"
                          "container caps: %s\nimage caps: %s\nvideo caps: %s\n",
                          gupnp_dlna_profile_get_name (profile),
@@ -1565,6 +1662,46 @@ gupnp_dlna_profile_loader_new (gboolean relaxed_mode,
                                          NULL));
 }
 
+/*
+ * Makes the loader allocate restrictions and their values in @arena,
+ * so they can be released together with it. Every loaded profile
+ * holds a reference to the arena.
+ */
+void
+gupnp_dlna_profile_loader_set_arena (GUPnPDLNAProfileLoader *loader,
+                                     GUPnPDLNAArena         *arena)
+{
+        g_return_if_fail (GUPNP_DLNA_IS_PROFILE_LOADER (loader));
+        GUPnPDLNAProfileLoaderPrivate *priv =
+                gupnp_dlna_profile_loader_get_instance_private (loader);
+
+        priv->arena = arena;
+}
+
+/*
+ * Gets the directory the profiles are loaded from - the one in
+ * GUPNP_DLNA_PROFILE_DIR environment variable if it is an absolute
+ * path, the installed one otherwise.
+ *
+ * Returns: The path. Free it with g_free().
+ */
+gchar *
+gupnp_dlna_profile_loader_get_profile_dir (void)
+{
+        char **env = g_get_environ ();
+        const char *profile_dir = g_environ_getenv (env,
+                                                    "GUPNP_DLNA_PROFILE_DIR");
+        gchar *dir;
+
+        if (profile_dir != NULL && g_path_is_absolute (profile_dir))
+                dir = g_strdup (profile_dir);
+        else
+                dir = g_strdup (DLNA_DATA_DIR);
+        g_strfreev (env);
+
+        return dir;
+}
+
 GList *
 gupnp_dlna_profile_loader_get_from_disk (GUPnPDLNAProfileLoader *loader)
 {
@@ -1574,21 +1711,9 @@ gupnp_dlna_profile_loader_get_from_disk (GUPnPDLNAProfileLoader *loader)
         GUPnPDLNAProfileLoaderPrivate *priv =
                 gupnp_dlna_profile_loader_get_instance_private (loader);
 
-        if (priv->dlna_profile_dir == NULL) {
-                char **env = NULL;
-                const char *profile_dir = NULL;
-
-                env = g_get_environ ();
-                profile_dir = g_environ_getenv (env, "GUPNP_DLNA_PROFILE_DIR");
-                if (profile_dir != NULL && g_path_is_absolute (profile_dir)) {
-                        priv->dlna_profile_dir = g_strdup (profile_dir);
-                } else {
-                        priv->dlna_profile_dir = g_strdup (DLNA_DATA_DIR);
-                }
-
-
-                g_strfreev (env);
-        }
+        if (priv->dlna_profile_dir == NULL)
+                priv->dlna_profile_dir =
+                                gupnp_dlna_profile_loader_get_profile_dir ();
 
         profiles =
                 gupnp_dlna_profile_loader_get_from_dir (loader,
@@ -1598,3 +1723,47 @@ gupnp_dlna_profile_loader_get_from_disk (GUPnPDLNAProfileLoader *loader)
 
         return cleanup (loader, profiles);
 }
+
+/*
+ * Reads the profile analysis written by gupnp-dlna-ls-profiles into
+ * the directory the profiles were loaded from. Call it after
+ * gupnp_dlna_profile_loader_get_from_disk().
+ *
+ * Returns: The analysis or %NULL if there is none. Free it with
+ * g_key_file_unref().
+ */
+GKeyFile *
+gupnp_dlna_profile_loader_load_analysis (GUPnPDLNAProfileLoader *loader)
+{
+        GKeyFile *key_file;
+        gchar *path;
+        GError *error = NULL;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE_LOADER (loader), NULL);
+        GUPnPDLNAProfileLoaderPrivate *priv =
+                gupnp_dlna_profile_loader_get_instance_private (loader);
+
+        if (priv->dlna_profile_dir == NULL)
+                return NULL;
+
+        path = g_build_filename (priv->dlna_profile_dir,
+                                 GUPNP_DLNA_PROFILE_ANALYSIS_FILE,
+                                 NULL);
+        key_file = g_key_file_new ();
+        if (!g_key_file_load_from_file (key_file,
+                                        path,
+                                        G_KEY_FILE_NONE,
+                                        &error)) {
+                if (!g_error_matches (error,
+                                      G_FILE_ERROR,
+                                      G_FILE_ERROR_NOENT))
+                        g_warning ("Failed to read profile analysis %s: %s",
+                                   path,
+                                   error->message);
+                g_error_free (error);
+                g_clear_pointer (&key_file, g_key_file_unref);
+        }
+        g_free (path);
+
+        return key_file;
+}
@@ -28,9 +28,14 @@
 #include <glib-object.h>
 #include "gupnp-dlna-profile.h"
 #include "gupnp-dlna-field-value.h"
+#include "gupnp-dlna-arena.h"
 
 G_BEGIN_DECLS
 
+/* Name of the file in the profile directory holding the analysis of
+ * the profiles, see gupnp_dlna_profile_loader_load_analysis(). */
+#define GUPNP_DLNA_PROFILE_ANALYSIS_FILE "profile-analysis.ini"
+
 G_DECLARE_DERIVABLE_TYPE (GUPnPDLNAProfileLoader,
                           gupnp_dlna_profile_loader,
                           GUPNP_DLNA,
@@ -59,9 +64,19 @@ GUPnPDLNAProfileLoader *
 gupnp_dlna_profile_loader_new (gboolean relaxed_mode,
                                gboolean extended_mode);
 
+void
+gupnp_dlna_profile_loader_set_arena (GUPnPDLNAProfileLoader *loader,
+                                     GUPnPDLNAArena         *arena);
+
+gchar *
+gupnp_dlna_profile_loader_get_profile_dir (void);
+
 GList *
 gupnp_dlna_profile_loader_get_from_disk (GUPnPDLNAProfileLoader *loader);
 
+GKeyFile *
+gupnp_dlna_profile_loader_load_analysis (GUPnPDLNAProfileLoader *loader);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_PROFILE_LOADER_H__ */
@@ -24,6 +24,7 @@
 
 #include <glib-object.h>
 #include "gupnp-dlna-profile.h"
+#include "gupnp-dlna-arena.h"
 
 G_BEGIN_DECLS
 
@@ -36,6 +37,22 @@ gupnp_dlna_profile_new (const gchar *name,
                         GList       *video_restrictions,
                         gboolean     extended);
 
+void
+gupnp_dlna_profile_set_arena (GUPnPDLNAProfile *profile,
+                              GUPnPDLNAArena   *arena);
+
+void
+gupnp_dlna_profile_set_digest (GUPnPDLNAProfile *profile,
+                               const gchar      *digest);
+
+gboolean
+gupnp_dlna_profile_may_overlap (GUPnPDLNAProfile *profile,
+                                GUPnPDLNAProfile *other);
+
+gboolean
+gupnp_dlna_profile_covers (GUPnPDLNAProfile *profile,
+                           GUPnPDLNAProfile *other);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_PROFILE_PRIVATE_H__ */
@@ -23,6 +23,7 @@
 
 #include "gupnp-dlna-profile.h"
 #include "gupnp-dlna-profile-private.h"
+#include "gupnp-dlna-restriction-private.h"
 
 /**
  * SECTION:gupnp-dlna-profile
@@ -47,11 +48,14 @@
 struct _GUPnPDLNAProfilePrivate {
         gchar    *name;
         gchar    *mime;
+        gchar    *digest;
         gboolean  extended;
         GList    *audio_restrictions;
         GList    *container_restrictions;
         GList    *image_restrictions;
         GList    *video_restrictions;
+        /* holds the restrictions if they were loaded in an arena */
+        GUPnPDLNAArena *arena;
 };
 typedef struct _GUPnPDLNAProfilePrivate GUPnPDLNAProfilePrivate;
 
@@ -185,10 +189,13 @@ gupnp_dlna_profile_finalize (GObject *object)
 
         g_free (priv->name);
         g_free (priv->mime);
+        g_free (priv->digest);
         free_restrictions (priv->audio_restrictions);
         free_restrictions (priv->container_restrictions);
         free_restrictions (priv->image_restrictions);
         free_restrictions (priv->video_restrictions);
+        /* the restrictions are gone, their memory can go too */
+        gupnp_dlna_arena_unref (priv->arena);
 
         G_OBJECT_CLASS (gupnp_dlna_profile_parent_class)->finalize (object);
 }
@@ -332,6 +339,58 @@ gupnp_dlna_profile_get_extended (GUPnPDLNAProfile *profile)
         return priv->extended;
 }
 
+/* Profiles whose restrictions were loaded in @arena keep it alive, so
+ * they stay usable after their profile database is gone. */
+void
+gupnp_dlna_profile_set_arena (GUPnPDLNAProfile *profile,
+                              GUPnPDLNAArena   *arena)
+{
+        g_return_if_fail (GUPNP_DLNA_IS_PROFILE (profile));
+        GUPnPDLNAProfilePrivate *priv =
+                gupnp_dlna_profile_get_instance_private (profile);
+
+        if (arena != NULL)
+                gupnp_dlna_arena_ref (arena);
+        gupnp_dlna_arena_unref (priv->arena);
+        priv->arena = arena;
+}
+
+/**
+ * gupnp_dlna_profile_get_digest:
+ * @profile: The #GUPnPDLNAProfile object.
+ *
+ * Gets a digest of everything deciding which media match @profile -
+ * its name, MIME type and restrictions, including the inherited ones.
+ * It changes whenever a change of the profile files changes the
+ * profile, so it can be stored with a guessed profile to find out
+ * which guesses a change of the profiles affects, see
+ * gupnp_dlna_profile_guesser_get_changes().
+ *
+ * Returns: A hexadecimal SHA-256 digest or %NULL for profiles
+ * returned by gupnp-dlna-daemon-2.0.
+ */
+const gchar *
+gupnp_dlna_profile_get_digest (GUPnPDLNAProfile *profile)
+{
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE (profile), NULL);
+        GUPnPDLNAProfilePrivate *priv =
+                gupnp_dlna_profile_get_instance_private (profile);
+
+        return priv->digest;
+}
+
+void
+gupnp_dlna_profile_set_digest (GUPnPDLNAProfile *profile,
+                               const gchar      *digest)
+{
+        g_return_if_fail (GUPNP_DLNA_IS_PROFILE (profile));
+        GUPnPDLNAProfilePrivate *priv =
+                gupnp_dlna_profile_get_instance_private (profile);
+
+        g_free (priv->digest);
+        priv->digest = g_strdup (digest);
+}
+
 /**
  * gupnp_dlna_profile_get_audio_restrictions:
  * @profile: (transfer none): A profile.
@@ -429,3 +488,174 @@ gupnp_dlna_profile_new (const gchar *name,
                                "extended", extended,
                                NULL));
 }
+
+/* Restriction lists are alternatives - a stream matches the list if
+ * it fits any of them. An empty list matches nothing. */
+static gboolean
+restrictions_may_overlap (GList *restrictions,
+                          GList *other)
+{
+        GList *iter;
+        GList *other_iter;
+
+        for (iter = restrictions; iter != NULL; iter = iter->next)
+                for (other_iter = other;
+                     other_iter != NULL;
+                     other_iter = other_iter->next)
+                        if (gupnp_dlna_restriction_may_overlap
+                                        (iter->data,
+                                         other_iter->data))
+                                return TRUE;
+
+        return FALSE;
+}
+
+/* A profile without container restrictions matches only streams
+ * without a container and vice versa. */
+static gboolean
+containers_may_overlap (GUPnPDLNAProfilePrivate *priv,
+                        GUPnPDLNAProfilePrivate *other)
+{
+        if (priv->container_restrictions == NULL ||
+            other->container_restrictions == NULL)
+                return (priv->container_restrictions ==
+                        other->container_restrictions);
+
+        return restrictions_may_overlap (priv->container_restrictions,
+                                         other->container_restrictions);
+}
+
+/* Mirrors which restrictions are checked when guessing a profile
+ * for an audio, a video and an image media. */
+static gboolean
+is_video (GUPnPDLNAProfilePrivate *priv)
+{
+        return (priv->container_restrictions != NULL &&
+                priv->video_restrictions != NULL);
+}
+
+/* Checks whether some media could match both @profile and @other,
+ * assuming its metadata has no unsupported values. Profiles that may
+ * not overlap can be tried in any order without changing the result
+ * of a guess. */
+gboolean
+gupnp_dlna_profile_may_overlap (GUPnPDLNAProfile *profile,
+                                GUPnPDLNAProfile *other)
+{
+        GUPnPDLNAProfilePrivate *priv;
+        GUPnPDLNAProfilePrivate *other_priv;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE (profile), TRUE);
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE (other), TRUE);
+
+        if (profile == other)
+                return TRUE;
+
+        priv = gupnp_dlna_profile_get_instance_private (profile);
+        other_priv = gupnp_dlna_profile_get_instance_private (other);
+
+        /* image */
+        if (restrictions_may_overlap (priv->image_restrictions,
+                                      other_priv->image_restrictions))
+                return TRUE;
+
+        /* audio and video share the audio and the container checks */
+        if (!restrictions_may_overlap (priv->audio_restrictions,
+                                       other_priv->audio_restrictions) ||
+            !containers_may_overlap (priv, other_priv))
+                return FALSE;
+
+        /* audio */
+        if (!is_video (priv) && !is_video (other_priv))
+                return TRUE;
+
+        /* video */
+        return restrictions_may_overlap (priv->video_restrictions,
+                                         other_priv->video_restrictions);
+}
+
+static gboolean
+restrictions_cover (GList *restrictions,
+                    GList *other)
+{
+        GList *iter;
+        GList *other_iter;
+
+        for (other_iter = other;
+             other_iter != NULL;
+             other_iter = other_iter->next) {
+                for (iter = restrictions; iter != NULL; iter = iter->next)
+                        if (gupnp_dlna_restriction_covers (iter->data,
+                                                           other_iter->data))
+                                break;
+                if (iter == NULL)
+                        return FALSE;
+        }
+
+        return TRUE;
+}
+
+static gboolean
+containers_cover (GUPnPDLNAProfilePrivate *priv,
+                  GUPnPDLNAProfilePrivate *other)
+{
+        if (priv->container_restrictions == NULL ||
+            other->container_restrictions == NULL)
+                return (priv->container_restrictions ==
+                        other->container_restrictions);
+
+        return restrictions_cover (priv->container_restrictions,
+                                   other->container_restrictions);
+}
+
+/* Checks whether every media matching @other also matches @profile,
+ * so @other is never returned by a guess if it comes after
+ * @profile. Only simple cases are recognized, so this may give false
+ * negatives. A profile matching no media is not covered by anything.
+ */
+gboolean
+gupnp_dlna_profile_covers (GUPnPDLNAProfile *profile,
+                           GUPnPDLNAProfile *other)
+{
+        GUPnPDLNAProfilePrivate *priv;
+        GUPnPDLNAProfilePrivate *other_priv;
+        gboolean matches_any = FALSE;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE (profile), FALSE);
+        g_return_val_if_fail (GUPNP_DLNA_IS_PROFILE (other), FALSE);
+
+        priv = gupnp_dlna_profile_get_instance_private (profile);
+        other_priv = gupnp_dlna_profile_get_instance_private (other);
+
+        /* image */
+        if (other_priv->image_restrictions != NULL) {
+                if (!restrictions_cover (priv->image_restrictions,
+                                         other_priv->image_restrictions))
+                        return FALSE;
+                matches_any = TRUE;
+        }
+
+        /* audio */
+        if (other_priv->audio_restrictions != NULL && !is_video (other_priv)) {
+                if (is_video (priv) ||
+                    !restrictions_cover (priv->audio_restrictions,
+                                         other_priv->audio_restrictions) ||
+                    !containers_cover (priv, other_priv))
+                        return FALSE;
+                matches_any = TRUE;
+        }
+
+        /* video */
+        if (other_priv->audio_restrictions != NULL &&
+            other_priv->video_restrictions != NULL) {
+                if (!restrictions_cover (priv->video_restrictions,
+                                         other_priv->video_restrictions) ||
+                    !restrictions_cover (priv->audio_restrictions,
+                                         other_priv->audio_restrictions) ||
+                    !containers_cover (priv, other_priv))
+                        return FALSE;
+                matches_any = TRUE;
+        }
+
+        return matches_any;
+}
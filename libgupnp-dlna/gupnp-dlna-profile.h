@@ -64,6 +64,9 @@ gupnp_dlna_profile_get_mime (GUPnPDLNAProfile *profile);
 gboolean
 gupnp_dlna_profile_get_extended (GUPnPDLNAProfile *profile);
 
+const gchar *
+gupnp_dlna_profile_get_digest (GUPnPDLNAProfile *profile);
+
 GList *
 gupnp_dlna_profile_get_container_restrictions (GUPnPDLNAProfile *profile);
 
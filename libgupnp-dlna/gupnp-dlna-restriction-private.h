@@ -24,14 +24,30 @@
 
 #include <glib.h>
 #include <glib-object.h>
+#include "gupnp-dlna-arena.h"
 #include "gupnp-dlna-restriction.h"
 #include "gupnp-dlna-value-list.h"
 
 G_BEGIN_DECLS
 
+typedef struct {
+        const gchar        *name; /* interned */
+        GUPnPDLNAValueList *list;
+} GUPnPDLNARestrictionField;
+
 GUPnPDLNARestriction *
 gupnp_dlna_restriction_new (const gchar *mime);
 
+GUPnPDLNARestriction *
+gupnp_dlna_restriction_new_in_arena (const gchar    *mime,
+                                     GUPnPDLNAArena *arena);
+
+GUPnPDLNARestriction *
+gupnp_dlna_restriction_ref (GUPnPDLNARestriction *restriction);
+
+void
+gupnp_dlna_restriction_unref (GUPnPDLNARestriction *restriction);
+
 gboolean
 gupnp_dlna_restriction_add_value_list (GUPnPDLNARestriction *restriction,
                                        const gchar          *name,
@@ -41,6 +57,21 @@ void
 gupnp_dlna_restriction_merge (GUPnPDLNARestriction *restriction,
                               GUPnPDLNARestriction *merged);
 
+gboolean
+gupnp_dlna_restriction_may_overlap (GUPnPDLNARestriction *restriction,
+                                    GUPnPDLNARestriction *other);
+
+gboolean
+gupnp_dlna_restriction_covers (GUPnPDLNARestriction *restriction,
+                               GUPnPDLNARestriction *other);
+
+void
+gupnp_dlna_restriction_order_fields (GUPnPDLNARestriction *restriction);
+
+GUPnPDLNARestrictionField *
+gupnp_dlna_restriction_get_ordered_fields (GUPnPDLNARestriction *restriction,
+                                           guint                *count);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_RESTRICTION_PRIVATE_H__ */
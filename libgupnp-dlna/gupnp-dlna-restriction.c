@@ -19,14 +19,25 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <stdlib.h>
 #include <glib.h>
 
 #include "gupnp-dlna-restriction-private.h"
 #include "gupnp-dlna-value-list-private.h"
 
+/* Restrictions are immutable once the profile loader is done with
+ * them, so they are refcounted and shared between profiles inheriting
+ * from each other instead of being deep-copied. MIME types and entry
+ * names come from a small, fixed vocabulary, so they are interned. */
 struct _GUPnPDLNARestriction {
-        gchar *mime;
-        GHashTable *entries; /* <gchar *, GUPnPDLNAValueList *> */
+        const gchar *mime;
+        GHashTable *entries; /* <interned gchar *, GUPnPDLNAValueList *> */
+        /* entries, most selective first, see
+         * gupnp_dlna_restriction_order_fields() */
+        GUPnPDLNARestrictionField *fields;
+        guint field_count;
+        gint ref_count;
+        GUPnPDLNAArena *arena; /* NULL if allocated on the heap */
 };
 
 G_DEFINE_BOXED_TYPE (GUPnPDLNARestriction,
@@ -39,20 +50,79 @@ gupnp_dlna_restriction_new (const gchar *mime)
 {
         GUPnPDLNARestriction *restriction = g_slice_new (GUPnPDLNARestriction);
 
-        restriction->mime = g_strdup (mime);
+        restriction->mime = g_intern_string (mime);
         restriction->entries = g_hash_table_new_full
                            (g_str_hash,
                             g_str_equal,
-                            g_free,
-                            (GDestroyNotify) gupnp_dlna_value_list_free);
+                            NULL,
+                            (GDestroyNotify) gupnp_dlna_value_list_unref);
+        restriction->fields = NULL;
+        restriction->field_count = 0;
+        restriction->ref_count = 1;
+        restriction->arena = NULL;
 
         return restriction;
 }
 
+/* Like gupnp_dlna_value_list_new_in_arena(), restrictions allocated
+ * in an arena live as long as the arena does. */
+GUPnPDLNARestriction *
+gupnp_dlna_restriction_new_in_arena (const gchar    *mime,
+                                     GUPnPDLNAArena *arena)
+{
+        GUPnPDLNARestriction *restriction;
+
+        g_return_val_if_fail (arena != NULL, NULL);
+
+        restriction = gupnp_dlna_arena_alloc (arena,
+                                              sizeof (GUPnPDLNARestriction));
+        restriction->mime = g_intern_string (mime);
+        restriction->entries = g_hash_table_new_full
+                           (g_str_hash,
+                            g_str_equal,
+                            NULL,
+                            (GDestroyNotify) gupnp_dlna_value_list_unref);
+        restriction->fields = NULL;
+        restriction->field_count = 0;
+        restriction->ref_count = 1;
+        restriction->arena = arena;
+        gupnp_dlna_arena_add_cleanup (arena,
+                                      (GDestroyNotify) g_hash_table_unref,
+                                      restriction->entries);
+
+        return restriction;
+}
+
+GUPnPDLNARestriction *
+gupnp_dlna_restriction_ref (GUPnPDLNARestriction *restriction)
+{
+        g_return_val_if_fail (restriction != NULL, NULL);
+
+        if (restriction->arena == NULL)
+                g_atomic_int_inc (&restriction->ref_count);
+
+        return restriction;
+}
+
+void
+gupnp_dlna_restriction_unref (GUPnPDLNARestriction *restriction)
+{
+        if (restriction == NULL || restriction->arena != NULL)
+                return;
+        if (!g_atomic_int_dec_and_test (&restriction->ref_count))
+                return;
+        g_hash_table_unref (restriction->entries);
+        g_free (restriction->fields);
+        g_slice_free (GUPnPDLNARestriction, restriction);
+}
+
 /**
  * gupnp_dlna_restriction_copy:
  * @restriction: (transfer none): A restriction to copy.
  *
+ * Restrictions are immutable, so the copy usually shares its contents
+ * with @restriction.
+ *
  * Returns: (transfer full): A copy of @restriction.
  */
 GUPnPDLNARestriction *
@@ -65,19 +135,16 @@ gupnp_dlna_restriction_copy (GUPnPDLNARestriction *restriction)
 
         g_return_val_if_fail (restriction != NULL, NULL);
 
+        if (restriction->arena == NULL)
+                return gupnp_dlna_restriction_ref (restriction);
+
+        /* The copy may outlive the arena, so move it to the heap. */
         dup = gupnp_dlna_restriction_new (restriction->mime);
         g_hash_table_iter_init (&iter, restriction->entries);
-        while (g_hash_table_iter_next (&iter, &key, &value)) {
-                GUPnPDLNAValueList *dup_entry;
-
-                if (key == NULL || value == NULL)
-                        continue;
-                dup_entry = gupnp_dlna_value_list_copy (value);
-
-                if (dup_entry == NULL)
-                        continue;
-                g_hash_table_insert (dup->entries, g_strdup (key), dup_entry);
-        }
+        while (g_hash_table_iter_next (&iter, &key, &value))
+                g_hash_table_insert (dup->entries,
+                                     key,
+                                     gupnp_dlna_value_list_copy (value));
 
         return dup;
 }
@@ -91,11 +158,7 @@ gupnp_dlna_restriction_copy (GUPnPDLNARestriction *restriction)
 void
 gupnp_dlna_restriction_free (GUPnPDLNARestriction *restriction)
 {
-        if (restriction == NULL)
-                return;
-        g_free (restriction->mime);
-        g_hash_table_unref (restriction->entries);
-        g_slice_free (GUPnPDLNARestriction, restriction);
+        gupnp_dlna_restriction_unref (restriction);
 }
 
 gboolean
@@ -106,13 +169,17 @@ gupnp_dlna_restriction_add_value_list (GUPnPDLNARestriction *restriction,
         g_return_val_if_fail (restriction != NULL, FALSE);
         g_return_val_if_fail (name != NULL, FALSE);
         g_return_val_if_fail (list != NULL, FALSE);
+        g_return_val_if_fail (restriction->ref_count == 1, FALSE);
+        g_return_val_if_fail (restriction->fields == NULL, FALSE);
 
         if (gupnp_dlna_value_list_is_empty (list))
                 return FALSE;
         if (g_hash_table_contains (restriction->entries, name))
                 return FALSE;
         gupnp_dlna_value_list_sort_items (list);
-        g_hash_table_insert (restriction->entries, g_strdup (name), list);
+        g_hash_table_insert (restriction->entries,
+                             (gpointer) g_intern_string (name),
+                             list);
 
         return TRUE;
 }
@@ -127,24 +194,88 @@ gupnp_dlna_restriction_merge (GUPnPDLNARestriction *restriction,
 
         g_return_if_fail (restriction != NULL);
         g_return_if_fail (merged != NULL);
+        g_return_if_fail (restriction->ref_count == 1);
+        g_return_if_fail (restriction->fields == NULL);
 
-        if (restriction->mime == NULL) {
+        if (restriction->mime == NULL)
                 restriction->mime = merged->mime;
-                merged->mime = NULL;
-        }
 
+        /* merged may be shared with other restrictions, so take
+         * references to its value lists instead of stealing them. */
         g_hash_table_iter_init (&iter, merged->entries);
         while (g_hash_table_iter_next (&iter,
                                        &name_ptr,
-                                       &value_list_ptr)) {
-                if (!g_hash_table_contains (restriction->entries, name_ptr)) {
-                        g_hash_table_iter_steal (&iter);
-                        g_hash_table_insert (restriction->entries,
-                                             name_ptr,
-                                             value_list_ptr);
-                }
+                                       &value_list_ptr))
+                if (!g_hash_table_contains (restriction->entries, name_ptr))
+                        g_hash_table_insert
+                                  (restriction->entries,
+                                   name_ptr,
+                                   gupnp_dlna_value_list_ref (value_list_ptr));
+        gupnp_dlna_restriction_unref (merged);
+}
+
+/* Checks whether some info set could fit both restrictions. A field
+ * restricted by only one of them may hold any value, so only the
+ * fields restricted by both have to have a value in common. */
+gboolean
+gupnp_dlna_restriction_may_overlap (GUPnPDLNARestriction *restriction,
+                                    GUPnPDLNARestriction *other)
+{
+        GHashTableIter iter;
+        gpointer name_ptr;
+        gpointer value_list_ptr;
+
+        g_return_val_if_fail (restriction != NULL, TRUE);
+        g_return_val_if_fail (other != NULL, TRUE);
+
+        if (g_strcmp0 (restriction->mime, other->mime))
+                return FALSE;
+
+        g_hash_table_iter_init (&iter, restriction->entries);
+        while (g_hash_table_iter_next (&iter, &name_ptr, &value_list_ptr)) {
+                GUPnPDLNAValueList *other_list =
+                                    g_hash_table_lookup (other->entries,
+                                                         name_ptr);
+
+                if (other_list != NULL &&
+                    !gupnp_dlna_value_list_intersects (value_list_ptr,
+                                                       other_list))
+                        return FALSE;
+        }
+
+        return TRUE;
+}
+
+/* Checks whether every info set fitting @other also fits
+ * @restriction. */
+gboolean
+gupnp_dlna_restriction_covers (GUPnPDLNARestriction *restriction,
+                               GUPnPDLNARestriction *other)
+{
+        GHashTableIter iter;
+        gpointer name_ptr;
+        gpointer value_list_ptr;
+
+        g_return_val_if_fail (restriction != NULL, FALSE);
+        g_return_val_if_fail (other != NULL, FALSE);
+
+        if (g_strcmp0 (restriction->mime, other->mime))
+                return FALSE;
+
+        g_hash_table_iter_init (&iter, restriction->entries);
+        while (g_hash_table_iter_next (&iter, &name_ptr, &value_list_ptr)) {
+                GUPnPDLNAValueList *other_list =
+                                    g_hash_table_lookup (other->entries,
+                                                         name_ptr);
+
+                /* @other accepts info sets without the field */
+                if (other_list == NULL ||
+                    !gupnp_dlna_value_list_covers (value_list_ptr,
+                                                   other_list))
+                        return FALSE;
         }
-        gupnp_dlna_restriction_free (merged);
+
+        return TRUE;
 }
 
 /**
@@ -230,3 +361,75 @@ gupnp_dlna_restriction_get_entries (GUPnPDLNARestriction *restriction)
 
         return restriction->entries;
 }
+
+static gint
+compare_fields (gconstpointer a,
+                gconstpointer b)
+{
+        const GUPnPDLNARestrictionField *field_a = a;
+        const GUPnPDLNARestrictionField *field_b = b;
+        guint acceptance_a = gupnp_dlna_value_list_get_acceptance
+                                        (field_a->list);
+        guint acceptance_b = gupnp_dlna_value_list_get_acceptance
+                                        (field_b->list);
+
+        if (acceptance_a != acceptance_b)
+                return (acceptance_a < acceptance_b) ? -1 : 1;
+
+        return g_strcmp0 (field_a->name, field_b->name);
+}
+
+/* Lays out the entries in an array, the ones accepting the fewest
+ * values first, so an info set not fitting the restriction is
+ * usually rejected on its first or second field. Call it once the
+ * restriction is complete - it must not be modified afterwards. */
+void
+gupnp_dlna_restriction_order_fields (GUPnPDLNARestriction *restriction)
+{
+        GHashTableIter iter;
+        gpointer name_ptr;
+        gpointer value_list_ptr;
+        guint index = 0;
+
+        g_return_if_fail (restriction != NULL);
+
+        if (restriction->fields != NULL)
+                return;
+
+        restriction->field_count = g_hash_table_size (restriction->entries);
+        if (restriction->field_count == 0)
+                return;
+        if (restriction->arena != NULL)
+                restriction->fields = gupnp_dlna_arena_alloc
+                                  (restriction->arena,
+                                   sizeof (GUPnPDLNARestrictionField) *
+                                   restriction->field_count);
+        else
+                restriction->fields = g_new (GUPnPDLNARestrictionField,
+                                             restriction->field_count);
+
+        g_hash_table_iter_init (&iter, restriction->entries);
+        while (g_hash_table_iter_next (&iter, &name_ptr, &value_list_ptr)) {
+                restriction->fields[index].name = name_ptr;
+                restriction->fields[index].list = value_list_ptr;
+                ++index;
+        }
+        qsort (restriction->fields,
+               restriction->field_count,
+               sizeof (GUPnPDLNARestrictionField),
+               compare_fields);
+}
+
+/* Returns the entries ordered by gupnp_dlna_restriction_order_fields()
+ * or %NULL if they were not ordered. */
+GUPnPDLNARestrictionField *
+gupnp_dlna_restriction_get_ordered_fields (GUPnPDLNARestriction *restriction,
+                                           guint                *count)
+{
+        g_return_val_if_fail (restriction != NULL, NULL);
+        g_return_val_if_fail (count != NULL, NULL);
+
+        *count = restriction->field_count;
+
+        return restriction->fields;
+}
@@ -0,0 +1,848 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Serialization of #GUPnPDLNAInformation and the backend-less
+ * information subclasses created when deserializing it.
+ *
+ * Serialized information is a GVariant of SERIALIZED_TYPE type:
+ * format version, URI, optional guessed profile name and optional
+ * audio, container, image and video streams. Each stream is a
+ * dictionary of its fields, "mime" included, to either the field
+ * value ("b", "i", "(ii)" or "s" depending on the field) or an empty
+ * tuple for unsupported ones. Unset fields are left out.
+ */
+
+#include <gio/gio.h>
+#include <string.h>
+
+#include "gupnp-dlna-information.h"
+#include "gupnp-dlna-information-fields-private.h"
+#include "gupnp-dlna-information-private.h"
+
+#define SERIALIZED_VERSION 1
+#define SERIALIZED_TYPE "(qsmsma{sv}ma{sv}ma{sv}ma{sv})"
+#define SERIALIZE_FORMAT "(qsmsm@a{sv}m@a{sv}m@a{sv}m@a{sv})"
+#define DESERIALIZE_FORMAT "(q&sm&sm@a{sv}m@a{sv}m@a{sv}m@a{sv})"
+
+static GVariant *
+lookup_field (GVariant    *fields,
+              const gchar *name)
+{
+        return g_variant_lookup_value (fields, name, NULL);
+}
+
+static GUPnPDLNABoolValue
+get_bool (GVariant    *fields,
+          const gchar *name)
+{
+        GVariant *variant = lookup_field (fields, name);
+        GUPnPDLNABoolValue value = GUPNP_DLNA_BOOL_VALUE_UNSET;
+
+        if (variant == NULL)
+                return value;
+        if (g_variant_is_of_type (variant, G_VARIANT_TYPE_BOOLEAN)) {
+                value.value = g_variant_get_boolean (variant);
+                value.state = GUPNP_DLNA_VALUE_STATE_SET;
+        } else {
+                value = GUPNP_DLNA_BOOL_VALUE_UNSUPPORTED;
+        }
+        g_variant_unref (variant);
+
+        return value;
+}
+
+static GUPnPDLNAFractionValue
+get_fraction (GVariant    *fields,
+              const gchar *name)
+{
+        GVariant *variant = lookup_field (fields, name);
+        GUPnPDLNAFractionValue value = GUPNP_DLNA_FRACTION_VALUE_UNSET;
+
+        if (variant == NULL)
+                return value;
+        if (g_variant_is_of_type (variant, G_VARIANT_TYPE ("(ii)"))) {
+                g_variant_get (variant,
+                               "(ii)",
+                               &value.numerator,
+                               &value.denominator);
+                value.state = GUPNP_DLNA_VALUE_STATE_SET;
+        } else {
+                value = GUPNP_DLNA_FRACTION_VALUE_UNSUPPORTED;
+        }
+        g_variant_unref (variant);
+
+        return value;
+}
+
+static GUPnPDLNAIntValue
+get_int (GVariant    *fields,
+         const gchar *name)
+{
+        GVariant *variant = lookup_field (fields, name);
+        GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+
+        if (variant == NULL)
+                return value;
+        if (g_variant_is_of_type (variant, G_VARIANT_TYPE_INT32)) {
+                value.value = g_variant_get_int32 (variant);
+                value.state = GUPNP_DLNA_VALUE_STATE_SET;
+        } else {
+                value = GUPNP_DLNA_INT_VALUE_UNSUPPORTED;
+        }
+        g_variant_unref (variant);
+
+        return value;
+}
+
+/* The string stays owned by @fields - either it is a part of its
+ * serialized data or @fields holds a reference to the child. */
+static GUPnPDLNAConstStringValue
+peek_string (GVariant    *fields,
+             const gchar *name)
+{
+        GVariant *variant = lookup_field (fields, name);
+        GUPnPDLNAConstStringValue value = GUPNP_DLNA_CONST_STRING_VALUE_UNSET;
+
+        if (variant == NULL)
+                return value;
+        if (g_variant_is_of_type (variant, G_VARIANT_TYPE_STRING)) {
+                value.value = g_variant_get_string (variant, NULL);
+                value.state = GUPNP_DLNA_VALUE_STATE_SET;
+        } else {
+                value = GUPNP_DLNA_CONST_STRING_VALUE_UNSUPPORTED;
+        }
+        g_variant_unref (variant);
+
+        return value;
+}
+
+static GUPnPDLNAStringValue
+get_string (GVariant    *fields,
+            const gchar *name)
+{
+        GUPnPDLNAConstStringValue borrowed = peek_string (fields, name);
+        GUPnPDLNAStringValue value;
+
+        value.value = g_strdup (borrowed.value);
+        value.state = borrowed.state;
+
+        return value;
+}
+
+/* Stream information classes. All of them just look up values in
+ * the field dictionary of their stream. */
+
+#define STORED_DEFINE_STREAM_TYPE(Name, name, NAME, PARENT_TYPE)        \
+        typedef struct {                                                \
+                GUPnPDLNA##Name##Information parent;                    \
+                GVariant *fields;                                       \
+        } GUPnPDLNAStored##Name##Information;                           \
+                                                                        \
+        typedef struct {                                                \
+                GUPnPDLNA##Name##InformationClass parent_class;         \
+        } GUPnPDLNAStored##Name##InformationClass;                      \
+                                                                        \
+        GType gupnp_dlna_stored_##name##_information_get_type (void);   \
+                                                                        \
+        G_DEFINE_TYPE (GUPnPDLNAStored##Name##Information,              \
+                       gupnp_dlna_stored_##name##_information,          \
+                       PARENT_TYPE)                                     \
+                                                                        \
+        static void                                                     \
+        gupnp_dlna_stored_##name##_information_init                     \
+                                (GUPnPDLNAStored##Name##Information *info) \
+        {                                                               \
+        }                                                               \
+                                                                        \
+        static void                                                     \
+        gupnp_dlna_stored_##name##_information_finalize                 \
+                                                   (GObject *object)    \
+        {                                                               \
+                GUPnPDLNAStored##Name##Information *info =              \
+                        (GUPnPDLNAStored##Name##Information *) object;  \
+                                                                        \
+                g_variant_unref (info->fields);                         \
+                G_OBJECT_CLASS                                          \
+                      (gupnp_dlna_stored_##name##_information_parent_class)-> \
+                                                finalize (object);      \
+        }                                                               \
+                                                                        \
+        static GVariant *                                               \
+        name##_fields (GUPnPDLNA##Name##Information *info)              \
+        {                                                               \
+                return ((GUPnPDLNAStored##Name##Information *)          \
+                        info)->fields;                                  \
+        }                                                               \
+                                                                        \
+        static GUPnPDLNA##Name##Information *                           \
+        gupnp_dlna_stored_##name##_information_new (GVariant *fields)   \
+        {                                                               \
+                GUPnPDLNAStored##Name##Information *info;               \
+                                                                        \
+                if (fields == NULL)                                     \
+                        return NULL;                                    \
+                info = g_object_new                                     \
+                        (gupnp_dlna_stored_##name##_information_get_type \
+                                                                (),     \
+                         NULL);                                         \
+                info->fields = g_variant_ref (fields);                  \
+                                                                        \
+                return GUPNP_DLNA_##NAME##_INFORMATION (info);          \
+        }
+
+#define STORED_GETTER(name, Name, Type, vfunc, getter, field)           \
+        static GUPnPDLNA##Type##Value                                   \
+        name##_##vfunc (GUPnPDLNA##Name##Information *info)             \
+        {                                                               \
+                return getter (name##_fields (info), field);            \
+        }
+
+STORED_DEFINE_STREAM_TYPE (Audio,
+                           audio,
+                           AUDIO,
+                           GUPNP_TYPE_DLNA_AUDIO_INFORMATION)
+STORED_GETTER (audio, Audio, Int, get_bitrate, get_int, "bitrate")
+STORED_GETTER (audio, Audio, Int, get_channels, get_int, "channels")
+STORED_GETTER (audio, Audio, Int, get_depth, get_int, "depth")
+STORED_GETTER (audio, Audio, Int, get_layer, get_int, "layer")
+STORED_GETTER (audio, Audio, String, get_level, get_string, "level")
+STORED_GETTER (audio, Audio, Int, get_mpeg_audio_version, get_int,
+               "mpegaudioversion")
+STORED_GETTER (audio, Audio, Int, get_mpeg_version, get_int, "mpegversion")
+STORED_GETTER (audio, Audio, String, get_profile, get_string, "profile")
+STORED_GETTER (audio, Audio, Int, get_rate, get_int, "rate")
+STORED_GETTER (audio, Audio, String, get_stream_format, get_string,
+               "stream-format")
+STORED_GETTER (audio, Audio, Int, get_wma_version, get_int, "wmaversion")
+STORED_GETTER (audio, Audio, String, get_mime, get_string, "mime")
+STORED_GETTER (audio, Audio, ConstString, peek_level, peek_string, "level")
+STORED_GETTER (audio, Audio, ConstString, peek_profile, peek_string,
+               "profile")
+STORED_GETTER (audio, Audio, ConstString, peek_stream_format, peek_string,
+               "stream-format")
+STORED_GETTER (audio, Audio, ConstString, peek_mime, peek_string, "mime")
+
+static void
+gupnp_dlna_stored_audio_information_class_init
+                            (GUPnPDLNAStoredAudioInformationClass *stored_class)
+{
+        GUPnPDLNAAudioInformationClass *info_class =
+                            GUPNP_DLNA_AUDIO_INFORMATION_CLASS (stored_class);
+
+        G_OBJECT_CLASS (stored_class)->finalize =
+                               gupnp_dlna_stored_audio_information_finalize;
+        info_class->get_bitrate = audio_get_bitrate;
+        info_class->get_channels = audio_get_channels;
+        info_class->get_depth = audio_get_depth;
+        info_class->get_layer = audio_get_layer;
+        info_class->get_level = audio_get_level;
+        info_class->get_mpeg_audio_version = audio_get_mpeg_audio_version;
+        info_class->get_mpeg_version = audio_get_mpeg_version;
+        info_class->get_profile = audio_get_profile;
+        info_class->get_rate = audio_get_rate;
+        info_class->get_stream_format = audio_get_stream_format;
+        info_class->get_wma_version = audio_get_wma_version;
+        info_class->get_mime = audio_get_mime;
+        info_class->peek_level = audio_peek_level;
+        info_class->peek_profile = audio_peek_profile;
+        info_class->peek_stream_format = audio_peek_stream_format;
+        info_class->peek_mime = audio_peek_mime;
+}
+
+STORED_DEFINE_STREAM_TYPE (Container,
+                           container,
+                           CONTAINER,
+                           GUPNP_TYPE_DLNA_CONTAINER_INFORMATION)
+STORED_GETTER (container, Container, Int, get_mpeg_version, get_int,
+               "mpegversion")
+STORED_GETTER (container, Container, Int, get_packet_size, get_int,
+               "packetsize")
+STORED_GETTER (container, Container, String, get_profile, get_string,
+               "profile")
+STORED_GETTER (container, Container, Bool, is_system_stream, get_bool,
+               "systemstream")
+STORED_GETTER (container, Container, String, get_variant, get_string,
+               "variant")
+STORED_GETTER (container, Container, String, get_mime, get_string, "mime")
+STORED_GETTER (container, Container, ConstString, peek_profile, peek_string,
+               "profile")
+STORED_GETTER (container, Container, ConstString, peek_variant, peek_string,
+               "variant")
+STORED_GETTER (container, Container, ConstString, peek_mime, peek_string,
+               "mime")
+
+static void
+gupnp_dlna_stored_container_information_class_init
+                        (GUPnPDLNAStoredContainerInformationClass *stored_class)
+{
+        GUPnPDLNAContainerInformationClass *info_class =
+                        GUPNP_DLNA_CONTAINER_INFORMATION_CLASS (stored_class);
+
+        G_OBJECT_CLASS (stored_class)->finalize =
+                           gupnp_dlna_stored_container_information_finalize;
+        info_class->get_mpeg_version = container_get_mpeg_version;
+        info_class->get_packet_size = container_get_packet_size;
+        info_class->get_profile = container_get_profile;
+        info_class->is_system_stream = container_is_system_stream;
+        info_class->get_variant = container_get_variant;
+        info_class->get_mime = container_get_mime;
+        info_class->peek_profile = container_peek_profile;
+        info_class->peek_variant = container_peek_variant;
+        info_class->peek_mime = container_peek_mime;
+}
+
+STORED_DEFINE_STREAM_TYPE (Image,
+                           image,
+                           IMAGE,
+                           GUPNP_TYPE_DLNA_IMAGE_INFORMATION)
+STORED_GETTER (image, Image, Int, get_depth, get_int, "depth")
+STORED_GETTER (image, Image, Int, get_height, get_int, "height")
+STORED_GETTER (image, Image, Int, get_width, get_int, "width")
+STORED_GETTER (image, Image, String, get_mime, get_string, "mime")
+STORED_GETTER (image, Image, ConstString, peek_mime, peek_string, "mime")
+
+static void
+gupnp_dlna_stored_image_information_class_init
+                            (GUPnPDLNAStoredImageInformationClass *stored_class)
+{
+        GUPnPDLNAImageInformationClass *info_class =
+                            GUPNP_DLNA_IMAGE_INFORMATION_CLASS (stored_class);
+
+        G_OBJECT_CLASS (stored_class)->finalize =
+                               gupnp_dlna_stored_image_information_finalize;
+        info_class->get_depth = image_get_depth;
+        info_class->get_height = image_get_height;
+        info_class->get_width = image_get_width;
+        info_class->get_mime = image_get_mime;
+        info_class->peek_mime = image_peek_mime;
+}
+
+STORED_DEFINE_STREAM_TYPE (Video,
+                           video,
+                           VIDEO,
+                           GUPNP_TYPE_DLNA_VIDEO_INFORMATION)
+STORED_GETTER (video, Video, Int, get_bitrate, get_int, "bitrate")
+STORED_GETTER (video, Video, Fraction, get_framerate, get_fraction,
+               "framerate")
+STORED_GETTER (video, Video, Int, get_height, get_int, "height")
+STORED_GETTER (video, Video, Bool, is_interlaced, get_bool, "interlaced")
+STORED_GETTER (video, Video, String, get_level, get_string, "level")
+STORED_GETTER (video, Video, Int, get_mpeg_version, get_int, "mpegversion")
+STORED_GETTER (video, Video, Fraction, get_pixel_aspect_ratio, get_fraction,
+               "pixel-aspect-ratio")
+STORED_GETTER (video, Video, String, get_profile, get_string, "profile")
+STORED_GETTER (video, Video, Bool, is_system_stream, get_bool,
+               "systemstream")
+STORED_GETTER (video, Video, Int, get_width, get_int, "width")
+STORED_GETTER (video, Video, String, get_mime, get_string, "mime")
+STORED_GETTER (video, Video, ConstString, peek_level, peek_string, "level")
+STORED_GETTER (video, Video, ConstString, peek_profile, peek_string,
+               "profile")
+STORED_GETTER (video, Video, ConstString, peek_mime, peek_string, "mime")
+
+static void
+gupnp_dlna_stored_video_information_class_init
+                            (GUPnPDLNAStoredVideoInformationClass *stored_class)
+{
+        GUPnPDLNAVideoInformationClass *info_class =
+                            GUPNP_DLNA_VIDEO_INFORMATION_CLASS (stored_class);
+
+        G_OBJECT_CLASS (stored_class)->finalize =
+                               gupnp_dlna_stored_video_information_finalize;
+        info_class->get_bitrate = video_get_bitrate;
+        info_class->get_framerate = video_get_framerate;
+        info_class->get_height = video_get_height;
+        info_class->is_interlaced = video_is_interlaced;
+        info_class->get_level = video_get_level;
+        info_class->get_mpeg_version = video_get_mpeg_version;
+        info_class->get_pixel_aspect_ratio = video_get_pixel_aspect_ratio;
+        info_class->get_profile = video_get_profile;
+        info_class->is_system_stream = video_is_system_stream;
+        info_class->get_width = video_get_width;
+        info_class->get_mime = video_get_mime;
+        info_class->peek_level = video_peek_level;
+        info_class->peek_profile = video_peek_profile;
+        info_class->peek_mime = video_peek_mime;
+}
+
+/* The information itself. */
+
+typedef enum {
+        STORED_STREAM_AUDIO,
+        STORED_STREAM_CONTAINER,
+        STORED_STREAM_IMAGE,
+        STORED_STREAM_VIDEO,
+        STORED_STREAM_COUNT
+} GUPnPDLNAStoredStream;
+
+typedef struct {
+        GUPnPDLNAInformation parent;
+
+        GVariant *fields[STORED_STREAM_COUNT];
+} GUPnPDLNAStoredInformation;
+
+typedef struct {
+        GUPnPDLNAInformationClass parent_class;
+} GUPnPDLNAStoredInformationClass;
+
+GType gupnp_dlna_stored_information_get_type (void);
+
+G_DEFINE_TYPE (GUPnPDLNAStoredInformation,
+               gupnp_dlna_stored_information,
+               GUPNP_TYPE_DLNA_INFORMATION)
+
+static GVariant *
+stored_fields (GUPnPDLNAInformation  *info,
+               GUPnPDLNAStoredStream  stream)
+{
+        return ((GUPnPDLNAStoredInformation *) info)->fields[stream];
+}
+
+static GUPnPDLNAAudioInformation *
+get_audio_information (GUPnPDLNAInformation *info)
+{
+        return gupnp_dlna_stored_audio_information_new
+                                   (stored_fields (info, STORED_STREAM_AUDIO));
+}
+
+static GUPnPDLNAContainerInformation *
+get_container_information (GUPnPDLNAInformation *info)
+{
+        return gupnp_dlna_stored_container_information_new
+                               (stored_fields (info, STORED_STREAM_CONTAINER));
+}
+
+static GUPnPDLNAImageInformation *
+get_image_information (GUPnPDLNAInformation *info)
+{
+        return gupnp_dlna_stored_image_information_new
+                                   (stored_fields (info, STORED_STREAM_IMAGE));
+}
+
+static GUPnPDLNAVideoInformation *
+get_video_information (GUPnPDLNAInformation *info)
+{
+        return gupnp_dlna_stored_video_information_new
+                                   (stored_fields (info, STORED_STREAM_VIDEO));
+}
+
+static void
+gupnp_dlna_stored_information_finalize (GObject *object)
+{
+        GUPnPDLNAStoredInformation *info =
+                                        (GUPnPDLNAStoredInformation *) object;
+        guint iter;
+
+        for (iter = 0; iter < STORED_STREAM_COUNT; ++iter)
+                g_clear_pointer (&info->fields[iter], g_variant_unref);
+        G_OBJECT_CLASS
+                (gupnp_dlna_stored_information_parent_class)->finalize (object);
+}
+
+static void
+gupnp_dlna_stored_information_class_init
+                                (GUPnPDLNAStoredInformationClass *stored_class)
+{
+        GUPnPDLNAInformationClass *info_class =
+                                 GUPNP_DLNA_INFORMATION_CLASS (stored_class);
+
+        G_OBJECT_CLASS (stored_class)->finalize =
+                                        gupnp_dlna_stored_information_finalize;
+        info_class->get_audio_information = get_audio_information;
+        info_class->get_container_information = get_container_information;
+        info_class->get_image_information = get_image_information;
+        info_class->get_video_information = get_video_information;
+}
+
+static void
+gupnp_dlna_stored_information_init (GUPnPDLNAStoredInformation *info)
+{
+}
+
+/* Serialization. */
+
+static GVariant *
+unsupported_variant (void)
+{
+        return g_variant_new_tuple (NULL, 0);
+}
+
+static void
+add_string (GVariantBuilder           *builder,
+            const gchar               *name,
+            GUPnPDLNAConstStringValue  value)
+{
+        switch (value.state) {
+        case GUPNP_DLNA_VALUE_STATE_SET:
+                g_variant_builder_add (builder,
+                                       "{sv}",
+                                       name,
+                                       g_variant_new_string (value.value));
+
+                break;
+        case GUPNP_DLNA_VALUE_STATE_UNSUPPORTED:
+                g_variant_builder_add (builder,
+                                       "{sv}",
+                                       name,
+                                       unsupported_variant ());
+
+                break;
+        default:
+                break;
+        }
+}
+
+static void
+add_field (GVariantBuilder      *builder,
+           const GUPnPDLNAField *field,
+           gpointer              info)
+{
+        GVariant *variant = NULL;
+        GUPnPDLNAValueState state = GUPNP_DLNA_VALUE_STATE_UNSET;
+
+        switch (field->kind) {
+        case GUPNP_DLNA_FIELD_BOOL: {
+                GUPnPDLNABoolValue value =
+                        ((GUPnPDLNAFieldGetBoolFunc) field->getter) (info);
+
+                state = value.state;
+                if (state == GUPNP_DLNA_VALUE_STATE_SET)
+                        variant = g_variant_new_boolean (value.value);
+
+                break;
+        }
+        case GUPNP_DLNA_FIELD_FRACTION: {
+                GUPnPDLNAFractionValue value =
+                        ((GUPnPDLNAFieldGetFractionFunc) field->getter) (info);
+
+                state = value.state;
+                if (state == GUPNP_DLNA_VALUE_STATE_SET)
+                        variant = g_variant_new ("(ii)",
+                                                 value.numerator,
+                                                 value.denominator);
+
+                break;
+        }
+        case GUPNP_DLNA_FIELD_INT: {
+                GUPnPDLNAIntValue value =
+                        ((GUPnPDLNAFieldGetIntFunc) field->getter) (info);
+
+                state = value.state;
+                if (state == GUPNP_DLNA_VALUE_STATE_SET)
+                        variant = g_variant_new_int32 (value.value);
+
+                break;
+        }
+        case GUPNP_DLNA_FIELD_STRING:
+                add_string (builder,
+                            field->name,
+                            ((GUPnPDLNAFieldPeekStringFunc)
+                                        field->getter) (info));
+
+                return;
+        default:
+                g_critical ("Wrong field kind (%d).", field->kind);
+
+                return;
+        }
+
+        if (state == GUPNP_DLNA_VALUE_STATE_UNSUPPORTED)
+                variant = unsupported_variant ();
+        if (variant != NULL)
+                g_variant_builder_add (builder, "{sv}", field->name, variant);
+}
+
+static GVariant *
+serialize_stream (gpointer                   info,
+                  const GUPnPDLNAField      *fields,
+                  GUPnPDLNAConstStringValue  mime)
+{
+        GVariantBuilder builder;
+        const GUPnPDLNAField *field;
+
+        if (info == NULL)
+                return NULL;
+
+        g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+        add_string (&builder, "mime", mime);
+        for (field = fields; field->name != NULL; ++field)
+                add_field (&builder, field, info);
+
+        return g_variant_builder_end (&builder);
+}
+
+/**
+ * gupnp_dlna_information_serialize:
+ * @info: A #GUPnPDLNAInformation object.
+ * @profile_name: (allow-none): A name of a DLNA profile guessed for
+ * @info or %NULL.
+ *
+ * Serializes the URI and all the metadata values held by @info,
+ * together with @profile_name, into a compact and versioned binary
+ * form. It can be stored or sent to another process and turned back
+ * into an information with gupnp_dlna_information_deserialize().
+ *
+ * Returns: (transfer full): The serialized information.
+ */
+GBytes *
+gupnp_dlna_information_serialize (GUPnPDLNAInformation *info,
+                                  const gchar          *profile_name)
+{
+        GUPnPDLNAAudioInformation *audio_info;
+        GUPnPDLNAContainerInformation *container_info;
+        GUPnPDLNAImageInformation *image_info;
+        GUPnPDLNAVideoInformation *video_info;
+        const gchar *uri;
+        GVariant *serialized;
+        GBytes *bytes;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), NULL);
+
+        audio_info = gupnp_dlna_information_get_audio_information (info);
+        container_info =
+                      gupnp_dlna_information_get_container_information (info);
+        image_info = gupnp_dlna_information_get_image_information (info);
+        video_info = gupnp_dlna_information_get_video_information (info);
+        uri = gupnp_dlna_information_get_uri (info);
+
+        serialized = g_variant_new
+                (SERIALIZE_FORMAT,
+                 (guint16) SERIALIZED_VERSION,
+                 uri != NULL ? uri : "",
+                 profile_name,
+                 serialize_stream
+                          (audio_info,
+                           gupnp_dlna_audio_fields,
+                           audio_info == NULL ?
+                           GUPNP_DLNA_CONST_STRING_VALUE_UNSET :
+                           gupnp_dlna_audio_information_peek_mime (audio_info)),
+                 serialize_stream
+                      (container_info,
+                       gupnp_dlna_container_fields,
+                       container_info == NULL ?
+                       GUPNP_DLNA_CONST_STRING_VALUE_UNSET :
+                       gupnp_dlna_container_information_peek_mime
+                                        (container_info)),
+                 serialize_stream
+                          (image_info,
+                           gupnp_dlna_image_fields,
+                           image_info == NULL ?
+                           GUPNP_DLNA_CONST_STRING_VALUE_UNSET :
+                           gupnp_dlna_image_information_peek_mime (image_info)),
+                 serialize_stream
+                          (video_info,
+                           gupnp_dlna_video_fields,
+                           video_info == NULL ?
+                           GUPNP_DLNA_CONST_STRING_VALUE_UNSET :
+                           gupnp_dlna_video_information_peek_mime
+                                        (video_info)));
+        g_variant_ref_sink (serialized);
+        bytes = g_variant_get_data_as_bytes (serialized);
+        g_variant_unref (serialized);
+
+        return bytes;
+}
+
+/* Deserialization. */
+
+static gboolean
+check_field_type (GVariant             *value,
+                  GUPnPDLNAFieldKind    kind)
+{
+        GVariant *inner = g_variant_get_variant (value);
+        const GVariantType *type;
+        gboolean valid;
+
+        switch (kind) {
+        case GUPNP_DLNA_FIELD_BOOL:
+                type = G_VARIANT_TYPE_BOOLEAN;
+
+                break;
+        case GUPNP_DLNA_FIELD_FRACTION:
+                type = G_VARIANT_TYPE ("(ii)");
+
+                break;
+        case GUPNP_DLNA_FIELD_INT:
+                type = G_VARIANT_TYPE_INT32;
+
+                break;
+        case GUPNP_DLNA_FIELD_STRING:
+        default:
+                type = G_VARIANT_TYPE_STRING;
+
+                break;
+        }
+
+        valid = (g_variant_is_of_type (inner, type) ||
+                 g_variant_is_of_type (inner, G_VARIANT_TYPE_UNIT));
+        g_variant_unref (inner);
+
+        return valid;
+}
+
+/* Checks that every stored field is known to @fields and holds a
+ * value of proper type, so the getters can rely on it. */
+static gboolean
+check_stream (GVariant              *stream,
+              const GUPnPDLNAField  *fields,
+              const gchar           *type,
+              GError               **error)
+{
+        GVariantIter iter;
+        const gchar *name;
+        GVariant *value;
+
+        if (stream == NULL)
+                return TRUE;
+
+        g_variant_iter_init (&iter, stream);
+        while (g_variant_iter_loop (&iter, "{&s@v}", &name, &value)) {
+                GUPnPDLNAFieldKind kind = GUPNP_DLNA_FIELD_STRING;
+                const GUPnPDLNAField *field = NULL;
+
+                if (strcmp (name, "mime")) {
+                        for (field = fields; field->name != NULL; ++field)
+                                if (!strcmp (field->name, name))
+                                        break;
+                        kind = field->kind;
+                }
+                if ((field != NULL && field->name == NULL) ||
+                    !check_field_type (value, kind)) {
+                        g_set_error (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_INVALID_DATA,
+                                     "Invalid %s field '%s' in serialized "
+                                     "information.",
+                                     type,
+                                     name);
+                        g_variant_unref (value);
+
+                        return FALSE;
+                }
+        }
+
+        return TRUE;
+}
+
+/**
+ * gupnp_dlna_information_deserialize:
+ * @bytes: Information serialized with gupnp_dlna_information_serialize().
+ * @profile_name: (out) (transfer full) (allow-none): Location for
+ * the stored name of a DLNA profile or %NULL.
+ * @error: A #GError or %NULL.
+ *
+ * Creates an information holding the metadata stored in @bytes. It
+ * does not need any metadata backend, so it can be matched against
+ * DLNA profiles in a process that never saw the media file. The
+ * returned information does not report the stored profile name in
+ * gupnp_dlna_information_get_profile_name(), so the guesser always
+ * matches the metadata itself. Use @profile_name to get it.
+ *
+ * Returns: (transfer full): A #GUPnPDLNAInformation or %NULL if
+ * @bytes are not a valid serialized information of a known version.
+ */
+GUPnPDLNAInformation *
+gupnp_dlna_information_deserialize (GBytes  *bytes,
+                                    gchar  **profile_name,
+                                    GError **error)
+{
+        GVariant *serialized;
+        GVariant *streams[STORED_STREAM_COUNT];
+        GUPnPDLNAStoredInformation *info = NULL;
+        guint16 version;
+        const gchar *uri;
+        const gchar *name;
+        guint iter;
+
+        g_return_val_if_fail (bytes != NULL, NULL);
+
+        serialized = g_variant_new_from_bytes (G_VARIANT_TYPE (SERIALIZED_TYPE),
+                                               bytes,
+                                               FALSE);
+        g_variant_ref_sink (serialized);
+        g_variant_get_child (serialized, 0, "q", &version);
+        if (version != SERIALIZED_VERSION) {
+                g_set_error (error,
+                             G_IO_ERROR,
+                             G_IO_ERROR_NOT_SUPPORTED,
+                             "Unknown serialized information version %u.",
+                             version);
+                g_variant_unref (serialized);
+
+                return NULL;
+        }
+
+        g_variant_get (serialized,
+                       DESERIALIZE_FORMAT,
+                       NULL,
+                       &uri,
+                       &name,
+                       &streams[STORED_STREAM_AUDIO],
+                       &streams[STORED_STREAM_CONTAINER],
+                       &streams[STORED_STREAM_IMAGE],
+                       &streams[STORED_STREAM_VIDEO]);
+
+        if (check_stream (streams[STORED_STREAM_AUDIO],
+                          gupnp_dlna_audio_fields,
+                          "audio",
+                          error) &&
+            check_stream (streams[STORED_STREAM_CONTAINER],
+                          gupnp_dlna_container_fields,
+                          "container",
+                          error) &&
+            check_stream (streams[STORED_STREAM_IMAGE],
+                          gupnp_dlna_image_fields,
+                          "image",
+                          error) &&
+            check_stream (streams[STORED_STREAM_VIDEO],
+                          gupnp_dlna_video_fields,
+                          "video",
+                          error)) {
+                info = g_object_new (gupnp_dlna_stored_information_get_type (),
+                                     "uri",
+                                     uri[0] != '\0' ? uri : NULL,
+                                     NULL);
+                for (iter = 0; iter < STORED_STREAM_COUNT; ++iter) {
+                        info->fields[iter] = streams[iter];
+                        streams[iter] = NULL;
+                }
+                if (profile_name != NULL)
+                        *profile_name = g_strdup (name);
+        }
+
+        for (iter = 0; iter < STORED_STREAM_COUNT; ++iter)
+                g_clear_pointer (&streams[iter], g_variant_unref);
+        g_variant_unref (serialized);
+
+        return GUPNP_DLNA_INFORMATION (info);
+}
+
+/* An information without any streams, for reporting failed
+ * extractions. */
+GUPnPDLNAInformation *
+gupnp_dlna_stored_information_new_empty (const gchar *uri)
+{
+        return GUPNP_DLNA_INFORMATION
+                        (g_object_new (gupnp_dlna_stored_information_get_type (),
+                                       "uri", uri,
+                                       NULL));
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GUPNP_DLNA_STRING_CACHE_PRIVATE_H__
+#define __GUPNP_DLNA_STRING_CACHE_PRIVATE_H__
+
+#include <glib.h>
+
+#include "gupnp-dlna-values.h"
+
+G_BEGIN_DECLS
+
+/* Keeps owned string values returned by a getter alive, so borrowed
+ * pointers to them can be handed out. Meant to be embedded in the
+ * private data of an information object. */
+typedef struct {
+        GMutex      lock;
+        GHashTable *values;
+} GUPnPDLNAStringCache;
+
+typedef GUPnPDLNAStringValue
+(* GUPnPDLNAStringCacheGetFunc) (gpointer info);
+
+void
+gupnp_dlna_string_cache_init (GUPnPDLNAStringCache *cache);
+
+void
+gupnp_dlna_string_cache_clear (GUPnPDLNAStringCache *cache);
+
+GUPnPDLNAConstStringValue
+gupnp_dlna_string_cache_peek (GUPnPDLNAStringCache        *cache,
+                              const gchar                 *name,
+                              GUPnPDLNAStringCacheGetFunc  get,
+                              gpointer                     info);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_STRING_CACHE_PRIVATE_H__ */
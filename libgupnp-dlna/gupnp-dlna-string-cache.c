@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "gupnp-dlna-string-cache-private.h"
+
+static void
+free_string_value (gpointer data)
+{
+        GUPnPDLNAStringValue *value = data;
+
+        g_free (value->value);
+        g_slice_free (GUPnPDLNAStringValue, value);
+}
+
+void
+gupnp_dlna_string_cache_init (GUPnPDLNAStringCache *cache)
+{
+        g_return_if_fail (cache != NULL);
+
+        g_mutex_init (&cache->lock);
+        cache->values = NULL;
+}
+
+void
+gupnp_dlna_string_cache_clear (GUPnPDLNAStringCache *cache)
+{
+        g_return_if_fail (cache != NULL);
+
+        g_clear_pointer (&cache->values, g_hash_table_unref);
+        g_mutex_clear (&cache->lock);
+}
+
+/* Returns a value borrowed from the cache, calling @get at most once
+ * per @name. @name is expected to be a static string. */
+GUPnPDLNAConstStringValue
+gupnp_dlna_string_cache_peek (GUPnPDLNAStringCache        *cache,
+                              const gchar                 *name,
+                              GUPnPDLNAStringCacheGetFunc  get,
+                              gpointer                     info)
+{
+        GUPnPDLNAConstStringValue borrowed =
+                                           GUPNP_DLNA_CONST_STRING_VALUE_UNSET;
+        GUPnPDLNAStringValue *value;
+
+        g_return_val_if_fail (cache != NULL, borrowed);
+        g_return_val_if_fail (name != NULL, borrowed);
+        g_return_val_if_fail (get != NULL, borrowed);
+
+        g_mutex_lock (&cache->lock);
+        if (cache->values == NULL)
+                cache->values = g_hash_table_new_full (g_str_hash,
+                                                       g_str_equal,
+                                                       NULL,
+                                                       free_string_value);
+        value = g_hash_table_lookup (cache->values, name);
+        g_mutex_unlock (&cache->lock);
+
+        if (value == NULL) {
+                GUPnPDLNAStringValue *existing;
+
+                /* the getter is called unlocked, it may be slow */
+                value = g_slice_new (GUPnPDLNAStringValue);
+                *value = get (info);
+
+                g_mutex_lock (&cache->lock);
+                existing = g_hash_table_lookup (cache->values, name);
+                if (existing == NULL)
+                        g_hash_table_insert (cache->values,
+                                             (gpointer) name,
+                                             value);
+                g_mutex_unlock (&cache->lock);
+
+                if (existing != NULL) {
+                        free_string_value (value);
+                        value = existing;
+                }
+        }
+
+        borrowed.value = value->value;
+        borrowed.state = value->state;
+
+        return borrowed;
+}
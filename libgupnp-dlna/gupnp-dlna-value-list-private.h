@@ -24,6 +24,7 @@
 
 #include <glib.h>
 
+#include "gupnp-dlna-arena.h"
 #include "gupnp-dlna-info-value.h"
 #include "gupnp-dlna-value-list.h"
 #include "gupnp-dlna-value-type.h"
@@ -33,6 +34,16 @@ G_BEGIN_DECLS
 GUPnPDLNAValueList *
 gupnp_dlna_value_list_new (GUPnPDLNAValueType *type);
 
+GUPnPDLNAValueList *
+gupnp_dlna_value_list_new_in_arena (GUPnPDLNAValueType *type,
+                                    GUPnPDLNAArena     *arena);
+
+GUPnPDLNAValueList *
+gupnp_dlna_value_list_ref (GUPnPDLNAValueList *list);
+
+void
+gupnp_dlna_value_list_unref (GUPnPDLNAValueList *list);
+
 gboolean
 gupnp_dlna_value_list_add_range (GUPnPDLNAValueList *list,
                                  const gchar        *min,
@@ -47,6 +58,17 @@ gupnp_dlna_value_list_is_superset (GUPnPDLNAValueList *list,
                                    GUPnPDLNAInfoValue *value,
                                    gboolean           *unsupported);
 
+gboolean
+gupnp_dlna_value_list_intersects (GUPnPDLNAValueList *list,
+                                  GUPnPDLNAValueList *other);
+
+gboolean
+gupnp_dlna_value_list_covers (GUPnPDLNAValueList *list,
+                              GUPnPDLNAValueList *other);
+
+guint
+gupnp_dlna_value_list_get_acceptance (GUPnPDLNAValueList *list);
+
 GList *
 gupnp_dlna_value_list_get_list (GUPnPDLNAValueList *value_list);
 
@@ -27,6 +27,8 @@ struct _GUPnPDLNAValueList {
         GUPnPDLNAValueType *type;
         GList              *values; /* <GUPnPDLNAValue *> */
         gboolean            sorted;
+        gint                ref_count;
+        GUPnPDLNAArena     *arena; /* NULL if allocated on the heap */
 };
 
 G_DEFINE_BOXED_TYPE (GUPnPDLNAValueList,
@@ -45,6 +47,30 @@ gupnp_dlna_value_list_new (GUPnPDLNAValueType *type)
         list->type = type;
         list->values = NULL;
         list->sorted = FALSE;
+        list->ref_count = 1;
+        list->arena = NULL;
+
+        return list;
+}
+
+/* Lists allocated in an arena, along with their values, live as long
+ * as the arena does - referencing and unreferencing them is a
+ * no-op. */
+GUPnPDLNAValueList *
+gupnp_dlna_value_list_new_in_arena (GUPnPDLNAValueType *type,
+                                    GUPnPDLNAArena     *arena)
+{
+        GUPnPDLNAValueList *list;
+
+        g_return_val_if_fail (type != NULL, NULL);
+        g_return_val_if_fail (arena != NULL, NULL);
+
+        list = gupnp_dlna_arena_alloc (arena, sizeof (GUPnPDLNAValueList));
+        list->type = type;
+        list->values = NULL;
+        list->sorted = FALSE;
+        list->ref_count = 1;
+        list->arena = arena;
 
         return list;
 }
@@ -61,6 +87,29 @@ free_value_list (GUPnPDLNAValueList *list)
         }
 }
 
+GUPnPDLNAValueList *
+gupnp_dlna_value_list_ref (GUPnPDLNAValueList *list)
+{
+        g_return_val_if_fail (list != NULL, NULL);
+
+        if (list->arena == NULL)
+                g_atomic_int_inc (&list->ref_count);
+
+        return list;
+}
+
+void
+gupnp_dlna_value_list_unref (GUPnPDLNAValueList *list)
+{
+        if (!list || list->arena != NULL)
+                return;
+        if (!g_atomic_int_dec_and_test (&list->ref_count))
+                return;
+
+        free_value_list (list);
+        g_slice_free (GUPnPDLNAValueList, list);
+}
+
 /**
  * gupnp_dlna_value_list_free:
  * @list: A list to free.
@@ -70,11 +119,7 @@ free_value_list (GUPnPDLNAValueList *list)
 void
 gupnp_dlna_value_list_free (GUPnPDLNAValueList *list)
 {
-        if (!list)
-                return;
-
-        free_value_list (list);
-        g_slice_free (GUPnPDLNAValueList, list);
+        gupnp_dlna_value_list_unref (list);
 }
 
 static gint
@@ -89,7 +134,33 @@ static gboolean
 insert_value (GUPnPDLNAValueList *list,
               GUPnPDLNAValue     *value)
 {
-        if (value) {
+        if (value && list->arena) {
+                GList *prev = NULL;
+                GList *next = list->values;
+                GList *node;
+
+                /* Splice an arena node in before the first value not
+                 * smaller than the new one, like
+                 * g_list_insert_sorted_with_data() does. */
+                if (list->sorted)
+                        while (next != NULL &&
+                               value_compare (value,
+                                              next->data,
+                                              list->type) > 0) {
+                                prev = next;
+                                next = next->next;
+                        }
+                node = gupnp_dlna_arena_list_prepend (list->arena,
+                                                      next,
+                                                      value);
+                node->prev = prev;
+                if (prev != NULL)
+                        prev->next = node;
+                else
+                        list->values = node;
+
+                return TRUE;
+        } else if (value) {
                 if (list->sorted)
                         list->values = g_list_insert_sorted_with_data
                                         (list->values,
@@ -112,8 +183,14 @@ gupnp_dlna_value_list_add_single (GUPnPDLNAValueList *list,
 
         g_return_val_if_fail (list != NULL, FALSE);
         g_return_val_if_fail (single != NULL, FALSE);
+        g_return_val_if_fail (list->ref_count == 1, FALSE);
 
-        value = gupnp_dlna_value_new_single (list->type, single);
+        if (list->arena)
+                value = gupnp_dlna_value_new_single_in_arena (list->type,
+                                                              single,
+                                                              list->arena);
+        else
+                value = gupnp_dlna_value_new_single (list->type, single);
 
         return insert_value (list, value);
 }
@@ -128,22 +205,26 @@ gupnp_dlna_value_list_add_range (GUPnPDLNAValueList *list,
         g_return_val_if_fail (list != NULL, FALSE);
         g_return_val_if_fail (min != NULL, FALSE);
         g_return_val_if_fail (max != NULL, FALSE);
+        g_return_val_if_fail (list->ref_count == 1, FALSE);
 
-        range = gupnp_dlna_value_new_ranged (list->type, min, max);
+        if (list->arena)
+                range = gupnp_dlna_value_new_ranged_in_arena (list->type,
+                                                              min,
+                                                              max,
+                                                              list->arena);
+        else
+                range = gupnp_dlna_value_new_ranged (list->type, min, max);
 
-        if (range) {
-                list->values = g_list_prepend (list->values, range);
-
-                return TRUE;
-        }
-
-        return FALSE;
+        return insert_value (list, range);
 }
 
 /**
  * gupnp_dlna_value_list_copy:
  * @list: (transfer none): A list to copy.
  *
+ * Value lists are immutable, so the copy usually shares its contents
+ * with @list.
+ *
  * Returns: (transfer full): A copy of @list.
  */
 GUPnPDLNAValueList *
@@ -154,22 +235,20 @@ gupnp_dlna_value_list_copy (GUPnPDLNAValueList *list)
 
         g_return_val_if_fail (list != NULL, NULL);
 
-	dup = gupnp_dlna_value_list_new (list->type);
-
-        g_return_val_if_fail (dup != NULL, NULL);
+        if (list->arena == NULL)
+                return gupnp_dlna_value_list_ref (list);
 
-	for (iter = list->values; iter != NULL; iter = iter->next) {
-		GUPnPDLNAValue *base = (GUPnPDLNAValue *) iter->data;
-		GUPnPDLNAValue *copy;
-
-		if (base == NULL)
-			continue;
+        /* The copy may outlive the arena, so move it to the heap. */
+        dup = gupnp_dlna_value_list_new (list->type);
+        for (iter = list->values; iter != NULL; iter = iter->next) {
+                GUPnPDLNAValue *copy = gupnp_dlna_value_copy (iter->data,
+                                                              list->type);
 
-		copy = gupnp_dlna_value_copy (base, list->type);
-		if (copy != NULL)
-			dup->values = g_list_prepend (dup->values, copy);
-	}
-	dup->values = g_list_reverse (dup->values);
+                if (copy != NULL)
+                        dup->values = g_list_prepend (dup->values, copy);
+        }
+        dup->values = g_list_reverse (dup->values);
+        dup->sorted = list->sorted;
 
         return dup;
 }
@@ -207,6 +286,81 @@ gupnp_dlna_value_list_is_superset (GUPnPDLNAValueList *list,
         return FALSE;
 }
 
+/* Checks whether some info value could be accepted by both
+ * lists. Lists of different types never accept the same value. */
+gboolean
+gupnp_dlna_value_list_intersects (GUPnPDLNAValueList *list,
+                                  GUPnPDLNAValueList *other)
+{
+        GList *iter;
+        GList *other_iter;
+
+        g_return_val_if_fail (list != NULL, TRUE);
+        g_return_val_if_fail (other != NULL, TRUE);
+
+        if (list->type != other->type)
+                return FALSE;
+
+        for (iter = list->values; iter != NULL; iter = iter->next)
+                for (other_iter = other->values;
+                     other_iter != NULL;
+                     other_iter = other_iter->next)
+                        if (gupnp_dlna_value_intersects (iter->data,
+                                                         other_iter->data,
+                                                         list->type))
+                                return TRUE;
+
+        return FALSE;
+}
+
+/* Checks whether every info value accepted by @other is also
+ * accepted by @list. A value of @other split between several values
+ * of @list is not recognized, so this may give false negatives. */
+gboolean
+gupnp_dlna_value_list_covers (GUPnPDLNAValueList *list,
+                              GUPnPDLNAValueList *other)
+{
+        GList *iter;
+        GList *other_iter;
+
+        g_return_val_if_fail (list != NULL, FALSE);
+        g_return_val_if_fail (other != NULL, FALSE);
+
+        if (list->type != other->type)
+                return FALSE;
+
+        for (other_iter = other->values;
+             other_iter != NULL;
+             other_iter = other_iter->next) {
+                for (iter = list->values; iter != NULL; iter = iter->next)
+                        if (gupnp_dlna_value_covers (iter->data,
+                                                     other_iter->data,
+                                                     list->type))
+                                break;
+                if (iter == NULL)
+                        return FALSE;
+        }
+
+        return TRUE;
+}
+
+/* A rough share of all possible values of a field, in per mille,
+ * that @list accepts. */
+guint
+gupnp_dlna_value_list_get_acceptance (GUPnPDLNAValueList *list)
+{
+        GList *iter;
+        guint acceptance = 0;
+
+        g_return_val_if_fail (list != NULL, 1000);
+
+        for (iter = list->values; iter != NULL; iter = iter->next)
+                acceptance += gupnp_dlna_value_get_acceptance (iter->data,
+                                                               list->type);
+
+        return MIN (acceptance, 1000);
+}
+
 /**
  * gupnp_dlna_value_list_is_empty:
  * @list: (transfer none): A list.
@@ -23,6 +23,7 @@
 
 #include "gupnp-dlna-g-values-private.h"
 #include "gupnp-dlna-value-type.h"
+#include "gupnp-dlna-arena.h"
 
 struct _GUPnPDLNAValueType {
         gboolean
@@ -80,6 +81,12 @@ struct _GUPnPDLNAValueType {
                      GValue             *target,
                      GValue             *min,
                      GValue             *max);
+
+        /* Optional, only types owning heap memory need it. */
+        void
+        (* move_to_arena) (GUPnPDLNAValueType  *type,
+                           GUPnPDLNAValueUnion *value,
+                           GUPnPDLNAArena      *arena);
 };
 
 /* utils */
@@ -295,7 +302,8 @@ static GUPnPDLNAValueType bool_type_impl = {
         bool_compare,
         bool_get_g_type,
         bool_to_g_value,
-        bool_flatten
+        bool_flatten,
+        NULL
 };
 
 /* fraction */
@@ -442,7 +450,8 @@ static GUPnPDLNAValueType fraction_type_impl = {
         fraction_compare,
         fraction_get_g_type,
         fraction_to_g_value,
-        fraction_flatten
+        fraction_flatten,
+        NULL
 };
 
 /* int */
@@ -565,7 +574,8 @@ static GUPnPDLNAValueType int_type_impl = {
         int_compare,
         int_get_g_type,
         int_to_g_value,
-        int_flatten
+        int_flatten,
+        NULL
 };
 
 /* string */
@@ -669,6 +679,17 @@ string_flatten (GUPnPDLNAValueType *type G_GNUC_UNUSED,
         return FALSE;
 }
 
+static void
+string_move_to_arena (GUPnPDLNAValueType  *type G_GNUC_UNUSED,
+                      GUPnPDLNAValueUnion *value,
+                      GUPnPDLNAArena      *arena)
+{
+        gchar *heap_string = value->string_value;
+
+        value->string_value = gupnp_dlna_arena_strdup (arena, heap_string);
+        g_free (heap_string);
+}
+
 static GUPnPDLNAValueType string_type_impl = {
         string_init,
         string_copy,
@@ -681,7 +702,8 @@ static GUPnPDLNAValueType string_type_impl = {
         string_compare,
         string_get_g_type,
         string_to_g_value,
-        string_flatten
+        string_flatten,
+        string_move_to_arena
 };
 
 GUPnPDLNAValueType *
@@ -860,3 +882,18 @@ gupnp_dlna_value_type_flatten (GUPnPDLNAValueType *type,
 
         return type->flatten (type, target, from, to);
 }
+
+/* Moves any heap memory owned by value into arena. Afterwards the
+ * value must not be cleaned with gupnp_dlna_value_type_clean(). */
+void
+gupnp_dlna_value_type_move_to_arena (GUPnPDLNAValueType  *type,
+                                     GUPnPDLNAValueUnion *value,
+                                     GUPnPDLNAArena      *arena)
+{
+        g_return_if_fail (type != NULL);
+        g_return_if_fail (value != NULL);
+        g_return_if_fail (arena != NULL);
+
+        if (type->move_to_arena != NULL)
+                type->move_to_arena (type, value, arena);
+}
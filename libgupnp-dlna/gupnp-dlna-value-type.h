@@ -26,6 +26,7 @@
 #include <glib-object.h>
 
 #include "gupnp-dlna-value-union.h"
+#include "gupnp-dlna-arena.h"
 
 G_BEGIN_DECLS
 
@@ -96,6 +97,11 @@ gupnp_dlna_value_type_flatten (GUPnPDLNAValueType *type,
                                GValue             *from,
                                GValue             *to);
 
+void
+gupnp_dlna_value_type_move_to_arena (GUPnPDLNAValueType  *type,
+                                     GUPnPDLNAValueUnion *value,
+                                     GUPnPDLNAArena      *arena);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_VALUE_TYPE_H__ */
@@ -48,6 +48,12 @@ struct _GUPnPDLNAValueVTable {
                         GValue             *g_value);
 };
 
+/* Values allocated in an arena share the implementation with the heap
+ * ones, except for freeing - the arena releases them all at once. */
+static void
+arena_free (GUPnPDLNAValue     *base,
+            GUPnPDLNAValueType *type);
+
 /* single */
 typedef struct _GUPnPDLNAValueSingle GUPnPDLNAValueSingle;
 
@@ -89,6 +95,15 @@ static GUPnPDLNAValueVTable single_vtable = {
         single_to_g_value
 };
 
+static GUPnPDLNAValueVTable single_arena_vtable = {
+        single_is_superset,
+        single_copy,
+        arena_free,
+        single_to_string,
+        single_get_sort_value,
+        single_to_g_value
+};
+
 static gboolean
 single_is_superset (GUPnPDLNAValue     *base,
                     GUPnPDLNAInfoValue *info)
@@ -200,6 +215,15 @@ static GUPnPDLNAValueVTable range_vtable = {
         range_to_g_value
 };
 
+static GUPnPDLNAValueVTable range_arena_vtable = {
+        range_is_superset,
+        range_copy,
+        arena_free,
+        range_to_string,
+        range_get_sort_value,
+        range_to_g_value
+};
+
 static gboolean
 range_is_superset (GUPnPDLNAValue     *base,
                    GUPnPDLNAInfoValue *info)
@@ -292,6 +316,13 @@ range_to_g_value (GUPnPDLNAValue     *base,
         return result;
 }
 
+/* arena */
+static void
+arena_free (GUPnPDLNAValue     *base G_GNUC_UNUSED,
+            GUPnPDLNAValueType *type G_GNUC_UNUSED)
+{
+}
+
 /* API */
 
 GUPnPDLNAValue *
@@ -347,6 +378,70 @@ gupnp_dlna_value_new_ranged (GUPnPDLNAValueType *type,
         return (GUPnPDLNAValue *) range;
 }
 
+GUPnPDLNAValue *
+gupnp_dlna_value_new_single_in_arena (GUPnPDLNAValueType *type,
+                                      const gchar        *raw,
+                                      GUPnPDLNAArena     *arena)
+{
+        GUPnPDLNAValueSingle *value;
+        GUPnPDLNAValueUnion single;
+
+        g_return_val_if_fail (type != NULL, NULL);
+        g_return_val_if_fail (raw != NULL, NULL);
+        g_return_val_if_fail (arena != NULL, NULL);
+
+        if (!gupnp_dlna_value_type_init (type, &single, raw))
+                return NULL;
+        gupnp_dlna_value_type_move_to_arena (type, &single, arena);
+
+        value = gupnp_dlna_arena_alloc (arena, sizeof (GUPnPDLNAValueSingle));
+        value->base.vtable = &single_arena_vtable;
+        value->value = single;
+
+        return (GUPnPDLNAValue *) value;
+}
+
+GUPnPDLNAValue *
+gupnp_dlna_value_new_ranged_in_arena (GUPnPDLNAValueType *type,
+                                      const gchar        *min,
+                                      const gchar        *max,
+                                      GUPnPDLNAArena     *arena)
+{
+        GUPnPDLNAValueRange *range;
+        GUPnPDLNAValueUnion min_value;
+        GUPnPDLNAValueUnion max_value;
+
+        g_return_val_if_fail (type != NULL, NULL);
+        g_return_val_if_fail (min != NULL, NULL);
+        g_return_val_if_fail (max != NULL, NULL);
+        g_return_val_if_fail (arena != NULL, NULL);
+
+        if (!gupnp_dlna_value_type_init (type, &min_value, min))
+                return NULL;
+        if (!gupnp_dlna_value_type_init (type, &max_value, max)) {
+                gupnp_dlna_value_type_clean (type, &min_value);
+
+                return NULL;
+        }
+        if (!gupnp_dlna_value_type_verify_range (type,
+                                                 &min_value,
+                                                 &max_value)) {
+                gupnp_dlna_value_type_clean (type, &min_value);
+                gupnp_dlna_value_type_clean (type, &max_value);
+
+                return NULL;
+        }
+        gupnp_dlna_value_type_move_to_arena (type, &min_value, arena);
+        gupnp_dlna_value_type_move_to_arena (type, &max_value, arena);
+
+        range = gupnp_dlna_arena_alloc (arena, sizeof (GUPnPDLNAValueRange));
+        range->base.vtable = &range_arena_vtable;
+        range->min = min_value;
+        range->max = max_value;
+
+        return (GUPnPDLNAValue *) range;
+}
+
 gboolean
 gupnp_dlna_value_is_superset (GUPnPDLNAValue     *base,
                               GUPnPDLNAInfoValue *single)
@@ -442,3 +537,123 @@ gupnp_dlna_value_to_g_value (GUPnPDLNAValue     *base,
 
         return g_value;
 }
+
+/* Points @min and @max at the bounds of @base - a single value is
+ * its own both bounds. */
+static void
+get_bounds (GUPnPDLNAValue       *base,
+            GUPnPDLNAValueUnion **min,
+            GUPnPDLNAValueUnion **max)
+{
+        if (base->vtable->is_superset == range_is_superset) {
+                GUPnPDLNAValueRange *range = (GUPnPDLNAValueRange *) base;
+
+                *min = &range->min;
+                *max = &range->max;
+        } else {
+                GUPnPDLNAValueSingle *value = (GUPnPDLNAValueSingle *) base;
+
+                *min = &value->value;
+                *max = &value->value;
+        }
+}
+
+/* Checks whether some info value could be a subset of both @base
+ * and @other. */
+gboolean
+gupnp_dlna_value_intersects (GUPnPDLNAValue     *base,
+                             GUPnPDLNAValue     *other,
+                             GUPnPDLNAValueType *type)
+{
+        GUPnPDLNAValueUnion *base_min;
+        GUPnPDLNAValueUnion *base_max;
+        GUPnPDLNAValueUnion *other_min;
+        GUPnPDLNAValueUnion *other_max;
+
+        g_return_val_if_fail (base != NULL, TRUE);
+        g_return_val_if_fail (other != NULL, TRUE);
+        g_return_val_if_fail (type != NULL, TRUE);
+
+        get_bounds (base, &base_min, &base_max);
+        get_bounds (other, &other_min, &other_max);
+
+        if (base_min == base_max && other_min == other_max)
+                return gupnp_dlna_value_type_is_equal (type,
+                                                       base_min,
+                                                       other_min);
+        if (base_min == base_max)
+                return gupnp_dlna_value_type_is_in_range (type,
+                                                          other_min,
+                                                          other_max,
+                                                          base_min);
+        if (other_min == other_max)
+                return gupnp_dlna_value_type_is_in_range (type,
+                                                          base_min,
+                                                          base_max,
+                                                          other_min);
+
+        return (gupnp_dlna_value_type_compare (type,
+                                               base_min,
+                                               other_max) <= 0 &&
+                gupnp_dlna_value_type_compare (type,
+                                               other_min,
+                                               base_max) <= 0);
+}
+
+/* Checks whether every info value that is a subset of @other is
+ * also a subset of @base. */
+gboolean
+gupnp_dlna_value_covers (GUPnPDLNAValue     *base,
+                         GUPnPDLNAValue     *other,
+                         GUPnPDLNAValueType *type)
+{
+        GUPnPDLNAValueUnion *base_min;
+        GUPnPDLNAValueUnion *base_max;
+        GUPnPDLNAValueUnion *other_min;
+        GUPnPDLNAValueUnion *other_max;
+
+        g_return_val_if_fail (base != NULL, FALSE);
+        g_return_val_if_fail (other != NULL, FALSE);
+        g_return_val_if_fail (type != NULL, FALSE);
+
+        get_bounds (base, &base_min, &base_max);
+        get_bounds (other, &other_min, &other_max);
+
+        if (base_min == base_max)
+                return (gupnp_dlna_value_type_is_equal (type,
+                                                        base_min,
+                                                        other_min) &&
+                        gupnp_dlna_value_type_is_equal (type,
+                                                        base_min,
+                                                        other_max));
+
+        return (gupnp_dlna_value_type_is_in_range (type,
+                                                   base_min,
+                                                   base_max,
+                                                   other_min) &&
+                gupnp_dlna_value_type_is_in_range (type,
+                                                   base_min,
+                                                   base_max,
+                                                   other_max));
+}
+
+/* A rough share of all possible values of a field, in per mille,
+ * that @base accepts. Used only to check the most selective fields
+ * first. */
+guint
+gupnp_dlna_value_get_acceptance (GUPnPDLNAValue     *base,
+                                 GUPnPDLNAValueType *type)
+{
+        GUPnPDLNAValueUnion *min;
+        GUPnPDLNAValueUnion *max;
+
+        g_return_val_if_fail (base != NULL, 1000);
+        g_return_val_if_fail (type != NULL, 1000);
+
+        if (type == gupnp_dlna_value_type_bool ())
+                return 500;
+
+        get_bounds (base, &min, &max);
+
+        return (min == max) ? 1 : 100;
+}
@@ -25,6 +25,7 @@
 #include <glib.h>
 #include <glib-object.h>
 
+#include "gupnp-dlna-arena.h"
 #include "gupnp-dlna-info-value.h"
 #include "gupnp-dlna-value-type.h"
 
@@ -46,6 +47,17 @@ gupnp_dlna_value_new_ranged (GUPnPDLNAValueType *type,
                              const gchar        *min,
                              const gchar        *max);
 
+GUPnPDLNAValue *
+gupnp_dlna_value_new_single_in_arena (GUPnPDLNAValueType *type,
+                                      const gchar        *single,
+                                      GUPnPDLNAArena     *arena);
+
+GUPnPDLNAValue *
+gupnp_dlna_value_new_ranged_in_arena (GUPnPDLNAValueType *type,
+                                      const gchar        *min,
+                                      const gchar        *max,
+                                      GUPnPDLNAArena     *arena);
+
 gboolean
 gupnp_dlna_value_is_superset (GUPnPDLNAValue     *base,
                               GUPnPDLNAInfoValue *single);
@@ -67,6 +79,20 @@ gupnp_dlna_value_compare (GUPnPDLNAValue     *base,
                           GUPnPDLNAValue     *other,
                           GUPnPDLNAValueType *type);
 
+gboolean
+gupnp_dlna_value_intersects (GUPnPDLNAValue     *base,
+                             GUPnPDLNAValue     *other,
+                             GUPnPDLNAValueType *type);
+
+gboolean
+gupnp_dlna_value_covers (GUPnPDLNAValue     *base,
+                         GUPnPDLNAValue     *other,
+                         GUPnPDLNAValueType *type);
+
+guint
+gupnp_dlna_value_get_acceptance (GUPnPDLNAValue     *base,
+                                 GUPnPDLNAValueType *type);
+
 GValue *
 gupnp_dlna_value_to_g_value (GUPnPDLNAValue     *base,
                              GUPnPDLNAValueType *type);
@@ -265,6 +265,59 @@ typedef struct {
 #define GUPNP_DLNA_STRING_VALUE_UNSUPPORTED \
         ((GUPnPDLNAStringValue) {NULL, GUPNP_DLNA_VALUE_STATE_UNSUPPORTED})
 
+/**
+ * GUPnPDLNAConstStringValue:
+ * @value: The string value.
+ * @state: The state of #GUPnPDLNAConstStringValue.
+ *
+ * GUPnP DLNA Value representing a borrowed string value of some
+ * metadata attribute. Unlike in #GUPnPDLNAStringValue, @value is
+ * owned by whoever returned it and must not be freed.
+ */
+typedef struct {
+        const gchar         *value;
+        GUPnPDLNAValueState  state;
+} GUPnPDLNAConstStringValue;
+
+/**
+ * GUPNP_DLNA_CONST_STRING_VALUE_UNSET:
+ *
+ * Static initializer for unset #GUPnPDLNAConstStringValue. Can be
+ * used in two ways:
+ *
+ * |[
+ *   GUPnPDLNAConstStringValue value = GUPNP_DLNA_CONST_STRING_VALUE_UNSET;
+ * ]|
+ *
+ * or
+ *
+ * |[
+ *   return GUPNP_DLNA_CONST_STRING_VALUE_UNSET;
+ * ]|
+ */
+#define GUPNP_DLNA_CONST_STRING_VALUE_UNSET \
+        ((GUPnPDLNAConstStringValue) {NULL, GUPNP_DLNA_VALUE_STATE_UNSET})
+/**
+ * GUPNP_DLNA_CONST_STRING_VALUE_UNSUPPORTED:
+ *
+ * Static initializer for unsupported #GUPnPDLNAConstStringValue. Can
+ * be used in two ways:
+ *
+ * |[
+ *   GUPnPDLNAConstStringValue value =
+ *                                GUPNP_DLNA_CONST_STRING_VALUE_UNSUPPORTED;
+ * ]|
+ *
+ * or
+ *
+ * |[
+ *   return GUPNP_DLNA_CONST_STRING_VALUE_UNSUPPORTED;
+ * ]|
+ */
+#define GUPNP_DLNA_CONST_STRING_VALUE_UNSUPPORTED \
+        ((GUPnPDLNAConstStringValue) \
+         {NULL, GUPNP_DLNA_VALUE_STATE_UNSUPPORTED})
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_VALUES_H__ */
@@ -47,9 +47,11 @@
  */
 
 #include "gupnp-dlna-video-information.h"
+#include "gupnp-dlna-string-cache-private.h"
 
 struct _GUPnPDLNAVideoInformationPrivate {
-        gpointer placeholder;
+        /* owned strings handed out by the default peek_* */
+        GUPnPDLNAStringCache strings;
 };
 
 typedef struct _GUPnPDLNAVideoInformationPrivate
@@ -59,10 +61,27 @@ G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GUPnPDLNAVideoInformation,
                                      gupnp_dlna_video_information,
                                      G_TYPE_OBJECT)
 
+static void
+gupnp_dlna_video_information_finalize (GObject *object)
+{
+        GUPnPDLNAVideoInformation *info = GUPNP_DLNA_VIDEO_INFORMATION (object);
+        GUPnPDLNAVideoInformationPrivate *priv =
+                gupnp_dlna_video_information_get_instance_private (info);
+        GObjectClass *parent_class =
+                G_OBJECT_CLASS (gupnp_dlna_video_information_parent_class);
+
+        gupnp_dlna_string_cache_clear (&priv->strings);
+        parent_class->finalize (object);
+}
+
 static void
 gupnp_dlna_video_information_class_init
                                     (GUPnPDLNAVideoInformationClass *info_class)
 {
+        GObjectClass *object_class = G_OBJECT_CLASS (info_class);
+
+        object_class->finalize = gupnp_dlna_video_information_finalize;
+
         info_class->get_bitrate = NULL;
         info_class->get_framerate = NULL;
         info_class->get_height = NULL;
@@ -74,11 +93,18 @@ gupnp_dlna_video_information_class_init
         info_class->is_system_stream = NULL;
         info_class->get_width = NULL;
         info_class->get_mime = NULL;
+        info_class->peek_level = NULL;
+        info_class->peek_profile = NULL;
+        info_class->peek_mime = NULL;
 }
 
 static void
 gupnp_dlna_video_information_init (GUPnPDLNAVideoInformation *info)
 {
+        GUPnPDLNAVideoInformationPrivate *priv =
+                gupnp_dlna_video_information_get_instance_private (info);
+
+        gupnp_dlna_string_cache_init (&priv->strings);
 }
 
 /**
@@ -356,3 +382,117 @@ gupnp_dlna_video_information_get_mime (GUPnPDLNAVideoInformation *info)
 
         return info_class->get_mime (info);
 }
+
+/**
+ * gupnp_dlna_video_information_peek_level: (skip)
+ * @info: A #GUPnPDLNAVideoInformation object.
+ *
+ * Gets the same value as gupnp_dlna_video_information_get_level(),
+ * but without copying the string. The string is owned by @info and
+ * stays valid for its lifetime.
+ *
+ * Returns: A level.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_video_information_peek_level (GUPnPDLNAVideoInformation *info)
+{
+        GUPnPDLNAVideoInformationClass *info_class;
+        GUPnPDLNAVideoInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_VIDEO_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_VIDEO_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                            (GUPNP_DLNA_IS_VIDEO_INFORMATION_CLASS (info_class),
+                             GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_level != NULL)
+                return info_class->peek_level (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_level;
+        priv = gupnp_dlna_video_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "level",
+                                             get,
+                                             info);
+}
+
+/**
+ * gupnp_dlna_video_information_peek_profile: (skip)
+ * @info: A #GUPnPDLNAVideoInformation object.
+ *
+ * Gets the same value as gupnp_dlna_video_information_get_profile(),
+ * but without copying the string. The string is owned by @info and
+ * stays valid for its lifetime.
+ *
+ * Returns: A profile.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_video_information_peek_profile (GUPnPDLNAVideoInformation *info)
+{
+        GUPnPDLNAVideoInformationClass *info_class;
+        GUPnPDLNAVideoInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_VIDEO_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_VIDEO_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                            (GUPNP_DLNA_IS_VIDEO_INFORMATION_CLASS (info_class),
+                             GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_profile != NULL)
+                return info_class->peek_profile (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_profile;
+        priv = gupnp_dlna_video_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "profile",
+                                             get,
+                                             info);
+}
+
+/**
+ * gupnp_dlna_video_information_peek_mime: (skip)
+ * @info: A #GUPnPDLNAVideoInformation object.
+ *
+ * Gets the same value as gupnp_dlna_video_information_get_mime(), but
+ * without copying the string. The string is owned by @info and stays
+ * valid for its lifetime.
+ *
+ * Returns: A MIME type.
+ */
+GUPnPDLNAConstStringValue
+gupnp_dlna_video_information_peek_mime (GUPnPDLNAVideoInformation *info)
+{
+        GUPnPDLNAVideoInformationClass *info_class;
+        GUPnPDLNAVideoInformationPrivate *priv;
+        GUPnPDLNAStringCacheGetFunc get;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_VIDEO_INFORMATION (info),
+                              GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        info_class = GUPNP_DLNA_VIDEO_INFORMATION_GET_CLASS (info);
+
+        g_return_val_if_fail
+                            (GUPNP_DLNA_IS_VIDEO_INFORMATION_CLASS (info_class),
+                             GUPNP_DLNA_CONST_STRING_VALUE_UNSET);
+
+        if (info_class->peek_mime != NULL)
+                return info_class->peek_mime (info);
+
+        get = (GUPnPDLNAStringCacheGetFunc) info_class->get_mime;
+        priv = gupnp_dlna_video_information_get_instance_private (info);
+
+        return gupnp_dlna_string_cache_peek (&priv->strings,
+                                             "mime",
+                                             get,
+                                             info);
+}
@@ -72,6 +72,15 @@ G_DECLARE_DERIVABLE_TYPE (GUPnPDLNAVideoInformation,
  * width.
  * @get_mime: This is called by #GUPnPDLNAProfileGuesser to get a MIME
  * type.
+ * @peek_level: This is called by #GUPnPDLNAProfileGuesser to get
+ * a level without copying it. Optional, by default the result of
+ * @get_level is cached.
+ * @peek_profile: This is called by #GUPnPDLNAProfileGuesser to get
+ * a profile without copying it. Optional, by default the result of
+ * @get_profile is cached.
+ * @peek_mime: This is called by #GUPnPDLNAProfileGuesser to get
+ * a MIME type without copying it. Optional, by default the result of
+ * @get_mime is cached.
  * @_reserved: Padding. Ignore it.
  */
 struct _GUPnPDLNAVideoInformationClass {
@@ -110,7 +119,16 @@ struct _GUPnPDLNAVideoInformationClass {
         GUPnPDLNAStringValue
         (* get_mime) (GUPnPDLNAVideoInformation *info);
 
-        gpointer _reserved[12];
+        GUPnPDLNAConstStringValue
+        (* peek_level) (GUPnPDLNAVideoInformation *info);
+
+        GUPnPDLNAConstStringValue
+        (* peek_profile) (GUPnPDLNAVideoInformation *info);
+
+        GUPnPDLNAConstStringValue
+        (* peek_mime) (GUPnPDLNAVideoInformation *info);
+
+        gpointer _reserved[9];
 };
 
 GUPnPDLNAIntValue
@@ -147,6 +165,15 @@ gupnp_dlna_video_information_get_width (GUPnPDLNAVideoInformation *info);
 GUPnPDLNAStringValue
 gupnp_dlna_video_information_get_mime (GUPnPDLNAVideoInformation *info);
 
+GUPnPDLNAConstStringValue
+gupnp_dlna_video_information_peek_level (GUPnPDLNAVideoInformation *info);
+
+GUPnPDLNAConstStringValue
+gupnp_dlna_video_information_peek_profile (GUPnPDLNAVideoInformation *info);
+
+GUPnPDLNAConstStringValue
+gupnp_dlna_video_information_peek_mime (GUPnPDLNAVideoInformation *info);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_VIDEO_INFORMATION_H__ */
@@ -21,6 +21,7 @@
 
 #include "gupnp-dlna-profile-guesser.h"
 #include "gupnp-dlna-profile.h"
+#include "gupnp-dlna-profile-changes.h"
 #include "gupnp-dlna-restriction.h"
 #include "gupnp-dlna-value-list.h"
 #include "gupnp-dlna-g-values.h"
@@ -28,9 +28,10 @@
 
 struct _GUPnPDLNAGstAudioInformationPrivate {
         GstDiscovererInfo *info;
-        GList *stream_list;
-        GstDiscovererAudioInfo *audio_info;
-        GstCaps *caps;
+        GUPnPDLNAGstStreams *streams;
+        GUPnPDLNAGstFieldTable *fields;
+        /* guards lazily initialized fields above */
+        GRecMutex lock;
 };
 typedef struct _GUPnPDLNAGstAudioInformationPrivate
         GUPnPDLNAGstAudioInformationPrivate;
@@ -50,105 +51,116 @@ enum
         PROP_INFO
 };
 
-static GstDiscovererAudioInfo *
-get_audio_info (GUPnPDLNAGstAudioInformation *gst_info)
+static GUPnPDLNAGstStreams *
+get_streams (GUPnPDLNAGstAudioInformation *gst_info)
 {
         GUPnPDLNAGstAudioInformationPrivate *priv =
                 gupnp_dlna_gst_audio_information_get_instance_private (
                         gst_info);
+        GUPnPDLNAGstStreams *streams;
 
-        if (!priv->audio_info) {
-                GList *iter;
-                gboolean adts_hack = FALSE;
-                int stream_count = 0;
-
-                if (!priv->stream_list) {
-                        priv->stream_list =
-                               gst_discoverer_info_get_stream_list (priv->info);
-                        if (!priv->stream_list)
-                                return NULL;
-                }
-
-                /* For ADTS files we get two audio streams and the important
-                 * information is only on the "outer" stream which is the
-                 * second stream in the stream list. If we only have audio
-                 * streams, we skip the first audio stream we see
-                 *
-                 * Works around
-                 * https://bugzilla.gnome.org/show_bug.cgi?id=699212
-                 */
-                iter = gst_discoverer_info_get_audio_streams (priv->info);
-                stream_count = g_list_length (priv->stream_list);
-
-                adts_hack = (stream_count == g_list_length (iter)) &&
-                            stream_count == 2;
-                gst_discoverer_stream_info_list_free (iter);
-
-                for (iter = priv->stream_list; iter; iter = iter->next) {
-                        GstDiscovererStreamInfo *stream =
-                                        GST_DISCOVERER_STREAM_INFO (iter->data);
-                        GType stream_type = G_TYPE_FROM_INSTANCE (stream);
-
-                        /* copy caps from other stream */
-                        if (adts_hack && !iter->next) {
-                                priv->caps = gst_discoverer_stream_info_get_caps (stream);
-
-                                continue;
-                        }
-
-                        if (stream_type == GST_TYPE_DISCOVERER_AUDIO_INFO) {
-                                priv->audio_info =
-                                             GST_DISCOVERER_AUDIO_INFO (stream);
-
-                                if (!adts_hack)
-                                        break;
-                        }
-                }
-        }
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->streams && priv->info)
+                priv->streams = gupnp_dlna_gst_streams_new (priv->info);
+        streams = priv->streams;
+        g_rec_mutex_unlock (&priv->lock);
+
+        return streams;
+}
+
+static GstDiscovererAudioInfo *
+get_audio_info (GUPnPDLNAGstAudioInformation *gst_info)
+{
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
 
-        return priv->audio_info;
+        return streams ? streams->audio : NULL;
 }
 
 static GstCaps *
 get_caps (GUPnPDLNAGstAudioInformation *gst_info)
 {
-        GstDiscovererStreamInfo *info = GST_DISCOVERER_STREAM_INFO (get_audio_info (gst_info));
-        GUPnPDLNAGstAudioInformationPrivate *priv =
-                gupnp_dlna_gst_audio_information_get_instance_private (
-                        gst_info);
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
 
-        if (!priv->caps)
-                priv->caps = gst_discoverer_stream_info_get_caps (info);
+        return streams ? streams->audio_caps : NULL;
+}
+
+static GstTagList *
+get_tags (GUPnPDLNAGstAudioInformation *gst_info)
+{
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
 
-        return priv->caps;
+        return streams ? streams->audio_tags : NULL;
 }
 
-static GUPnPDLNAIntValue
-get_int_value (GUPnPDLNAGstAudioInformation *gst_info,
-               const gchar *name)
+static GUPnPDLNAGstFieldTable *
+get_fields (GUPnPDLNAGstAudioInformation *gst_info)
 {
-        GstCaps *caps = get_caps (gst_info);
-        GstDiscovererStreamInfo *stream =
-                         GST_DISCOVERER_STREAM_INFO (get_audio_info (gst_info));
         GUPnPDLNAGstAudioInformationPrivate *priv =
                 gupnp_dlna_gst_audio_information_get_instance_private (
                         gst_info);
+        GUPnPDLNAGstFieldTable *fields;
+
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->fields)
+                priv->fields = gupnp_dlna_gst_field_table_new
+                                        (get_caps (gst_info),
+                                         GST_DISCOVERER_STREAM_INFO
+                                                   (get_audio_info (gst_info)),
+                                         priv->info,
+                                         get_tags (gst_info));
+        fields = priv->fields;
+        g_rec_mutex_unlock (&priv->lock);
+
+        return fields;
+}
 
-        return gupnp_dlna_gst_get_int_value (caps, stream, priv->info, name);
+static GUPnPDLNAIntValue
+get_int_value (GUPnPDLNAGstAudioInformation *gst_info,
+               const gchar *name)
+{
+        return gupnp_dlna_gst_field_table_get_int (get_fields (gst_info), name);
 }
 
 static GUPnPDLNAStringValue
 get_string_value (GUPnPDLNAGstAudioInformation *gst_info,
                   const gchar *name)
 {
-        GstCaps *caps = get_caps (gst_info);
-        GstDiscovererStreamInfo *stream =
-                         GST_DISCOVERER_STREAM_INFO (get_audio_info (gst_info));
-        GUPnPDLNAGstAudioInformationPrivate *priv =
-                gupnp_dlna_gst_audio_information_get_instance_private (
-                        gst_info);
+        return gupnp_dlna_gst_field_table_get_string (get_fields (gst_info),
+                                                      name);
+}
+
+static GUPnPDLNAConstStringValue
+peek_string_value (GUPnPDLNAGstAudioInformation *gst_info,
+                   const gchar *name)
+{
+        return gupnp_dlna_gst_field_table_peek_string (get_fields (gst_info),
+                                                       name);
+}
+
+/* Without a decoder the depth is known only for raw audio, as the
+ * number in its sample format, like 16 in S16LE or 24 in S24_32LE. */
+static GUPnPDLNAIntValue
+get_depth_from_caps (GUPnPDLNAGstAudioInformation *gst_info)
+{
+        GUPnPDLNAIntValue value = get_int_value (gst_info, "depth");
+        GUPnPDLNAConstStringValue format;
+        guint64 depth;
+
+        if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
+                return value;
 
-        return gupnp_dlna_gst_get_string_value (caps, stream, priv->info, name);
+        format = peek_string_value (gst_info, "format");
+        if (format.state != GUPNP_DLNA_VALUE_STATE_SET ||
+            format.value[0] == '\0')
+                return value;
+
+        depth = g_ascii_strtoull (format.value + 1, NULL, 10);
+        if (depth > 0 && depth <= G_MAXINT) {
+                value.state = GUPNP_DLNA_VALUE_STATE_SET;
+                value.value = (gint) depth;
+        }
+
+        return value;
 }
 
 static GUPnPDLNAIntValue
@@ -157,9 +169,13 @@ backend_get_bitrate (GUPnPDLNAAudioInformation *self)
         GUPnPDLNAGstAudioInformation* gst_info =
                                         GUPNP_DLNA_GST_AUDIO_INFORMATION (self);
         GstDiscovererAudioInfo *audio_info = get_audio_info (gst_info);
-        guint data = gst_discoverer_audio_info_get_bitrate (audio_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
+
+        if (audio_info == NULL)
+                return get_int_value (gst_info, "bitrate");
 
+        data = gst_discoverer_audio_info_get_bitrate (audio_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -176,9 +192,14 @@ backend_get_channels (GUPnPDLNAAudioInformation *self)
         GUPnPDLNAGstAudioInformation* gst_info =
                                         GUPNP_DLNA_GST_AUDIO_INFORMATION (self);
         GstDiscovererAudioInfo *audio_info = get_audio_info (gst_info);
-        guint data = gst_discoverer_audio_info_get_channels (audio_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
 
+        /* streams found by a header probe have only caps and tags */
+        if (audio_info == NULL)
+                return get_int_value (gst_info, "channels");
+
+        data = gst_discoverer_audio_info_get_channels (audio_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -193,9 +214,13 @@ backend_get_depth (GUPnPDLNAAudioInformation *self)
         GUPnPDLNAGstAudioInformation* gst_info =
                                         GUPNP_DLNA_GST_AUDIO_INFORMATION (self);
         GstDiscovererAudioInfo *audio_info = get_audio_info (gst_info);
-        guint data = gst_discoverer_audio_info_get_depth (audio_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
+
+        if (audio_info == NULL)
+                return get_depth_from_caps (gst_info);
 
+        data = gst_discoverer_audio_info_get_depth (audio_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -221,6 +246,14 @@ backend_get_level (GUPnPDLNAAudioInformation *self)
         return get_string_value (gst_info, "level");
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_level (GUPnPDLNAAudioInformation *self)
+{
+        GUPnPDLNAGstAudioInformation* gst_info =
+                                        GUPNP_DLNA_GST_AUDIO_INFORMATION (self);
+        return peek_string_value (gst_info, "level");
+}
+
 static GUPnPDLNAIntValue
 backend_get_mpeg_audio_version (GUPnPDLNAAudioInformation *self)
 {
@@ -248,15 +281,29 @@ backend_get_profile (GUPnPDLNAAudioInformation *self)
         return get_string_value (gst_info, "profile");
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_profile (GUPnPDLNAAudioInformation *self)
+{
+        GUPnPDLNAGstAudioInformation* gst_info =
+                                        GUPNP_DLNA_GST_AUDIO_INFORMATION (self);
+
+        return peek_string_value (gst_info, "profile");
+}
+
 static GUPnPDLNAIntValue
 backend_get_rate (GUPnPDLNAAudioInformation *self)
 {
         GUPnPDLNAGstAudioInformation* gst_info =
                                         GUPNP_DLNA_GST_AUDIO_INFORMATION (self);
         GstDiscovererAudioInfo *audio_info = get_audio_info (gst_info);
-        guint data = gst_discoverer_audio_info_get_sample_rate (audio_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
+
+        /* streams found by a header probe have only caps and tags */
+        if (audio_info == NULL)
+                return get_int_value (gst_info, "rate");
 
+        data = gst_discoverer_audio_info_get_sample_rate (audio_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -274,6 +321,15 @@ backend_get_stream_format (GUPnPDLNAAudioInformation *self)
         return get_string_value (gst_info, "stream-format");
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_stream_format (GUPnPDLNAAudioInformation *self)
+{
+        GUPnPDLNAGstAudioInformation* gst_info =
+                                        GUPNP_DLNA_GST_AUDIO_INFORMATION (self);
+
+        return peek_string_value (gst_info, "stream-format");
+}
+
 static GUPnPDLNAIntValue
 backend_get_wma_version (GUPnPDLNAAudioInformation *self)
 {
@@ -292,6 +348,15 @@ backend_get_mime (GUPnPDLNAAudioInformation *self)
         return gupnp_dlna_gst_get_mime (get_caps (gst_info));
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_mime (GUPnPDLNAAudioInformation *self)
+{
+        GUPnPDLNAGstAudioInformation* gst_info =
+                                        GUPNP_DLNA_GST_AUDIO_INFORMATION (self);
+
+        return gupnp_dlna_gst_peek_mime (get_caps (gst_info));
+}
+
 static void
 gupnp_dlna_gst_audio_information_dispose (GObject *object)
 {
@@ -302,15 +367,27 @@ gupnp_dlna_gst_audio_information_dispose (GObject *object)
         GObjectClass *parent_class =
                  G_OBJECT_CLASS (gupnp_dlna_gst_audio_information_parent_class);
 
+        /* fields borrow values from streams */
+        g_clear_pointer (&priv->fields, gupnp_dlna_gst_field_table_free);
         g_clear_pointer (&priv->info, gupnp_dlna_gst_discoverer_info_unref);
-        g_clear_pointer (&priv->stream_list,
-                         gst_discoverer_stream_info_list_free);
-        /* priv->audio_info is freed with stream list above */
-        priv->audio_info = NULL;
-        g_clear_pointer (&priv->caps, gst_caps_unref);
+        g_clear_pointer (&priv->streams, gupnp_dlna_gst_streams_unref);
         parent_class->dispose (object);
 }
 
+static void
+gupnp_dlna_gst_audio_information_finalize (GObject *object)
+{
+        GUPnPDLNAGstAudioInformation *info =
+                                      GUPNP_DLNA_GST_AUDIO_INFORMATION (object);
+        GUPnPDLNAGstAudioInformationPrivate *priv =
+                gupnp_dlna_gst_audio_information_get_instance_private (info);
+        GObjectClass *parent_class =
+                 G_OBJECT_CLASS (gupnp_dlna_gst_audio_information_parent_class);
+
+        g_rec_mutex_clear (&priv->lock);
+        parent_class->finalize (object);
+}
+
 static void
 gupnp_dlna_gst_audio_information_set_property (GObject      *object,
                                                guint         property_id,
@@ -326,6 +403,10 @@ gupnp_dlna_gst_audio_information_set_property (GObject      *object,
         case PROP_INFO:
                 g_clear_pointer (&priv->info,
                                  gupnp_dlna_gst_discoverer_info_unref);
+                g_clear_pointer (&priv->fields,
+                                 gupnp_dlna_gst_field_table_free);
+                g_clear_pointer (&priv->streams,
+                                 gupnp_dlna_gst_streams_unref);
                 priv->info =
                         GST_DISCOVERER_INFO (g_value_dup_object (value));
                 break;
@@ -372,6 +453,7 @@ gupnp_dlna_gst_audio_information_class_init
         object_class->set_property =
                                   gupnp_dlna_gst_audio_information_set_property;
         object_class->dispose = gupnp_dlna_gst_audio_information_dispose;
+        object_class->finalize = gupnp_dlna_gst_audio_information_finalize;
 
         info_class->get_bitrate = backend_get_bitrate;
         info_class->get_channels = backend_get_channels;
@@ -385,6 +467,10 @@ gupnp_dlna_gst_audio_information_class_init
         info_class->get_stream_format = backend_get_stream_format;
         info_class->get_wma_version = backend_get_wma_version;
         info_class->get_mime = backend_get_mime;
+        info_class->peek_level = backend_peek_level;
+        info_class->peek_profile = backend_peek_profile;
+        info_class->peek_stream_format = backend_peek_stream_format;
+        info_class->peek_mime = backend_peek_mime;
 
         pspec = g_param_spec_object ("info",
                                      "info",
@@ -400,25 +486,51 @@ gupnp_dlna_gst_audio_information_class_init
 static void
 gupnp_dlna_gst_audio_information_init (GUPnPDLNAGstAudioInformation *self)
 {
+        GUPnPDLNAGstAudioInformationPrivate *priv =
+                gupnp_dlna_gst_audio_information_get_instance_private (self);
+
+        g_rec_mutex_init (&priv->lock);
+}
+
+/* Creates the information borrowing already classified @streams,
+ * or returns %NULL if there is no audio stream among them. */
+GUPnPDLNAGstAudioInformation *
+gupnp_dlna_gst_audio_information_new_from_streams
+                                        (GUPnPDLNAGstStreams *streams)
+{
+        GUPnPDLNAGstAudioInformation *audio_info;
+        GUPnPDLNAGstAudioInformationPrivate *priv;
+
+        g_return_val_if_fail (streams != NULL, NULL);
+
+        if (!streams->has_audio)
+                return NULL;
+
+        audio_info = GUPNP_DLNA_GST_AUDIO_INFORMATION
+                                (g_object_new
+                                     (GUPNP_TYPE_DLNA_GST_AUDIO_INFORMATION,
+                                      "info", streams->info,
+                                      NULL));
+        priv = gupnp_dlna_gst_audio_information_get_instance_private
+                                        (audio_info);
+        priv->streams = gupnp_dlna_gst_streams_ref (streams);
+
+        return audio_info;
 }
 
 GUPnPDLNAGstAudioInformation *
-gupnp_dlna_gst_audio_information_new_from_discoverer_info (GstDiscovererInfo *info)
+gupnp_dlna_gst_audio_information_new_from_discoverer_info
+                                        (GstDiscovererInfo *info)
 {
-        GList* audio_list;
-        GUPnPDLNAGstAudioInformation *audio_info = NULL;
+        GUPnPDLNAGstStreams *streams;
+        GUPnPDLNAGstAudioInformation *audio_info;
 
         g_return_val_if_fail (GST_IS_DISCOVERER_INFO (info), NULL);
 
-        audio_list = gst_discoverer_info_get_audio_streams (info);
-
-        if (audio_list) {
-                audio_info = GUPNP_DLNA_GST_AUDIO_INFORMATION (g_object_new
-                                         (GUPNP_TYPE_DLNA_GST_AUDIO_INFORMATION,
-                                          "info", info,
-                                          NULL));
-                gst_discoverer_stream_info_list_free (audio_list);
-        }
+        streams = gupnp_dlna_gst_streams_new (info);
+        audio_info = gupnp_dlna_gst_audio_information_new_from_streams
+                                        (streams);
+        gupnp_dlna_gst_streams_unref (streams);
 
         return audio_info;
 }
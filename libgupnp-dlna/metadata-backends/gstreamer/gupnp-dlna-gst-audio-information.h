@@ -25,6 +25,7 @@
 #include <glib-object.h>
 #include <gst/pbutils/pbutils.h>
 #include "gupnp-dlna-audio-information.h"
+#include "gupnp-dlna-gst-info-utils.h"
 
 G_BEGIN_DECLS
 
@@ -59,6 +60,10 @@ GUPnPDLNAGstAudioInformation *
 gupnp_dlna_gst_audio_information_new_from_discoverer_info
                                         (GstDiscovererInfo *info);
 
+GUPnPDLNAGstAudioInformation *
+gupnp_dlna_gst_audio_information_new_from_streams
+                                        (GUPnPDLNAGstStreams *streams);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_GST_AUDIO_INFORMATION_H__ */
@@ -27,8 +27,10 @@
 
 struct _GUPnPDLNAGstContainerInformationPrivate {
         GstDiscovererInfo *info;
-        GstDiscovererStreamInfo *container_info;
-        GstCaps *caps;
+        GUPnPDLNAGstStreams *streams;
+        GUPnPDLNAGstFieldTable *fields;
+        /* guards lazily initialized fields above */
+        GRecMutex lock;
 };
 typedef struct _GUPnPDLNAGstContainerInformationPrivate
         GUPnPDLNAGstContainerInformationPrivate;
@@ -48,73 +50,97 @@ enum
         PROP_INFO
 };
 
-static GstDiscovererStreamInfo *
-get_container_info (GUPnPDLNAGstContainerInformation *gst_info)
+static GUPnPDLNAGstStreams *
+get_streams (GUPnPDLNAGstContainerInformation *gst_info)
 {
         GUPnPDLNAGstContainerInformationPrivate *priv =
                 gupnp_dlna_gst_container_information_get_instance_private (
                         gst_info);
+        GUPnPDLNAGstStreams *streams;
 
-        if (!priv->container_info) {
-                priv->container_info =
-                               gst_discoverer_info_get_stream_info (priv->info);
-        }
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->streams && priv->info)
+                priv->streams = gupnp_dlna_gst_streams_new (priv->info);
+        streams = priv->streams;
+        g_rec_mutex_unlock (&priv->lock);
+
+        return streams;
+}
 
-        return priv->container_info;
+static GstDiscovererStreamInfo *
+get_container_info (GUPnPDLNAGstContainerInformation *gst_info)
+{
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
+
+        return streams ? streams->container : NULL;
 }
 
 static GstCaps *
 get_caps (GUPnPDLNAGstContainerInformation *gst_info)
 {
-        GUPnPDLNAGstContainerInformationPrivate *priv =
-                gupnp_dlna_gst_container_information_get_instance_private (
-                        gst_info);
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
 
-        if (!priv->caps) {
-                priv->caps = gst_discoverer_stream_info_get_caps
-                                        (get_container_info (gst_info));
-        }
+        return streams ? streams->container_caps : NULL;
+}
+
+static GstTagList *
+get_tags (GUPnPDLNAGstContainerInformation *gst_info)
+{
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
 
-        return priv->caps;
+        return streams ? streams->container_tags : NULL;
 }
 
-static GUPnPDLNAIntValue
-get_int_value (GUPnPDLNAGstContainerInformation *gst_info,
-               const gchar *name)
+static GUPnPDLNAGstFieldTable *
+get_fields (GUPnPDLNAGstContainerInformation *gst_info)
 {
-        GstCaps *caps = get_caps (gst_info);
-        GstDiscovererStreamInfo *stream = get_container_info (gst_info);
         GUPnPDLNAGstContainerInformationPrivate *priv =
                 gupnp_dlna_gst_container_information_get_instance_private (
                         gst_info);
+        GUPnPDLNAGstFieldTable *fields;
+
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->fields)
+                priv->fields = gupnp_dlna_gst_field_table_new
+                                        (get_caps (gst_info),
+                                         get_container_info (gst_info),
+                                         priv->info,
+                                         get_tags (gst_info));
+        fields = priv->fields;
+        g_rec_mutex_unlock (&priv->lock);
+
+        return fields;
+}
 
-        return gupnp_dlna_gst_get_int_value (caps, stream, priv->info, name);
+static GUPnPDLNAIntValue
+get_int_value (GUPnPDLNAGstContainerInformation *gst_info,
+               const gchar *name)
+{
+        return gupnp_dlna_gst_field_table_get_int (get_fields (gst_info), name);
 }
 
 static GUPnPDLNAStringValue
 get_string_value (GUPnPDLNAGstContainerInformation *gst_info,
                   const gchar *name)
 {
-        GstCaps *caps = get_caps (gst_info);
-        GstDiscovererStreamInfo *stream = get_container_info (gst_info);
-        GUPnPDLNAGstContainerInformationPrivate *priv =
-                gupnp_dlna_gst_container_information_get_instance_private (
-                        gst_info);
+        return gupnp_dlna_gst_field_table_get_string (get_fields (gst_info),
+                                                      name);
+}
 
-        return gupnp_dlna_gst_get_string_value (caps, stream, priv->info, name);
+static GUPnPDLNAConstStringValue
+peek_string_value (GUPnPDLNAGstContainerInformation *gst_info,
+                   const gchar *name)
+{
+        return gupnp_dlna_gst_field_table_peek_string (get_fields (gst_info),
+                                                       name);
 }
 
 static GUPnPDLNABoolValue
 get_bool_value (GUPnPDLNAGstContainerInformation *gst_info,
                 const gchar *name)
 {
-        GstCaps *caps = get_caps (gst_info);
-        GstDiscovererStreamInfo *stream = get_container_info (gst_info);
-        GUPnPDLNAGstContainerInformationPrivate *priv =
-                gupnp_dlna_gst_container_information_get_instance_private (
-                        gst_info);
-
-        return gupnp_dlna_gst_get_bool_value (caps, stream, priv->info, name);
+        return gupnp_dlna_gst_field_table_get_bool (get_fields (gst_info),
+                                                    name);
 }
 
 static GUPnPDLNAIntValue
@@ -144,6 +170,15 @@ backend_get_profile (GUPnPDLNAContainerInformation *self)
         return get_string_value (gst_info, "profile");
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_profile (GUPnPDLNAContainerInformation *self)
+{
+        GUPnPDLNAGstContainerInformation* gst_info =
+                                    GUPNP_DLNA_GST_CONTAINER_INFORMATION (self);
+
+        return peek_string_value (gst_info, "profile");
+}
+
 static GUPnPDLNABoolValue
 backend_is_system_stream (GUPnPDLNAContainerInformation *self)
 {
@@ -162,6 +197,15 @@ backend_get_variant (GUPnPDLNAContainerInformation *self)
         return get_string_value (gst_info, "variant");
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_variant (GUPnPDLNAContainerInformation *self)
+{
+        GUPnPDLNAGstContainerInformation* gst_info =
+                                    GUPNP_DLNA_GST_CONTAINER_INFORMATION (self);
+
+        return peek_string_value (gst_info, "variant");
+}
+
 static GUPnPDLNAStringValue
 backend_get_mime (GUPnPDLNAContainerInformation *self)
 {
@@ -171,6 +215,15 @@ backend_get_mime (GUPnPDLNAContainerInformation *self)
         return gupnp_dlna_gst_get_mime (get_caps (gst_info));
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_mime (GUPnPDLNAContainerInformation *self)
+{
+        GUPnPDLNAGstContainerInformation* gst_info =
+                                    GUPNP_DLNA_GST_CONTAINER_INFORMATION (self);
+
+        return gupnp_dlna_gst_peek_mime (get_caps (gst_info));
+}
+
 static void
 gupnp_dlna_gst_container_information_dispose (GObject *object)
 {
@@ -182,13 +235,28 @@ gupnp_dlna_gst_container_information_dispose (GObject *object)
         GObjectClass *parent_class =
              G_OBJECT_CLASS (gupnp_dlna_gst_container_information_parent_class);
 
+        /* fields borrow values from streams */
+        g_clear_pointer (&priv->fields, gupnp_dlna_gst_field_table_free);
         g_clear_pointer (&priv->info, gupnp_dlna_gst_discoverer_info_unref);
-        g_clear_pointer (&priv->container_info,
-                         gupnp_dlna_gst_discoverer_stream_info_unref);
-        g_clear_pointer (&priv->caps, gst_caps_unref);
+        g_clear_pointer (&priv->streams, gupnp_dlna_gst_streams_unref);
         parent_class->dispose (object);
 }
 
+static void
+gupnp_dlna_gst_container_information_finalize (GObject *object)
+{
+        GUPnPDLNAGstContainerInformation *info =
+                                  GUPNP_DLNA_GST_CONTAINER_INFORMATION (object);
+        GUPnPDLNAGstContainerInformationPrivate *priv =
+                gupnp_dlna_gst_container_information_get_instance_private (
+                        info);
+        GObjectClass *parent_class = G_OBJECT_CLASS
+                           (gupnp_dlna_gst_container_information_parent_class);
+
+        g_rec_mutex_clear (&priv->lock);
+        parent_class->finalize (object);
+}
+
 static void
 gupnp_dlna_gst_container_information_set_property (GObject      *object,
                                                    guint         property_id,
@@ -205,6 +273,10 @@ gupnp_dlna_gst_container_information_set_property (GObject      *object,
         case PROP_INFO:
                 g_clear_pointer (&priv->info,
                                  gupnp_dlna_gst_discoverer_info_unref);
+                g_clear_pointer (&priv->fields,
+                                 gupnp_dlna_gst_field_table_free);
+                g_clear_pointer (&priv->streams,
+                                 gupnp_dlna_gst_streams_unref);
                 priv->info =
                         GST_DISCOVERER_INFO (g_value_dup_object (value));
                 break;
@@ -252,6 +324,8 @@ gupnp_dlna_gst_container_information_class_init
         object_class->set_property =
                               gupnp_dlna_gst_container_information_set_property;
         object_class->dispose = gupnp_dlna_gst_container_information_dispose;
+        object_class->finalize =
+                                  gupnp_dlna_gst_container_information_finalize;
 
         info_class->get_mpeg_version = backend_get_mpeg_version;
         info_class->get_packet_size = backend_get_packet_size;
@@ -259,6 +333,9 @@ gupnp_dlna_gst_container_information_class_init
         info_class->is_system_stream = backend_is_system_stream;
         info_class->get_variant = backend_get_variant;
         info_class->get_mime = backend_get_mime;
+        info_class->peek_profile = backend_peek_profile;
+        info_class->peek_variant = backend_peek_variant;
+        info_class->peek_mime = backend_peek_mime;
 
         pspec = g_param_spec_object ("info",
                                      "info",
@@ -275,30 +352,52 @@ static void
 gupnp_dlna_gst_container_information_init
                                         (GUPnPDLNAGstContainerInformation *self)
 {
+        GUPnPDLNAGstContainerInformationPrivate *priv =
+                gupnp_dlna_gst_container_information_get_instance_private (
+                        self);
+
+        g_rec_mutex_init (&priv->lock);
 }
 
+/* Creates the information borrowing already classified @streams,
+ * or returns %NULL if there is no container stream among them. */
 GUPnPDLNAGstContainerInformation *
-gupnp_dlna_gst_container_information_new_from_discoverer_info
-                                        (GstDiscovererInfo *info)
+gupnp_dlna_gst_container_information_new_from_streams
+                                        (GUPnPDLNAGstStreams *streams)
 {
-        GUPnPDLNAGstContainerInformation *container_info = NULL;
-        GstDiscovererStreamInfo *stream_info;
-
-        g_return_val_if_fail (GST_IS_DISCOVERER_INFO (info), NULL);
+        GUPnPDLNAGstContainerInformation *container_info;
+        GUPnPDLNAGstContainerInformationPrivate *priv;
 
-        stream_info = gst_discoverer_info_get_stream_info (info);
+        g_return_val_if_fail (streams != NULL, NULL);
 
-        if (stream_info) {
-                GType type = G_TYPE_FROM_INSTANCE (stream_info);
+        if (!streams->has_container)
+                return NULL;
 
-                if (type == GST_TYPE_DISCOVERER_CONTAINER_INFO)
-                        container_info = GUPNP_DLNA_GST_CONTAINER_INFORMATION
+        container_info = GUPNP_DLNA_GST_CONTAINER_INFORMATION
                                 (g_object_new
                                      (GUPNP_TYPE_DLNA_GST_CONTAINER_INFORMATION,
-                                      "info", info,
+                                      "info", streams->info,
                                       NULL));
-                gst_discoverer_stream_info_unref (stream_info);
-        }
+        priv = gupnp_dlna_gst_container_information_get_instance_private
+                                        (container_info);
+        priv->streams = gupnp_dlna_gst_streams_ref (streams);
+
+        return container_info;
+}
+
+GUPnPDLNAGstContainerInformation *
+gupnp_dlna_gst_container_information_new_from_discoverer_info
+                                        (GstDiscovererInfo *info)
+{
+        GUPnPDLNAGstStreams *streams;
+        GUPnPDLNAGstContainerInformation *container_info;
+
+        g_return_val_if_fail (GST_IS_DISCOVERER_INFO (info), NULL);
+
+        streams = gupnp_dlna_gst_streams_new (info);
+        container_info = gupnp_dlna_gst_container_information_new_from_streams
+                                        (streams);
+        gupnp_dlna_gst_streams_unref (streams);
 
         return container_info;
 }
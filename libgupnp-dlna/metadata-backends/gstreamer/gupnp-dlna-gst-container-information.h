@@ -25,6 +25,7 @@
 #include <glib-object.h>
 #include <gst/pbutils/pbutils.h>
 #include "gupnp-dlna-container-information.h"
+#include "gupnp-dlna-gst-info-utils.h"
 
 G_BEGIN_DECLS
 
@@ -58,6 +59,10 @@ GUPnPDLNAGstContainerInformation *
 gupnp_dlna_gst_container_information_new_from_discoverer_info
                                         (GstDiscovererInfo *info);
 
+GUPnPDLNAGstContainerInformation *
+gupnp_dlna_gst_container_information_new_from_streams
+                                        (GUPnPDLNAGstStreams *streams);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_GST_CONTAINER_INFORMATION_H__ */
@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+#include <gio/gio.h>
+#include "gupnp-dlna-gst-header-probe.h"
+
+/* Name of the application message posted once every stream is
+ * found. */
+#define PROBE_DONE "gupnp-dlna-header-probe-done"
+
+/* Mirrors GstAutoplugSelectResult of decodebin, which is not in any
+ * public header. */
+typedef enum {
+        AUTOPLUG_SELECT_TRY,
+        AUTOPLUG_SELECT_EXPOSE,
+        AUTOPLUG_SELECT_SKIP
+} AutoplugSelectResult;
+
+struct _GUPnPDLNAGstHeaderProbe {
+        GstElement                      *pipeline;
+        GstBus                          *bus;
+        GUPnPDLNAGstHeaderProbeProgress  progress;
+        gpointer                         progress_data;
+        /* guards the members below, they are filled from streaming
+         * threads */
+        GMutex                           lock;
+        GstCaps                         *container_caps;
+        GstTagList                      *container_tags;
+        GPtrArray                       *stream_caps;
+        GPtrArray                       *stream_tags;
+        gboolean                         stopped;
+};
+
+static gboolean
+klass_has (GstElementFactory *factory,
+           const gchar       *word)
+{
+        const gchar *klass = gst_element_factory_get_metadata
+                                        (factory,
+                                         GST_ELEMENT_METADATA_KLASS);
+
+        return klass != NULL && strstr (klass, word) != NULL;
+}
+
+static void
+post_done (GUPnPDLNAGstHeaderProbe *probe)
+{
+        GstStructure *st = gst_structure_new_empty (PROBE_DONE);
+
+        gst_element_post_message (probe->pipeline,
+                                  gst_message_new_application
+                                        (GST_OBJECT (probe->pipeline),
+                                         st));
+}
+
+static GUPnPDLNAGstStreams *
+get_streams (GUPnPDLNAGstHeaderProbe *probe)
+{
+        GUPnPDLNAGstStreams *streams;
+
+        g_mutex_lock (&probe->lock);
+        streams = gupnp_dlna_gst_streams_new_from_caps (probe->container_caps,
+                                                        probe->container_tags,
+                                                        probe->stream_caps,
+                                                        probe->stream_tags);
+        g_mutex_unlock (&probe->lock);
+
+        return streams;
+}
+
+/* Reports the container alone, which often rules out everything
+ * before any stream is found. */
+static gboolean
+report_container (GUPnPDLNAGstHeaderProbe *probe)
+{
+        GUPnPDLNAGstStreams *streams;
+        gboolean stop;
+
+        if (probe->progress == NULL)
+                return FALSE;
+
+        streams = get_streams (probe);
+        stop = probe->progress (streams, probe->progress_data);
+        gupnp_dlna_gst_streams_unref (streams);
+        if (stop) {
+                g_mutex_lock (&probe->lock);
+                probe->stopped = TRUE;
+                g_mutex_unlock (&probe->lock);
+                post_done (probe);
+        }
+
+        return stop;
+}
+
+/* Demuxers and parsers are all it takes to get the caps of every
+ * stream - everything past them, like decoders and converters, is
+ * skipped by exposing the pad as it is. */
+static gint
+autoplug_select_cb (GstElement        *uridecodebin G_GNUC_UNUSED,
+                    GstPad            *pad G_GNUC_UNUSED,
+                    GstCaps           *caps,
+                    GstElementFactory *factory,
+                    gpointer           user_data)
+{
+        GUPnPDLNAGstHeaderProbe *probe = user_data;
+        gboolean stopped;
+        gboolean first;
+
+        g_mutex_lock (&probe->lock);
+        stopped = probe->stopped;
+        g_mutex_unlock (&probe->lock);
+        if (stopped)
+                return AUTOPLUG_SELECT_EXPOSE;
+
+        if (klass_has (factory, "Demux")) {
+                g_mutex_lock (&probe->lock);
+                /* the first demuxer gets the outermost caps */
+                first = (probe->container_caps == NULL);
+                if (first)
+                        probe->container_caps = gst_caps_ref (caps);
+                g_mutex_unlock (&probe->lock);
+
+                if (first && report_container (probe))
+                        return AUTOPLUG_SELECT_EXPOSE;
+
+                return AUTOPLUG_SELECT_TRY;
+        }
+
+        if (klass_has (factory, "Parser"))
+                return AUTOPLUG_SELECT_TRY;
+
+        return AUTOPLUG_SELECT_EXPOSE;
+}
+
+static void
+add_stream (GUPnPDLNAGstHeaderProbe *probe,
+            GstCaps                 *caps,
+            GstTagList              *tags)
+{
+        g_mutex_lock (&probe->lock);
+        g_ptr_array_add (probe->stream_caps, caps);
+        g_ptr_array_add (probe->stream_tags, tags);
+        g_mutex_unlock (&probe->lock);
+}
+
+static GstPadProbeReturn
+drop_data_cb (GstPad          *pad G_GNUC_UNUSED,
+              GstPadProbeInfo *info G_GNUC_UNUSED,
+              gpointer         user_data G_GNUC_UNUSED)
+{
+        return GST_PAD_PROBE_DROP;
+}
+
+/* Exposed pads are never linked, so the data is dropped instead of
+ * failing the pipeline with not-linked errors until it is stopped. */
+static void
+pad_added_cb (GstElement *uridecodebin G_GNUC_UNUSED,
+              GstPad     *pad,
+              gpointer    user_data)
+{
+        GstCaps *caps = gst_pad_get_current_caps (pad);
+        GstEvent *event = gst_pad_get_sticky_event (pad, GST_EVENT_TAG, 0);
+        GstTagList *tags = NULL;
+
+        gst_pad_add_probe (pad,
+                           GST_PAD_PROBE_TYPE_BUFFER |
+                           GST_PAD_PROBE_TYPE_BUFFER_LIST,
+                           drop_data_cb,
+                           NULL,
+                           NULL);
+        if (caps == NULL)
+                caps = gst_pad_query_caps (pad, NULL);
+        if (event != NULL) {
+                GstTagList *event_tags;
+
+                gst_event_parse_tag (event, &event_tags);
+                tags = gst_tag_list_ref (event_tags);
+                gst_event_unref (event);
+        }
+        add_stream (user_data, caps, tags);
+}
+
+/* Streams nothing can be plugged for are still streams, like in
+ * GstDiscoverer. */
+static void
+unknown_type_cb (GstElement *uridecodebin G_GNUC_UNUSED,
+                 GstPad     *pad G_GNUC_UNUSED,
+                 GstCaps    *caps,
+                 gpointer    user_data)
+{
+        add_stream (user_data, gst_caps_ref (caps), NULL);
+}
+
+/* Decodebin exposes pads once all of them have caps, so this is the
+ * earliest point every stream is known. */
+static void
+no_more_pads_cb (GstElement *uridecodebin G_GNUC_UNUSED,
+                 gpointer    user_data)
+{
+        post_done (user_data);
+}
+
+static void
+free_tag_list (gpointer tags)
+{
+        if (tags != NULL)
+                gst_tag_list_unref (tags);
+}
+
+GUPnPDLNAGstHeaderProbe *
+gupnp_dlna_gst_header_probe_new (const gchar                      *uri,
+                                 GUPnPDLNAGstHeaderProbeProgress   progress,
+                                 gpointer                          user_data,
+                                 GError                          **error)
+{
+        GUPnPDLNAGstHeaderProbe *probe;
+        GstElement *uridecodebin;
+
+        g_return_val_if_fail (uri != NULL, NULL);
+
+        uridecodebin = gst_element_factory_make ("uridecodebin", NULL);
+        if (uridecodebin == NULL) {
+                g_set_error (error,
+                             GST_CORE_ERROR,
+                             GST_CORE_ERROR_MISSING_PLUGIN,
+                             "Could not create uridecodebin element");
+
+                return NULL;
+        }
+
+        probe = g_slice_new0 (GUPnPDLNAGstHeaderProbe);
+        probe->progress = progress;
+        probe->progress_data = user_data;
+        g_mutex_init (&probe->lock);
+        probe->stream_caps = g_ptr_array_new_with_free_func
+                                        ((GDestroyNotify) gst_caps_unref);
+        probe->stream_tags = g_ptr_array_new_with_free_func (free_tag_list);
+        probe->pipeline = gst_pipeline_new (NULL);
+        probe->bus = gst_pipeline_get_bus (GST_PIPELINE (probe->pipeline));
+
+        g_object_set (uridecodebin, "uri", uri, NULL);
+        g_signal_connect (uridecodebin,
+                          "autoplug-select",
+                          G_CALLBACK (autoplug_select_cb),
+                          probe);
+        g_signal_connect (uridecodebin,
+                          "pad-added",
+                          G_CALLBACK (pad_added_cb),
+                          probe);
+        g_signal_connect (uridecodebin,
+                          "unknown-type",
+                          G_CALLBACK (unknown_type_cb),
+                          probe);
+        g_signal_connect (uridecodebin,
+                          "no-more-pads",
+                          G_CALLBACK (no_more_pads_cb),
+                          probe);
+        gst_bin_add (GST_BIN (probe->pipeline), uridecodebin);
+
+        return probe;
+}
+
+static void
+merge_container_tags (GUPnPDLNAGstHeaderProbe *probe,
+                      GstMessage              *message)
+{
+        GstTagList *tags;
+
+        gst_message_parse_tag (message, &tags);
+        g_mutex_lock (&probe->lock);
+        if (probe->container_tags == NULL) {
+                probe->container_tags = tags;
+        } else {
+                GstTagList *merged = gst_tag_list_merge (probe->container_tags,
+                                                         tags,
+                                                         GST_TAG_MERGE_KEEP);
+
+                gst_tag_list_unref (probe->container_tags);
+                gst_tag_list_unref (tags);
+                probe->container_tags = merged;
+        }
+        g_mutex_unlock (&probe->lock);
+}
+
+/* Returns %TRUE when the probe is over, successfully or not. */
+static gboolean
+handle_message (GUPnPDLNAGstHeaderProbe  *probe,
+                GstMessage               *message,
+                GError                  **error)
+{
+        switch (GST_MESSAGE_TYPE (message)) {
+        case GST_MESSAGE_ERROR:
+                gst_message_parse_error (message, error, NULL);
+
+                return TRUE;
+
+        case GST_MESSAGE_TAG:
+                merge_container_tags (probe, message);
+
+                return FALSE;
+
+        case GST_MESSAGE_APPLICATION:
+                return gst_message_has_name (message, PROBE_DONE);
+
+        default:
+                return FALSE;
+        }
+}
+
+/* Plays the pipeline until every stream has caps or the progress
+ * callback stops it, but no longer than @timeout_in_ms (0 means no
+ * limit). */
+GUPnPDLNAGstStreams *
+gupnp_dlna_gst_header_probe_run (GUPnPDLNAGstHeaderProbe  *probe,
+                                 guint                     timeout_in_ms,
+                                 GError                  **error)
+{
+        GstMessageType types = GST_MESSAGE_ERROR |
+                               GST_MESSAGE_TAG |
+                               GST_MESSAGE_APPLICATION;
+        gint64 deadline = g_get_monotonic_time () +
+                          (gint64) timeout_in_ms * G_TIME_SPAN_MILLISECOND;
+        GError *probe_error = NULL;
+        gboolean done = FALSE;
+
+        g_return_val_if_fail (probe != NULL, NULL);
+
+        if (gst_element_set_state (probe->pipeline, GST_STATE_PAUSED) ==
+            GST_STATE_CHANGE_FAILURE)
+                /* whatever failed should have posted an error */
+                types = GST_MESSAGE_ERROR;
+
+        while (!done) {
+                GstClockTime wait = GST_CLOCK_TIME_NONE;
+                GstMessage *message;
+
+                if (types == GST_MESSAGE_ERROR) {
+                        wait = 0;
+                } else if (timeout_in_ms > 0) {
+                        gint64 remaining = deadline - g_get_monotonic_time ();
+
+                        wait = MAX (remaining, 0) * GST_USECOND;
+                }
+
+                message = gst_bus_timed_pop_filtered (probe->bus, wait, types);
+                if (message == NULL) {
+                        g_set_error (&probe_error,
+                                     G_IO_ERROR,
+                                     types == GST_MESSAGE_ERROR ?
+                                     G_IO_ERROR_FAILED :
+                                     G_IO_ERROR_TIMED_OUT,
+                                     "Probing stream headers failed");
+
+                        break;
+                }
+                done = handle_message (probe, message, &probe_error);
+                gst_message_unref (message);
+        }
+
+        gst_element_set_state (probe->pipeline, GST_STATE_NULL);
+
+        if (probe_error != NULL) {
+                g_propagate_error (error, probe_error);
+
+                return NULL;
+        }
+
+        return get_streams (probe);
+}
+
+void
+gupnp_dlna_gst_header_probe_free (GUPnPDLNAGstHeaderProbe *probe)
+{
+        if (probe == NULL)
+                return;
+
+        gst_element_set_state (probe->pipeline, GST_STATE_NULL);
+        gst_object_unref (probe->bus);
+        gst_object_unref (probe->pipeline);
+        g_clear_pointer (&probe->container_caps, gst_caps_unref);
+        g_clear_pointer (&probe->container_tags, gst_tag_list_unref);
+        g_ptr_array_unref (probe->stream_caps);
+        g_ptr_array_unref (probe->stream_tags);
+        g_mutex_clear (&probe->lock);
+        g_slice_free (GUPnPDLNAGstHeaderProbe, probe);
+}
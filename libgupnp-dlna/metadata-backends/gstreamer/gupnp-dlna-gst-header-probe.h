@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GUPNP_DLNA_GST_HEADER_PROBE_H__
+#define __GUPNP_DLNA_GST_HEADER_PROBE_H__
+
+#include <glib.h>
+#include "gupnp-dlna-gst-info-utils.h"
+
+G_BEGIN_DECLS
+
+/* A lightweight replacement of GstDiscoverer, plugging only the
+ * typefinder, demuxers and parsers. */
+typedef struct _GUPnPDLNAGstHeaderProbe GUPnPDLNAGstHeaderProbe;
+
+/* Called from a streaming thread with the streams found so far, once
+ * the container is known. Returning %TRUE stops the probe, which then
+ * returns those streams. */
+typedef gboolean
+(* GUPnPDLNAGstHeaderProbeProgress) (GUPnPDLNAGstStreams *streams,
+                                     gpointer             user_data);
+
+GUPnPDLNAGstHeaderProbe *
+gupnp_dlna_gst_header_probe_new (const gchar                      *uri,
+                                 GUPnPDLNAGstHeaderProbeProgress   progress,
+                                 gpointer                          user_data,
+                                 GError                          **error);
+
+GUPnPDLNAGstStreams *
+gupnp_dlna_gst_header_probe_run (GUPnPDLNAGstHeaderProbe  *probe,
+                                 guint                     timeout_in_ms,
+                                 GError                  **error);
+
+void
+gupnp_dlna_gst_header_probe_free (GUPnPDLNAGstHeaderProbe *probe);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_GST_HEADER_PROBE_H__ */
@@ -27,9 +27,9 @@
 
 struct _GUPnPDLNAGstImageInformationPrivate {
         GstDiscovererInfo *info;
-        GList *stream_list;
-        GstDiscovererVideoInfo *image_info;
-        GstCaps *caps;
+        GUPnPDLNAGstStreams *streams;
+        /* guards lazily initialized fields above */
+        GRecMutex lock;
 };
 typedef struct _GUPnPDLNAGstImageInformationPrivate
         GUPnPDLNAGstImageInformationPrivate;
@@ -49,53 +49,58 @@ enum
         PROP_INFO
 };
 
-static GstDiscovererVideoInfo *
-get_image_info (GUPnPDLNAGstImageInformation *gst_info)
+static GUPnPDLNAGstStreams *
+get_streams (GUPnPDLNAGstImageInformation *gst_info)
 {
         GUPnPDLNAGstImageInformationPrivate *priv =
                 gupnp_dlna_gst_image_information_get_instance_private (
                         gst_info);
+        GUPnPDLNAGstStreams *streams;
 
-        if (!priv->image_info) {
-                GList *iter;
-
-                if (!priv->stream_list) {
-                        priv->stream_list =
-                               gst_discoverer_info_get_stream_list (priv->info);
-                        if (!priv->stream_list)
-                                return NULL;
-                }
-
-                for (iter = priv->stream_list; iter; iter = iter->next) {
-                        GstDiscovererStreamInfo *stream =
-                                        GST_DISCOVERER_STREAM_INFO (iter->data);
-                        GType stream_type = G_TYPE_FROM_INSTANCE (stream);
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->streams && priv->info)
+                priv->streams = gupnp_dlna_gst_streams_new (priv->info);
+        streams = priv->streams;
+        g_rec_mutex_unlock (&priv->lock);
 
-                        if (stream_type == GST_TYPE_DISCOVERER_VIDEO_INFO) {
-                                priv->image_info =
-                                             GST_DISCOVERER_VIDEO_INFO (stream);
+        return streams;
+}
 
-                                break;
-                        }
-                }
-        }
+static GstDiscovererVideoInfo *
+get_image_info (GUPnPDLNAGstImageInformation *gst_info)
+{
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
 
-        return priv->image_info;
+        return streams ? streams->image : NULL;
 }
 
 static GstCaps *
 get_caps (GUPnPDLNAGstImageInformation *gst_info)
 {
-        GUPnPDLNAGstImageInformationPrivate *priv =
-                gupnp_dlna_gst_image_information_get_instance_private (
-                        gst_info);
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
+
+        return streams ? streams->video_caps : NULL;
+}
 
-        if (!priv->caps)
-                priv->caps = gst_discoverer_stream_info_get_caps
-                                        (GST_DISCOVERER_STREAM_INFO
-                                                   (get_image_info (gst_info)));
+/* Streams found by a header probe have only caps. */
+static GUPnPDLNAIntValue
+get_caps_int_value (GUPnPDLNAGstImageInformation *gst_info,
+                    const gchar                  *name)
+{
+        GstCaps *caps = get_caps (gst_info);
+        GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        gint data;
 
-        return priv->caps;
+        if (caps != NULL && gst_caps_get_size (caps) > 0 &&
+            gst_structure_get_int (gst_caps_get_structure (caps, 0),
+                                   name,
+                                   &data) &&
+            data > 0) {
+                value.state = GUPNP_DLNA_VALUE_STATE_SET;
+                value.value = data;
+        }
+
+        return value;
 }
 
 static GUPnPDLNAIntValue
@@ -104,9 +109,13 @@ backend_get_depth (GUPnPDLNAImageInformation *self)
         GUPnPDLNAGstImageInformation *gst_info =
                                         GUPNP_DLNA_GST_IMAGE_INFORMATION (self);
         GstDiscovererVideoInfo *image_info = get_image_info (gst_info);
-        guint data = gst_discoverer_video_info_get_depth (image_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
 
+        if (image_info == NULL)
+                return get_caps_int_value (gst_info, "depth");
+
+        data = gst_discoverer_video_info_get_depth (image_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -121,9 +130,13 @@ backend_get_height (GUPnPDLNAImageInformation *self)
         GUPnPDLNAGstImageInformation* gst_info =
                                         GUPNP_DLNA_GST_IMAGE_INFORMATION (self);
         GstDiscovererVideoInfo *image_info = get_image_info (gst_info);
-        guint data = gst_discoverer_video_info_get_height (image_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
+
+        if (image_info == NULL)
+                return get_caps_int_value (gst_info, "height");
 
+        data = gst_discoverer_video_info_get_height (image_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -138,9 +151,13 @@ backend_get_width (GUPnPDLNAImageInformation *self)
         GUPnPDLNAGstImageInformation* gst_info =
                                         GUPNP_DLNA_GST_IMAGE_INFORMATION (self);
         GstDiscovererVideoInfo *image_info = get_image_info (gst_info);
-        guint data = gst_discoverer_video_info_get_width (image_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
 
+        if (image_info == NULL)
+                return get_caps_int_value (gst_info, "width");
+
+        data = gst_discoverer_video_info_get_width (image_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -158,6 +175,15 @@ backend_get_mime (GUPnPDLNAImageInformation *self)
         return gupnp_dlna_gst_get_mime (get_caps (gst_info));
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_mime (GUPnPDLNAImageInformation *self)
+{
+        GUPnPDLNAGstImageInformation* gst_info =
+                                        GUPNP_DLNA_GST_IMAGE_INFORMATION (self);
+
+        return gupnp_dlna_gst_peek_mime (get_caps (gst_info));
+}
+
 static void
 gupnp_dlna_gst_image_information_dispose (GObject *object)
 {
@@ -168,14 +194,24 @@ gupnp_dlna_gst_image_information_dispose (GObject *object)
         GObjectClass *parent_class =
                  G_OBJECT_CLASS (gupnp_dlna_gst_image_information_parent_class);
         g_clear_pointer (&priv->info, gupnp_dlna_gst_discoverer_info_unref);
-        g_clear_pointer (&priv->stream_list,
-                         gst_discoverer_stream_info_list_free);
-        /* priv->image_info is freed with stream list above */
-        priv->image_info = NULL;
-        g_clear_pointer (&priv->caps, gst_caps_unref);
+        g_clear_pointer (&priv->streams, gupnp_dlna_gst_streams_unref);
         parent_class->dispose (object);
 }
 
+static void
+gupnp_dlna_gst_image_information_finalize (GObject *object)
+{
+        GUPnPDLNAGstImageInformation *info =
+                                      GUPNP_DLNA_GST_IMAGE_INFORMATION (object);
+        GUPnPDLNAGstImageInformationPrivate *priv =
+                gupnp_dlna_gst_image_information_get_instance_private (info);
+        GObjectClass *parent_class =
+                 G_OBJECT_CLASS (gupnp_dlna_gst_image_information_parent_class);
+
+        g_rec_mutex_clear (&priv->lock);
+        parent_class->finalize (object);
+}
+
 static void
 gupnp_dlna_gst_image_information_set_property (GObject      *object,
                                                guint         property_id,
@@ -191,6 +227,8 @@ gupnp_dlna_gst_image_information_set_property (GObject      *object,
         case PROP_INFO:
                 g_clear_pointer (&priv->info,
                                  gupnp_dlna_gst_discoverer_info_unref);
+                g_clear_pointer (&priv->streams,
+                                 gupnp_dlna_gst_streams_unref);
                 priv->info =
                         GST_DISCOVERER_INFO (g_value_dup_object (value));
                 break;
@@ -237,11 +275,13 @@ gupnp_dlna_gst_image_information_class_init
         object_class->set_property =
                                   gupnp_dlna_gst_image_information_set_property;
         object_class->dispose = gupnp_dlna_gst_image_information_dispose;
+        object_class->finalize = gupnp_dlna_gst_image_information_finalize;
 
         info_class->get_depth = backend_get_depth;
         info_class->get_height = backend_get_height;
         info_class->get_width = backend_get_width;
         info_class->get_mime = backend_get_mime;
+        info_class->peek_mime = backend_peek_mime;
 
         pspec = g_param_spec_object ("info",
                                      "info",
@@ -257,30 +297,51 @@ gupnp_dlna_gst_image_information_class_init
 static void
 gupnp_dlna_gst_image_information_init (GUPnPDLNAGstImageInformation *self)
 {
+        GUPnPDLNAGstImageInformationPrivate *priv =
+                gupnp_dlna_gst_image_information_get_instance_private (self);
+
+        g_rec_mutex_init (&priv->lock);
+}
+
+/* Creates the information borrowing already classified @streams,
+ * or returns %NULL if there is no image stream among them. */
+GUPnPDLNAGstImageInformation *
+gupnp_dlna_gst_image_information_new_from_streams
+                                        (GUPnPDLNAGstStreams *streams)
+{
+        GUPnPDLNAGstImageInformation *image_info;
+        GUPnPDLNAGstImageInformationPrivate *priv;
+
+        g_return_val_if_fail (streams != NULL, NULL);
+
+        if (!streams->has_image)
+                return NULL;
+
+        image_info = GUPNP_DLNA_GST_IMAGE_INFORMATION
+                                (g_object_new
+                                     (GUPNP_TYPE_DLNA_GST_IMAGE_INFORMATION,
+                                      "info", streams->info,
+                                      NULL));
+        priv = gupnp_dlna_gst_image_information_get_instance_private
+                                        (image_info);
+        priv->streams = gupnp_dlna_gst_streams_ref (streams);
+
+        return image_info;
 }
 
 GUPnPDLNAGstImageInformation *
 gupnp_dlna_gst_image_information_new_from_discoverer_info
                                         (GstDiscovererInfo *info)
 {
-        GList* image_list;
-        GUPnPDLNAGstImageInformation *image_info = NULL;
+        GUPnPDLNAGstStreams *streams;
+        GUPnPDLNAGstImageInformation *image_info;
 
         g_return_val_if_fail (GST_IS_DISCOVERER_INFO (info), NULL);
 
-        image_list = gst_discoverer_info_get_video_streams (info);
-
-        if (image_list) {
-                if ((image_list->next == NULL) &&
-                    gst_discoverer_video_info_is_image
-                                 (GST_DISCOVERER_VIDEO_INFO (image_list->data)))
-                        image_info = GUPNP_DLNA_GST_IMAGE_INFORMATION
-                                (g_object_new
-                                         (GUPNP_TYPE_DLNA_GST_IMAGE_INFORMATION,
-                                          "info", info,
-                                          NULL));
-                gst_discoverer_stream_info_list_free (image_list);
-        }
+        streams = gupnp_dlna_gst_streams_new (info);
+        image_info = gupnp_dlna_gst_image_information_new_from_streams
+                                        (streams);
+        gupnp_dlna_gst_streams_unref (streams);
 
         return image_info;
 }
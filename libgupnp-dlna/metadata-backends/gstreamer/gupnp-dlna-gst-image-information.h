@@ -25,6 +25,7 @@
 #include <glib-object.h>
 #include <gst/pbutils/pbutils.h>
 #include "gupnp-dlna-image-information.h"
+#include "gupnp-dlna-gst-info-utils.h"
 
 G_BEGIN_DECLS
 
@@ -56,6 +57,10 @@ GUPnPDLNAGstImageInformation *
 gupnp_dlna_gst_image_information_new_from_discoverer_info
                                         (GstDiscovererInfo *info);
 
+GUPnPDLNAGstImageInformation *
+gupnp_dlna_gst_image_information_new_from_streams
+                                        (GUPnPDLNAGstStreams *streams);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_GST_IMAGE_INFORMATION_H__ */
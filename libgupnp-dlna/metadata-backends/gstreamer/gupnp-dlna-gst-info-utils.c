@@ -33,380 +33,480 @@ gupnp_dlna_gst_discoverer_stream_info_unref (gpointer stream)
         gst_discoverer_stream_info_unref (stream);
 }
 
-static GUPnPDLNAStringValue
-get_string_value_from_structure (const GstStructure *st,
-                                 const gchar *name)
+/* Walks the stream list of @info once and remembers the first stream
+ * of every kind, so the information objects of all kinds can share
+ * it instead of each getting and scanning its own copy of the list.
+ */
+GUPnPDLNAGstStreams *
+gupnp_dlna_gst_streams_new (GstDiscovererInfo *info)
 {
-        GUPnPDLNAStringValue value = GUPNP_DLNA_STRING_VALUE_UNSET;
-
-        if (st != NULL) {
-                const gchar* data = gst_structure_get_string (st, name);
-
-                if (data != NULL) {
-                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                        value.value = g_strdup (data);
+        GUPnPDLNAGstStreams *streams;
+        GstDiscovererStreamInfo *last = NULL;
+        GList *iter;
+        guint stream_count = 0;
+        guint audio_count = 0;
+        guint video_count = 0;
+        GstDiscovererVideoInfo *first_video = NULL;
+        GstDiscovererStreamInfo *top;
+
+        g_return_val_if_fail (GST_IS_DISCOVERER_INFO (info), NULL);
+
+        streams = g_slice_new0 (GUPnPDLNAGstStreams);
+        streams->ref_count = 1;
+        streams->info = gst_discoverer_info_ref (info);
+        streams->stream_list = gst_discoverer_info_get_stream_list (info);
+
+        for (iter = streams->stream_list; iter != NULL; iter = iter->next) {
+                GstDiscovererStreamInfo *stream =
+                                        GST_DISCOVERER_STREAM_INFO (iter->data);
+                GType stream_type = G_TYPE_FROM_INSTANCE (stream);
+
+                ++stream_count;
+                last = stream;
+                if (stream_type == GST_TYPE_DISCOVERER_AUDIO_INFO) {
+                        if (audio_count++ == 0)
+                                streams->audio =
+                                             GST_DISCOVERER_AUDIO_INFO (stream);
+                } else if (stream_type == GST_TYPE_DISCOVERER_VIDEO_INFO) {
+                        if (video_count++ == 0)
+                                first_video =
+                                             GST_DISCOVERER_VIDEO_INFO (stream);
                 }
         }
 
-        return value;
-}
-
-static GUPnPDLNAStringValue
-get_string_value_from_tag_list (const GstTagList *tags,
-                                const gchar *name)
-{
-        GUPnPDLNAStringValue value = GUPNP_DLNA_STRING_VALUE_UNSET;
+        if (streams->audio != NULL) {
+                GstDiscovererStreamInfo *caps_stream =
+                                   GST_DISCOVERER_STREAM_INFO (streams->audio);
+
+                /* For ADTS files we get two audio streams and the
+                 * important information is only on the "outer" stream
+                 * which is the second stream in the stream list. If we
+                 * only have audio streams, we take the caps from the
+                 * second one.
+                 *
+                 * Works around
+                 * https://bugzilla.gnome.org/show_bug.cgi?id=699212
+                 */
+                if (stream_count == 2 && audio_count == stream_count)
+                        caps_stream = last;
+                streams->audio_caps = gst_discoverer_stream_info_get_caps
+                                        (caps_stream);
+        }
 
-        if (tags != NULL) {
-                const GValue *g_value = gst_tag_list_get_value_index (tags,
-                                                                      name,
-                                                                      0);
+        if (first_video != NULL) {
+                if (!gst_discoverer_video_info_is_image (first_video))
+                        streams->video = first_video;
+                else if (video_count == 1)
+                        streams->image = first_video;
+                streams->video_caps = gst_discoverer_stream_info_get_caps
+                                        (GST_DISCOVERER_STREAM_INFO
+                                                   (first_video));
+        }
 
-                if (g_value != NULL && G_VALUE_HOLDS_STRING (g_value)) {
-                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                        value.value = g_value_dup_string (g_value);
-                }
+        top = gst_discoverer_info_get_stream_info (info);
+        if (top != NULL) {
+                if (G_TYPE_FROM_INSTANCE (top) ==
+                    GST_TYPE_DISCOVERER_CONTAINER_INFO) {
+                        streams->container = top;
+                        streams->container_caps =
+                                      gst_discoverer_stream_info_get_caps (top);
+                } else
+                        gst_discoverer_stream_info_unref (top);
         }
 
-        return value;
+        streams->has_audio = (streams->audio != NULL);
+        streams->has_container = (streams->container != NULL);
+        streams->has_image = (streams->image != NULL);
+        streams->has_video = (streams->video != NULL);
+
+        return streams;
 }
 
-static GUPnPDLNAIntValue
-get_int_value_from_structure (const GstStructure *st,
-                              const gchar *name)
+static gboolean
+caps_have_prefix (GstCaps     *caps,
+                  const gchar *prefix)
 {
-        GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        const GstStructure *st;
 
-        if (st != NULL) {
-                gint idata;
-                guint udata;
+        if (caps == NULL || gst_caps_get_size (caps) == 0)
+                return FALSE;
 
-                if (gst_structure_get_int (st, name, &idata)) {
-                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                        value.value = idata;
-                } else if (gst_structure_get_uint (st, name, &udata)) {
-                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                        value.value = (gint) udata;
-                }
-        }
+        st = gst_caps_get_structure (caps, 0);
 
-        return value;
+        return g_str_has_prefix (gst_structure_get_name (st), prefix);
 }
 
-static GUPnPDLNAIntValue
-get_int_value_from_tag_list (const GstTagList *tags,
-                             const gchar *name)
+/* Classifies streams found by a header probe the same way as the
+ * discoverer ones - the first audio stream and the first video
+ * stream are taken, and a lone stream with image caps is an
+ * image. @stream_tags is parallel to @stream_caps and may hold
+ * %NULL. References are taken on everything. */
+GUPnPDLNAGstStreams *
+gupnp_dlna_gst_streams_new_from_caps (GstCaps    *container_caps,
+                                      GstTagList *container_tags,
+                                      GPtrArray  *stream_caps,
+                                      GPtrArray  *stream_tags)
 {
-        GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
-
-        if (tags != NULL) {
-                const GValue *g_value = gst_tag_list_get_value_index (tags,
-                                                                      name,
-                                                                      0);
-
-                if (g_value != NULL) {
-                        if (G_VALUE_HOLDS_INT (g_value)) {
-                                value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                                value.value = g_value_get_int (g_value);
-                        } else if (G_VALUE_HOLDS_UINT (g_value)) {
-                                value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                                value.value = g_value_get_uint (g_value);
+        GUPnPDLNAGstStreams *streams;
+        guint video_count = 0;
+        guint iter;
+        GstCaps *first_video_caps = NULL;
+        GstTagList *first_video_tags = NULL;
+
+        g_return_val_if_fail (stream_caps != NULL, NULL);
+        g_return_val_if_fail (stream_tags != NULL, NULL);
+        g_return_val_if_fail (stream_caps->len == stream_tags->len, NULL);
+
+        streams = g_slice_new0 (GUPnPDLNAGstStreams);
+        streams->ref_count = 1;
+
+        for (iter = 0; iter < stream_caps->len; ++iter) {
+                GstCaps *caps = g_ptr_array_index (stream_caps, iter);
+                GstTagList *tags = g_ptr_array_index (stream_tags, iter);
+
+                if (caps_have_prefix (caps, "audio/")) {
+                        if (streams->audio_caps == NULL) {
+                                streams->audio_caps = gst_caps_ref (caps);
+                                if (tags != NULL)
+                                        streams->audio_tags =
+                                                      gst_tag_list_ref (tags);
+                        }
+                } else if (caps_have_prefix (caps, "video/") ||
+                           caps_have_prefix (caps, "image/")) {
+                        if (video_count++ == 0) {
+                                first_video_caps = caps;
+                                first_video_tags = tags;
                         }
                 }
         }
 
-        return value;
-}
-
-static GUPnPDLNABoolValue
-get_bool_value_from_structure (const GstStructure *st,
-                               const gchar *name)
-{
-        GUPnPDLNABoolValue value = GUPNP_DLNA_BOOL_VALUE_UNSET;
-
-        if (st != NULL) {
-                gboolean data;
+        if (first_video_caps != NULL) {
+                if (!caps_have_prefix (first_video_caps, "image/"))
+                        streams->has_video = TRUE;
+                else if (video_count == 1)
+                        streams->has_image = TRUE;
+                streams->video_caps = gst_caps_ref (first_video_caps);
+                if (first_video_tags != NULL)
+                        streams->video_tags =
+                                        gst_tag_list_ref (first_video_tags);
+        }
 
-                if (gst_structure_get_boolean (st, name, &data)) {
-                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                        value.value = data;
-                }
+        if (container_caps != NULL) {
+                streams->container_caps = gst_caps_ref (container_caps);
+                if (container_tags != NULL)
+                        streams->container_tags =
+                                        gst_tag_list_ref (container_tags);
         }
 
-        return value;
+        streams->has_audio = (streams->audio_caps != NULL);
+        streams->has_container = (streams->container_caps != NULL);
+
+        return streams;
 }
 
-static GUPnPDLNABoolValue
-get_bool_value_from_tag_list (const GstTagList *tags,
-                              const gchar *name)
+GUPnPDLNAGstStreams *
+gupnp_dlna_gst_streams_ref (GUPnPDLNAGstStreams *streams)
 {
-        GUPnPDLNABoolValue value = GUPNP_DLNA_BOOL_VALUE_UNSET;
+        g_return_val_if_fail (streams != NULL, NULL);
 
-        if (tags != NULL) {
-                const GValue *g_value = gst_tag_list_get_value_index (tags,
-                                                                      name,
-                                                                      0);
+        g_atomic_int_inc (&streams->ref_count);
 
-                if (g_value != NULL && G_VALUE_HOLDS_BOOLEAN (g_value)) {
-                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                        value.value = g_value_get_boolean (g_value);
-                }
-        }
+        return streams;
+}
 
-        return value;
+void
+gupnp_dlna_gst_streams_unref (GUPnPDLNAGstStreams *streams)
+{
+        if (streams == NULL ||
+            !g_atomic_int_dec_and_test (&streams->ref_count))
+                return;
+
+        g_clear_pointer (&streams->audio_caps, gst_caps_unref);
+        g_clear_pointer (&streams->container_caps, gst_caps_unref);
+        g_clear_pointer (&streams->video_caps, gst_caps_unref);
+        g_clear_pointer (&streams->audio_tags, gst_tag_list_unref);
+        g_clear_pointer (&streams->container_tags, gst_tag_list_unref);
+        g_clear_pointer (&streams->video_tags, gst_tag_list_unref);
+        g_clear_pointer (&streams->container,
+                         gupnp_dlna_gst_discoverer_stream_info_unref);
+        /* audio, image and video are freed with the list */
+        gst_discoverer_stream_info_list_free (streams->stream_list);
+        g_clear_pointer (&streams->info, gupnp_dlna_gst_discoverer_info_unref);
+        g_slice_free (GUPnPDLNAGstStreams, streams);
 }
 
-static GUPnPDLNAFractionValue
-get_fraction_value_from_structure (const GstStructure *st,
-                                   const gchar *name)
+/* Values of every field are kept in precedence order, so a getter
+ * expecting some type can still skip a value of another type, like
+ * the field by field lookups did. */
+struct _GUPnPDLNAGstFieldTable {
+        GHashTable *fields; /* <GQuark, GPtrArray of const GValue *> */
+};
+
+static void
+add_candidate (GUPnPDLNAGstFieldTable *table,
+               GQuark                  field,
+               const GValue           *value)
 {
-        GUPnPDLNAFractionValue value = GUPNP_DLNA_FRACTION_VALUE_UNSET;
+        GPtrArray *candidates = g_hash_table_lookup (table->fields,
+                                                     GUINT_TO_POINTER (field));
+
+        if (candidates == NULL) {
+                candidates = g_ptr_array_new ();
+                g_hash_table_insert (table->fields,
+                                     GUINT_TO_POINTER (field),
+                                     candidates);
+        }
+        g_ptr_array_add (candidates, (gpointer) value);
+}
 
-        if (st != NULL) {
-                gint ndata;
-                gint ddata;
+static gboolean
+add_structure_field (GQuark        field,
+                     const GValue *value,
+                     gpointer      user_data)
+{
+        add_candidate (user_data, field, value);
 
-                if (gst_structure_get_fraction (st, name, &ndata, &ddata)) {
-                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                        value.numerator = ndata;
-                        value.denominator = ddata;
-                }
-        }
+        return TRUE;
+}
 
-        return value;
+static void
+add_structure (GUPnPDLNAGstFieldTable *table,
+               const GstStructure     *st)
+{
+        if (st != NULL)
+                gst_structure_foreach (st, add_structure_field, table);
 }
 
-static GUPnPDLNAFractionValue
-get_fraction_value_from_tag_list (const GstTagList *tags,
-                                  const gchar *name)
+static void
+add_tag_list (GUPnPDLNAGstFieldTable *table,
+              const GstTagList       *tags)
 {
-        GUPnPDLNAFractionValue value = GUPNP_DLNA_FRACTION_VALUE_UNSET;
+        gint count;
+        gint iter;
 
-        if (tags != NULL) {
-                const GValue *g_value = gst_tag_list_get_value_index (tags,
-                                                                      name,
-                                                                      0);
+        if (tags == NULL)
+                return;
 
-                if (g_value != NULL && GST_VALUE_HOLDS_FRACTION (g_value)) {
-                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                        value.numerator =
-                                     gst_value_get_fraction_numerator (g_value);
-                        value.denominator =
-                                   gst_value_get_fraction_denominator (g_value);
-                }
+        count = gst_tag_list_n_tags (tags);
+        for (iter = 0; iter < count; ++iter) {
+                const gchar *name = gst_tag_list_nth_tag_name (tags, iter);
+                const GValue *value = gst_tag_list_get_value_index (tags,
+                                                                    name,
+                                                                    0);
+
+                if (value != NULL)
+                        add_candidate (table,
+                                       g_quark_from_string (name),
+                                       value);
         }
-
-        return value;
 }
 
-GUPnPDLNAIntValue
-gupnp_dlna_gst_get_int_value (GstCaps* caps,
-                              GstDiscovererStreamInfo *stream,
-                              GstDiscovererInfo *info,
-                              const gchar *name)
+/* Resolves all fields of a stream at once, in the order they used to
+ * be looked up one by one: caps structures, stream misc structure,
+ * discoverer misc structure and stream tags, followed by @tags of a
+ * stream without discoverer info. Values are borrowed, so the table
+ * must not outlive any of them. */
+GUPnPDLNAGstFieldTable *
+gupnp_dlna_gst_field_table_new (GstCaps                 *caps,
+                                GstDiscovererStreamInfo *stream,
+                                GstDiscovererInfo       *info,
+                                const GstTagList        *tags)
 {
-        GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        GUPnPDLNAGstFieldTable *table = g_slice_new (GUPnPDLNAGstFieldTable);
+
+        table->fields = g_hash_table_new_full
+                                        (g_direct_hash,
+                                         g_direct_equal,
+                                         NULL,
+                                         (GDestroyNotify) g_ptr_array_unref);
 
         if (caps != NULL) {
                 guint caps_size = gst_caps_get_size (caps);
                 guint iter;
 
-                for (iter = 0; iter < caps_size; ++iter) {
-                        const GstStructure *st = gst_caps_get_structure (caps,
-                                                                         iter);
-
-                        value = get_int_value_from_structure (st, name);
-                        if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                                return value;
-                }
+                for (iter = 0; iter < caps_size; ++iter)
+                        add_structure (table,
+                                       gst_caps_get_structure (caps, iter));
         }
 
-        if (stream != NULL) {
-                const GstStructure *st =
-                                   gst_discoverer_stream_info_get_misc (stream);
+        if (stream != NULL)
+                add_structure (table,
+                               gst_discoverer_stream_info_get_misc (stream));
 
-                value = get_int_value_from_structure (st, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+        if (info != NULL)
+                add_structure (table, gst_discoverer_info_get_misc (info));
 
-        if (info != NULL) {
-                const GstStructure *st = gst_discoverer_info_get_misc (info);
+        if (stream != NULL)
+                add_tag_list (table,
+                              gst_discoverer_stream_info_get_tags (stream));
 
-                value = get_int_value_from_structure (st, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+        add_tag_list (table, tags);
 
-        if (stream != NULL) {
-                const GstTagList *tags =
-                                   gst_discoverer_stream_info_get_tags (stream);
+        return table;
+}
 
-                value = get_int_value_from_tag_list (tags, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+void
+gupnp_dlna_gst_field_table_free (GUPnPDLNAGstFieldTable *table)
+{
+        if (table == NULL)
+                return;
 
-        return value;
+        g_hash_table_unref (table->fields);
+        g_slice_free (GUPnPDLNAGstFieldTable, table);
 }
 
-GUPnPDLNAStringValue
-gupnp_dlna_gst_get_string_value (GstCaps* caps,
-                                 GstDiscovererStreamInfo *stream,
-                                 GstDiscovererInfo *info,
-                                 const gchar *name)
+static GPtrArray *
+get_candidates (GUPnPDLNAGstFieldTable *table,
+                const gchar            *name)
 {
-        GUPnPDLNAStringValue value = GUPNP_DLNA_STRING_VALUE_UNSET;
-
-        if (caps != NULL) {
-                guint caps_size = gst_caps_get_size (caps);
-                guint iter;
+        GQuark field = g_quark_try_string (name);
 
-                for (iter = 0; iter < caps_size; ++iter) {
-                        const GstStructure *st = gst_caps_get_structure (caps,
-                                                                         iter);
+        /* no structure nor tag list has ever had such field */
+        if (field == 0)
+                return NULL;
 
-                        value = get_string_value_from_structure (st, name);
-                        if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                                return value;
-                }
-        }
+        return g_hash_table_lookup (table->fields, GUINT_TO_POINTER (field));
+}
 
-        if (stream != NULL) {
-                const GstStructure *st =
-                                   gst_discoverer_stream_info_get_misc (stream);
+GUPnPDLNAIntValue
+gupnp_dlna_gst_field_table_get_int (GUPnPDLNAGstFieldTable *table,
+                                    const gchar            *name)
+{
+        GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        GPtrArray *candidates;
+        guint iter;
 
-                value = get_string_value_from_structure (st, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+        g_return_val_if_fail (table != NULL, value);
+        g_return_val_if_fail (name != NULL, value);
 
-        if (info != NULL) {
-                const GstStructure *st = gst_discoverer_info_get_misc (info);
+        candidates = get_candidates (table, name);
+        for (iter = 0; candidates != NULL && iter < candidates->len; ++iter) {
+                const GValue *g_value = g_ptr_array_index (candidates, iter);
 
-                value = get_string_value_from_structure (st, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+                if (G_VALUE_HOLDS_INT (g_value)) {
+                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
+                        value.value = g_value_get_int (g_value);
 
-        if (stream != NULL) {
-                const GstTagList *tags =
-                                   gst_discoverer_stream_info_get_tags (stream);
+                        break;
+                } else if (G_VALUE_HOLDS_UINT (g_value)) {
+                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
+                        value.value = (gint) g_value_get_uint (g_value);
 
-                value = get_string_value_from_tag_list (tags, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
+                        break;
+                }
         }
 
         return value;
 }
 
-GUPnPDLNABoolValue
-gupnp_dlna_gst_get_bool_value (GstCaps* caps,
-                               GstDiscovererStreamInfo *stream,
-                               GstDiscovererInfo *info,
-                               const gchar *name)
+GUPnPDLNAConstStringValue
+gupnp_dlna_gst_field_table_peek_string (GUPnPDLNAGstFieldTable *table,
+                                        const gchar            *name)
 {
-        GUPnPDLNABoolValue value = GUPNP_DLNA_BOOL_VALUE_UNSET;
+        GUPnPDLNAConstStringValue value = GUPNP_DLNA_CONST_STRING_VALUE_UNSET;
+        GPtrArray *candidates;
+        guint iter;
 
-        if (caps != NULL) {
-                guint caps_size = gst_caps_get_size (caps);
-                guint iter;
+        g_return_val_if_fail (table != NULL, value);
+        g_return_val_if_fail (name != NULL, value);
 
-                for (iter = 0; iter < caps_size; ++iter) {
-                        const GstStructure *st = gst_caps_get_structure (caps,
-                                                                         iter);
+        candidates = get_candidates (table, name);
+        for (iter = 0; candidates != NULL && iter < candidates->len; ++iter) {
+                const GValue *g_value = g_ptr_array_index (candidates, iter);
 
-                        value = get_bool_value_from_structure (st, name);
-                        if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                                return value;
+                if (G_VALUE_HOLDS_STRING (g_value) &&
+                    g_value_get_string (g_value) != NULL) {
+                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
+                        value.value = g_value_get_string (g_value);
+
+                        break;
                 }
         }
 
-        if (stream != NULL) {
-                const GstStructure *st =
-                                   gst_discoverer_stream_info_get_misc (stream);
-
-                value = get_bool_value_from_structure (st, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+        return value;
+}
 
-        if (info != NULL) {
-                const GstStructure *st = gst_discoverer_info_get_misc (info);
+static GUPnPDLNAStringValue
+dup_string_value (GUPnPDLNAConstStringValue borrowed)
+{
+        GUPnPDLNAStringValue value;
 
-                value = get_bool_value_from_structure (st, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+        value.state = borrowed.state;
+        value.value = g_strdup (borrowed.value);
 
-        if (stream != NULL) {
-                const GstTagList *tags =
-                                   gst_discoverer_stream_info_get_tags (stream);
+        return value;
+}
 
-                value = get_bool_value_from_tag_list (tags, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+GUPnPDLNAStringValue
+gupnp_dlna_gst_field_table_get_string (GUPnPDLNAGstFieldTable *table,
+                                       const gchar            *name)
+{
+        g_return_val_if_fail (table != NULL, GUPNP_DLNA_STRING_VALUE_UNSET);
+        g_return_val_if_fail (name != NULL, GUPNP_DLNA_STRING_VALUE_UNSET);
 
-        return value;
+        return dup_string_value (gupnp_dlna_gst_field_table_peek_string (table,
+                                                                         name));
 }
 
-GUPnPDLNAFractionValue
-gupnp_dlna_gst_get_fraction_value (GstCaps* caps,
-                                   GstDiscovererStreamInfo *stream,
-                                   GstDiscovererInfo *info,
-                                   const gchar *name)
+GUPnPDLNABoolValue
+gupnp_dlna_gst_field_table_get_bool (GUPnPDLNAGstFieldTable *table,
+                                     const gchar            *name)
 {
-        GUPnPDLNAFractionValue value = GUPNP_DLNA_FRACTION_VALUE_UNSET;
+        GUPnPDLNABoolValue value = GUPNP_DLNA_BOOL_VALUE_UNSET;
+        GPtrArray *candidates;
+        guint iter;
 
-        if (caps != NULL) {
-                guint caps_size = gst_caps_get_size (caps);
-                guint iter;
+        g_return_val_if_fail (table != NULL, value);
+        g_return_val_if_fail (name != NULL, value);
 
-                for (iter = 0; iter < caps_size; ++iter) {
-                        const GstStructure *st = gst_caps_get_structure (caps,
-                                                                         iter);
+        candidates = get_candidates (table, name);
+        for (iter = 0; candidates != NULL && iter < candidates->len; ++iter) {
+                const GValue *g_value = g_ptr_array_index (candidates, iter);
 
-                        value = get_fraction_value_from_structure (st, name);
-                        if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                                return value;
+                if (G_VALUE_HOLDS_BOOLEAN (g_value)) {
+                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
+                        value.value = g_value_get_boolean (g_value);
+
+                        break;
                 }
         }
 
-        if (stream != NULL) {
-                const GstStructure *st =
-                                   gst_discoverer_stream_info_get_misc (stream);
+        return value;
+}
 
-                value = get_fraction_value_from_structure (st, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+GUPnPDLNAFractionValue
+gupnp_dlna_gst_field_table_get_fraction (GUPnPDLNAGstFieldTable *table,
+                                         const gchar            *name)
+{
+        GUPnPDLNAFractionValue value = GUPNP_DLNA_FRACTION_VALUE_UNSET;
+        GPtrArray *candidates;
+        guint iter;
 
-        if (info != NULL) {
-                const GstStructure *st = gst_discoverer_info_get_misc (info);
+        g_return_val_if_fail (table != NULL, value);
+        g_return_val_if_fail (name != NULL, value);
 
-                value = get_fraction_value_from_structure (st, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
-        }
+        candidates = get_candidates (table, name);
+        for (iter = 0; candidates != NULL && iter < candidates->len; ++iter) {
+                const GValue *g_value = g_ptr_array_index (candidates, iter);
 
-        if (stream != NULL) {
-                const GstTagList *tags =
-                                   gst_discoverer_stream_info_get_tags (stream);
+                if (GST_VALUE_HOLDS_FRACTION (g_value)) {
+                        value.state = GUPNP_DLNA_VALUE_STATE_SET;
+                        value.numerator =
+                                     gst_value_get_fraction_numerator (g_value);
+                        value.denominator =
+                                   gst_value_get_fraction_denominator (g_value);
 
-                value = get_fraction_value_from_tag_list (tags, name);
-                if (value.state == GUPNP_DLNA_VALUE_STATE_SET)
-                        return value;
+                        break;
+                }
         }
 
         return value;
 }
 
-GUPnPDLNAStringValue
-gupnp_dlna_gst_get_mime (GstCaps* caps)
+GUPnPDLNAConstStringValue
+gupnp_dlna_gst_peek_mime (GstCaps* caps)
 {
-        GUPnPDLNAStringValue value = GUPNP_DLNA_STRING_VALUE_UNSET;
+        GUPnPDLNAConstStringValue value = GUPNP_DLNA_CONST_STRING_VALUE_UNSET;
         guint count = gst_caps_get_size (caps);
         guint iter;
 
@@ -419,7 +519,7 @@ gupnp_dlna_gst_get_mime (GstCaps* caps)
                         /* just in case */
                         if (name != NULL && name[0] != '\0') {
                                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
-                                value.value = g_strdup (name);
+                                value.value = name;
 
                                 break;
                         }
@@ -428,3 +528,9 @@ gupnp_dlna_gst_get_mime (GstCaps* caps)
 
         return value;
 }
+
+GUPnPDLNAStringValue
+gupnp_dlna_gst_get_mime (GstCaps* caps)
+{
+        return dup_string_value (gupnp_dlna_gst_peek_mime (caps));
+}
@@ -36,29 +36,82 @@ gupnp_dlna_gst_discoverer_info_unref (gpointer info);
 void
 gupnp_dlna_gst_discoverer_stream_info_unref (gpointer stream);
 
+/* Streams of a discoverer info, classified by kind. All members are
+ * read-only, the stream ones are %NULL if there is no stream of
+ * such kind. Streams found by a header probe have only caps and
+ * tags, so info, stream_list and the stream members are all %NULL
+ * for them and the has_* members tell which kinds were found. */
+typedef struct {
+        GstDiscovererInfo       *info;
+        GList                   *stream_list;
+        GstDiscovererAudioInfo  *audio;
+        GstDiscovererStreamInfo *container;
+        GstDiscovererVideoInfo  *image;
+        GstDiscovererVideoInfo  *video;
+        GstCaps                 *audio_caps;
+        GstCaps                 *container_caps;
+        /* caps of both image and video stream */
+        GstCaps                 *video_caps;
+        GstTagList              *audio_tags;
+        GstTagList              *container_tags;
+        GstTagList              *video_tags;
+        gboolean                 has_audio;
+        gboolean                 has_container;
+        gboolean                 has_image;
+        gboolean                 has_video;
+        gint                     ref_count;
+} GUPnPDLNAGstStreams;
+
+GUPnPDLNAGstStreams *
+gupnp_dlna_gst_streams_new (GstDiscovererInfo *info);
+
+GUPnPDLNAGstStreams *
+gupnp_dlna_gst_streams_new_from_caps (GstCaps    *container_caps,
+                                      GstTagList *container_tags,
+                                      GPtrArray  *stream_caps,
+                                      GPtrArray  *stream_tags);
+
+GUPnPDLNAGstStreams *
+gupnp_dlna_gst_streams_ref (GUPnPDLNAGstStreams *streams);
+
+void
+gupnp_dlna_gst_streams_unref (GUPnPDLNAGstStreams *streams);
+
+typedef struct _GUPnPDLNAGstFieldTable GUPnPDLNAGstFieldTable;
+
+GUPnPDLNAGstFieldTable *
+gupnp_dlna_gst_field_table_new (GstCaps                 *caps,
+                                GstDiscovererStreamInfo *stream,
+                                GstDiscovererInfo       *info,
+                                const GstTagList        *tags);
+
+void
+gupnp_dlna_gst_field_table_free (GUPnPDLNAGstFieldTable *table);
+
 GUPnPDLNAIntValue
-gupnp_dlna_gst_get_int_value (GstCaps* caps,
-                              GstDiscovererStreamInfo *stream,
-                              GstDiscovererInfo *info,
-                              const gchar *name);
+gupnp_dlna_gst_field_table_get_int (GUPnPDLNAGstFieldTable *table,
+                                    const gchar            *name);
+
+/* Returned strings are owned by the caps and discoverer info the
+ * table was created from. */
+GUPnPDLNAConstStringValue
+gupnp_dlna_gst_field_table_peek_string (GUPnPDLNAGstFieldTable *table,
+                                        const gchar            *name);
 
 GUPnPDLNAStringValue
-gupnp_dlna_gst_get_string_value (GstCaps* caps,
-                                 GstDiscovererStreamInfo *stream,
-                                 GstDiscovererInfo *info,
-                                 const gchar *name);
+gupnp_dlna_gst_field_table_get_string (GUPnPDLNAGstFieldTable *table,
+                                       const gchar            *name);
 
 GUPnPDLNABoolValue
-gupnp_dlna_gst_get_bool_value (GstCaps* caps,
-                               GstDiscovererStreamInfo *stream,
-                               GstDiscovererInfo *info,
-                               const gchar *name);
+gupnp_dlna_gst_field_table_get_bool (GUPnPDLNAGstFieldTable *table,
+                                     const gchar            *name);
 
 GUPnPDLNAFractionValue
-gupnp_dlna_gst_get_fraction_value (GstCaps* caps,
-                                   GstDiscovererStreamInfo *stream,
-                                   GstDiscovererInfo *info,
-                                   const gchar *name);
+gupnp_dlna_gst_field_table_get_fraction (GUPnPDLNAGstFieldTable *table,
+                                         const gchar            *name);
+
+GUPnPDLNAConstStringValue
+gupnp_dlna_gst_peek_mime (GstCaps* caps);
 
 GUPnPDLNAStringValue
 gupnp_dlna_gst_get_mime (GstCaps* caps);
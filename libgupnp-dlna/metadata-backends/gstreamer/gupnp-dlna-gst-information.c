@@ -31,6 +31,8 @@
 
 struct _GUPnPDLNAGstInformationPrivate {
         GstDiscovererInfo* info;
+        /* classified once and shared by all the stream informations */
+        GUPnPDLNAGstStreams *streams;
 };
 
 typedef struct _GUPnPDLNAGstInformationPrivate GUPnPDLNAGstInformationPrivate;
@@ -57,6 +59,7 @@ gupnp_dlna_gst_information_dispose (GObject *object)
                 gupnp_dlna_gst_information_get_instance_private (info);
 
         g_clear_pointer (&priv->info, gupnp_dlna_gst_discoverer_info_unref);
+        g_clear_pointer (&priv->streams, gupnp_dlna_gst_streams_unref);
         G_OBJECT_CLASS
                     (gupnp_dlna_gst_information_parent_class)->dispose (object);
 }
@@ -75,8 +78,13 @@ gupnp_dlna_gst_information_set_property (GObject      *object,
         case PROP_INFO:
                 g_clear_pointer (&priv->info,
                                  gupnp_dlna_gst_discoverer_info_unref);
+                g_clear_pointer (&priv->streams,
+                                 gupnp_dlna_gst_streams_unref);
                 priv->info =
                         GST_DISCOVERER_INFO (g_value_dup_object (value));
+                if (priv->info != NULL)
+                        priv->streams = gupnp_dlna_gst_streams_new
+                                        (priv->info);
 
                 break;
 
@@ -113,56 +121,71 @@ gupnp_dlna_gst_information_get_property (GObject    *object,
 GUPnPDLNAAudioInformation *
 backend_get_audio_information (GUPnPDLNAInformation *self)
 {
+        GUPnPDLNAGstInformation *info;
+        GUPnPDLNAGstInformationPrivate *priv;
+
         if (!GUPNP_DLNA_IS_GST_INFORMATION (self))
                 return NULL;
 
-        GUPnPDLNAGstInformation *info = GUPNP_DLNA_GST_INFORMATION (self);
-
-        GUPnPDLNAGstInformationPrivate *priv =
-                gupnp_dlna_gst_information_get_instance_private (info);
+        info = GUPNP_DLNA_GST_INFORMATION (self);
+        priv = gupnp_dlna_gst_information_get_instance_private (info);
+        if (priv->streams == NULL)
+                return NULL;
 
-        return GUPNP_DLNA_AUDIO_INFORMATION (
-                gupnp_dlna_gst_audio_information_new_from_discoverer_info (
-                        priv->info));
+        return GUPNP_DLNA_AUDIO_INFORMATION
+                (gupnp_dlna_gst_audio_information_new_from_streams
+                                        (priv->streams));
 }
 
 GUPnPDLNAContainerInformation *
 backend_get_container_information (GUPnPDLNAInformation *self)
 {
+        GUPnPDLNAGstInformation *info;
+        GUPnPDLNAGstInformationPrivate *priv;
+
         if (!GUPNP_DLNA_IS_GST_INFORMATION (self))
                 return NULL;
 
-        GUPnPDLNAGstInformation *info = GUPNP_DLNA_GST_INFORMATION (self);
-        GUPnPDLNAGstInformationPrivate *priv =
-                gupnp_dlna_gst_information_get_instance_private (info);
+        info = GUPNP_DLNA_GST_INFORMATION (self);
+        priv = gupnp_dlna_gst_information_get_instance_private (info);
+        if (priv->streams == NULL)
+                return NULL;
 
         return GUPNP_DLNA_CONTAINER_INFORMATION
-                (gupnp_dlna_gst_container_information_new_from_discoverer_info
-                                        (priv->info));
+                (gupnp_dlna_gst_container_information_new_from_streams
+                                        (priv->streams));
 }
 
 GUPnPDLNAImageInformation *
 backend_get_image_information (GUPnPDLNAInformation *self)
 {
-        GUPnPDLNAGstInformation *info = GUPNP_DLNA_GST_INFORMATION (self);
-        GUPnPDLNAGstInformationPrivate *priv =
-                gupnp_dlna_gst_information_get_instance_private (info);
+        GUPnPDLNAGstInformation *info;
+        GUPnPDLNAGstInformationPrivate *priv;
 
-        return GUPNP_DLNA_IMAGE_INFORMATION (
-                gupnp_dlna_gst_image_information_new_from_discoverer_info (
-                        priv->info));
+        info = GUPNP_DLNA_GST_INFORMATION (self);
+        priv = gupnp_dlna_gst_information_get_instance_private (info);
+        if (priv->streams == NULL)
+                return NULL;
+
+        return GUPNP_DLNA_IMAGE_INFORMATION
+                (gupnp_dlna_gst_image_information_new_from_streams
+                                        (priv->streams));
 }
 
 GUPnPDLNAVideoInformation *
 backend_get_video_information (GUPnPDLNAInformation *self)
 {
-        GUPnPDLNAGstInformation *info = GUPNP_DLNA_GST_INFORMATION (self);
-        GUPnPDLNAGstInformationPrivate *priv =
-                gupnp_dlna_gst_information_get_instance_private (info);
+        GUPnPDLNAGstInformation *info;
+        GUPnPDLNAGstInformationPrivate *priv;
+
+        info = GUPNP_DLNA_GST_INFORMATION (self);
+        priv = gupnp_dlna_gst_information_get_instance_private (info);
+        if (priv->streams == NULL)
+                return NULL;
 
-        return GUPNP_DLNA_VIDEO_INFORMATION (
-                gupnp_dlna_gst_video_information_new_from_discoverer_info (
-                        priv->info));
+        return GUPNP_DLNA_VIDEO_INFORMATION
+                (gupnp_dlna_gst_video_information_new_from_streams
+                                        (priv->streams));
 }
 
 static void
@@ -218,3 +241,24 @@ gupnp_dlna_gst_information_new_empty_with_uri (const gchar *uri)
                                                 "uri", uri,
                                                 NULL));
 }
+
+/* Creates the information from streams found without a discoverer,
+ * taking a reference on @streams. */
+GUPnPDLNAGstInformation *
+gupnp_dlna_gst_information_new_from_streams (const gchar         *uri,
+                                             GUPnPDLNAGstStreams *streams)
+{
+        GUPnPDLNAGstInformation *info;
+        GUPnPDLNAGstInformationPrivate *priv;
+
+        g_return_val_if_fail (streams != NULL, NULL);
+
+        info = GUPNP_DLNA_GST_INFORMATION
+                                 (g_object_new (GUPNP_TYPE_DLNA_GST_INFORMATION,
+                                                "uri", uri,
+                                                NULL));
+        priv = gupnp_dlna_gst_information_get_instance_private (info);
+        priv->streams = gupnp_dlna_gst_streams_ref (streams);
+
+        return info;
+}
@@ -27,6 +27,7 @@
 #include <glib-object.h>
 #include <gst/pbutils/pbutils.h>
 #include <libgupnp-dlna/gupnp-dlna-information.h>
+#include "gupnp-dlna-gst-info-utils.h"
 
 G_BEGIN_DECLS
 
@@ -58,6 +59,10 @@ gupnp_dlna_gst_information_new_from_discoverer_info (const gchar       *uri,
 GUPnPDLNAGstInformation *
 gupnp_dlna_gst_information_new_empty_with_uri (const gchar *uri);
 
+GUPnPDLNAGstInformation *
+gupnp_dlna_gst_information_new_from_streams (const gchar         *uri,
+                                             GUPnPDLNAGstStreams *streams);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_GST_INFORMATION_H__ */
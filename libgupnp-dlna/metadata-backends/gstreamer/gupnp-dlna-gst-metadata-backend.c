@@ -24,11 +24,19 @@
 #include <gst/gst.h>
 #include "gupnp-dlna-gst-metadata-extractor.h"
 
+/* GUPNP_DLNA_GST_HEADER_ONLY makes the extractors probe only the
+ * stream headers by default, each one can still be switched with
+ * its "header-only" property. */
 G_MODULE_EXPORT GUPnPDLNAMetadataExtractor *
 gupnp_dlna_get_default_extractor (void)
 {
-        return GUPNP_DLNA_METADATA_EXTRACTOR
-                                     (gupnp_dlna_gst_metadata_extractor_new ());
+        GUPnPDLNAGstMetadataExtractor *extractor =
+                                       gupnp_dlna_gst_metadata_extractor_new ();
+
+        if (g_getenv ("GUPNP_DLNA_GST_HEADER_ONLY") != NULL)
+                g_object_set (extractor, "header-only", TRUE, NULL);
+
+        return GUPNP_DLNA_METADATA_EXTRACTOR (extractor);
 }
 
 G_MODULE_EXPORT const gchar *
@@ -22,10 +22,15 @@
  */
 
 #include <gst/pbutils/pbutils.h>
+#include <gio/gio.h>
 #include "gupnp-dlna-gst-metadata-extractor.h"
+#include "gupnp-dlna-gst-header-probe.h"
 #include "gupnp-dlna-gst-information.h"
 #include "gupnp-dlna-gst-utils.h"
 
+struct _GUPnPDLNAGstMetadataExtractorPrivate {
+        gboolean header_only;
+};
 typedef struct _GUPnPDLNAGstMetadataExtractorPrivate
         GUPnPDLNAGstMetadataExtractorPrivate;
 
@@ -36,8 +41,6 @@ typedef struct _GUPnPDLNAGstMetadataExtractorPrivate
  */
 struct _GUPnPDLNAGstMetadataExtractor {
         GUPnPDLNAMetadataExtractor parent;
-
-        GUPnPDLNAGstMetadataExtractorPrivate *priv;
 };
 // Backwards-compatible defines
 /**
@@ -49,9 +52,53 @@ struct _GUPnPDLNAGstMetadataExtractor {
  */
 #define GUPNP_IS_GST_DLNA_METADATA_BACKEND_CLASS GUPNP_DLNA_IS_GST_METADATA_BACKEND_CLASS
 
-G_DEFINE_TYPE (GUPnPDLNAGstMetadataExtractor,
-               gupnp_dlna_gst_metadata_extractor,
-               GUPNP_TYPE_DLNA_METADATA_EXTRACTOR)
+G_DEFINE_TYPE_WITH_PRIVATE (GUPnPDLNAGstMetadataExtractor,
+                            gupnp_dlna_gst_metadata_extractor,
+                            GUPNP_TYPE_DLNA_METADATA_EXTRACTOR)
+
+static gboolean
+is_header_only (GUPnPDLNAMetadataExtractor *extractor)
+{
+        GUPnPDLNAGstMetadataExtractorPrivate *priv =
+                gupnp_dlna_gst_metadata_extractor_get_instance_private
+                                (GUPNP_DLNA_GST_METADATA_EXTRACTOR (extractor));
+
+        return priv->header_only;
+}
+
+enum {
+        PROP_0,
+
+        PROP_HEADER_ONLY
+};
+
+/* Times of an asynchronous extraction, kept on the discoverer until
+ * it is done. */
+#define DISCOVERER_TIMES_KEY "gupnp-dlna-discoverer-times"
+
+typedef struct {
+        gint64 creation_time;
+        gint64 start;
+} GUPnPDLNAGstDiscovererTimes;
+
+static void
+set_times (GUPnPDLNAInformation *info,
+           gint64                creation_time,
+           gint64                preroll_time,
+           gint64                wrapping_time)
+{
+        gupnp_dlna_information_set_phase_time
+                                    (info,
+                                     GUPNP_DLNA_GUESS_PHASE_DISCOVERER_CREATION,
+                                     creation_time);
+        gupnp_dlna_information_set_phase_time (info,
+                                               GUPNP_DLNA_GUESS_PHASE_PREROLL,
+                                               preroll_time);
+        gupnp_dlna_information_set_phase_time
+                                   (info,
+                                    GUPNP_DLNA_GUESS_PHASE_INFORMATION_WRAPPING,
+                                    wrapping_time);
+}
 
 static gboolean
 unref_discoverer_in_idle (GstDiscoverer *discoverer)
@@ -68,7 +115,11 @@ gupnp_dlna_discovered_cb (GUPnPDLNAMetadataExtractor *self,
                           gpointer user_data)
 {
         GstDiscoverer *discoverer = GST_DISCOVERER (user_data);
+        GUPnPDLNAGstDiscovererTimes *times =
+                                      g_object_get_data (G_OBJECT (discoverer),
+                                                         DISCOVERER_TIMES_KEY);
         GUPnPDLNAInformation *gupnp_info = NULL;
+        gint64 wrapping_start = g_get_monotonic_time ();
 
         if (error)
                 gupnp_info = GUPNP_DLNA_INFORMATION
@@ -77,6 +128,11 @@ gupnp_dlna_discovered_cb (GUPnPDLNAMetadataExtractor *self,
         else
                 gupnp_info = gupnp_dlna_gst_utils_information_from_discoverer_info
                                         (info);
+        if (times != NULL)
+                set_times (gupnp_info,
+                           times->creation_time,
+                           wrapping_start - times->start,
+                           g_get_monotonic_time () - wrapping_start);
         gupnp_dlna_metadata_extractor_emit_done (self,
                                                  gupnp_info,
                                                  error);
@@ -84,6 +140,167 @@ gupnp_dlna_discovered_cb (GUPnPDLNAMetadataExtractor *self,
         g_idle_add ((GSourceFunc) unref_discoverer_in_idle, discoverer);
 }
 
+typedef struct {
+        GUPnPDLNAMetadataExtractor *extractor;
+        const gchar                *uri;
+} GUPnPDLNAGstHeaderProgress;
+
+static gboolean
+header_progress_cb (GUPnPDLNAGstStreams *streams,
+                    gpointer             user_data)
+{
+        GUPnPDLNAGstHeaderProgress *progress = user_data;
+        GUPnPDLNAInformation *partial = GUPNP_DLNA_INFORMATION
+                    (gupnp_dlna_gst_information_new_from_streams (progress->uri,
+                                                                  streams));
+        gboolean stop = gupnp_dlna_metadata_extractor_emit_progress
+                                        (progress->extractor,
+                                         partial);
+
+        g_object_unref (partial);
+
+        return stop;
+}
+
+/* Extracts the information with a header probe instead of
+ * GstDiscoverer. Nothing is decoded, so values only a decoder knows
+ * stay unset unless a parser puts them into caps or tags. */
+static GUPnPDLNAInformation *
+extract_headers (GUPnPDLNAMetadataExtractor  *extractor,
+                 const gchar                 *uri,
+                 guint                        timeout_in_ms,
+                 GError                     **error)
+{
+        GUPnPDLNAGstHeaderProgress progress = { extractor, uri };
+        gint64 start = g_get_monotonic_time ();
+        GUPnPDLNAGstHeaderProbe *probe = gupnp_dlna_gst_header_probe_new
+                                        (uri,
+                                         header_progress_cb,
+                                         &progress,
+                                         error);
+        gint64 probe_start = g_get_monotonic_time ();
+        gint64 wrapping_start;
+        GUPnPDLNAGstStreams *streams;
+        GUPnPDLNAInformation *gupnp_info;
+
+        if (probe == NULL)
+                return NULL;
+
+        streams = gupnp_dlna_gst_header_probe_run (probe,
+                                                   timeout_in_ms,
+                                                   error);
+        gupnp_dlna_gst_header_probe_free (probe);
+        if (streams == NULL)
+                return NULL;
+
+        wrapping_start = g_get_monotonic_time ();
+        gupnp_info = GUPNP_DLNA_INFORMATION
+                     (gupnp_dlna_gst_information_new_from_streams (uri,
+                                                                   streams));
+        gupnp_dlna_gst_streams_unref (streams);
+        set_times (gupnp_info,
+                   probe_start - start,
+                   wrapping_start - probe_start,
+                   g_get_monotonic_time () - wrapping_start);
+
+        return gupnp_info;
+}
+
+typedef struct {
+        GUPnPDLNAMetadataExtractor *extractor;
+        GMainContext               *context;
+        gchar                      *uri;
+        guint                       timeout_in_ms;
+        GUPnPDLNAInformation       *info;
+        GError                     *error;
+} GUPnPDLNAGstHeaderAsyncData;
+
+static void
+free_header_async_data (GUPnPDLNAGstHeaderAsyncData *data)
+{
+        g_object_unref (data->extractor);
+        g_main_context_unref (data->context);
+        g_free (data->uri);
+        g_clear_object (&data->info);
+        g_clear_error (&data->error);
+        g_slice_free (GUPnPDLNAGstHeaderAsyncData, data);
+}
+
+static gboolean
+emit_header_done (GUPnPDLNAGstHeaderAsyncData *data)
+{
+        gupnp_dlna_metadata_extractor_emit_done (data->extractor,
+                                                 data->info,
+                                                 data->error);
+
+        return G_SOURCE_REMOVE;
+}
+
+static void
+extract_headers_in_thread (gpointer job,
+                           gpointer user_data G_GNUC_UNUSED)
+{
+        GUPnPDLNAGstHeaderAsyncData *data = job;
+
+        data->info = extract_headers (data->extractor,
+                                      data->uri,
+                                      data->timeout_in_ms,
+                                      &data->error);
+        if (data->info == NULL)
+                data->info = GUPNP_DLNA_INFORMATION
+                                  (gupnp_dlna_gst_information_new_empty_with_uri
+                                        (data->uri));
+        g_main_context_invoke_full (data->context,
+                                    G_PRIORITY_DEFAULT,
+                                    (GSourceFunc) emit_header_done,
+                                    data,
+                                    (GDestroyNotify) free_header_async_data);
+}
+
+/* Probes block on the pipeline bus, so they are run in a pool shared
+ * by all extractors. */
+static GThreadPool *
+get_header_pool (void)
+{
+        static gsize pool = 0;
+
+        if (g_once_init_enter (&pool)) {
+                GThreadPool *new_pool = g_thread_pool_new
+                                        (extract_headers_in_thread,
+                                         NULL,
+                                         g_get_num_processors (),
+                                         FALSE,
+                                         NULL);
+
+                g_once_init_leave (&pool, (gsize) new_pool);
+        }
+
+        return (GThreadPool *) pool;
+}
+
+static gboolean
+extract_headers_async (GUPnPDLNAMetadataExtractor  *extractor,
+                       const gchar                 *uri,
+                       guint                        timeout_in_ms,
+                       GError                     **error)
+{
+        GUPnPDLNAGstHeaderAsyncData *data = g_slice_new0
+                                        (GUPnPDLNAGstHeaderAsyncData);
+
+        data->extractor = g_object_ref (extractor);
+        data->context = g_main_context_ref_thread_default ();
+        data->uri = g_strdup (uri);
+        data->timeout_in_ms = timeout_in_ms;
+
+        if (!g_thread_pool_push (get_header_pool (), data, error)) {
+                free_header_async_data (data);
+
+                return FALSE;
+        }
+
+        return TRUE;
+}
+
 static gboolean
 backend_extract_async (GUPnPDLNAMetadataExtractor  *extractor,
                        const gchar                 *uri,
@@ -92,14 +309,31 @@ backend_extract_async (GUPnPDLNAMetadataExtractor  *extractor,
 {
         GError *gst_error = NULL;
         GstClockTime clock_time = GST_MSECOND * timeout;
-        GstDiscoverer *discoverer = gst_discoverer_new (clock_time, &gst_error);
+        gint64 start = g_get_monotonic_time ();
+        GstDiscoverer *discoverer;
+        GUPnPDLNAGstDiscovererTimes *times;
+
+        if (is_header_only (extractor))
+                return extract_headers_async (extractor,
+                                              uri,
+                                              timeout,
+                                              error);
 
+        discoverer = gst_discoverer_new (clock_time, &gst_error);
         if (gst_error) {
                 g_propagate_error (error, gst_error);
 
                 return FALSE;
         }
 
+        times = g_new (GUPnPDLNAGstDiscovererTimes, 1);
+        times->start = g_get_monotonic_time ();
+        times->creation_time = times->start - start;
+        g_object_set_data_full (G_OBJECT (discoverer),
+                                DISCOVERER_TIMES_KEY,
+                                times,
+                                g_free);
+
         g_signal_connect_swapped (discoverer,
                                   "discovered",
                                   G_CALLBACK (gupnp_dlna_discovered_cb),
@@ -111,17 +345,29 @@ backend_extract_async (GUPnPDLNAMetadataExtractor  *extractor,
 }
 
 static GUPnPDLNAInformation *
-backend_extract_sync (GUPnPDLNAMetadataExtractor  *extractor G_GNUC_UNUSED,
+backend_extract_sync (GUPnPDLNAMetadataExtractor  *extractor,
                       const gchar                 *uri,
                       guint                        timeout_in_ms,
                       GError                     **error)
 {
         GError *gst_error = NULL;
         GstClockTime clock_time = GST_MSECOND * timeout_in_ms;
-        GstDiscoverer *discoverer = gst_discoverer_new (clock_time, &gst_error);
+        gint64 start;
+        GstDiscoverer *discoverer;
+        gint64 preroll_start;
+        gint64 wrapping_start;
         GstDiscovererInfo* info;
         GUPnPDLNAInformation *gupnp_info;
 
+        if (is_header_only (extractor))
+                return extract_headers (extractor,
+                                        uri,
+                                        timeout_in_ms,
+                                        error);
+
+        start = g_get_monotonic_time ();
+        discoverer = gst_discoverer_new (clock_time, &gst_error);
+        preroll_start = g_get_monotonic_time ();
         if (gst_error) {
                 g_propagate_error (error, gst_error);
 
@@ -139,22 +385,102 @@ backend_extract_sync (GUPnPDLNAMetadataExtractor  *extractor G_GNUC_UNUSED,
                 return NULL;
         }
 
+        wrapping_start = g_get_monotonic_time ();
         gupnp_info = GUPNP_DLNA_INFORMATION
               (gupnp_dlna_gst_information_new_from_discoverer_info (uri, info));
         gst_discoverer_info_unref (info);
+        set_times (gupnp_info,
+                   preroll_start - start,
+                   wrapping_start - preroll_start,
+                   g_get_monotonic_time () - wrapping_start);
 
         return gupnp_info;
 }
 
+static void
+gupnp_dlna_gst_metadata_extractor_set_property (GObject      *object,
+                                                guint         property_id,
+                                                const GValue *value,
+                                                GParamSpec   *pspec)
+{
+        GUPnPDLNAGstMetadataExtractor *self =
+                                     GUPNP_DLNA_GST_METADATA_EXTRACTOR (object);
+        GUPnPDLNAGstMetadataExtractorPrivate *priv =
+                gupnp_dlna_gst_metadata_extractor_get_instance_private (self);
+
+        switch (property_id) {
+        case PROP_HEADER_ONLY:
+                priv->header_only = g_value_get_boolean (value);
+
+                break;
+
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+
+                break;
+        }
+}
+
+static void
+gupnp_dlna_gst_metadata_extractor_get_property (GObject    *object,
+                                                guint       property_id,
+                                                GValue     *value,
+                                                GParamSpec *pspec)
+{
+        GUPnPDLNAGstMetadataExtractor *self =
+                                     GUPNP_DLNA_GST_METADATA_EXTRACTOR (object);
+        GUPnPDLNAGstMetadataExtractorPrivate *priv =
+                gupnp_dlna_gst_metadata_extractor_get_instance_private (self);
+
+        switch (property_id) {
+        case PROP_HEADER_ONLY:
+                g_value_set_boolean (value, priv->header_only);
+
+                break;
+
+        default:
+                G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+
+                break;
+        }
+}
+
 static void
 gupnp_dlna_gst_metadata_extractor_class_init
                        (GUPnPDLNAGstMetadataExtractorClass *gst_extractor_class)
 {
+        GObjectClass *object_class = G_OBJECT_CLASS (gst_extractor_class);
         GUPnPDLNAMetadataExtractorClass *extractor_class =
                       GUPNP_DLNA_METADATA_EXTRACTOR_CLASS (gst_extractor_class);
+        GParamSpec *pspec;
 
+        object_class->set_property =
+                                gupnp_dlna_gst_metadata_extractor_set_property;
+        object_class->get_property =
+                                gupnp_dlna_gst_metadata_extractor_get_property;
         extractor_class->extract_async = backend_extract_async;
         extractor_class->extract_sync = backend_extract_sync;
+
+        /**
+         * GUPnPDLNAGstMetadataExtractor:header-only:
+         *
+         * Whether to extract the information with a pipeline of
+         * only a typefinder, demuxers and parsers instead of
+         * #GstDiscoverer. It stops as soon as every stream has caps
+         * and never plugs decoders or sinks, so it is much cheaper,
+         * but values known only after decoding, like the depth of
+         * compressed audio, may stay unset.
+         */
+        pspec = g_param_spec_boolean ("header-only",
+                                      "Header only",
+                                      "Extract without decoding",
+                                      FALSE,
+                                      G_PARAM_READWRITE |
+                                      G_PARAM_CONSTRUCT |
+                                      G_PARAM_STATIC_STRINGS);
+        g_object_class_install_property (object_class,
+                                         PROP_HEADER_ONLY,
+                                         pspec);
 }
 
 static void
@@ -27,9 +27,10 @@
 
 struct _GUPnPDLNAGstVideoInformationPrivate {
         GstDiscovererInfo *info;
-        GList *stream_list;
-        GstDiscovererVideoInfo *video_info;
-        GstCaps *caps;
+        GUPnPDLNAGstStreams *streams;
+        GUPnPDLNAGstFieldTable *fields;
+        /* guards lazily initialized fields above */
+        GRecMutex lock;
 };
 
 typedef struct _GUPnPDLNAGstVideoInformationPrivate GUPnPDLNAGstVideoInformationPrivate;
@@ -51,85 +52,102 @@ enum
         PROP_INFO
 };
 
-static GstDiscovererVideoInfo *
-get_video_info (GUPnPDLNAGstVideoInformation *gst_info)
+static GUPnPDLNAGstStreams *
+get_streams (GUPnPDLNAGstVideoInformation *gst_info)
 {
         GUPnPDLNAGstVideoInformationPrivate *priv = gst_info->priv;
+        GUPnPDLNAGstStreams *streams;
 
-        if (!priv->video_info) {
-                GList *iter;
-
-                if (!priv->stream_list) {
-                        priv->stream_list =
-                               gst_discoverer_info_get_stream_list (priv->info);
-                        if (!priv->stream_list)
-                                return NULL;
-                }
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->streams && priv->info)
+                priv->streams = gupnp_dlna_gst_streams_new (priv->info);
+        streams = priv->streams;
+        g_rec_mutex_unlock (&priv->lock);
 
-                for (iter = priv->stream_list; iter; iter = iter->next) {
-                        GstDiscovererStreamInfo *stream =
-                                        GST_DISCOVERER_STREAM_INFO (iter->data);
-                        GType stream_type = G_TYPE_FROM_INSTANCE (stream);
-
-                        if (stream_type == GST_TYPE_DISCOVERER_VIDEO_INFO) {
-                                priv->video_info =
-                                             GST_DISCOVERER_VIDEO_INFO (stream);
+        return streams;
+}
 
-                                break;
-                        }
-                }
-        }
+static GstDiscovererVideoInfo *
+get_video_info (GUPnPDLNAGstVideoInformation *gst_info)
+{
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
 
-        return priv->video_info;
+        return streams ? streams->video : NULL;
 }
 
 static GstCaps *
 get_caps (GUPnPDLNAGstVideoInformation *gst_info)
 {
-        GUPnPDLNAGstVideoInformationPrivate *priv = gst_info->priv;
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
+
+        return streams ? streams->video_caps : NULL;
+}
+
+static GstTagList *
+get_tags (GUPnPDLNAGstVideoInformation *gst_info)
+{
+        GUPnPDLNAGstStreams *streams = get_streams (gst_info);
 
-        if (!priv->caps)
-                priv->caps = gst_discoverer_stream_info_get_caps
-                                        (GST_DISCOVERER_STREAM_INFO
-                                                   (get_video_info (gst_info)));
+        return streams ? streams->video_tags : NULL;
+}
 
-        return priv->caps;
+static GUPnPDLNAGstFieldTable *
+get_fields (GUPnPDLNAGstVideoInformation *gst_info)
+{
+        GUPnPDLNAGstVideoInformationPrivate *priv = gst_info->priv;
+        GUPnPDLNAGstFieldTable *fields;
+
+        g_rec_mutex_lock (&priv->lock);
+        if (!priv->fields)
+                priv->fields = gupnp_dlna_gst_field_table_new
+                                        (get_caps (gst_info),
+                                         GST_DISCOVERER_STREAM_INFO
+                                                   (get_video_info (gst_info)),
+                                         priv->info,
+                                         get_tags (gst_info));
+        fields = priv->fields;
+        g_rec_mutex_unlock (&priv->lock);
+
+        return fields;
 }
 
 static GUPnPDLNAIntValue
 get_int_value (GUPnPDLNAGstVideoInformation *gst_info,
                const gchar *name)
 {
-        GstCaps *caps = get_caps (gst_info);
-        GstDiscovererStreamInfo *stream =
-                         GST_DISCOVERER_STREAM_INFO (get_video_info (gst_info));
-        GstDiscovererInfo *info = gst_info->priv->info;
-
-        return gupnp_dlna_gst_get_int_value (caps, stream, info, name);
+        return gupnp_dlna_gst_field_table_get_int (get_fields (gst_info), name);
 }
 
 static GUPnPDLNAStringValue
 get_string_value (GUPnPDLNAGstVideoInformation *gst_info,
                   const gchar *name)
 {
-        GstCaps *caps = get_caps (gst_info);
-        GstDiscovererStreamInfo *stream =
-                         GST_DISCOVERER_STREAM_INFO (get_video_info (gst_info));
-        GstDiscovererInfo *info = gst_info->priv->info;
+        return gupnp_dlna_gst_field_table_get_string (get_fields (gst_info),
+                                                      name);
+}
 
-        return gupnp_dlna_gst_get_string_value (caps, stream, info, name);
+static GUPnPDLNAConstStringValue
+peek_string_value (GUPnPDLNAGstVideoInformation *gst_info,
+                   const gchar *name)
+{
+        return gupnp_dlna_gst_field_table_peek_string (get_fields (gst_info),
+                                                       name);
 }
 
 static GUPnPDLNABoolValue
 get_bool_value (GUPnPDLNAGstVideoInformation *gst_info,
                 const gchar *name)
 {
-        GstCaps *caps = get_caps (gst_info);
-        GstDiscovererStreamInfo *stream =
-                         GST_DISCOVERER_STREAM_INFO (get_video_info (gst_info));
-        GstDiscovererInfo *info = gst_info->priv->info;
+        return gupnp_dlna_gst_field_table_get_bool (get_fields (gst_info),
+                                                    name);
+}
 
-        return gupnp_dlna_gst_get_bool_value (caps, stream, info, name);
+static GUPnPDLNAFractionValue
+get_fraction_value (GUPnPDLNAGstVideoInformation *gst_info,
+                    const gchar *name)
+{
+        return gupnp_dlna_gst_field_table_get_fraction (get_fields (gst_info),
+                                                        name);
 }
 
 static GUPnPDLNAIntValue
@@ -138,9 +156,14 @@ backend_get_bitrate (GUPnPDLNAVideoInformation *self)
         GUPnPDLNAGstVideoInformation* gst_info =
                                         GUPNP_DLNA_GST_VIDEO_INFORMATION (self);
         GstDiscovererVideoInfo *video_info = get_video_info (gst_info);
-        guint data = gst_discoverer_video_info_get_bitrate (video_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
 
+        /* streams found by a header probe have only caps and tags */
+        if (video_info == NULL)
+                return get_int_value (gst_info, "bitrate");
+
+        data = gst_discoverer_video_info_get_bitrate (video_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -155,11 +178,15 @@ backend_get_framerate (GUPnPDLNAVideoInformation *self)
         GUPnPDLNAGstVideoInformation* gst_info =
                                         GUPNP_DLNA_GST_VIDEO_INFORMATION (self);
         GstDiscovererVideoInfo *video_info = get_video_info (gst_info);
-        guint ndata = gst_discoverer_video_info_get_framerate_num (video_info);
-        guint ddata = gst_discoverer_video_info_get_framerate_denom
-                                        (video_info);
         GUPnPDLNAFractionValue value = GUPNP_DLNA_FRACTION_VALUE_UNSET;
+        guint ndata;
+        guint ddata;
+
+        if (video_info == NULL)
+                return get_fraction_value (gst_info, "framerate");
 
+        ndata = gst_discoverer_video_info_get_framerate_num (video_info);
+        ddata = gst_discoverer_video_info_get_framerate_denom (video_info);
         if (ndata > 0 && ndata <= G_MAXINT && ddata > 0 && ddata <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.numerator = (gint) ndata;
@@ -175,9 +202,13 @@ backend_get_height (GUPnPDLNAVideoInformation *self)
         GUPnPDLNAGstVideoInformation* gst_info =
                                         GUPNP_DLNA_GST_VIDEO_INFORMATION (self);
         GstDiscovererVideoInfo *video_info = get_video_info (gst_info);
-        guint data = gst_discoverer_video_info_get_height (video_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
 
+        if (video_info == NULL)
+                return get_int_value (gst_info, "height");
+
+        data = gst_discoverer_video_info_get_height (video_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -192,8 +223,18 @@ backend_is_interlaced (GUPnPDLNAVideoInformation *self)
         GUPnPDLNAGstVideoInformation* gst_info =
                                         GUPNP_DLNA_GST_VIDEO_INFORMATION (self);
         GstDiscovererVideoInfo *video_info = get_video_info (gst_info);
-        gboolean data = gst_discoverer_video_info_get_height (video_info);
         GUPnPDLNABoolValue value;
+        gboolean data;
+
+        if (video_info == NULL) {
+                GUPnPDLNAConstStringValue mode =
+                                   peek_string_value (gst_info,
+                                                      "interlace-mode");
+
+                data = (mode.state == GUPNP_DLNA_VALUE_STATE_SET &&
+                        g_strcmp0 (mode.value, "progressive") != 0);
+        } else
+                data = gst_discoverer_video_info_get_height (video_info);
 
         value.state = GUPNP_DLNA_VALUE_STATE_SET;
         value.value = data;
@@ -210,6 +251,15 @@ backend_get_level (GUPnPDLNAVideoInformation *self)
         return get_string_value (gst_info, "level");
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_level (GUPnPDLNAVideoInformation *self)
+{
+        GUPnPDLNAGstVideoInformation* gst_info =
+                                        GUPNP_DLNA_GST_VIDEO_INFORMATION (self);
+
+        return peek_string_value (gst_info, "level");
+}
+
 static GUPnPDLNAIntValue
 backend_get_mpeg_version (GUPnPDLNAVideoInformation *self)
 {
@@ -225,10 +275,15 @@ backend_get_pixel_aspect_ratio (GUPnPDLNAVideoInformation *self)
         GUPnPDLNAGstVideoInformation* gst_info =
                                         GUPNP_DLNA_GST_VIDEO_INFORMATION (self);
         GstDiscovererVideoInfo *video_info = get_video_info (gst_info);
-        guint ndata = gst_discoverer_video_info_get_par_num (video_info);
-        guint ddata = gst_discoverer_video_info_get_par_denom (video_info);
         GUPnPDLNAFractionValue value = GUPNP_DLNA_FRACTION_VALUE_UNSET;
+        guint ndata;
+        guint ddata;
+
+        if (video_info == NULL)
+                return get_fraction_value (gst_info, "pixel-aspect-ratio");
 
+        ndata = gst_discoverer_video_info_get_par_num (video_info);
+        ddata = gst_discoverer_video_info_get_par_denom (video_info);
         if (ndata > 0 && ndata <= G_MAXINT && ddata > 0 && ddata <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.numerator = (gint) ndata;
@@ -247,6 +302,15 @@ backend_get_profile (GUPnPDLNAVideoInformation *self)
         return get_string_value (gst_info, "profile");
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_profile (GUPnPDLNAVideoInformation *self)
+{
+        GUPnPDLNAGstVideoInformation* gst_info =
+                                        GUPNP_DLNA_GST_VIDEO_INFORMATION (self);
+
+        return peek_string_value (gst_info, "profile");
+}
+
 static GUPnPDLNABoolValue
 backend_is_system_stream (GUPnPDLNAVideoInformation *self)
 {
@@ -262,9 +326,13 @@ backend_get_width (GUPnPDLNAVideoInformation *self)
         GUPnPDLNAGstVideoInformation* gst_info =
                                         GUPNP_DLNA_GST_VIDEO_INFORMATION (self);
         GstDiscovererVideoInfo *video_info = get_video_info (gst_info);
-        guint data = gst_discoverer_video_info_get_width (video_info);
         GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+        guint data;
+
+        if (video_info == NULL)
+                return get_int_value (gst_info, "width");
 
+        data = gst_discoverer_video_info_get_width (video_info);
         if (data > 0 && data <= G_MAXINT) {
                 value.state = GUPNP_DLNA_VALUE_STATE_SET;
                 value.value = (gint) data;
@@ -282,6 +350,15 @@ backend_get_mime (GUPnPDLNAVideoInformation *self)
         return gupnp_dlna_gst_get_mime (get_caps (gst_info));
 }
 
+static GUPnPDLNAConstStringValue
+backend_peek_mime (GUPnPDLNAVideoInformation *self)
+{
+        GUPnPDLNAGstVideoInformation* gst_info =
+                                        GUPNP_DLNA_GST_VIDEO_INFORMATION (self);
+
+        return gupnp_dlna_gst_peek_mime (get_caps (gst_info));
+}
+
 static void
 gupnp_dlna_gst_video_information_dispose (GObject *object)
 {
@@ -289,16 +366,26 @@ gupnp_dlna_gst_video_information_dispose (GObject *object)
                                       GUPNP_DLNA_GST_VIDEO_INFORMATION (object);
         GUPnPDLNAGstVideoInformationPrivate *priv = info->priv;
 
+        /* fields borrow values from streams */
+        g_clear_pointer (&priv->fields, gupnp_dlna_gst_field_table_free);
         g_clear_pointer (&priv->info, gupnp_dlna_gst_discoverer_info_unref);
-        g_clear_pointer (&priv->stream_list,
-                         gst_discoverer_stream_info_list_free);
-        /* priv->video_info is freed with stream list above */
-        priv->video_info = NULL;
-        g_clear_pointer (&priv->caps, gst_caps_unref);
+        g_clear_pointer (&priv->streams, gupnp_dlna_gst_streams_unref);
         G_OBJECT_CLASS
               (gupnp_dlna_gst_video_information_parent_class)->dispose (object);
 }
 
+static void
+gupnp_dlna_gst_video_information_finalize (GObject *object)
+{
+        GUPnPDLNAGstVideoInformation *info =
+                                      GUPNP_DLNA_GST_VIDEO_INFORMATION (object);
+        GObjectClass *parent_class =
+                 G_OBJECT_CLASS (gupnp_dlna_gst_video_information_parent_class);
+
+        g_rec_mutex_clear (&info->priv->lock);
+        parent_class->finalize (object);
+}
+
 static void
 gupnp_dlna_gst_video_information_set_property (GObject      *object,
                                                guint         property_id,
@@ -313,6 +400,10 @@ gupnp_dlna_gst_video_information_set_property (GObject      *object,
         case PROP_INFO:
                 g_clear_pointer (&priv->info,
                                  gupnp_dlna_gst_discoverer_info_unref);
+                g_clear_pointer (&priv->fields,
+                                 gupnp_dlna_gst_field_table_free);
+                g_clear_pointer (&priv->streams,
+                                 gupnp_dlna_gst_streams_unref);
                 priv->info =
                         GST_DISCOVERER_INFO (g_value_dup_object (value));
                 break;
@@ -358,6 +449,7 @@ gupnp_dlna_gst_video_information_class_init
         object_class->set_property =
                                   gupnp_dlna_gst_video_information_set_property;
         object_class->dispose = gupnp_dlna_gst_video_information_dispose;
+        object_class->finalize = gupnp_dlna_gst_video_information_finalize;
 
         info_class->get_bitrate = backend_get_bitrate;
         info_class->get_framerate = backend_get_framerate;
@@ -370,6 +462,9 @@ gupnp_dlna_gst_video_information_class_init
         info_class->is_system_stream = backend_is_system_stream;
         info_class->get_width = backend_get_width;
         info_class->get_mime = backend_get_mime;
+        info_class->peek_level = backend_peek_level;
+        info_class->peek_profile = backend_peek_profile;
+        info_class->peek_mime = backend_peek_mime;
 
         pspec = g_param_spec_object ("info",
                                      "info",
@@ -387,29 +482,47 @@ gupnp_dlna_gst_video_information_init (GUPnPDLNAGstVideoInformation *self)
 {
         self->priv = gupnp_dlna_gst_video_information_get_instance_private
                                         (self);
+        g_rec_mutex_init (&self->priv->lock);
+}
+
+/* Creates the information borrowing already classified @streams,
+ * or returns %NULL if there is no video stream among them. */
+GUPnPDLNAGstVideoInformation *
+gupnp_dlna_gst_video_information_new_from_streams
+                                        (GUPnPDLNAGstStreams *streams)
+{
+        GUPnPDLNAGstVideoInformation *video_info;
+        GUPnPDLNAGstVideoInformationPrivate *priv;
+
+        g_return_val_if_fail (streams != NULL, NULL);
+
+        if (!streams->has_video)
+                return NULL;
+
+        video_info = GUPNP_DLNA_GST_VIDEO_INFORMATION
+                                (g_object_new
+                                     (GUPNP_TYPE_DLNA_GST_VIDEO_INFORMATION,
+                                      "info", streams->info,
+                                      NULL));
+        priv = video_info->priv;
+        priv->streams = gupnp_dlna_gst_streams_ref (streams);
+
+        return video_info;
 }
 
 GUPnPDLNAGstVideoInformation *
 gupnp_dlna_gst_video_information_new_from_discoverer_info
                                         (GstDiscovererInfo *info)
 {
-        GList* video_list;
-        GUPnPDLNAGstVideoInformation *video_info = NULL;
+        GUPnPDLNAGstStreams *streams;
+        GUPnPDLNAGstVideoInformation *video_info;
 
         g_return_val_if_fail (GST_IS_DISCOVERER_INFO (info), NULL);
 
-        video_list = gst_discoverer_info_get_video_streams (info);
-
-        if (video_list) {
-                if (!gst_discoverer_video_info_is_image
-                                 (GST_DISCOVERER_VIDEO_INFO (video_list->data)))
-                        video_info = GUPNP_DLNA_GST_VIDEO_INFORMATION
-                                        (g_object_new
-                                         (GUPNP_TYPE_DLNA_GST_VIDEO_INFORMATION,
-                                          "info", info,
-                                          NULL));
-                gst_discoverer_stream_info_list_free (video_list);
-        }
+        streams = gupnp_dlna_gst_streams_new (info);
+        video_info = gupnp_dlna_gst_video_information_new_from_streams
+                                        (streams);
+        gupnp_dlna_gst_streams_unref (streams);
 
         return video_info;
 }
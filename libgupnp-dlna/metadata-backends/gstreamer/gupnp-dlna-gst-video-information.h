@@ -25,6 +25,7 @@
 #include <glib-object.h>
 #include <gst/pbutils/pbutils.h>
 #include "gupnp-dlna-video-information.h"
+#include "gupnp-dlna-gst-info-utils.h"
 
 G_BEGIN_DECLS
 
@@ -53,6 +54,10 @@ struct _GUPnPDLNAGstVideoInformationClass {
 GUPnPDLNAGstVideoInformation *
 gupnp_dlna_gst_video_information_new_from_discoverer_info (GstDiscovererInfo *info);
 
+GUPnPDLNAGstVideoInformation *
+gupnp_dlna_gst_video_information_new_from_streams
+                                        (GUPnPDLNAGstStreams *streams);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_GST_VIDEO_INFORMATION_H__ */
@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Extractor helper run by the process metadata backend. It loads
+ * another metadata backend and serves extraction requests coming on
+ * stdin, replying on stdout - see gupnp-dlna-process-protocol.h.
+ *
+ * The inner backend is taken from GUPNP_DLNA_PROCESS_BACKEND and
+ * GUPNP_DLNA_PROCESS_BACKEND_DIR environment variables, falling back
+ * to the defaults the library was built with.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <gmodule.h>
+#include <libgupnp-dlna/metadata/gupnp-dlna-metadata-extractor.h>
+#include <libgupnp-dlna/gupnp-dlna-information.h>
+
+#include "gupnp-dlna-process-protocol.h"
+
+#define GET_DEFAULT_EXTRACTOR_SYMBOL "gupnp_dlna_get_default_extractor"
+
+typedef GUPnPDLNAMetadataExtractor *
+(* GetDefaultExtractorFunc) (void);
+
+static GUPnPDLNAMetadataExtractor *
+load_extractor (void)
+{
+        const gchar *backend = g_getenv ("GUPNP_DLNA_PROCESS_BACKEND");
+        const gchar *backend_dir = g_getenv ("GUPNP_DLNA_PROCESS_BACKEND_DIR");
+        gchar *module_path;
+        GModule *module;
+        gpointer get_default_extractor = NULL;
+
+        if (backend == NULL)
+                backend = GUPNP_DLNA_DEFAULT_METADATA_BACKEND;
+        if (backend_dir == NULL)
+                backend_dir = g_getenv ("GUPNP_DLNA_METADATA_BACKEND_DIR");
+        if (backend_dir == NULL)
+                backend_dir = GUPNP_DLNA_DEFAULT_METADATA_BACKEND_DIR;
+        if (g_strcmp0 (backend, "process") == 0) {
+                g_warning ("Refusing to run the process backend inside "
+                           "its own helper.");
+
+                return NULL;
+        }
+
+        module_path = g_module_build_path (backend_dir, backend);
+        module = g_module_open (module_path, G_MODULE_BIND_MASK);
+        if (module == NULL) {
+                g_warning ("Could not open metadata backend '%s': %s",
+                           module_path,
+                           g_module_error ());
+                g_free (module_path);
+
+                return NULL;
+        }
+        if (!g_module_symbol (module,
+                              GET_DEFAULT_EXTRACTOR_SYMBOL,
+                              &get_default_extractor) ||
+            get_default_extractor == NULL) {
+                g_warning ("Could not find valid '"
+                           GET_DEFAULT_EXTRACTOR_SYMBOL
+                           "' symbol in '%s'.",
+                           module_path);
+                g_module_close (module);
+                g_free (module_path);
+
+                return NULL;
+        }
+        g_module_make_resident (module);
+        g_free (module_path);
+
+        return ((GetDefaultExtractorFunc) get_default_extractor) ();
+}
+
+/* Returns the number of bytes read, which is less than @size only at
+ * the end of input, or -1 on error. */
+static gssize
+read_all (int     fd,
+          guint8 *data,
+          gsize   size)
+{
+        gsize done = 0;
+
+        while (done < size) {
+                gssize count = read (fd, data + done, size - done);
+
+                if (count < 0) {
+                        if (errno == EINTR)
+                                continue;
+
+                        return -1;
+                }
+                if (count == 0)
+                        break;
+                done += count;
+        }
+
+        return done;
+}
+
+static gboolean
+write_all (int           fd,
+           const guint8 *data,
+           gsize         size)
+{
+        while (size > 0) {
+                gssize count = write (fd, data, size);
+
+                if (count < 0) {
+                        if (errno == EINTR)
+                                continue;
+
+                        return FALSE;
+                }
+                data += count;
+                size -= count;
+        }
+
+        return TRUE;
+}
+
+static GVariant *
+read_request (int fd)
+{
+        guint32 size;
+        guint8 *data;
+        GBytes *bytes;
+        GVariant *request;
+
+        if (read_all (fd,
+                      (guint8 *) &size,
+                      GUPNP_DLNA_PROCESS_HEADER_SIZE) !=
+            GUPNP_DLNA_PROCESS_HEADER_SIZE)
+                return NULL;
+        size = GUINT32_FROM_BE (size);
+        if (size > GUPNP_DLNA_PROCESS_MAX_FRAME_SIZE) {
+                g_warning ("Request of %u bytes is too big.", size);
+
+                return NULL;
+        }
+
+        data = g_malloc (size);
+        if (read_all (fd, data, size) != (gssize) size) {
+                g_free (data);
+
+                return NULL;
+        }
+        bytes = g_bytes_new_take (data, size);
+        request = g_variant_new_from_bytes
+                            (G_VARIANT_TYPE (GUPNP_DLNA_PROCESS_REQUEST_TYPE),
+                             bytes,
+                             FALSE);
+        g_bytes_unref (bytes);
+
+        return g_variant_ref_sink (request);
+}
+
+static gboolean
+write_reply (int       fd,
+             GVariant *reply)
+{
+        gsize size = g_variant_get_size (reply);
+        guint32 header = GUINT32_TO_BE (size);
+
+        return (write_all (fd,
+                           (const guint8 *) &header,
+                           GUPNP_DLNA_PROCESS_HEADER_SIZE) &&
+                write_all (fd, g_variant_get_data (reply), size));
+}
+
+static GVariant *
+extract (GUPnPDLNAMetadataExtractor *extractor,
+         GVariant                   *request)
+{
+        guint timeout_in_ms;
+        const gchar *uri;
+        GError *error = NULL;
+        GUPnPDLNAInformation *info;
+        GBytes *serialized;
+        GVariant *data;
+        GVariant *reply;
+
+        g_variant_get (request, "(u&s)", &timeout_in_ms, &uri);
+        info = gupnp_dlna_metadata_extractor_extract_sync (extractor,
+                                                          uri,
+                                                          timeout_in_ms,
+                                                          &error);
+        if (info == NULL) {
+                data = g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE,
+                                                  NULL,
+                                                  0,
+                                                  1);
+                /* the pool recreates the error from its domain and
+                 * code */
+                reply = g_variant_new ("(bsis@ay)",
+                                       FALSE,
+                                       (error != NULL ?
+                                        g_quark_to_string (error->domain) :
+                                        ""),
+                                       (error != NULL ? error->code : 0),
+                                       (error != NULL ?
+                                        error->message :
+                                        "Unknown error"),
+                                       data);
+                g_clear_error (&error);
+
+                return g_variant_ref_sink (reply);
+        }
+
+        serialized = gupnp_dlna_information_serialize (info, NULL);
+        g_object_unref (info);
+        data = g_variant_new_from_bytes (G_VARIANT_TYPE_BYTESTRING,
+                                         serialized,
+                                         TRUE);
+        g_bytes_unref (serialized);
+        reply = g_variant_new ("(bsis@ay)", TRUE, "", 0, "", data);
+
+        return g_variant_ref_sink (reply);
+}
+
+int
+main (int    argc G_GNUC_UNUSED,
+      char **argv G_GNUC_UNUSED)
+{
+        GUPnPDLNAMetadataExtractor *extractor;
+        GVariant *request;
+        int reply_fd;
+
+        /* keep the reply channel away from anything the backend might
+         * print */
+        reply_fd = dup (STDOUT_FILENO);
+        if (reply_fd < 0 || dup2 (STDERR_FILENO, STDOUT_FILENO) < 0) {
+                g_warning ("Could not set up the reply channel: %s",
+                           g_strerror (errno));
+
+                return 1;
+        }
+
+        extractor = load_extractor ();
+        if (extractor == NULL)
+                return 1;
+
+        while ((request = read_request (STDIN_FILENO)) != NULL) {
+                GVariant *reply = extract (extractor, request);
+                gboolean written = write_reply (reply_fd, reply);
+
+                g_variant_unref (reply);
+                g_variant_unref (request);
+                if (!written)
+                        break;
+        }
+
+        g_object_unref (extractor);
+        close (reply_fd);
+
+        return 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib.h>
+#include <gmodule.h>
+#include "gupnp-dlna-process-metadata-extractor.h"
+
+/* Runs extraction of some other backend in separate helper
+ * processes, so a crash or a hang on a broken file takes down only
+ * the helper. */
+
+G_MODULE_EXPORT GUPnPDLNAMetadataExtractor *
+gupnp_dlna_get_default_extractor (void)
+{
+        GUPnPDLNAProcessPool *pool = gupnp_dlna_process_pool_get_default ();
+
+        return GUPNP_DLNA_METADATA_EXTRACTOR
+                        (gupnp_dlna_process_metadata_extractor_new (pool));
+}
+
+/* The pool's helpers and threads live until the process exits. */
+G_MODULE_EXPORT const gchar *
+g_module_check_init (GModule *module)
+{
+        g_module_make_resident (module);
+
+        return NULL;
+}
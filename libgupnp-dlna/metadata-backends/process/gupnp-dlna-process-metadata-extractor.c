@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "gupnp-dlna-process-metadata-extractor.h"
+
+struct _GUPnPDLNAProcessMetadataExtractor {
+        GUPnPDLNAMetadataExtractor parent;
+
+        GUPnPDLNAProcessPool *pool;
+};
+
+G_DEFINE_TYPE (GUPnPDLNAProcessMetadataExtractor,
+               gupnp_dlna_process_metadata_extractor,
+               GUPNP_TYPE_DLNA_METADATA_EXTRACTOR)
+
+/* Information without any streams, passed along with an error from an
+ * asynchronous extraction. */
+typedef GUPnPDLNAInformation GUPnPDLNAProcessEmptyInformation;
+typedef GUPnPDLNAInformationClass GUPnPDLNAProcessEmptyInformationClass;
+
+G_DEFINE_TYPE (GUPnPDLNAProcessEmptyInformation,
+               gupnp_dlna_process_empty_information,
+               GUPNP_TYPE_DLNA_INFORMATION)
+
+static gpointer
+empty_get_stream (GUPnPDLNAInformation *info G_GNUC_UNUSED)
+{
+        return NULL;
+}
+
+static void
+gupnp_dlna_process_empty_information_class_init
+                                  (GUPnPDLNAProcessEmptyInformationClass *klass)
+{
+        klass->get_audio_information = (gpointer) empty_get_stream;
+        klass->get_container_information = (gpointer) empty_get_stream;
+        klass->get_image_information = (gpointer) empty_get_stream;
+        klass->get_video_information = (gpointer) empty_get_stream;
+}
+
+static void
+gupnp_dlna_process_empty_information_init
+                                 (GUPnPDLNAProcessEmptyInformation *self
+                                  G_GNUC_UNUSED)
+{
+}
+
+typedef struct {
+        GUPnPDLNAMetadataExtractor *extractor;
+        GMainContext               *context;
+        gchar                      *uri;
+        guint                       timeout_in_ms;
+        GUPnPDLNAInformation       *info;
+        GError                     *error;
+} GUPnPDLNAProcessAsyncData;
+
+static void
+free_async_data (GUPnPDLNAProcessAsyncData *data)
+{
+        g_object_unref (data->extractor);
+        g_main_context_unref (data->context);
+        g_free (data->uri);
+        g_clear_object (&data->info);
+        g_clear_error (&data->error);
+        g_slice_free (GUPnPDLNAProcessAsyncData, data);
+}
+
+static GUPnPDLNAInformation *
+extract (GUPnPDLNAProcessPool  *pool,
+         const gchar           *uri,
+         guint                  timeout_in_ms,
+         GError               **error)
+{
+        gint64 start = g_get_monotonic_time ();
+        gint64 wrapping_start;
+        GBytes *serialized = gupnp_dlna_process_pool_extract (pool,
+                                                              uri,
+                                                              timeout_in_ms,
+                                                              error);
+        GUPnPDLNAInformation *info;
+
+        if (serialized == NULL)
+                return NULL;
+
+        wrapping_start = g_get_monotonic_time ();
+        info = gupnp_dlna_information_deserialize (serialized, NULL, error);
+        g_bytes_unref (serialized);
+        if (info == NULL)
+                return NULL;
+
+        /* the helper's discoverer creation and preroll are both
+         * accounted as preroll here */
+        gupnp_dlna_information_set_phase_time (info,
+                                               GUPNP_DLNA_GUESS_PHASE_PREROLL,
+                                               wrapping_start - start);
+        gupnp_dlna_information_set_phase_time
+                                   (info,
+                                    GUPNP_DLNA_GUESS_PHASE_INFORMATION_WRAPPING,
+                                    g_get_monotonic_time () - wrapping_start);
+
+        return info;
+}
+
+static gboolean
+emit_done (GUPnPDLNAProcessAsyncData *data)
+{
+        gupnp_dlna_metadata_extractor_emit_done (data->extractor,
+                                                 data->info,
+                                                 data->error);
+
+        return G_SOURCE_REMOVE;
+}
+
+static void
+extract_in_thread (gpointer job,
+                   gpointer user_data G_GNUC_UNUSED)
+{
+        GUPnPDLNAProcessAsyncData *data = job;
+        GUPnPDLNAProcessMetadataExtractor *self =
+                       GUPNP_DLNA_PROCESS_METADATA_EXTRACTOR (data->extractor);
+
+        data->info = extract (self->pool,
+                              data->uri,
+                              data->timeout_in_ms,
+                              &data->error);
+        if (data->info == NULL) {
+                GType type = gupnp_dlna_process_empty_information_get_type ();
+
+                data->info = g_object_new (type, "uri", data->uri, NULL);
+        }
+        g_main_context_invoke_full (data->context,
+                                    G_PRIORITY_DEFAULT,
+                                    (GSourceFunc) emit_done,
+                                    data,
+                                    (GDestroyNotify) free_async_data);
+}
+
+static gboolean
+backend_extract_async (GUPnPDLNAMetadataExtractor  *extractor,
+                       const gchar                 *uri,
+                       guint                        timeout_in_ms,
+                       GError                     **error G_GNUC_UNUSED)
+{
+        GUPnPDLNAProcessMetadataExtractor *self =
+                             GUPNP_DLNA_PROCESS_METADATA_EXTRACTOR (extractor);
+        GUPnPDLNAProcessAsyncData *data = g_slice_new0
+                                        (GUPnPDLNAProcessAsyncData);
+
+        data->extractor = g_object_ref (extractor);
+        data->context = g_main_context_ref_thread_default ();
+        data->uri = g_strdup (uri);
+        data->timeout_in_ms = timeout_in_ms;
+        gupnp_dlna_process_pool_push (self->pool, extract_in_thread, data);
+
+        return TRUE;
+}
+
+static GUPnPDLNAInformation *
+backend_extract_sync (GUPnPDLNAMetadataExtractor  *extractor,
+                      const gchar                 *uri,
+                      guint                        timeout_in_ms,
+                      GError                     **error)
+{
+        GUPnPDLNAProcessMetadataExtractor *self =
+                             GUPNP_DLNA_PROCESS_METADATA_EXTRACTOR (extractor);
+
+        return extract (self->pool, uri, timeout_in_ms, error);
+}
+
+static void
+gupnp_dlna_process_metadata_extractor_class_init
+               (GUPnPDLNAProcessMetadataExtractorClass *process_extractor_class)
+{
+        GUPnPDLNAMetadataExtractorClass *extractor_class =
+                  GUPNP_DLNA_METADATA_EXTRACTOR_CLASS (process_extractor_class);
+
+        extractor_class->extract_async = backend_extract_async;
+        extractor_class->extract_sync = backend_extract_sync;
+}
+
+static void
+gupnp_dlna_process_metadata_extractor_init
+                                (GUPnPDLNAProcessMetadataExtractor *self
+                                 G_GNUC_UNUSED)
+{
+}
+
+/* The pool is not owned by the extractor - it is shared by all of
+ * them and outlives them. */
+GUPnPDLNAProcessMetadataExtractor *
+gupnp_dlna_process_metadata_extractor_new (GUPnPDLNAProcessPool *pool)
+{
+        GUPnPDLNAProcessMetadataExtractor *self;
+
+        g_return_val_if_fail (pool != NULL, NULL);
+
+        self = g_object_new (GUPNP_TYPE_DLNA_PROCESS_METADATA_EXTRACTOR, NULL);
+        self->pool = pool;
+
+        return self;
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GUPNP_DLNA_PROCESS_METADATA_EXTRACTOR_H__
+#define __GUPNP_DLNA_PROCESS_METADATA_EXTRACTOR_H__
+
+#include <glib-object.h>
+#include <libgupnp-dlna/metadata/gupnp-dlna-metadata-extractor.h>
+#include "gupnp-dlna-process-pool.h"
+
+G_BEGIN_DECLS
+
+#define GUPNP_TYPE_DLNA_PROCESS_METADATA_EXTRACTOR \
+        (gupnp_dlna_process_metadata_extractor_get_type())
+
+G_DECLARE_FINAL_TYPE (GUPnPDLNAProcessMetadataExtractor,
+                      gupnp_dlna_process_metadata_extractor,
+                      GUPNP_DLNA,
+                      PROCESS_METADATA_EXTRACTOR,
+                      GUPnPDLNAMetadataExtractor)
+
+GUPnPDLNAProcessMetadataExtractor *
+gupnp_dlna_process_metadata_extractor_new (GUPnPDLNAProcessPool *pool);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_PROCESS_METADATA_EXTRACTOR_H__ */
@@ -0,0 +1,547 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gio/gio.h>
+
+#include "gupnp-dlna-process-pool.h"
+#include "gupnp-dlna-process-protocol.h"
+
+/* A pool of long-lived extractor helper processes. Each request is
+ * served by an idle helper, and new helpers are spawned on demand
+ * up to the size of the pool. A helper that exits in the middle of a
+ * request, or does not answer within the discovery timeout plus a
+ * grace period, is killed and forgotten - a fresh one is spawned in
+ * its place by the next request. The request itself fails, so a
+ * single bad file costs only its own extraction.
+ */
+
+#define DEFAULT_WATCHDOG_GRACE_MS 5000
+
+typedef struct {
+        GSubprocess *process;
+        GSocket     *socket;
+} GUPnPDLNAProcessWorker;
+
+typedef struct {
+        GFunc    func;
+        gpointer data;
+} GUPnPDLNAProcessJob;
+
+struct _GUPnPDLNAProcessPool {
+        gchar       *helper_path;
+        guint        size;
+        guint        watchdog_grace_ms;
+        GThreadPool *jobs;
+        /* guards everything below */
+        GMutex       lock;
+        GCond        cond;
+        GQueue       idle;
+        guint        spawned;
+        guint        restarts;
+};
+
+static GUPnPDLNAProcessWorker *
+spawn_worker (GUPnPDLNAProcessPool  *pool,
+              GError               **error)
+{
+        GUPnPDLNAProcessWorker *worker;
+        GSubprocessLauncher *launcher;
+        GSubprocess *process;
+        GSocket *socket;
+        int fds[2];
+
+        if (socketpair (AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+                int saved_errno = errno;
+
+                g_set_error (error,
+                             G_IO_ERROR,
+                             g_io_error_from_errno (saved_errno),
+                             "Failed to create a socket pair: %s",
+                             g_strerror (saved_errno));
+
+                return NULL;
+        }
+        /* our end must not leak into other children */
+        fcntl (fds[0], F_SETFD, FD_CLOEXEC);
+
+        launcher = g_subprocess_launcher_new (G_SUBPROCESS_FLAGS_NONE);
+        g_subprocess_launcher_take_stdin_fd (launcher, fds[1]);
+        g_subprocess_launcher_take_stdout_fd (launcher, dup (fds[1]));
+        process = g_subprocess_launcher_spawn (launcher,
+                                               error,
+                                               pool->helper_path,
+                                               NULL);
+        /* closes the helper's end in this process */
+        g_object_unref (launcher);
+        if (process == NULL) {
+                close (fds[0]);
+
+                return NULL;
+        }
+
+        socket = g_socket_new_from_fd (fds[0], error);
+        if (socket == NULL) {
+                close (fds[0]);
+                g_subprocess_force_exit (process);
+                g_subprocess_wait (process, NULL, NULL);
+                g_object_unref (process);
+
+                return NULL;
+        }
+
+        worker = g_slice_new (GUPnPDLNAProcessWorker);
+        worker->process = process;
+        worker->socket = socket;
+
+        return worker;
+}
+
+static void
+kill_worker (GUPnPDLNAProcessWorker *worker)
+{
+        g_subprocess_force_exit (worker->process);
+        g_subprocess_wait (worker->process, NULL, NULL);
+        g_socket_close (worker->socket, NULL);
+        g_object_unref (worker->socket);
+        g_object_unref (worker->process);
+        g_slice_free (GUPnPDLNAProcessWorker, worker);
+}
+
+static GUPnPDLNAProcessWorker *
+acquire_worker (GUPnPDLNAProcessPool  *pool,
+                GError               **error)
+{
+        GUPnPDLNAProcessWorker *worker;
+
+        g_mutex_lock (&pool->lock);
+        while (g_queue_is_empty (&pool->idle) && pool->spawned >= pool->size)
+                g_cond_wait (&pool->cond, &pool->lock);
+        worker = g_queue_pop_head (&pool->idle);
+        if (worker == NULL)
+                ++pool->spawned;
+        g_mutex_unlock (&pool->lock);
+
+        if (worker == NULL) {
+                worker = spawn_worker (pool, error);
+                if (worker == NULL) {
+                        g_mutex_lock (&pool->lock);
+                        --pool->spawned;
+                        g_cond_signal (&pool->cond);
+                        g_mutex_unlock (&pool->lock);
+                }
+        }
+
+        return worker;
+}
+
+/* A broken worker is killed, so its slot can be taken by a new
+ * one. */
+static void
+release_worker (GUPnPDLNAProcessPool   *pool,
+                GUPnPDLNAProcessWorker *worker,
+                gboolean                broken)
+{
+        if (broken)
+                kill_worker (worker);
+
+        g_mutex_lock (&pool->lock);
+        if (broken) {
+                --pool->spawned;
+                ++pool->restarts;
+        } else {
+                g_queue_push_head (&pool->idle, worker);
+        }
+        g_cond_signal (&pool->cond);
+        g_mutex_unlock (&pool->lock);
+}
+
+static gboolean
+send_all (GSocket       *socket,
+          const guint8  *data,
+          gsize          size,
+          GError       **error)
+{
+        while (size > 0) {
+                gssize sent = g_socket_send (socket,
+                                             (const gchar *) data,
+                                             size,
+                                             NULL,
+                                             error);
+
+                if (sent < 0)
+                        return FALSE;
+                data += sent;
+                size -= sent;
+        }
+
+        return TRUE;
+}
+
+static gboolean
+receive_all (GSocket  *socket,
+             guint8   *data,
+             gsize     size,
+             gint64    deadline,
+             GError  **error)
+{
+        while (size > 0) {
+                gint64 remaining = deadline - g_get_monotonic_time ();
+                gssize received;
+
+                if (remaining <= 0 ||
+                    !g_socket_condition_timed_wait (socket,
+                                                    G_IO_IN,
+                                                    remaining,
+                                                    NULL,
+                                                    NULL)) {
+                        g_set_error_literal (error,
+                                             G_IO_ERROR,
+                                             G_IO_ERROR_TIMED_OUT,
+                                             "Extractor helper did not "
+                                             "answer in time");
+
+                        return FALSE;
+                }
+                received = g_socket_receive (socket,
+                                             (gchar *) data,
+                                             size,
+                                             NULL,
+                                             error);
+                if (received < 0)
+                        return FALSE;
+                if (received == 0) {
+                        g_set_error_literal (error,
+                                             G_IO_ERROR,
+                                             G_IO_ERROR_CONNECTION_CLOSED,
+                                             "Extractor helper exited "
+                                             "unexpectedly");
+
+                        return FALSE;
+                }
+                data += received;
+                size -= received;
+        }
+
+        return TRUE;
+}
+
+static gboolean
+send_request (GUPnPDLNAProcessWorker  *worker,
+              GBytes                  *request,
+              GError                 **error)
+{
+        guint32 size = GUINT32_TO_BE (g_bytes_get_size (request));
+
+        return (send_all (worker->socket,
+                          (const guint8 *) &size,
+                          GUPNP_DLNA_PROCESS_HEADER_SIZE,
+                          error) &&
+                send_all (worker->socket,
+                          g_bytes_get_data (request, NULL),
+                          g_bytes_get_size (request),
+                          error));
+}
+
+static GBytes *
+receive_reply (GUPnPDLNAProcessWorker  *worker,
+               gint64                   deadline,
+               GError                 **error)
+{
+        guint32 size;
+        guint8 *data;
+
+        if (!receive_all (worker->socket,
+                          (guint8 *) &size,
+                          GUPNP_DLNA_PROCESS_HEADER_SIZE,
+                          deadline,
+                          error))
+                return NULL;
+        size = GUINT32_FROM_BE (size);
+        if (size > GUPNP_DLNA_PROCESS_MAX_FRAME_SIZE) {
+                g_set_error (error,
+                             G_IO_ERROR,
+                             G_IO_ERROR_INVALID_DATA,
+                             "Extractor helper sent too big reply (%u "
+                             "bytes)",
+                             size);
+
+                return NULL;
+        }
+
+        data = g_malloc (size);
+        if (!receive_all (worker->socket, data, size, deadline, error)) {
+                g_free (data);
+
+                return NULL;
+        }
+
+        return g_bytes_new_take (data, size);
+}
+
+static GBytes *
+parse_reply (GBytes  *reply,
+             GError **error)
+{
+        const GVariantType *type = G_VARIANT_TYPE
+                                        (GUPNP_DLNA_PROCESS_REPLY_TYPE);
+        GVariant *variant = g_variant_new_from_bytes (type, reply, FALSE);
+        GBytes *serialized = NULL;
+        gboolean ok;
+        const gchar *domain;
+        gint code;
+        const gchar *message;
+        GVariant *data;
+
+        g_variant_ref_sink (variant);
+        g_variant_get (variant,
+                       "(b&si&s@ay)",
+                       &ok,
+                       &domain,
+                       &code,
+                       &message,
+                       &data);
+        if (ok)
+                serialized = g_variant_get_data_as_bytes (data);
+        else if (domain[0] != '\0')
+                g_set_error_literal (error,
+                                     g_quark_from_string (domain),
+                                     code,
+                                     message);
+        else
+                g_set_error_literal (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_FAILED,
+                                     message);
+        g_variant_unref (data);
+        g_variant_unref (variant);
+
+        return serialized;
+}
+
+static void
+run_job (gpointer data,
+         gpointer user_data G_GNUC_UNUSED)
+{
+        GUPnPDLNAProcessJob *job = data;
+
+        job->func (job->data, NULL);
+        g_slice_free (GUPnPDLNAProcessJob, job);
+}
+
+/* @size of 0 means one helper per processor. */
+GUPnPDLNAProcessPool *
+gupnp_dlna_process_pool_new (const gchar *helper_path,
+                             guint        size,
+                             guint        watchdog_grace_ms)
+{
+        GUPnPDLNAProcessPool *pool;
+
+        g_return_val_if_fail (helper_path != NULL, NULL);
+
+        pool = g_slice_new0 (GUPnPDLNAProcessPool);
+        pool->helper_path = g_strdup (helper_path);
+        pool->size = (size > 0 ? size : g_get_num_processors ());
+        pool->watchdog_grace_ms = watchdog_grace_ms;
+        pool->jobs = g_thread_pool_new (run_job,
+                                        NULL,
+                                        pool->size,
+                                        FALSE,
+                                        NULL);
+        g_mutex_init (&pool->lock);
+        g_cond_init (&pool->cond);
+        g_queue_init (&pool->idle);
+
+        return pool;
+}
+
+static guint
+get_env_uint (const gchar *name,
+              guint        fallback)
+{
+        const gchar *value = g_getenv (name);
+        guint64 number;
+
+        if (value == NULL ||
+            !g_ascii_string_to_unsigned (value,
+                                         10,
+                                         0,
+                                         G_MAXUINT,
+                                         &number,
+                                         NULL))
+                return fallback;
+
+        return number;
+}
+
+/* The pool shared by all extractors of this backend. It is
+ * configured with GUPNP_DLNA_PROCESS_HELPER (path of the helper
+ * executable), GUPNP_DLNA_PROCESS_WORKERS (number of helpers) and
+ * GUPNP_DLNA_PROCESS_WATCHDOG_GRACE_MS (time given to helpers on top
+ * of the discovery timeout) environment variables. */
+GUPnPDLNAProcessPool *
+gupnp_dlna_process_pool_get_default (void)
+{
+        static GUPnPDLNAProcessPool *pool = NULL;
+
+        if (g_once_init_enter (&pool)) {
+                const gchar *helper_path = g_getenv
+                                                 ("GUPNP_DLNA_PROCESS_HELPER");
+
+                if (helper_path == NULL)
+                        helper_path = GUPNP_DLNA_EXTRACTOR_HELPER;
+                g_once_init_leave
+                        (&pool,
+                         gupnp_dlna_process_pool_new
+                                 (helper_path,
+                                  get_env_uint ("GUPNP_DLNA_PROCESS_WORKERS",
+                                                0),
+                                  get_env_uint
+                                        ("GUPNP_DLNA_PROCESS_WATCHDOG_GRACE_MS",
+                                         DEFAULT_WATCHDOG_GRACE_MS)));
+        }
+
+        return pool;
+}
+
+void
+gupnp_dlna_process_pool_free (GUPnPDLNAProcessPool *pool)
+{
+        GUPnPDLNAProcessWorker *worker;
+
+        g_return_if_fail (pool != NULL);
+
+        g_thread_pool_free (pool->jobs, FALSE, TRUE);
+        while ((worker = g_queue_pop_head (&pool->idle)) != NULL)
+                kill_worker (worker);
+        g_cond_clear (&pool->cond);
+        g_mutex_clear (&pool->lock);
+        g_free (pool->helper_path);
+        g_slice_free (GUPnPDLNAProcessPool, pool);
+}
+
+/* Extracts information about @uri in one of the helpers. Returns the
+ * information serialized with gupnp_dlna_information_serialize(). */
+GBytes *
+gupnp_dlna_process_pool_extract (GUPnPDLNAProcessPool  *pool,
+                                 const gchar           *uri,
+                                 guint                  timeout_in_ms,
+                                 GError               **error)
+{
+        GVariant *request_variant;
+        GBytes *request;
+        GBytes *reply = NULL;
+        GBytes *serialized = NULL;
+        GUPnPDLNAProcessWorker *worker = NULL;
+        GError *worker_error = NULL;
+        gint64 deadline;
+        guint attempt;
+
+        g_return_val_if_fail (pool != NULL, NULL);
+        g_return_val_if_fail (uri != NULL, NULL);
+
+        request_variant = g_variant_new (GUPNP_DLNA_PROCESS_REQUEST_TYPE,
+                                         timeout_in_ms,
+                                         uri);
+        g_variant_ref_sink (request_variant);
+        request = g_variant_get_data_as_bytes (request_variant);
+        g_variant_unref (request_variant);
+
+        /* an idle helper might have died since its last request, in
+         * such case the request is retried once with a new one */
+        for (attempt = 0; attempt < 2 && worker == NULL; ++attempt) {
+                g_clear_error (&worker_error);
+                worker = acquire_worker (pool, &worker_error);
+                if (worker == NULL)
+                        break;
+                if (!send_request (worker, request, &worker_error)) {
+                        release_worker (pool, worker, TRUE);
+                        worker = NULL;
+                }
+        }
+        g_bytes_unref (request);
+
+        if (worker != NULL) {
+                deadline = g_get_monotonic_time () +
+                           (gint64) (timeout_in_ms +
+                                     pool->watchdog_grace_ms) * 1000;
+                reply = receive_reply (worker, deadline, &worker_error);
+                release_worker (pool, worker, reply == NULL);
+        }
+
+        if (reply != NULL) {
+                serialized = parse_reply (reply, error);
+                g_bytes_unref (reply);
+        } else {
+                g_set_error (error,
+                             worker_error->domain,
+                             worker_error->code,
+                             "Failed to extract metadata of '%s': %s",
+                             uri,
+                             worker_error->message);
+        }
+        g_clear_error (&worker_error);
+
+        return serialized;
+}
+
+/* Runs @func with @data in one of the threads of the pool. There are
+ * as many threads as helpers. */
+void
+gupnp_dlna_process_pool_push (GUPnPDLNAProcessPool *pool,
+                              GFunc                 func,
+                              gpointer              data)
+{
+        GUPnPDLNAProcessJob *job;
+
+        g_return_if_fail (pool != NULL);
+        g_return_if_fail (func != NULL);
+
+        job = g_slice_new (GUPnPDLNAProcessJob);
+        job->func = func;
+        job->data = data;
+        g_thread_pool_push (pool->jobs, job, NULL);
+}
+
+/* Number of helpers killed because they crashed or hung. */
+guint
+gupnp_dlna_process_pool_get_restarts (GUPnPDLNAProcessPool *pool)
+{
+        guint restarts;
+
+        g_return_val_if_fail (pool != NULL, 0);
+
+        g_mutex_lock (&pool->lock);
+        restarts = pool->restarts;
+        g_mutex_unlock (&pool->lock);
+
+        return restarts;
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GUPNP_DLNA_PROCESS_POOL_H__
+#define __GUPNP_DLNA_PROCESS_POOL_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GUPnPDLNAProcessPool GUPnPDLNAProcessPool;
+
+GUPnPDLNAProcessPool *
+gupnp_dlna_process_pool_new (const gchar *helper_path,
+                             guint        size,
+                             guint        watchdog_grace_ms);
+
+GUPnPDLNAProcessPool *
+gupnp_dlna_process_pool_get_default (void);
+
+void
+gupnp_dlna_process_pool_free (GUPnPDLNAProcessPool *pool);
+
+GBytes *
+gupnp_dlna_process_pool_extract (GUPnPDLNAProcessPool  *pool,
+                                 const gchar           *uri,
+                                 guint                  timeout_in_ms,
+                                 GError               **error);
+
+void
+gupnp_dlna_process_pool_push (GUPnPDLNAProcessPool *pool,
+                              GFunc                 func,
+                              gpointer              data);
+
+guint
+gupnp_dlna_process_pool_get_restarts (GUPnPDLNAProcessPool *pool);
+
+G_END_DECLS
+
+#endif /* __GUPNP_DLNA_PROCESS_POOL_H__ */
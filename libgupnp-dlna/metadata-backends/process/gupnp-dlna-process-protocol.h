@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GUPNP_DLNA_PROCESS_PROTOCOL_H__
+#define __GUPNP_DLNA_PROCESS_PROTOCOL_H__
+
+/* Protocol spoken between the process pool and its extractor
+ * helpers over a Unix socket connected to the helper's stdin and
+ * stdout.
+ *
+ * Every message is a frame - a 32-bit big endian payload size
+ * followed by the payload, which is a serialized GVariant. The pool
+ * sends a request holding the discovery timeout and the URI, the
+ * helper answers with a reply holding either the information
+ * serialized with gupnp_dlna_information_serialize() or an error -
+ * its domain as a quark string, its code and its message. A helper
+ * serves requests one by one until its stdin is closed.
+ */
+
+#define GUPNP_DLNA_PROCESS_REQUEST_TYPE "(us)"
+#define GUPNP_DLNA_PROCESS_REPLY_TYPE "(bsisay)"
+
+/* Size of a frame header. */
+#define GUPNP_DLNA_PROCESS_HEADER_SIZE 4
+
+/* Frames bigger than this are treated as garbage. */
+#define GUPNP_DLNA_PROCESS_MAX_FRAME_SIZE (16 * 1024 * 1024)
+
+#endif /* __GUPNP_DLNA_PROCESS_PROTOCOL_H__ */
@@ -50,6 +50,11 @@
  * <filename>libgstreamer.so</filename> will be loaded. For determining a
  * plugin filename g_module_build_path() is used.
  *
+ * Extractors which learn about the media gradually can report partial
+ * information with gupnp_dlna_metadata_extractor_emit_progress(),
+ * which lets #GUPnPDLNAProfileGuesser stop the extraction as soon as
+ * its result is known.
+ *
  * If subclassing #GUPnPDLNAMetadataExtractor then also
  * #GUPnPDLNAInformation, #GUPnPDLNAAudioInformation,
  * #GUPnPDLNAContainerInformation, #GUPnPDLNAImageInformation and
@@ -60,6 +65,7 @@
 
 enum {
         DONE,
+        PROGRESS,
         SIGNAL_LAST
 };
 
@@ -105,6 +111,31 @@ gupnp_dlna_metadata_extractor_class_init
                               2,
                               GUPNP_TYPE_DLNA_INFORMATION,
                               G_TYPE_ERROR);
+
+        /**
+         * GUPnPDLNAMetadataExtractor::progress:
+         * @extractor: The #GUPnPDLNAMetadataExtractor.
+         * @info: (transfer none): Information discovered so far.
+         *
+         * Will be emitted when more information about a URI was
+         * discovered, possibly from a thread of the backend. The
+         * container, if any, is reported before any stream, and
+         * streams already in @info do not change anymore - later
+         * emissions can only add streams.
+         *
+         * Returns: %TRUE to stop the extraction, %FALSE to go on.
+         */
+        signals[PROGRESS] =
+                g_signal_new ("progress",
+                              G_TYPE_FROM_CLASS (extractor_class),
+                              G_SIGNAL_RUN_LAST,
+                              0,
+                              g_signal_accumulator_true_handled,
+                              NULL,
+                              g_cclosure_marshal_generic,
+                              G_TYPE_BOOLEAN,
+                              1,
+                              GUPNP_TYPE_DLNA_INFORMATION);
 }
 
 static void
@@ -210,3 +241,32 @@ gupnp_dlna_metadata_extractor_emit_done (GUPnPDLNAMetadataExtractor *extractor,
 
         g_signal_emit (extractor, signals[DONE], 0, info, error);
 }
+
+/**
+ * gupnp_dlna_metadata_extractor_emit_progress:
+ * @extractor: A #GUPnPDLNAMetadataExtractor object.
+ * @info: (transfer none): A #GUPnPDLNAInformation about the part of
+ * the URI discovered so far.
+ *
+ * Emits ::progress signal. This function is intended to be used by
+ * subclasses of #GUPnPDLNAMetadataExtractor. When it returns %TRUE,
+ * the subclass should stop the extraction and finish it as usual,
+ * with the information it has so far and without an error.
+ *
+ * Returns: %TRUE if the extraction should stop, %FALSE otherwise.
+ */
+gboolean
+gupnp_dlna_metadata_extractor_emit_progress
+                                       (GUPnPDLNAMetadataExtractor *extractor,
+                                        GUPnPDLNAInformation       *info)
+{
+        gboolean stop = FALSE;
+
+        g_return_val_if_fail (GUPNP_DLNA_IS_METADATA_EXTRACTOR (extractor),
+                              FALSE);
+        g_return_val_if_fail (GUPNP_DLNA_IS_INFORMATION (info), FALSE);
+
+        g_signal_emit (extractor, signals[PROGRESS], 0, info, &stop);
+
+        return stop;
+}
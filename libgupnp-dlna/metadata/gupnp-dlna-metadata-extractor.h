@@ -97,6 +97,11 @@ gupnp_dlna_metadata_extractor_emit_done (GUPnPDLNAMetadataExtractor *extractor,
                                          GUPnPDLNAInformation       *info,
                                          GError                     *error);
 
+gboolean
+gupnp_dlna_metadata_extractor_emit_progress
+                                       (GUPnPDLNAMetadataExtractor *extractor,
+                                        GUPnPDLNAInformation       *info);
+
 G_END_DECLS
 
 #endif /* __GUPNP_DLNA_METADATA_EXTRACTOR_H__ */
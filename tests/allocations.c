@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <glib.h>
+
+#include "gupnp-dlna-audio-information.h"
+#include "gupnp-dlna-profile-private.h"
+#include "gupnp-dlna-profile-guesser-impl.h"
+#include "gupnp-dlna-restriction-private.h"
+#include "gupnp-dlna-value-list-private.h"
+#include "test-allocation-counter.h"
+#include "test-information.h"
+
+/* Upper bound of heap allocations done by a single guess - mostly
+ * the scratch arena. */
+#define MAX_GUESS_ALLOCATIONS 16
+
+static GList *
+restriction_list (const gchar *mime,
+                  const gchar *name,
+                  const gchar *raw)
+{
+        GUPnPDLNARestriction *restriction = gupnp_dlna_restriction_new (mime);
+
+        if (name != NULL) {
+                GUPnPDLNAValueList *list = gupnp_dlna_value_list_new
+                                        (gupnp_dlna_value_type_int ());
+
+                g_assert (gupnp_dlna_value_list_add_single (list, raw));
+                g_assert (gupnp_dlna_restriction_add_value_list (restriction,
+                                                                 name,
+                                                                 list));
+        }
+
+        return g_list_prepend (NULL, restriction);
+}
+
+static GUPnPDLNAProfile *
+audio_profile (const gchar *name,
+               const gchar *rate)
+{
+        return gupnp_dlna_profile_new
+                                (name,
+                                 "audio/mpeg",
+                                 restriction_list ("audio/mpeg", "rate", rate),
+                                 restriction_list ("application/ogg",
+                                                   NULL,
+                                                   NULL),
+                                 NULL,
+                                 NULL,
+                                 FALSE);
+}
+
+/* Builds @count profiles rejecting the stream with the matching one
+ * at the very end, so all of them are tried. */
+static GList *
+audio_profiles (guint count)
+{
+        GList *profiles = g_list_prepend (NULL, audio_profile ("MATCH",
+                                                               "44100"));
+        guint iter;
+
+        for (iter = 0; iter < count; ++iter) {
+                gchar *name = g_strdup_printf ("NO_MATCH_%u", iter);
+
+                profiles = g_list_prepend (profiles,
+                                           audio_profile (name, "8000"));
+                g_free (name);
+        }
+
+        return profiles;
+}
+
+static TestInformation *
+audio_information (void)
+{
+        TestInformation *info = test_information_new ("file:///test.ogg");
+
+        test_information_set_string (info,
+                                     TEST_STREAM_AUDIO,
+                                     "mime",
+                                     "audio/mpeg");
+        test_information_set_int (info, TEST_STREAM_AUDIO, "rate", 44100);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "channels", 2);
+        test_information_set_string (info,
+                                     TEST_STREAM_CONTAINER,
+                                     "mime",
+                                     "application/ogg");
+
+        return info;
+}
+
+#ifdef TEST_COUNT_ALLOCATIONS
+static guint
+count_guess_allocations (GUPnPDLNAInformation *info,
+                         GList                *profiles)
+{
+        GUPnPDLNAGuessCounts counts = { 0, 0, FALSE, 0, 0 };
+        GUPnPDLNAProfile *profile;
+        guint count;
+
+        test_allocation_counter_start ();
+        profile = gupnp_dlna_profile_guesser_impl_guess_audio_profile
+                                        (info,
+                                         profiles,
+                                         NULL,
+                                         &counts);
+        count = test_allocation_counter_stop ();
+
+        g_assert (profile != NULL);
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (profile), ==, "MATCH");
+        g_assert_cmpuint (counts.profiles, ==, g_list_length (profiles));
+
+        return count;
+}
+#endif
+
+static void
+guess_allocations_constant (void)
+{
+#ifdef TEST_COUNT_ALLOCATIONS
+        GUPnPDLNAInformation *info =
+                                GUPNP_DLNA_INFORMATION (audio_information ());
+        GList *few = audio_profiles (10);
+        GList *many = audio_profiles (1000);
+        guint few_count;
+        guint many_count;
+
+        /* warm up type classes, lazily created stream information
+         * objects and GLib internal caches */
+        count_guess_allocations (info, few);
+
+        few_count = count_guess_allocations (info, few);
+        many_count = count_guess_allocations (info, many);
+
+        g_assert_cmpuint (few_count, ==, many_count);
+        g_assert_cmpuint (many_count, <=, MAX_GUESS_ALLOCATIONS);
+
+        g_list_free_full (few, g_object_unref);
+        g_list_free_full (many, g_object_unref);
+        g_object_unref (info);
+#else
+        g_test_skip ("Counting allocations is not supported here.");
+#endif
+}
+
+static void
+peek_string_borrowed (void)
+{
+        TestInformation *test_info = audio_information ();
+        GUPnPDLNAAudioInformation *audio_info =
+                                gupnp_dlna_information_get_audio_information
+                                        (GUPNP_DLNA_INFORMATION (test_info));
+        GUPnPDLNAConstStringValue first;
+        GUPnPDLNAConstStringValue second;
+        GUPnPDLNAStringValue owned;
+
+        first = gupnp_dlna_audio_information_peek_mime (audio_info);
+        g_assert_cmpint (first.state, ==, GUPNP_DLNA_VALUE_STATE_SET);
+        g_assert_cmpstr (first.value, ==, "audio/mpeg");
+
+#ifdef TEST_COUNT_ALLOCATIONS
+        test_allocation_counter_start ();
+        second = gupnp_dlna_audio_information_peek_mime (audio_info);
+        g_assert_cmpuint (test_allocation_counter_stop (), ==, 0);
+#else
+        second = gupnp_dlna_audio_information_peek_mime (audio_info);
+#endif
+        g_assert (first.value == second.value);
+
+        owned = gupnp_dlna_audio_information_get_mime (audio_info);
+        g_assert_cmpstr (owned.value, ==, first.value);
+        g_assert (owned.value != first.value);
+        g_free (owned.value);
+
+        first = gupnp_dlna_audio_information_peek_level (audio_info);
+        g_assert_cmpint (first.state, ==, GUPNP_DLNA_VALUE_STATE_UNSET);
+        g_assert (first.value == NULL);
+
+        g_object_unref (test_info);
+}
+
+int
+main (int argc, char **argv)
+{
+        /* debug messages would cost allocations */
+        g_unsetenv ("G_MESSAGES_DEBUG");
+        g_test_init (&argc, &argv, NULL);
+
+        g_test_add_func ("/guess/allocations-constant",
+                         guess_allocations_constant);
+        g_test_add_func ("/information/peek-string", peek_string_borrowed);
+
+        g_test_run ();
+
+        return 0;
+}
@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Benchmarks guessing profiles from synthetic information objects,
+ * so the matcher can be measured without any metadata backend.
+ *
+ * For every loaded profile three samples are generated from its own
+ * restrictions: one that should match it, a near miss with one field
+ * out of range and one with unknown MIME types.
+ */
+
+#include <glib.h>
+
+#include "gupnp-dlna-g-values.h"
+#include "gupnp-dlna-profile-guesser.h"
+#include "test-allocation-counter.h"
+#include "test-information.h"
+
+typedef enum {
+        SAMPLE_MATCH,
+        SAMPLE_NEAR_MISS,
+        SAMPLE_NO_MATCH,
+        SAMPLE_KIND_COUNT
+} SampleKind;
+
+static const gchar *sample_kind_names[SAMPLE_KIND_COUNT] = {
+        "match",
+        "near-miss",
+        "no-match"
+};
+
+static gdouble seconds = 1.0;
+static gboolean relaxed = FALSE;
+static gboolean extended = FALSE;
+
+static GOptionEntry entries[] = {
+        { "seconds", 's', 0, G_OPTION_ARG_DOUBLE, &seconds,
+          "Minimal time to spend on each kind of samples", "SECONDS" },
+        { "relaxed", 'r', 0, G_OPTION_ARG_NONE, &relaxed,
+          "Use relaxed mode profiles", NULL },
+        { "extended", 'e', 0, G_OPTION_ARG_NONE, &extended,
+          "Use extended mode profiles", NULL },
+        { NULL }
+};
+
+static void
+set_field (TestInformation *info,
+           TestStream       stream,
+           const gchar     *name,
+           GValue          *value,
+           gboolean         miss)
+{
+        GType type = G_VALUE_TYPE (value);
+        GUPnPDLNAFraction *fraction = NULL;
+
+        if (type == G_TYPE_BOOLEAN) {
+                gboolean bool_value = g_value_get_boolean (value);
+
+                test_information_set_bool (info,
+                                           stream,
+                                           name,
+                                           miss ? !bool_value : bool_value);
+        } else if (type == G_TYPE_INT) {
+                test_information_set_int (info,
+                                          stream,
+                                          name,
+                                          miss ? -1 : g_value_get_int (value));
+        } else if (type == G_TYPE_STRING) {
+                test_information_set_string (info,
+                                             stream,
+                                             name,
+                                             miss ?
+                                             "near-miss" :
+                                             g_value_get_string (value));
+        } else if (type == GUPNP_TYPE_DLNA_INT_RANGE) {
+                GUPnPDLNAIntRange *range = g_value_get_boxed (value);
+
+                test_information_set_int
+                                  (info,
+                                   stream,
+                                   name,
+                                   miss ?
+                                   -1 :
+                                   gupnp_dlna_int_range_get_min (range));
+        } else if (type == GUPNP_TYPE_DLNA_FRACTION) {
+                fraction = g_value_get_boxed (value);
+        } else if (type == GUPNP_TYPE_DLNA_FRACTION_RANGE) {
+                fraction = gupnp_dlna_fraction_range_get_min
+                                        (g_value_get_boxed (value));
+        }
+
+        if (fraction != NULL) {
+                gint numerator = gupnp_dlna_fraction_get_numerator (fraction);
+                gint denominator =
+                               gupnp_dlna_fraction_get_denominator (fraction);
+
+                test_information_set_fraction (info,
+                                               stream,
+                                               name,
+                                               miss ? -1 : numerator,
+                                               miss ? 1 : denominator);
+        }
+}
+
+/* Fills @stream with the first value of every entry in the first
+ * restriction in @restrictions. A near miss gets the first entry out
+ * of the restriction, or the MIME type if there are no entries. */
+static void
+set_stream (TestInformation *info,
+            TestStream       stream,
+            GList           *restrictions,
+            SampleKind       kind)
+{
+        GUPnPDLNARestriction *restriction;
+        GHashTableIter iter;
+        gpointer name;
+        gpointer list;
+        guint index = 0;
+
+        if (restrictions == NULL)
+                return;
+
+        restriction = restrictions->data;
+        test_information_set_string
+                           (info,
+                            stream,
+                            "mime",
+                            kind == SAMPLE_NO_MATCH ?
+                            "application/x-no-match" :
+                            gupnp_dlna_restriction_get_mime (restriction));
+
+        g_hash_table_iter_init (&iter,
+                                gupnp_dlna_restriction_get_entries
+                                        (restriction));
+        while (g_hash_table_iter_next (&iter, &name, &list)) {
+                GList *values = gupnp_dlna_value_list_get_g_values (list);
+
+                if (values != NULL)
+                        set_field (info,
+                                   stream,
+                                   name,
+                                   values->data,
+                                   kind == SAMPLE_NEAR_MISS && index == 0);
+                g_list_free_full (values, (GDestroyNotify) g_free);
+                ++index;
+        }
+
+        if (kind == SAMPLE_NEAR_MISS && index == 0)
+                test_information_set_string (info,
+                                             stream,
+                                             "mime",
+                                             "application/x-near-miss");
+}
+
+static GUPnPDLNAInformation *
+new_sample (GUPnPDLNAProfile *profile,
+            SampleKind        kind)
+{
+        TestInformation *info = test_information_new ("file:///sample");
+        GList *image = gupnp_dlna_profile_get_image_restrictions (profile);
+        GList *video = gupnp_dlna_profile_get_video_restrictions (profile);
+        GList *audio = gupnp_dlna_profile_get_audio_restrictions (profile);
+        GList *container =
+                       gupnp_dlna_profile_get_container_restrictions (profile);
+
+        /* the near miss goes to the most specific stream */
+        if (image != NULL) {
+                set_stream (info, TEST_STREAM_IMAGE, image, kind);
+        } else {
+                set_stream (info, TEST_STREAM_CONTAINER, container, kind);
+                if (video != NULL) {
+                        set_stream (info, TEST_STREAM_VIDEO, video, kind);
+                        set_stream (info,
+                                    TEST_STREAM_AUDIO,
+                                    audio,
+                                    kind == SAMPLE_NEAR_MISS ?
+                                    SAMPLE_MATCH :
+                                    kind);
+                } else {
+                        set_stream (info, TEST_STREAM_AUDIO, audio, kind);
+                }
+        }
+
+        return GUPNP_DLNA_INFORMATION (info);
+}
+
+static void
+run_samples (GUPnPDLNAProfileGuesser *guesser,
+             GPtrArray               *samples,
+             const gchar             *name)
+{
+        GTimer *timer = g_timer_new ();
+        guint64 guesses = 0;
+        guint64 evaluated = 0;
+        guint matched = 0;
+        guint allocations = 0;
+        guint64 comparisons = 0;
+        guint64 rejections = 0;
+        gdouble elapsed;
+        guint iter;
+
+        /* warm up lazily created stream information and caches, and
+         * count allocations of one pass */
+        for (iter = 0; iter < samples->len; ++iter)
+                gupnp_dlna_profile_guesser_guess_profile_from_info
+                                        (guesser,
+                                         g_ptr_array_index (samples, iter));
+        test_allocation_counter_start ();
+        for (iter = 0; iter < samples->len; ++iter) {
+                GUPnPDLNAInformation *info = g_ptr_array_index (samples, iter);
+                GUPnPDLNAProfile *profile =
+                        gupnp_dlna_profile_guesser_guess_profile_from_info
+                                        (guesser,
+                                         info);
+
+                if (profile != NULL)
+                        ++matched;
+                rejections += gupnp_dlna_information_get_profiles_evaluated
+                                        (info) - (profile != NULL ? 1 : 0);
+                comparisons += gupnp_dlna_information_get_rejection_comparisons
+                                        (info);
+        }
+        allocations = test_allocation_counter_stop ();
+
+        /* the time per profile counts only the profiles a guess
+         * actually evaluated */
+        g_timer_start (timer);
+        do {
+                for (iter = 0; iter < samples->len; ++iter) {
+                        GUPnPDLNAInformation *info = g_ptr_array_index
+                                        (samples,
+                                         iter);
+
+                        gupnp_dlna_profile_guesser_guess_profile_from_info
+                                        (guesser,
+                                         info);
+                        evaluated +=
+                             gupnp_dlna_information_get_profiles_evaluated
+                                        (info);
+                }
+                guesses += samples->len;
+                elapsed = g_timer_elapsed (timer, NULL);
+        } while (elapsed < seconds);
+        g_timer_destroy (timer);
+
+        g_print ("%-10s %6u samples %6u matched %12.0f guesses/s "
+                 "%8.1f ns/profile %5.2f cmp/rejection",
+                 name,
+                 samples->len,
+                 matched,
+                 guesses / elapsed,
+                 evaluated ? elapsed * 1e9 / evaluated : 0.0,
+                 rejections ? (gdouble) comparisons / rejections : 0.0);
+#ifdef TEST_COUNT_ALLOCATIONS
+        g_print (" %6.1f allocations/guess\n",
+                 (gdouble) allocations / samples->len);
+#else
+        (void) allocations;
+        g_print ("    n/a allocations/guess\n");
+#endif
+}
+
+int
+main (int argc, char **argv)
+{
+        GOptionContext *context;
+        GError *error = NULL;
+        GUPnPDLNAProfileGuesser *guesser;
+        GPtrArray *samples[SAMPLE_KIND_COUNT];
+        GPtrArray *all;
+        GList *profiles;
+        GList *iter;
+        guint n_profiles;
+        guint kind;
+
+        /* debug messages would cost allocations */
+        g_unsetenv ("G_MESSAGES_DEBUG");
+
+        context = g_option_context_new ("- benchmark DLNA profile guessing");
+        g_option_context_add_main_entries (context, entries, NULL);
+        if (!g_option_context_parse (context, &argc, &argv, &error)) {
+                g_printerr ("Failed to parse options: %s\n", error->message);
+                g_error_free (error);
+                g_option_context_free (context);
+
+                return 1;
+        }
+        g_option_context_free (context);
+
+        guesser = gupnp_dlna_profile_guesser_new (relaxed, extended);
+        profiles = gupnp_dlna_profile_guesser_list_profiles (guesser);
+        n_profiles = g_list_length (profiles);
+        if (n_profiles == 0) {
+                g_printerr ("No profiles loaded.\n");
+                g_object_unref (guesser);
+
+                return 1;
+        }
+
+        all = g_ptr_array_new ();
+        for (kind = 0; kind < SAMPLE_KIND_COUNT; ++kind) {
+                samples[kind] = g_ptr_array_new_with_free_func
+                                        (g_object_unref);
+                for (iter = profiles; iter != NULL; iter = iter->next) {
+                        GUPnPDLNAInformation *info = new_sample (iter->data,
+                                                                 kind);
+
+                        g_ptr_array_add (samples[kind], info);
+                        g_ptr_array_add (all, info);
+                }
+        }
+
+        g_print ("%u profiles (relaxed: %s, extended: %s)\n",
+                 n_profiles,
+                 relaxed ? "yes" : "no",
+                 extended ? "yes" : "no");
+        for (kind = 0; kind < SAMPLE_KIND_COUNT; ++kind)
+                run_samples (guesser, samples[kind], sample_kind_names[kind]);
+        run_samples (guesser, all, "all");
+
+        g_ptr_array_unref (all);
+        for (kind = 0; kind < SAMPLE_KIND_COUNT; ++kind)
+                g_ptr_array_unref (samples[kind]);
+        g_object_unref (guesser);
+
+        return 0;
+}
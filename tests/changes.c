@@ -0,0 +1,462 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "gupnp-dlna-profile-db.h"
+#include "gupnp-dlna-profile-guesser.h"
+#include "gupnp-dlna-profile-loader.h"
+#include "test-information.h"
+
+#define SCHEMA_FILE "dlna-profiles.rng"
+#define PROFILE_FILE "changes.xml"
+#define DIGESTS_FILE "digests.ini"
+
+/* A copy of the schema and a profile file written by the tests. */
+static gchar *profile_dir;
+
+/* Only the number of channels of CHANGES_TWEAK is changed. */
+static void
+write_profiles (gint max_channels)
+{
+        gchar *path = g_build_filename (profile_dir, PROFILE_FILE, NULL);
+        gchar *contents = g_strdup_printf
+                ("<?xml version=\"1.0\"?>\n"
+                 "<dlna-profiles>\n"
+                 "  <dlna-profile name=\"CHANGES_KEPT\"\n"
+                 "                mime=\"audio/x-kept\">\n"
+                 "    <restriction type=\"audio\">\n"
+                 "      <field name=\"name\" type=\"string\">\n"
+                 "        <value>audio/x-kept</value>\n"
+                 "      </field>\n"
+                 "    </restriction>\n"
+                 "  </dlna-profile>\n"
+                 "  <dlna-profile name=\"CHANGES_TWEAK\"\n"
+                 "                mime=\"audio/x-test\">\n"
+                 "    <restriction type=\"audio\">\n"
+                 "      <field name=\"name\" type=\"string\">\n"
+                 "        <value>audio/x-test</value>\n"
+                 "      </field>\n"
+                 "      <field name=\"channels\" type=\"int\">\n"
+                 "        <range min=\"1\" max=\"%d\" />\n"
+                 "      </field>\n"
+                 "    </restriction>\n"
+                 "  </dlna-profile>\n"
+                 "  <dlna-profile name=\"CHANGES_IMAGE\"\n"
+                 "                mime=\"image/x-test\">\n"
+                 "    <restriction type=\"image\">\n"
+                 "      <field name=\"name\" type=\"string\">\n"
+                 "        <value>image/x-test</value>\n"
+                 "      </field>\n"
+                 "    </restriction>\n"
+                 "  </dlna-profile>\n"
+                 "</dlna-profiles>\n",
+                 max_channels);
+
+        g_assert (g_file_set_contents (path, contents, -1, NULL));
+        g_free (contents);
+        g_free (path);
+}
+
+/* CHANGES_FIRST is tried before CHANGES_SECOND, which overlaps with
+ * it only if it matches the same audio. */
+static void
+write_overlapping_profiles (const gchar *second_name,
+                            gint         max_channels)
+{
+        gchar *path = g_build_filename (profile_dir, PROFILE_FILE, NULL);
+        gchar *contents = g_strdup_printf
+                ("<?xml version=\"1.0\"?>\n"
+                 "<dlna-profiles>\n"
+                 "  <dlna-profile name=\"CHANGES_FIRST\"\n"
+                 "                mime=\"audio/x-first\">\n"
+                 "    <restriction type=\"audio\">\n"
+                 "      <field name=\"name\" type=\"string\">\n"
+                 "        <value>audio/x-test</value>\n"
+                 "      </field>\n"
+                 "      <field name=\"channels\" type=\"int\">\n"
+                 "        <range min=\"1\" max=\"%d\" />\n"
+                 "      </field>\n"
+                 "    </restriction>\n"
+                 "  </dlna-profile>\n"
+                 "  <dlna-profile name=\"CHANGES_SECOND\"\n"
+                 "                mime=\"audio/x-second\">\n"
+                 "    <restriction type=\"audio\">\n"
+                 "      <field name=\"name\" type=\"string\">\n"
+                 "        <value>%s</value>\n"
+                 "      </field>\n"
+                 "    </restriction>\n"
+                 "  </dlna-profile>\n"
+                 "</dlna-profiles>\n",
+                 max_channels,
+                 second_name);
+
+        g_assert (g_file_set_contents (path, contents, -1, NULL));
+        g_free (contents);
+        g_free (path);
+}
+
+static GUPnPDLNAInformation *
+new_information (const gchar *mime,
+                 gint         channels)
+{
+        TestInformation *info = test_information_new ("file:///test.media");
+        TestStream stream = (g_str_has_prefix (mime, "image/") ?
+                             TEST_STREAM_IMAGE :
+                             TEST_STREAM_AUDIO);
+
+        test_information_set_string (info, stream, "mime", mime);
+        if (channels > 0)
+                test_information_set_int (info, stream, "channels", channels);
+
+        return GUPNP_DLNA_INFORMATION (info);
+}
+
+static gchar *
+guess_digest (GUPnPDLNAProfileGuesser *guesser,
+              GUPnPDLNAInformation    *info)
+{
+        GUPnPDLNAProfile *profile =
+                gupnp_dlna_profile_guesser_guess_profile_from_info (guesser,
+                                                                    info);
+
+        if (profile == NULL)
+                return NULL;
+        g_assert (gupnp_dlna_profile_get_digest (profile) != NULL);
+
+        return g_strdup (gupnp_dlna_profile_get_digest (profile));
+}
+
+static gchar *
+dup_digest (GUPnPDLNAProfileGuesser *guesser,
+            const gchar             *name)
+{
+        GUPnPDLNAProfile *profile =
+                gupnp_dlna_profile_guesser_get_profile (guesser, name);
+
+        g_assert (profile != NULL);
+        g_assert (gupnp_dlna_profile_get_digest (profile) != NULL);
+
+        return g_strdup (gupnp_dlna_profile_get_digest (profile));
+}
+
+static void
+changes_digests (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                             gupnp_dlna_profile_guesser_new (FALSE, FALSE);
+        gchar *kept_digest;
+        gchar *tweak_digest;
+        gchar *digest;
+
+        write_profiles (2);
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+        kept_digest = dup_digest (guesser, "CHANGES_KEPT");
+        tweak_digest = dup_digest (guesser, "CHANGES_TWEAK");
+        g_assert_cmpstr (kept_digest, !=, tweak_digest);
+
+        /* the same profiles loaded again */
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+        digest = dup_digest (guesser, "CHANGES_TWEAK");
+        g_assert_cmpstr (digest, ==, tweak_digest);
+        g_free (digest);
+
+        write_profiles (8);
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+        digest = dup_digest (guesser, "CHANGES_KEPT");
+        g_assert_cmpstr (digest, ==, kept_digest);
+        g_free (digest);
+        digest = dup_digest (guesser, "CHANGES_TWEAK");
+        g_assert_cmpstr (digest, !=, tweak_digest);
+        g_free (digest);
+
+        g_free (tweak_digest);
+        g_free (kept_digest);
+        g_object_unref (guesser);
+}
+
+static void
+changes_affected (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                             gupnp_dlna_profile_guesser_new (FALSE, FALSE);
+        GUPnPDLNAInformation *kept_info = new_information ("audio/x-kept", 0);
+        GUPnPDLNAInformation *tweak_info = new_information ("audio/x-test",
+                                                            2);
+        GUPnPDLNAInformation *surround_info = new_information ("audio/x-test",
+                                                               6);
+        GUPnPDLNAInformation *image_info = new_information ("image/x-test", 0);
+        GUPnPDLNAInformation *unknown_info = new_information ("image/x-none",
+                                                              0);
+        gchar *digests = g_build_filename (profile_dir, DIGESTS_FILE, NULL);
+        gchar *kept_digest;
+        gchar *tweak_digest;
+        gchar *image_digest;
+        GUPnPDLNAProfileChanges *changes;
+        GError *error = NULL;
+
+        write_profiles (2);
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+        g_assert (gupnp_dlna_profile_guesser_save_digests (guesser,
+                                                           digests,
+                                                           &error));
+        g_assert_no_error (error);
+        kept_digest = guess_digest (guesser, kept_info);
+        tweak_digest = guess_digest (guesser, tweak_info);
+        image_digest = guess_digest (guesser, image_info);
+        g_assert (kept_digest != NULL);
+        g_assert (tweak_digest != NULL);
+        g_assert (image_digest != NULL);
+        g_assert (guess_digest (guesser, surround_info) == NULL);
+        g_assert (guess_digest (guesser, unknown_info) == NULL);
+
+        /* nothing changed */
+        changes = gupnp_dlna_profile_guesser_get_changes (guesser,
+                                                          digests,
+                                                          &error);
+        g_assert_no_error (error);
+        g_assert_cmpuint (gupnp_dlna_profile_changes_get_changed_count
+                                        (changes),
+                          ==,
+                          0);
+        g_assert (!gupnp_dlna_profile_changes_affects (changes,
+                                                       tweak_digest,
+                                                       NULL));
+        g_assert (!gupnp_dlna_profile_changes_affects (changes, NULL, NULL));
+        gupnp_dlna_profile_changes_unref (changes);
+
+        write_profiles (8);
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+        changes = gupnp_dlna_profile_guesser_get_changes (guesser,
+                                                          digests,
+                                                          &error);
+        g_assert_no_error (error);
+        g_assert_cmpuint (gupnp_dlna_profile_changes_get_changed_count
+                                        (changes),
+                          ==,
+                          1);
+        g_assert_cmpuint (gupnp_dlna_profile_changes_get_removed_count
+                                        (changes),
+                          ==,
+                          1);
+
+        /* tried before the changed profile */
+        g_assert (!gupnp_dlna_profile_changes_affects (changes,
+                                                       kept_digest,
+                                                       NULL));
+        /* the changed profile itself */
+        g_assert (gupnp_dlna_profile_changes_affects (changes,
+                                                      tweak_digest,
+                                                      NULL));
+        g_assert (gupnp_dlna_profile_changes_affects (changes,
+                                                      tweak_digest,
+                                                      tweak_info));
+        /* tried after the changed one, which cannot match it */
+        g_assert (!gupnp_dlna_profile_changes_affects (changes,
+                                                       image_digest,
+                                                       image_info));
+        /* no matches may match the changed profile now */
+        g_assert (gupnp_dlna_profile_changes_affects (changes, NULL, NULL));
+        g_assert (gupnp_dlna_profile_changes_affects (changes,
+                                                      NULL,
+                                                      surround_info));
+        g_assert (!gupnp_dlna_profile_changes_affects (changes,
+                                                       NULL,
+                                                       unknown_info));
+        gupnp_dlna_profile_changes_unref (changes);
+
+        g_assert (gupnp_dlna_profile_guesser_get_changes
+                                        (guesser,
+                                         "/nonexistent/gupnp-dlna-digests",
+                                         &error) == NULL);
+        g_assert (error != NULL);
+        g_clear_error (&error);
+
+        g_unlink (digests);
+        g_free (digests);
+        g_free (image_digest);
+        g_free (tweak_digest);
+        g_free (kept_digest);
+        g_object_unref (unknown_info);
+        g_object_unref (image_info);
+        g_object_unref (surround_info);
+        g_object_unref (tweak_info);
+        g_object_unref (kept_info);
+        g_object_unref (guesser);
+}
+
+static void
+changes_overlapping (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                             gupnp_dlna_profile_guesser_new (FALSE, FALSE);
+        GUPnPDLNAInformation *stereo_info = new_information ("audio/x-test",
+                                                             2);
+        GUPnPDLNAInformation *surround_info = new_information ("audio/x-test",
+                                                               6);
+        GUPnPDLNAInformation *many_info = new_information ("audio/x-test",
+                                                           12);
+        gchar *digests = g_build_filename (profile_dir, DIGESTS_FILE, NULL);
+        gchar *first_digest;
+        gchar *second_digest;
+        gchar *digest;
+        GUPnPDLNAProfileChanges *changes;
+        GError *error = NULL;
+
+        write_overlapping_profiles ("audio/x-test", 2);
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+        g_assert (gupnp_dlna_profile_guesser_save_digests (guesser,
+                                                           digests,
+                                                           &error));
+        g_assert_no_error (error);
+        first_digest = guess_digest (guesser, stereo_info);
+        second_digest = guess_digest (guesser, surround_info);
+        digest = guess_digest (guesser, many_info);
+        g_assert_cmpstr (first_digest, !=, second_digest);
+        g_assert_cmpstr (digest, ==, second_digest);
+        g_free (digest);
+
+        /* CHANGES_FIRST, tried before CHANGES_SECOND, now takes
+         * surround audio too */
+        write_overlapping_profiles ("audio/x-test", 8);
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+        changes = gupnp_dlna_profile_guesser_get_changes (guesser,
+                                                          digests,
+                                                          &error);
+        g_assert_no_error (error);
+        g_assert_cmpuint (gupnp_dlna_profile_changes_get_changed_count
+                                        (changes),
+                          ==,
+                          1);
+        g_assert (gupnp_dlna_profile_changes_affects (changes,
+                                                      second_digest,
+                                                      NULL));
+        g_assert (gupnp_dlna_profile_changes_affects (changes,
+                                                      second_digest,
+                                                      surround_info));
+        g_assert (!gupnp_dlna_profile_changes_affects (changes,
+                                                       second_digest,
+                                                       many_info));
+        gupnp_dlna_profile_changes_unref (changes);
+
+        g_unlink (digests);
+        g_free (digests);
+        g_free (second_digest);
+        g_free (first_digest);
+        g_object_unref (many_info);
+        g_object_unref (surround_info);
+        g_object_unref (stereo_info);
+        g_object_unref (guesser);
+        write_profiles (2);
+}
+
+static void
+changes_analysis (void)
+{
+        gchar *path = g_build_filename (profile_dir,
+                                        GUPNP_DLNA_PROFILE_ANALYSIS_FILE,
+                                        NULL);
+        GKeyFile *analysis = g_key_file_new ();
+        GUPnPDLNAProfileDB *db;
+
+        write_overlapping_profiles ("audio/x-other", 2);
+        db = gupnp_dlna_profile_db_new_full (FALSE, FALSE, FALSE);
+        g_assert (!gupnp_dlna_profile_db_may_overlap (db, 0, 1));
+        gupnp_dlna_profile_db_save_analysis (db, analysis);
+        g_assert (g_key_file_save_to_file (analysis, path, NULL));
+        gupnp_dlna_profile_db_unref (db);
+
+        /* the analysis is up to date */
+        db = gupnp_dlna_profile_db_new_full (FALSE, FALSE, TRUE);
+        g_assert (!gupnp_dlna_profile_db_may_overlap (db, 0, 1));
+        gupnp_dlna_profile_db_unref (db);
+
+        /* the same profiles, but CHANGES_SECOND now matches the audio
+         * of CHANGES_FIRST, while the analysis is left as it was */
+        write_overlapping_profiles ("audio/x-test", 2);
+        db = gupnp_dlna_profile_db_new_full (FALSE, FALSE, TRUE);
+        g_assert (gupnp_dlna_profile_db_may_overlap (db, 0, 1));
+        gupnp_dlna_profile_db_unref (db);
+
+        g_unlink (path);
+        g_key_file_unref (analysis);
+        g_free (path);
+        write_profiles (2);
+}
+
+static void
+copy_schema (const gchar *source_dir)
+{
+        gchar *source = g_build_filename (source_dir, SCHEMA_FILE, NULL);
+        gchar *target = g_build_filename (profile_dir, SCHEMA_FILE, NULL);
+        gchar *contents;
+        gsize length;
+
+        g_assert (g_file_get_contents (source, &contents, &length, NULL));
+        g_assert (g_file_set_contents (target, contents, length, NULL));
+        g_free (contents);
+        g_free (target);
+        g_free (source);
+}
+
+static void
+remove_file (const gchar *name)
+{
+        gchar *path = g_build_filename (profile_dir, name, NULL);
+
+        g_unlink (path);
+        g_free (path);
+}
+
+int
+main (int argc, char **argv)
+{
+        const gchar *source_dir;
+        int result;
+
+        g_test_init (&argc, &argv, NULL);
+
+        source_dir = g_getenv ("GUPNP_DLNA_PROFILE_DIR");
+        g_assert (source_dir != NULL);
+        profile_dir = g_dir_make_tmp ("gupnp-dlna-changes-XXXXXX", NULL);
+        g_assert (profile_dir != NULL);
+        copy_schema (source_dir);
+        write_profiles (2);
+        g_setenv ("GUPNP_DLNA_PROFILE_DIR", profile_dir, TRUE);
+
+        g_test_add_func ("/guesser/changes/digests", changes_digests);
+        g_test_add_func ("/guesser/changes/affected", changes_affected);
+        g_test_add_func ("/guesser/changes/overlapping",
+                         changes_overlapping);
+        g_test_add_func ("/guesser/changes/analysis", changes_analysis);
+
+        result = g_test_run ();
+
+        gupnp_dlna_profile_guesser_cleanup ();
+        remove_file (PROFILE_FILE);
+        remove_file (SCHEMA_FILE);
+        g_rmdir (profile_dir);
+        g_free (profile_dir);
+
+        return result;
+}
@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Runs gupnp-dlna-daemon with the test backend in test-backend.c and
+ * guesses through it. See tests/meson.build for the environment it
+ * needs.
+ */
+
+#include <signal.h>
+
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+#include "test-information.h"
+
+#define TIMEOUT_IN_MS 1000
+
+static gchar *socket_path;
+
+static GUPnPDLNAInformation *
+mp3_information (void)
+{
+        TestInformation *info = test_information_new ("file:///test.mp3");
+
+        test_information_set_string (info,
+                                     TEST_STREAM_AUDIO,
+                                     "mime",
+                                     "audio/mpeg");
+        test_information_set_int (info, TEST_STREAM_AUDIO, "mpegversion", 1);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "layer", 3);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "channels", 2);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "rate", 44100);
+        test_information_set_int (info,
+                                  TEST_STREAM_AUDIO,
+                                  "bitrate",
+                                  128000);
+
+        return GUPNP_DLNA_INFORMATION (info);
+}
+
+static void
+test_guess_uri (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                                   gupnp_dlna_profile_guesser_new_for_daemon
+                                        (TRUE,
+                                         TRUE,
+                                         socket_path);
+        GUPnPDLNAInformation *info = NULL;
+        GError *error = NULL;
+        GUPnPDLNAProfile *profile;
+        GUPnPDLNAAudioInformation *audio_info;
+
+        profile = gupnp_dlna_profile_guesser_guess_profile_sync
+                                        (guesser,
+                                         "file:///test.mp3",
+                                         TIMEOUT_IN_MS,
+                                         &info,
+                                         &error);
+        g_assert_no_error (error);
+        g_assert_nonnull (profile);
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (profile), ==, "MP3");
+        g_assert_cmpstr (gupnp_dlna_profile_get_mime (profile),
+                         ==,
+                         "audio/mpeg");
+
+        /* the information extracted by the daemon comes along */
+        g_assert_nonnull (info);
+        g_assert_cmpstr (gupnp_dlna_information_get_uri (info),
+                         ==,
+                         "file:///test.mp3");
+        audio_info = gupnp_dlna_information_get_audio_information (info);
+        g_assert_nonnull (audio_info);
+        g_assert_cmpint (gupnp_dlna_audio_information_get_rate
+                                        (audio_info).value,
+                         ==,
+                         44100);
+
+        /* profiles are reused between guesses */
+        g_assert_true (profile ==
+                       gupnp_dlna_profile_guesser_guess_profile_sync
+                                        (guesser,
+                                         "file:///test.mp3",
+                                         TIMEOUT_IN_MS,
+                                         NULL,
+                                         &error));
+        g_assert_no_error (error);
+
+        g_object_unref (info);
+        g_object_unref (guesser);
+}
+
+static void
+test_guess_info (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                                   gupnp_dlna_profile_guesser_new_for_daemon
+                                        (FALSE,
+                                         FALSE,
+                                         socket_path);
+        GUPnPDLNAInformation *info = mp3_information ();
+        GUPnPDLNAProfile *profile;
+
+        profile = gupnp_dlna_profile_guesser_guess_profile_from_info (guesser,
+                                                                      info);
+        g_assert_nonnull (profile);
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (profile), ==, "MP3");
+        g_assert_cmpuint (gupnp_dlna_profile_guesser_get_error_count
+                                        (guesser),
+                          ==,
+                          0);
+
+        g_object_unref (info);
+        g_object_unref (guesser);
+}
+
+static void
+test_failure (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                                   gupnp_dlna_profile_guesser_new_for_daemon
+                                        (FALSE,
+                                         FALSE,
+                                         socket_path);
+        GError *error = NULL;
+
+        g_assert_null (gupnp_dlna_profile_guesser_guess_profile_sync
+                                        (guesser,
+                                         "file:///fail.mp3",
+                                         TIMEOUT_IN_MS,
+                                         NULL,
+                                         &error));
+        /* the error of the test backend comes through as it is */
+        g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+        g_clear_error (&error);
+        g_assert_cmpuint (gupnp_dlna_profile_guesser_get_error_count
+                                        (guesser),
+                          ==,
+                          1);
+
+        g_object_unref (guesser);
+}
+
+static void
+test_profiles (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                                   gupnp_dlna_profile_guesser_new_for_daemon
+                                        (FALSE,
+                                         FALSE,
+                                         socket_path);
+        GUPnPDLNAInformation *info = mp3_information ();
+        GUPnPDLNAProfile *profile;
+        GList *profiles;
+
+        profiles = gupnp_dlna_profile_guesser_list_profiles (guesser);
+        g_assert_nonnull (profiles);
+
+        /* guesses return the listed profiles */
+        profile = gupnp_dlna_profile_guesser_guess_profile_from_info (guesser,
+                                                                      info);
+        g_assert_nonnull (profile);
+        g_assert_nonnull (g_list_find (profiles, profile));
+        g_assert_nonnull (gupnp_dlna_profile_get_digest (profile));
+        g_assert_true (profile ==
+                       gupnp_dlna_profile_guesser_get_profile (guesser,
+                                                               "MP3"));
+        g_assert_true (profiles ==
+                       gupnp_dlna_profile_guesser_list_profiles (guesser));
+
+        g_object_unref (info);
+        g_object_unref (guesser);
+}
+
+static void
+test_timeout (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                                   gupnp_dlna_profile_guesser_new_for_daemon
+                                        (FALSE,
+                                         FALSE,
+                                         socket_path);
+        GError *error = NULL;
+
+        /* the daemon never answers, the wait ends after the timeout
+         * and a grace period */
+        g_assert_null (gupnp_dlna_profile_guesser_guess_profile_sync
+                                        (guesser,
+                                         "file:///hang.mp3",
+                                         TIMEOUT_IN_MS,
+                                         NULL,
+                                         &error));
+        g_assert_error (error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+        g_clear_error (&error);
+
+        g_object_unref (guesser);
+}
+
+static void
+test_no_daemon (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                                   gupnp_dlna_profile_guesser_new_for_daemon
+                                        (FALSE,
+                                         FALSE,
+                                         "/nonexistent/gupnp-dlna.socket");
+        GError *error = NULL;
+
+        g_assert_null (gupnp_dlna_profile_guesser_guess_profile_sync
+                                        (guesser,
+                                         "file:///test.mp3",
+                                         TIMEOUT_IN_MS,
+                                         NULL,
+                                         &error));
+        g_assert_nonnull (error);
+        g_clear_error (&error);
+
+        g_object_unref (guesser);
+}
+
+static void
+done_cb (GUPnPDLNAProfileGuesser *guesser G_GNUC_UNUSED,
+         GUPnPDLNAInformation    *info,
+         GUPnPDLNAProfile        *profile,
+         GError                  *error,
+         gpointer                 user_data)
+{
+        g_assert_no_error (error);
+        g_assert_cmpstr (gupnp_dlna_information_get_uri (info),
+                         ==,
+                         "file:///test.mp3");
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (profile), ==, "MP3");
+        g_main_loop_quit (user_data);
+}
+
+static void
+test_async (void)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                                   gupnp_dlna_profile_guesser_new_for_daemon
+                                        (FALSE,
+                                         FALSE,
+                                         socket_path);
+        GMainLoop *loop = g_main_loop_new (NULL, FALSE);
+        GError *error = NULL;
+
+        g_signal_connect (guesser, "done", G_CALLBACK (done_cb), loop);
+        g_assert_true (gupnp_dlna_profile_guesser_guess_profile_async
+                                        (guesser,
+                                         "file:///test.mp3",
+                                         TIMEOUT_IN_MS,
+                                         &error));
+        g_assert_no_error (error);
+        g_main_loop_run (loop);
+
+        g_main_loop_unref (loop);
+        g_object_unref (guesser);
+}
+
+static GSubprocess *
+start_daemon (void)
+{
+        const gchar *daemon_path = g_getenv ("GUPNP_DLNA_DAEMON");
+        GError *error = NULL;
+        GSubprocess *daemon;
+        guint iter;
+
+        g_assert_nonnull (daemon_path);
+        daemon = g_subprocess_new (G_SUBPROCESS_FLAGS_NONE,
+                                   &error,
+                                   daemon_path,
+                                   "--socket",
+                                   socket_path,
+                                   NULL);
+        g_assert_no_error (error);
+
+        /* wait until it listens */
+        for (iter = 0; iter < 100; ++iter) {
+                if (g_file_test (socket_path, G_FILE_TEST_EXISTS))
+                        break;
+                g_usleep (G_USEC_PER_SEC / 20);
+        }
+        g_assert_true (g_file_test (socket_path, G_FILE_TEST_EXISTS));
+
+        return daemon;
+}
+
+int
+main (int argc, char **argv)
+{
+        gchar *dir;
+        GSubprocess *daemon;
+        int result;
+
+        g_test_init (&argc, &argv, NULL);
+
+        dir = g_dir_make_tmp ("gupnp-dlna-daemon-XXXXXX", NULL);
+        g_assert_nonnull (dir);
+        socket_path = g_build_filename (dir, "socket", NULL);
+        daemon = start_daemon ();
+
+        g_test_add_func ("/daemon/guess-uri", test_guess_uri);
+        g_test_add_func ("/daemon/guess-info", test_guess_info);
+        g_test_add_func ("/daemon/failure", test_failure);
+        g_test_add_func ("/daemon/profiles", test_profiles);
+        g_test_add_func ("/daemon/timeout", test_timeout);
+        g_test_add_func ("/daemon/no-daemon", test_no_daemon);
+        g_test_add_func ("/daemon/async", test_async);
+
+        result = g_test_run ();
+
+        g_subprocess_send_signal (daemon, SIGTERM);
+        g_subprocess_wait (daemon, NULL, NULL);
+        g_object_unref (daemon);
+        g_assert_false (g_file_test (socket_path, G_FILE_TEST_EXISTS));
+        g_rmdir (dir);
+        g_free (socket_path);
+        g_free (dir);
+
+        return result;
+}
@@ -0,0 +1,140 @@
+#!/bin/bash
+
+#
+# Generates a small media corpus for the discovery latency benchmark,
+# so it can run without the gupnp-dlna-media checkout.
+#
+# Usage:
+#   generate-media.sh <output_dir>
+#
+# Files are put into a subdirectory per media class. They are encoded
+# with GStreamer test sources where the needed elements are available.
+# LPCM and PNG files are also assembled by hand, so the corpus is
+# never empty even without any encoders.
+#
+
+if [[ ${#} -lt 1 ]]; then
+  echo "Usage:"
+  echo "  ${0} <output_dir>"
+  exit 1
+fi
+
+OUTPUT_DIR=${1}
+GST_LAUNCH=${GST_LAUNCH:-gst-launch-1.0}
+GST_INSPECT=${GST_INSPECT:-gst-inspect-1.0}
+
+have_elements() {
+  local element
+
+  command -v ${GST_LAUNCH} >/dev/null || return 1
+  command -v ${GST_INSPECT} >/dev/null || return 1
+  for element in "${@}"; do
+    ${GST_INSPECT} --exists ${element} || return 1
+  done
+
+  return 0
+}
+
+# encode <class> <file> <elements> -- <pipeline ...>
+encode() {
+  local class=${1}
+  local file=${2}
+  local elements=()
+
+  shift 2
+  while [[ "${1}" != "--" ]]; do
+    elements+=(${1})
+    shift
+  done
+  shift
+
+  if ! have_elements "${elements[@]}"; then
+    echo " Skipping ${class}/${file}: missing ${elements[*]}"
+    return
+  fi
+
+  mkdir -p "${OUTPUT_DIR}/${class}"
+  if ! ${GST_LAUNCH} -q "${@}" ! \
+       filesink location="${OUTPUT_DIR}/${class}/${file}" >/dev/null; then
+    echo " Failed to encode ${class}/${file}"
+    rm -f "${OUTPUT_DIR}/${class}/${file}"
+  fi
+}
+
+le16() {
+  printf "\\x$(printf %02x $((${1} & 255)))\\x$(printf %02x $((${1} >> 8 & 255)))"
+}
+
+le32() {
+  le16 $((${1} & 65535))
+  le16 $((${1} >> 16 & 65535))
+}
+
+# A second of 16-bit stereo silence in a RIFF/WAVE container.
+write_wav() {
+  local rate=${1}
+  local data_size=$((rate * 4))
+
+  printf "RIFF"
+  le32 $((36 + data_size))
+  printf "WAVEfmt "
+  le32 16
+  le16 1
+  le16 2
+  le32 ${rate}
+  le32 $((rate * 4))
+  le16 4
+  le16 16
+  printf "data"
+  le32 ${data_size}
+  head -c ${data_size} /dev/zero
+}
+
+# A 1x1 black 8-bit grayscale PNG.
+write_png() {
+  printf "\\x89PNG\\r\\n\\x1a\\n"
+  printf "\\x00\\x00\\x00\\x0dIHDR"
+  printf "\\x00\\x00\\x00\\x01\\x00\\x00\\x00\\x01\\x08\\x00\\x00\\x00\\x00"
+  printf "\\x3a\\x7e\\x9b\\x55"
+  printf "\\x00\\x00\\x00\\x0aIDAT"
+  printf "\\x78\\x9c\\x63\\x60\\x00\\x00\\x00\\x02\\x00\\x01"
+  printf "\\x48\\xaf\\xa4\\x71"
+  printf "\\x00\\x00\\x00\\x00IEND\\xae\\x42\\x60\\x82"
+}
+
+mkdir -p "${OUTPUT_DIR}/lpcm" "${OUTPUT_DIR}/png"
+write_wav 44100 >"${OUTPUT_DIR}/lpcm/hand-44100.wav"
+write_wav 48000 >"${OUTPUT_DIR}/lpcm/hand-48000.wav"
+write_png >"${OUTPUT_DIR}/png/hand-1x1.png"
+
+VIDEO="videotestsrc num-buffers=50"
+AUDIO="audiotestsrc num-buffers=50"
+
+encode jpeg sm.jpg videotestsrc jpegenc -- \
+  videotestsrc num-buffers=1 ! video/x-raw,width=640,height=480 ! jpegenc
+encode jpeg lrg.jpg videotestsrc jpegenc -- \
+  videotestsrc num-buffers=1 ! video/x-raw,width=1920,height=1080 ! jpegenc
+encode png lrg.png videotestsrc pngenc -- \
+  videotestsrc num-buffers=1 ! video/x-raw,width=1920,height=1080 ! pngenc
+encode mp3 44100.mp3 audiotestsrc lamemp3enc -- \
+  ${AUDIO} ! audio/x-raw,rate=44100,channels=2 ! lamemp3enc
+encode mp3 id3.mp3 audiotestsrc lamemp3enc id3v2mux -- \
+  ${AUDIO} ! audio/x-raw,rate=48000,channels=2 ! lamemp3enc ! id3v2mux
+encode aac adts.aac audiotestsrc avenc_aac aacparse -- \
+  ${AUDIO} ! audio/x-raw,rate=48000,channels=2 ! avenc_aac ! aacparse ! \
+  audio/mpeg,stream-format=adts
+encode aac audio.m4a audiotestsrc avenc_aac mp4mux -- \
+  ${AUDIO} ! audio/x-raw,rate=48000,channels=2 ! avenc_aac ! mp4mux
+encode lpcm 48000.wav audiotestsrc wavenc -- \
+  ${AUDIO} ! audio/x-raw,rate=48000,channels=2,format=S16LE ! wavenc
+encode h264-mp4 720p.mp4 videotestsrc x264enc mp4mux -- \
+  ${VIDEO} ! video/x-raw,width=1280,height=720,framerate=25/1 ! \
+  x264enc profile=main ! mp4mux
+encode mpeg-ts h264.ts videotestsrc x264enc h264parse mpegtsmux -- \
+  ${VIDEO} ! video/x-raw,width=1280,height=720,framerate=25/1 ! \
+  x264enc ! h264parse ! mpegtsmux
+encode mpeg-ts mpeg2.ts videotestsrc avenc_mpeg2video mpegtsmux -- \
+  ${VIDEO} ! video/x-raw,width=720,height=576,framerate=25/1 ! \
+  avenc_mpeg2video ! mpegtsmux
+
+exit 0
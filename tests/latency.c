@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Measures end-to-end latency of guessing profiles of media files,
+ * that is metadata extraction by the backend and profile matching.
+ *
+ * The media directory is expected to have a subdirectory per media
+ * class, like the one created by generate-media.sh. Latencies are
+ * reported per media class for the backend chosen with the
+ * GUPNP_DLNA_METADATA_BACKEND environment variable.
+ */
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+
+#define TIMEOUT_IN_MS 10000
+
+static gint iterations = 10;
+
+static GOptionEntry entries[] = {
+        { "iterations", 'i', 0, G_OPTION_ARG_INT, &iterations,
+          "Number of guesses for each file", "N" },
+        { NULL }
+};
+
+typedef struct {
+        gchar  *name;
+        GArray *latencies;
+        guint   files;
+        guint   failures;
+} MediaClass;
+
+static void
+media_class_free (MediaClass *media_class)
+{
+        g_free (media_class->name);
+        g_array_unref (media_class->latencies);
+        g_slice_free (MediaClass, media_class);
+}
+
+static gint
+compare_doubles (gconstpointer a,
+                 gconstpointer b)
+{
+        gdouble first = *(const gdouble *) a;
+        gdouble second = *(const gdouble *) b;
+
+        return (first > second) - (first < second);
+}
+
+/* Nearest-rank percentile of sorted @latencies. */
+static gdouble
+percentile (GArray *latencies,
+            guint   percent)
+{
+        guint rank = (percent * latencies->len + 99) / 100;
+
+        if (rank > 0)
+                --rank;
+
+        return g_array_index (latencies, gdouble, rank);
+}
+
+/* Returns a latency in microseconds or a negative value on failure. */
+static gdouble
+guess_file (GUPnPDLNAProfileGuesser *guesser,
+            const gchar             *uri)
+{
+        GUPnPDLNAInformation *info = NULL;
+        GError *error = NULL;
+        gint64 start = g_get_monotonic_time ();
+        gint64 end;
+
+        gupnp_dlna_profile_guesser_guess_profile_sync (guesser,
+                                                       uri,
+                                                       TIMEOUT_IN_MS,
+                                                       &info,
+                                                       &error);
+        end = g_get_monotonic_time ();
+        g_clear_object (&info);
+        if (error != NULL) {
+                g_printerr ("Failed to guess a profile of %s: %s\n",
+                            uri,
+                            error->message);
+                g_error_free (error);
+
+                return -1.0;
+        }
+
+        return end - start;
+}
+
+/* The very first guess also loads the backend and initializes it, so
+ * it is stored in @startup instead of the class latencies. */
+static MediaClass *
+measure_class (GUPnPDLNAProfileGuesser *guesser,
+               const gchar             *media_dir,
+               const gchar             *name,
+               gdouble                 *startup)
+{
+        MediaClass *media_class = g_slice_new0 (MediaClass);
+        gchar *path = g_build_filename (media_dir, name, NULL);
+        GDir *dir = g_dir_open (path, 0, NULL);
+        const gchar *file_name;
+
+        media_class->name = g_strdup (name);
+        media_class->latencies = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+        while (dir != NULL && (file_name = g_dir_read_name (dir)) != NULL) {
+                gchar *file_path = g_build_filename (path, file_name, NULL);
+                gchar *uri = g_filename_to_uri (file_path, NULL, NULL);
+                gint iter;
+
+                ++media_class->files;
+                for (iter = 0; iter < iterations; ++iter) {
+                        gdouble latency = guess_file (guesser, uri);
+
+                        if (latency < 0) {
+                                ++media_class->failures;
+
+                                break;
+                        }
+                        if (*startup < 0)
+                                *startup = latency;
+                        else
+                                g_array_append_val (media_class->latencies,
+                                                    latency);
+                }
+
+                g_free (uri);
+                g_free (file_path);
+        }
+
+        g_array_sort (media_class->latencies, compare_doubles);
+        if (dir != NULL)
+                g_dir_close (dir);
+        g_free (path);
+
+        return media_class;
+}
+
+int
+main (int argc, char **argv)
+{
+        GOptionContext *context;
+        GError *error = NULL;
+        GUPnPDLNAProfileGuesser *guesser;
+        GPtrArray *classes;
+        GDir *dir;
+        const gchar *backend;
+        const gchar *name;
+        gdouble startup = -1.0;
+        guint iter;
+        int ret = 0;
+
+        context = g_option_context_new ("MEDIA_DIR - benchmark profile "
+                                        "guessing of media files");
+        g_option_context_add_main_entries (context, entries, NULL);
+        if (!g_option_context_parse (context, &argc, &argv, &error)) {
+                g_printerr ("Failed to parse options: %s\n", error->message);
+                g_error_free (error);
+                g_option_context_free (context);
+
+                return 1;
+        }
+        g_option_context_free (context);
+
+        if (argc < 2 || iterations < 1) {
+                g_printerr ("Usage: %s [--iterations N] MEDIA_DIR\n",
+                            argv[0]);
+
+                return 1;
+        }
+
+        dir = g_dir_open (argv[1], 0, &error);
+        if (dir == NULL) {
+                g_printerr ("Failed to open media directory: %s\n",
+                            error->message);
+                g_error_free (error);
+
+                return 1;
+        }
+
+        backend = g_getenv ("GUPNP_DLNA_METADATA_BACKEND");
+        guesser = gupnp_dlna_profile_guesser_new (TRUE, TRUE);
+        classes = g_ptr_array_new_with_free_func
+                                        ((GDestroyNotify) media_class_free);
+
+        while ((name = g_dir_read_name (dir)) != NULL) {
+                gchar *path = g_build_filename (argv[1], name, NULL);
+
+                if (g_file_test (path, G_FILE_TEST_IS_DIR)) {
+                        g_ptr_array_add (classes,
+                                         measure_class (guesser,
+                                                        argv[1],
+                                                        name,
+                                                        &startup));
+                }
+                g_free (path);
+        }
+        g_dir_close (dir);
+
+        g_print ("backend: %s\n", backend != NULL ? backend : "default");
+        g_print ("%-12s %5s %8s %10s %10s %10s\n",
+                 "class",
+                 "files",
+                 "guesses",
+                 "p50 [us]",
+                 "p95 [us]",
+                 "p99 [us]");
+        for (iter = 0; iter < classes->len; ++iter) {
+                MediaClass *media_class = g_ptr_array_index (classes, iter);
+                GArray *latencies = media_class->latencies;
+
+                if (media_class->failures > 0)
+                        ret = 1;
+                if (latencies->len == 0) {
+                        g_print ("%-12s %5u %8u %10s %10s %10s\n",
+                                 media_class->name,
+                                 media_class->files,
+                                 0,
+                                 "-",
+                                 "-",
+                                 "-");
+
+                        continue;
+                }
+                g_print ("%-12s %5u %8u %10.0f %10.0f %10.0f\n",
+                         media_class->name,
+                         media_class->files,
+                         latencies->len,
+                         percentile (latencies, 50),
+                         percentile (latencies, 95),
+                         percentile (latencies, 99));
+        }
+        if (startup >= 0)
+                g_print ("first guess, including backend startup: %.0f us\n",
+                         startup);
+
+        g_ptr_array_unref (classes);
+        g_object_unref (guesser);
+
+        return ret;
+}
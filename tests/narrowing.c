@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Checks that the guesser stops an extraction once the partial
+ * information reported by the test backend in test-backend.c rules
+ * out every profile. See tests/meson.build for the environment it
+ * needs.
+ */
+
+#include <gio/gio.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+
+#define TIMEOUT_IN_MS 200
+
+static void
+test_stop (void)
+{
+        GUPnPDLNAProfileGuesser *guesser = gupnp_dlna_profile_guesser_new
+                                        (TRUE, TRUE);
+        GUPnPDLNAInformation *info = NULL;
+        GUPnPDLNAContainerInformation *container;
+        GUPnPDLNAStringValue mime;
+        GError *error = NULL;
+
+        g_assert_null (gupnp_dlna_profile_guesser_guess_profile_sync
+                                        (guesser,
+                                         "file:///partial.mkv",
+                                         TIMEOUT_IN_MS,
+                                         &info,
+                                         &error));
+        g_assert_no_error (error);
+        g_assert_nonnull (info);
+        container = gupnp_dlna_information_get_container_information (info);
+        g_assert_nonnull (container);
+        mime = gupnp_dlna_container_information_get_mime (container);
+        g_assert_cmpstr (mime.value, ==, "application/x-test-partial");
+        g_free (mime.value);
+        g_assert_null (gupnp_dlna_information_get_audio_information (info));
+
+        g_object_unref (info);
+        g_object_unref (guesser);
+}
+
+static void
+test_continue (void)
+{
+        GUPnPDLNAProfileGuesser *guesser = gupnp_dlna_profile_guesser_new
+                                        (TRUE, TRUE);
+        GUPnPDLNAProfile *profile;
+        GError *error = NULL;
+
+        profile = gupnp_dlna_profile_guesser_guess_profile_sync
+                                        (guesser,
+                                         "file:///test.mp3",
+                                         TIMEOUT_IN_MS,
+                                         NULL,
+                                         &error);
+        g_assert_no_error (error);
+        g_assert_nonnull (profile);
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (profile), ==, "MP3");
+
+        g_object_unref (guesser);
+}
+
+int
+main (int argc, char **argv)
+{
+        g_test_init (&argc, &argv, NULL);
+
+        g_test_add_func ("/narrowing/stop", test_stop);
+        g_test_add_func ("/narrowing/continue", test_continue);
+
+        return g_test_run ();
+}
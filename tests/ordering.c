@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+#include "gupnp-dlna-profile-private.h"
+#include "test-information.h"
+
+#define INFO_COUNT 48
+
+static GUPnPDLNAProfileGuesser *
+new_guesser (gboolean adaptive_ordering)
+{
+        return GUPNP_DLNA_PROFILE_GUESSER (g_object_new
+                                        (GUPNP_TYPE_DLNA_PROFILE_GUESSER,
+                                         "relaxed-mode", TRUE,
+                                         "extended-mode", TRUE,
+                                         "adaptive-ordering",
+                                         adaptive_ordering,
+                                         NULL));
+}
+
+/* Images and MP3 audio, some of them with values a backend could not
+ * extract. */
+static GUPnPDLNAInformation *
+new_information (guint index)
+{
+        static const gint rates[] = { 32000, 44100, 48000 };
+        TestInformation *info;
+        TestStream stream;
+
+        if (index % 2) {
+                info = test_information_new ("file:///test.img");
+                stream = TEST_STREAM_IMAGE;
+                test_information_set_string (info,
+                                             stream,
+                                             "mime",
+                                             (index % 3) ? "image/png" :
+                                                           "image/jpeg");
+                test_information_set_int (info,
+                                          stream,
+                                          "width",
+                                          160 * (1 + index % 12));
+                test_information_set_int (info,
+                                          stream,
+                                          "height",
+                                          120 * (1 + index % 12));
+                test_information_set_int (info, stream, "depth", 24);
+        } else {
+                info = test_information_new ("file:///test.mp3");
+                stream = TEST_STREAM_AUDIO;
+                test_information_set_string (info,
+                                             stream,
+                                             "mime",
+                                             "audio/mpeg");
+                test_information_set_int (info, stream, "mpegversion", 1);
+                test_information_set_int (info, stream, "layer", 3);
+                test_information_set_int (info,
+                                          stream,
+                                          "channels",
+                                          1 + index % 2);
+                test_information_set_int (info,
+                                          stream,
+                                          "rate",
+                                          rates[index % G_N_ELEMENTS (rates)]);
+                test_information_set_int (info,
+                                          stream,
+                                          "bitrate",
+                                          32000 * (1 + index % 10));
+        }
+        if (index % 8 == 0)
+                test_information_set_unsupported (info, stream, "depth");
+
+        return GUPNP_DLNA_INFORMATION (info);
+}
+
+static GUPnPDLNAProfile *
+find_profile (GUPnPDLNAProfileGuesser *guesser,
+              const gchar             *name)
+{
+        GUPnPDLNAProfile *profile =
+                     gupnp_dlna_profile_guesser_get_profile (guesser, name);
+
+        g_assert (profile != NULL);
+
+        return profile;
+}
+
+static void
+ordering_overlap (void)
+{
+        GUPnPDLNAProfileGuesser *guesser = new_guesser (TRUE);
+        GList *profiles = gupnp_dlna_profile_guesser_list_profiles (guesser);
+        GList *iter;
+        GList *other;
+
+        for (iter = profiles; iter != NULL; iter = iter->next) {
+                g_assert (gupnp_dlna_profile_may_overlap (iter->data,
+                                                          iter->data));
+                for (other = iter->next; other != NULL; other = other->next)
+                        g_assert (gupnp_dlna_profile_may_overlap
+                                        (iter->data,
+                                         other->data) ==
+                                  gupnp_dlna_profile_may_overlap
+                                        (other->data,
+                                         iter->data));
+        }
+
+        g_assert (!gupnp_dlna_profile_may_overlap
+                                        (find_profile (guesser, "MP3"),
+                                         find_profile (guesser, "JPEG_LRG")));
+        g_assert (!gupnp_dlna_profile_may_overlap
+                                        (find_profile (guesser, "PNG_LRG"),
+                                         find_profile (guesser, "JPEG_LRG")));
+        /* a small JPEG is also a large one */
+        g_assert (gupnp_dlna_profile_may_overlap
+                                        (find_profile (guesser, "JPEG_SM"),
+                                         find_profile (guesser, "JPEG_LRG")));
+
+        g_object_unref (guesser);
+}
+
+/* Guesses all the infos and returns the number of profiles tried. */
+static guint
+guess_all (GUPnPDLNAProfileGuesser  *guesser,
+           GUPnPDLNAProfile        **profiles)
+{
+        guint evaluated = 0;
+        guint iter;
+
+        for (iter = 0; iter < INFO_COUNT; ++iter) {
+                GUPnPDLNAInformation *info = new_information (iter);
+
+                profiles[iter] =
+                            gupnp_dlna_profile_guesser_guess_profile_from_info
+                                        (guesser,
+                                         info);
+                evaluated += gupnp_dlna_information_get_profiles_evaluated
+                                        (info);
+                g_object_unref (info);
+        }
+
+        return evaluated;
+}
+
+static gchar *
+new_stats_file (void)
+{
+        gchar *filename;
+        gint fd = g_file_open_tmp ("gupnp-dlna-stats-XXXXXX",
+                                   &filename,
+                                   NULL);
+
+        g_assert_cmpint (fd, >=, 0);
+        g_close (fd, NULL);
+
+        return filename;
+}
+
+static void
+ordering_same_results (void)
+{
+        GUPnPDLNAProfileGuesser *fixed = new_guesser (FALSE);
+        GUPnPDLNAProfileGuesser *adaptive = new_guesser (TRUE);
+        GUPnPDLNAProfile *expected[INFO_COUNT];
+        GUPnPDLNAProfile *results[INFO_COUNT];
+        gchar *filename = new_stats_file ();
+        guint fixed_evaluated;
+        guint adaptive_evaluated;
+        guint iter;
+
+        /* learn the hits of the fixed guesser and let the adaptive
+         * one start from them */
+        fixed_evaluated = guess_all (fixed, expected);
+        g_assert (gupnp_dlna_profile_guesser_save_stats (fixed,
+                                                         filename,
+                                                         NULL));
+        g_assert (gupnp_dlna_profile_guesser_load_stats (adaptive,
+                                                         filename,
+                                                         NULL));
+        adaptive_evaluated = guess_all (adaptive, results);
+
+        for (iter = 0; iter < INFO_COUNT; ++iter)
+                g_assert (results[iter] == expected[iter]);
+        g_assert_cmpuint (adaptive_evaluated, <, fixed_evaluated);
+
+        g_unlink (filename);
+        g_free (filename);
+        g_object_unref (adaptive);
+        g_object_unref (fixed);
+}
+
+static void
+ordering_save_load (void)
+{
+        GUPnPDLNAProfileGuesser *guesser = new_guesser (TRUE);
+        GUPnPDLNAProfileGuesser *loaded = new_guesser (TRUE);
+        GUPnPDLNAProfile *results[INFO_COUNT];
+        gchar *filename = new_stats_file ();
+        GList *iter;
+        GList *loaded_iter;
+        GError *error = NULL;
+
+        guess_all (guesser, results);
+        g_assert (gupnp_dlna_profile_guesser_save_stats (guesser,
+                                                         filename,
+                                                         &error));
+        g_assert_no_error (error);
+        g_assert (gupnp_dlna_profile_guesser_load_stats (loaded,
+                                                         filename,
+                                                         &error));
+        g_assert_no_error (error);
+
+        /* profiles sharing a name keep their own hits */
+        for (iter = gupnp_dlna_profile_guesser_list_profiles (guesser),
+             loaded_iter = gupnp_dlna_profile_guesser_list_profiles (loaded);
+             iter != NULL && loaded_iter != NULL;
+             iter = iter->next, loaded_iter = loaded_iter->next)
+                g_assert_cmpuint (gupnp_dlna_profile_guesser_get_profile_hits
+                                        (guesser,
+                                         iter->data),
+                                  ==,
+                                  gupnp_dlna_profile_guesser_get_profile_hits
+                                        (loaded,
+                                         loaded_iter->data));
+
+        g_assert (!gupnp_dlna_profile_guesser_load_stats
+                                        (loaded,
+                                         "/nonexistent/gupnp-dlna-stats",
+                                         &error));
+        g_assert (error != NULL);
+        g_clear_error (&error);
+
+        g_unlink (filename);
+        g_free (filename);
+        g_object_unref (loaded);
+        g_object_unref (guesser);
+}
+
+int
+main (int argc, char **argv)
+{
+        g_test_init (&argc, &argv, NULL);
+
+        g_test_add_func ("/guesser/ordering/overlap", ordering_overlap);
+        g_test_add_func ("/guesser/ordering/same-results",
+                         ordering_same_results);
+        g_test_add_func ("/guesser/ordering/save-load", ordering_save_load);
+
+        return g_test_run ();
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Checks that interactive guesses are not held up by a saturated
+ * queue of bulk guesses, using the slow URIs of the test backend in
+ * test-backend.c. See tests/meson.build for the environment it
+ * needs.
+ */
+
+#include <string.h>
+
+#include <gio/gio.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+
+#define TIMEOUT_IN_MS 5000
+/* see test-backend.c */
+#define SLOW_EXTRACTION_MS 100
+#define BULK_SLOTS 2
+#define BULK_COUNT 20
+#define INTERACTIVE_COUNT 2
+
+typedef struct {
+        GMainLoop *loop;
+        guint      pending;
+        guint      bulk_done;
+        guint      interactive_done;
+        /* bulk guesses done before each interactive one */
+        guint      bulk_done_before[INTERACTIVE_COUNT];
+        gint64     interactive_latency[INTERACTIVE_COUNT];
+        gint64     start;
+        gint64     bulk_end;
+} PriorityData;
+
+static void
+done_cb (GUPnPDLNAProfileGuesser *guesser G_GNUC_UNUSED,
+         GUPnPDLNAInformation    *info,
+         GUPnPDLNAProfile        *profile,
+         GError                  *error,
+         gpointer                 user_data)
+{
+        PriorityData *data = user_data;
+        gint64 now = g_get_monotonic_time ();
+
+        g_assert_no_error (error);
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (profile), ==, "MP3");
+
+        if (g_str_has_prefix (gupnp_dlna_information_get_uri (info),
+                              "file:///slow-interactive")) {
+                guint index = data->interactive_done++;
+
+                data->bulk_done_before[index] = data->bulk_done;
+                data->interactive_latency[index] = now - data->start;
+        } else if (++data->bulk_done == BULK_COUNT) {
+                data->bulk_end = now;
+        }
+        if (--data->pending == 0)
+                g_main_loop_quit (data->loop);
+}
+
+static void
+guess (GUPnPDLNAProfileGuesser *guesser,
+       const gchar             *name,
+       guint                    index,
+       GUPnPDLNAGuessPriority   priority)
+{
+        GError *error = NULL;
+        gchar *uri = g_strdup_printf ("file:///%s-%u.mp3", name, index);
+
+        g_assert_true (gupnp_dlna_profile_guesser_guess_profile_async_full
+                                        (guesser,
+                                         uri,
+                                         TIMEOUT_IN_MS,
+                                         priority,
+                                         &error));
+        g_assert_no_error (error);
+        g_free (uri);
+}
+
+static void
+test_interactive_latency (void)
+{
+        GUPnPDLNAProfileGuesser *guesser = gupnp_dlna_profile_guesser_new
+                                        (TRUE, TRUE);
+        PriorityData data;
+        guint iter;
+
+        memset (&data, 0, sizeof (data));
+        data.loop = g_main_loop_new (NULL, FALSE);
+        data.pending = BULK_COUNT + INTERACTIVE_COUNT;
+
+        g_object_set (guesser,
+                      "bulk-slots", BULK_SLOTS,
+                      "interactive-slots", 1,
+                      NULL);
+        g_signal_connect (guesser, "done", G_CALLBACK (done_cb), &data);
+
+        data.start = g_get_monotonic_time ();
+        for (iter = 0; iter < BULK_COUNT; ++iter)
+                guess (guesser,
+                       "slow-bulk",
+                       iter,
+                       GUPNP_DLNA_GUESS_PRIORITY_BULK);
+        for (iter = 0; iter < INTERACTIVE_COUNT; ++iter)
+                guess (guesser,
+                       "slow-interactive",
+                       iter,
+                       GUPNP_DLNA_GUESS_PRIORITY_INTERACTIVE);
+        g_main_loop_run (data.loop);
+
+        /* the bulk guesses kept to their slots */
+        g_assert_cmpint (data.bulk_end - data.start,
+                         >=,
+                         (BULK_COUNT / BULK_SLOTS) * SLOW_EXTRACTION_MS *
+                         G_TIME_SPAN_MILLISECOND);
+        /* while the interactive ones went ahead of the queue, one by
+         * one in the reserved slot at worst */
+        for (iter = 0; iter < INTERACTIVE_COUNT; ++iter) {
+                g_assert_cmpuint (data.bulk_done_before[iter],
+                                  <,
+                                  BULK_COUNT / 2);
+                g_assert_cmpint (data.interactive_latency[iter],
+                                 <,
+                                 (BULK_COUNT / BULK_SLOTS) *
+                                 SLOW_EXTRACTION_MS *
+                                 G_TIME_SPAN_MILLISECOND / 2);
+        }
+
+        g_main_loop_unref (data.loop);
+        g_object_unref (guesser);
+}
+
+int
+main (int argc, char **argv)
+{
+        g_test_init (&argc, &argv, NULL);
+
+        g_test_add_func ("/priority/interactive-latency",
+                         test_interactive_latency);
+
+        return g_test_run ();
+}
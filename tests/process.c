@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Runs the process metadata backend against the crashing and hanging
+ * test backend in test-backend.c. See tests/meson.build for the
+ * environment it needs.
+ */
+
+#include <string.h>
+
+#include <gio/gio.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+
+#define TIMEOUT_IN_MS 200
+#define THREAD_COUNT 4
+#define ROUNDS 8
+
+static GUPnPDLNAProfile *
+guess (const gchar  *uri,
+       GError      **error)
+{
+        GUPnPDLNAProfileGuesser *guesser = gupnp_dlna_profile_guesser_new
+                                        (TRUE, TRUE);
+        GUPnPDLNAProfile *profile;
+
+        profile = gupnp_dlna_profile_guesser_guess_profile_sync (guesser,
+                                                                 uri,
+                                                                 TIMEOUT_IN_MS,
+                                                                 NULL,
+                                                                 error);
+        g_object_unref (guesser);
+
+        return profile;
+}
+
+static void
+assert_mp3 (const gchar *uri)
+{
+        GError *error = NULL;
+        GUPnPDLNAProfile *profile = guess (uri, &error);
+
+        g_assert_no_error (error);
+        g_assert_nonnull (profile);
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (profile), ==, "MP3");
+}
+
+static void
+test_extract (void)
+{
+        assert_mp3 ("file:///test.mp3");
+}
+
+static void
+test_failure (void)
+{
+        GError *error = NULL;
+
+        g_assert_null (guess ("file:///fail.mp3", &error));
+        g_assert_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA);
+        g_assert_nonnull (strstr (error->message, "Broken file"));
+        g_clear_error (&error);
+
+        /* helper is still alive and serves the next request */
+        assert_mp3 ("file:///test.mp3");
+}
+
+static void
+test_crash (void)
+{
+        GError *error = NULL;
+
+        g_assert_null (guess ("file:///crash.mp3", &error));
+        g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED);
+        g_clear_error (&error);
+
+        assert_mp3 ("file:///test.mp3");
+}
+
+static void
+test_hang (void)
+{
+        GError *error = NULL;
+        gint64 start = g_get_monotonic_time ();
+        gint64 elapsed;
+
+        g_assert_null (guess ("file:///hang.mp3", &error));
+        elapsed = g_get_monotonic_time () - start;
+        g_assert_error (error, G_IO_ERROR, G_IO_ERROR_TIMED_OUT);
+        g_clear_error (&error);
+        /* the watchdog fires after the timeout plus the grace
+         * period, which is set to a second by tests/meson.build */
+        g_assert_cmpint (elapsed, <, 5 * G_USEC_PER_SEC);
+
+        assert_mp3 ("file:///test.mp3");
+}
+
+static gpointer
+guess_in_thread (gpointer data)
+{
+        guint index = GPOINTER_TO_UINT (data);
+        guint round;
+
+        for (round = 0; round < ROUNDS; ++round) {
+                if (index == 0 && round % 2 == 0) {
+                        GError *error = NULL;
+
+                        g_assert_null (guess ("file:///crash.mp3", &error));
+                        g_assert_nonnull (error);
+                        g_clear_error (&error);
+                } else {
+                        assert_mp3 ("file:///test.mp3");
+                }
+        }
+
+        return NULL;
+}
+
+/* Crashes in one thread do not disturb extraction in the others. */
+static void
+test_threads (void)
+{
+        GThread *threads[THREAD_COUNT];
+        guint iter;
+
+        for (iter = 0; iter < THREAD_COUNT; ++iter)
+                threads[iter] = g_thread_new ("guesser",
+                                              guess_in_thread,
+                                              GUINT_TO_POINTER (iter));
+        for (iter = 0; iter < THREAD_COUNT; ++iter)
+                g_thread_join (threads[iter]);
+}
+
+typedef struct {
+        GMainLoop *loop;
+        guint      pending;
+} AsyncData;
+
+static void
+done_cb (GUPnPDLNAProfileGuesser *guesser G_GNUC_UNUSED,
+         GUPnPDLNAInformation    *info,
+         GUPnPDLNAProfile        *profile,
+         GError                  *error,
+         gpointer                 user_data)
+{
+        AsyncData *data = user_data;
+
+        if (g_str_has_suffix (gupnp_dlna_information_get_uri (info),
+                              "crash.mp3")) {
+                g_assert_null (profile);
+                g_assert_nonnull (error);
+        } else {
+                g_assert_no_error (error);
+                g_assert_cmpstr (gupnp_dlna_profile_get_name (profile),
+                                 ==,
+                                 "MP3");
+        }
+        if (--data->pending == 0)
+                g_main_loop_quit (data->loop);
+}
+
+static void
+test_async (void)
+{
+        GUPnPDLNAProfileGuesser *guesser = gupnp_dlna_profile_guesser_new
+                                        (TRUE, TRUE);
+        AsyncData data = { g_main_loop_new (NULL, FALSE), 2 };
+        GError *error = NULL;
+
+        g_signal_connect (guesser, "done", G_CALLBACK (done_cb), &data);
+        g_assert_true (gupnp_dlna_profile_guesser_guess_profile_async
+                                        (guesser,
+                                         "file:///crash.mp3",
+                                         TIMEOUT_IN_MS,
+                                         &error));
+        g_assert_no_error (error);
+        g_assert_true (gupnp_dlna_profile_guesser_guess_profile_async
+                                        (guesser,
+                                         "file:///test.mp3",
+                                         TIMEOUT_IN_MS,
+                                         &error));
+        g_assert_no_error (error);
+        g_main_loop_run (data.loop);
+
+        g_main_loop_unref (data.loop);
+        g_object_unref (guesser);
+}
+
+int
+main (int argc, char **argv)
+{
+        g_test_init (&argc, &argv, NULL);
+
+        g_test_add_func ("/process/extract", test_extract);
+        g_test_add_func ("/process/failure", test_failure);
+        g_test_add_func ("/process/crash", test_crash);
+        g_test_add_func ("/process/hang", test_hang);
+        g_test_add_func ("/process/threads", test_threads);
+        g_test_add_func ("/process/async", test_async);
+
+        return g_test_run ();
+}
@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+#include "test-information.h"
+
+#define SCHEMA_FILE "dlna-profiles.rng"
+#define PROFILE_FILE "reload.xml"
+#define THREAD_COUNT 4
+#define RELOAD_COUNT 20
+#define MONITOR_TIMEOUT_US (10 * G_USEC_PER_SEC)
+
+/* A copy of the schema and a profile file written by the tests. */
+static gchar *profile_dir;
+
+/* RELOAD_KEPT stays the same, the other profile is renamed. */
+static void
+write_profiles (const gchar *name)
+{
+        gchar *path = g_build_filename (profile_dir, PROFILE_FILE, NULL);
+        gchar *contents = g_strdup_printf
+                ("<?xml version=\"1.0\"?>\n"
+                 "<dlna-profiles>\n"
+                 "  <dlna-profile name=\"RELOAD_KEPT\" mime=\"audio/x-kept\">\n"
+                 "    <restriction type=\"audio\">\n"
+                 "      <field name=\"name\" type=\"string\">\n"
+                 "        <value>audio/x-kept</value>\n"
+                 "      </field>\n"
+                 "    </restriction>\n"
+                 "  </dlna-profile>\n"
+                 "  <dlna-profile name=\"%s\" mime=\"audio/x-test\">\n"
+                 "    <restriction type=\"audio\">\n"
+                 "      <field name=\"name\" type=\"string\">\n"
+                 "        <value>audio/x-test</value>\n"
+                 "      </field>\n"
+                 "    </restriction>\n"
+                 "  </dlna-profile>\n"
+                 "</dlna-profiles>\n",
+                 name);
+
+        g_assert (g_file_set_contents (path, contents, -1, NULL));
+        g_free (contents);
+        g_free (path);
+}
+
+static GUPnPDLNAProfile *
+guess (GUPnPDLNAProfileGuesser *guesser,
+       const gchar             *mime)
+{
+        TestInformation *info = test_information_new ("file:///test.audio");
+        GUPnPDLNAProfile *profile;
+
+        test_information_set_string (info, TEST_STREAM_AUDIO, "mime", mime);
+        profile = gupnp_dlna_profile_guesser_guess_profile_from_info
+                                        (guesser,
+                                         GUPNP_DLNA_INFORMATION (info));
+        g_object_unref (info);
+
+        return profile;
+}
+
+static GUPnPDLNAProfileGuesser *
+new_guesser (const gchar *name)
+{
+        GUPnPDLNAProfileGuesser *guesser =
+                             gupnp_dlna_profile_guesser_new (FALSE, FALSE);
+
+        /* start every test from known profiles */
+        write_profiles (name);
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+
+        return guesser;
+}
+
+static void
+reload_manual (void)
+{
+        GUPnPDLNAProfileGuesser *guesser = new_guesser ("RELOAD_A");
+        GUPnPDLNAProfile *kept;
+        GUPnPDLNAProfile *old_profile;
+        GUPnPDLNAProfile *profile;
+
+        kept = guess (guesser, "audio/x-kept");
+        old_profile = guess (guesser, "audio/x-test");
+        g_assert (kept != NULL);
+        g_assert (old_profile != NULL);
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (old_profile),
+                         ==,
+                         "RELOAD_A");
+
+        write_profiles ("RELOAD_B");
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+
+        profile = guess (guesser, "audio/x-test");
+        g_assert (profile != NULL);
+        g_assert (profile != old_profile);
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (profile),
+                         ==,
+                         "RELOAD_B");
+        /* profiles returned before the reload are still usable */
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (old_profile),
+                         ==,
+                         "RELOAD_A");
+        g_assert_cmpuint (g_list_length
+                                (gupnp_dlna_profile_guesser_list_profiles
+                                        (guesser)),
+                          ==,
+                          2);
+
+        /* hits are carried over by name */
+        profile = gupnp_dlna_profile_guesser_get_profile (guesser,
+                                                          "RELOAD_KEPT");
+        g_assert (profile != NULL);
+        g_assert (profile != kept);
+        g_assert_cmpuint (gupnp_dlna_profile_guesser_get_profile_hits
+                                        (guesser,
+                                         profile),
+                          ==,
+                          1);
+
+        g_object_unref (guesser);
+}
+
+typedef struct {
+        GUPnPDLNAProfileGuesser *guesser;
+        gint                     stop;
+} ReloadRun;
+
+static gpointer
+guess_until_stopped (gpointer user_data)
+{
+        ReloadRun *run = user_data;
+
+        while (!g_atomic_int_get (&run->stop)) {
+                GUPnPDLNAProfile *profile = guess (run->guesser,
+                                                   "audio/x-test");
+                const gchar *name;
+
+                g_assert (profile != NULL);
+                name = gupnp_dlna_profile_get_name (profile);
+                g_assert (!g_strcmp0 (name, "RELOAD_A") ||
+                          !g_strcmp0 (name, "RELOAD_B"));
+        }
+
+        return NULL;
+}
+
+static void
+reload_in_flight (void)
+{
+        ReloadRun run;
+        GThread *threads[THREAD_COUNT];
+        guint iter;
+
+        run.guesser = new_guesser ("RELOAD_A");
+        run.stop = 0;
+        for (iter = 0; iter < THREAD_COUNT; ++iter)
+                threads[iter] = g_thread_new ("reload-guess",
+                                              guess_until_stopped,
+                                              &run);
+
+        for (iter = 0; iter < RELOAD_COUNT; ++iter) {
+                write_profiles (iter % 2 ? "RELOAD_A" : "RELOAD_B");
+                g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+        }
+
+        g_atomic_int_set (&run.stop, 1);
+        for (iter = 0; iter < THREAD_COUNT; ++iter)
+                g_thread_join (threads[iter]);
+
+        g_object_unref (run.guesser);
+}
+
+static void
+reload_and_guess (GUPnPDLNAProfileGuesser *guesser,
+                  const gchar             *name)
+{
+        write_profiles (name);
+        g_assert (gupnp_dlna_profile_guesser_reload_profiles ());
+        /* makes the guesser switch to the new profiles */
+        g_assert_cmpstr (gupnp_dlna_profile_get_name
+                                        (guess (guesser, "audio/x-test")),
+                         ==,
+                         name);
+}
+
+static void
+reload_release (void)
+{
+        GUPnPDLNAProfileGuesser *guesser = new_guesser ("RELOAD_A");
+        GUPnPDLNAProfile *released = guess (guesser, "audio/x-kept");
+        GUPnPDLNAProfile *kept = g_object_ref (guess (guesser,
+                                                      "audio/x-test"));
+        GUPnPDLNARestriction *restriction;
+        gchar *description;
+
+        g_object_add_weak_pointer (G_OBJECT (released),
+                                   (gpointer *) &released);
+
+        /* the guesser keeps the old profiles across one reload */
+        reload_and_guess (guesser, "RELOAD_B");
+        g_assert (released != NULL);
+        reload_and_guess (guesser, "RELOAD_A");
+        g_assert (released == NULL);
+
+        /* a referenced profile keeps its restrictions */
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (kept), ==, "RELOAD_A");
+        restriction = gupnp_dlna_profile_get_audio_restrictions (kept)->data;
+        description = gupnp_dlna_restriction_to_string (restriction);
+        g_assert_nonnull (strstr (description, "audio/x-test"));
+        g_free (description);
+        g_object_unref (kept);
+
+        g_object_unref (guesser);
+}
+
+static void
+reload_monitor (void)
+{
+        GUPnPDLNAProfileGuesser *guesser = new_guesser ("RELOAD_A");
+        gint64 deadline;
+
+        gupnp_dlna_profile_guesser_enable_reload ();
+        write_profiles ("RELOAD_C");
+
+        deadline = g_get_monotonic_time () + MONITOR_TIMEOUT_US;
+        while (gupnp_dlna_profile_guesser_get_profile (guesser,
+                                                       "RELOAD_C") == NULL &&
+               g_get_monotonic_time () < deadline)
+                g_usleep (G_USEC_PER_SEC / 20);
+
+        g_assert (gupnp_dlna_profile_guesser_get_profile (guesser,
+                                                          "RELOAD_C"));
+        g_assert_cmpstr (gupnp_dlna_profile_get_name
+                                        (guess (guesser, "audio/x-test")),
+                         ==,
+                         "RELOAD_C");
+
+        g_object_unref (guesser);
+}
+
+static void
+copy_schema (const gchar *source_dir)
+{
+        gchar *source = g_build_filename (source_dir, SCHEMA_FILE, NULL);
+        gchar *target = g_build_filename (profile_dir, SCHEMA_FILE, NULL);
+        gchar *contents;
+        gsize length;
+
+        g_assert (g_file_get_contents (source, &contents, &length, NULL));
+        g_assert (g_file_set_contents (target, contents, length, NULL));
+        g_free (contents);
+        g_free (target);
+        g_free (source);
+}
+
+static void
+remove_file (const gchar *name)
+{
+        gchar *path = g_build_filename (profile_dir, name, NULL);
+
+        g_unlink (path);
+        g_free (path);
+}
+
+int
+main (int argc, char **argv)
+{
+        const gchar *source_dir;
+        int result;
+
+        g_test_init (&argc, &argv, NULL);
+
+        source_dir = g_getenv ("GUPNP_DLNA_PROFILE_DIR");
+        g_assert (source_dir != NULL);
+        profile_dir = g_dir_make_tmp ("gupnp-dlna-reload-XXXXXX", NULL);
+        g_assert (profile_dir != NULL);
+        copy_schema (source_dir);
+        write_profiles ("RELOAD_A");
+        g_setenv ("GUPNP_DLNA_PROFILE_DIR", profile_dir, TRUE);
+
+        g_test_add_func ("/guesser/reload/manual", reload_manual);
+        g_test_add_func ("/guesser/reload/in-flight", reload_in_flight);
+        g_test_add_func ("/guesser/reload/release", reload_release);
+        /* leaves the profiles watched */
+        g_test_add_func ("/guesser/reload/monitor", reload_monitor);
+
+        result = g_test_run ();
+
+        gupnp_dlna_profile_guesser_cleanup ();
+        remove_file (PROFILE_FILE);
+        remove_file (SCHEMA_FILE);
+        g_rmdir (profile_dir);
+        g_free (profile_dir);
+
+        return result;
+}
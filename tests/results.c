@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Checks how the results of asynchronous guesses are passed back to
+ * the main context, using the test backend in test-backend.c. See
+ * tests/meson.build for the environment it needs.
+ */
+
+#include <string.h>
+
+#include <gio/gio.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+#include "test-information.h"
+
+#define TIMEOUT_IN_MS 200
+#define GUESS_COUNT 8
+#define BATCH_DELAY_MS 100
+/* long enough to never run out in a test */
+#define NO_DELAY_MS 600000
+
+typedef struct {
+        GMainLoop *loop;
+        GThread   *thread;
+        guint      pending;
+        guint      results;
+        guint      dispatches;
+        guint      last_source_id;
+        /* results matched in another thread than the caller's */
+        guint      matched_elsewhere;
+        gint64     start;
+        gint64     first_result;
+} ResultData;
+
+static void
+done_cb (GUPnPDLNAProfileGuesser *guesser G_GNUC_UNUSED,
+         GUPnPDLNAInformation    *info,
+         GUPnPDLNAProfile        *profile,
+         GError                  *error,
+         gpointer                 user_data)
+{
+        ResultData *data = user_data;
+        guint source_id = g_source_get_id (g_main_current_source ());
+        GThread *guess_thread = g_object_get_data
+                                        (G_OBJECT (info),
+                                         TEST_INFORMATION_GUESS_THREAD_KEY);
+
+        g_assert_no_error (error);
+        g_assert_cmpstr (gupnp_dlna_profile_get_name (profile), ==, "MP3");
+        g_assert_true (g_thread_self () == data->thread);
+
+        if (data->results++ == 0)
+                data->first_result = g_get_monotonic_time ();
+        if (guess_thread != NULL && guess_thread != data->thread)
+                ++data->matched_elsewhere;
+        /* results of a batch are delivered by the same source */
+        if (source_id != data->last_source_id) {
+                ++data->dispatches;
+                data->last_source_id = source_id;
+        }
+        if (--data->pending == 0)
+                g_main_loop_quit (data->loop);
+}
+
+static void
+run_guesses (guint       batch_size,
+             guint       batch_delay_ms,
+             guint       count,
+             ResultData *data)
+{
+        GUPnPDLNAProfileGuesser *guesser = gupnp_dlna_profile_guesser_new
+                                        (TRUE, TRUE);
+        guint iter;
+
+        memset (data, 0, sizeof (ResultData));
+        data->loop = g_main_loop_new (NULL, FALSE);
+        data->thread = g_thread_self ();
+        data->pending = count;
+
+        g_object_set (guesser,
+                      "result-batch-size", batch_size,
+                      "result-batch-delay", batch_delay_ms,
+                      NULL);
+        g_signal_connect (guesser, "done", G_CALLBACK (done_cb), data);
+        data->start = g_get_monotonic_time ();
+        for (iter = 0; iter < count; ++iter) {
+                GError *error = NULL;
+                gchar *uri = g_strdup_printf ("file:///test%u.mp3", iter);
+
+                g_assert_true (gupnp_dlna_profile_guesser_guess_profile_async
+                                        (guesser,
+                                         uri,
+                                         TIMEOUT_IN_MS,
+                                         &error));
+                g_assert_no_error (error);
+                g_free (uri);
+        }
+        g_main_loop_run (data->loop);
+
+        g_main_loop_unref (data->loop);
+        g_object_unref (guesser);
+}
+
+static void
+test_unbatched (void)
+{
+        ResultData data;
+
+        run_guesses (1, 0, GUESS_COUNT, &data);
+        g_assert_cmpuint (data.dispatches, ==, GUESS_COUNT);
+}
+
+static void
+test_full_batches (void)
+{
+        ResultData data;
+
+        run_guesses (GUESS_COUNT / 2, NO_DELAY_MS, GUESS_COUNT, &data);
+        g_assert_cmpuint (data.dispatches, ==, 2);
+}
+
+/* The batch never fills up, so the results have to arrive through
+ * the delay, maybe split up if it runs out before all are matched. */
+static void
+test_partial_batch (void)
+{
+        ResultData data;
+
+        run_guesses (GUESS_COUNT, BATCH_DELAY_MS, GUESS_COUNT - 1, &data);
+        g_assert_cmpuint (data.results, ==, GUESS_COUNT - 1);
+        g_assert_cmpuint (data.dispatches, <, data.results);
+        /* the delay starts with the first result of a batch */
+        g_assert_cmpint (data.first_result - data.start,
+                         >=,
+                         BATCH_DELAY_MS * G_TIME_SPAN_MILLISECOND);
+}
+
+/* Profiles are matched in the matching threads, only the results are
+ * passed back to the caller's thread. */
+static void
+test_matching_thread (void)
+{
+        ResultData data;
+
+        run_guesses (1, 0, GUESS_COUNT, &data);
+        g_assert_cmpuint (data.matched_elsewhere, ==, GUESS_COUNT);
+}
+
+int
+main (int argc, char **argv)
+{
+        g_test_init (&argc, &argv, NULL);
+
+        g_test_add_func ("/results/unbatched", test_unbatched);
+        g_test_add_func ("/results/full-batches", test_full_batches);
+        g_test_add_func ("/results/partial-batch", test_partial_batch);
+        g_test_add_func ("/results/matching-thread", test_matching_thread);
+
+        return g_test_run ();
+}
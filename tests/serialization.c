@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+
+#include <gio/gio.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+#include "test-information.h"
+
+static GUPnPDLNAInformation *
+video_information (void)
+{
+        TestInformation *info = test_information_new ("file:///test.ts");
+
+        test_information_set_string (info,
+                                     TEST_STREAM_CONTAINER,
+                                     "mime",
+                                     "video/mpegts");
+        test_information_set_bool (info,
+                                   TEST_STREAM_CONTAINER,
+                                   "systemstream",
+                                   TRUE);
+        test_information_set_int (info,
+                                  TEST_STREAM_CONTAINER,
+                                  "packetsize",
+                                  188);
+
+        test_information_set_string (info,
+                                     TEST_STREAM_VIDEO,
+                                     "mime",
+                                     "video/mpeg");
+        test_information_set_int (info, TEST_STREAM_VIDEO, "mpegversion", 2);
+        test_information_set_bool (info,
+                                   TEST_STREAM_VIDEO,
+                                   "systemstream",
+                                   FALSE);
+        test_information_set_int (info, TEST_STREAM_VIDEO, "width", 720);
+        test_information_set_int (info, TEST_STREAM_VIDEO, "height", 576);
+        test_information_set_fraction (info,
+                                       TEST_STREAM_VIDEO,
+                                       "framerate",
+                                       25,
+                                       1);
+        test_information_set_unsupported (info,
+                                          TEST_STREAM_VIDEO,
+                                          "profile");
+
+        test_information_set_string (info,
+                                     TEST_STREAM_AUDIO,
+                                     "mime",
+                                     "audio/mpeg");
+        test_information_set_int (info, TEST_STREAM_AUDIO, "mpegversion", 1);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "layer", 2);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "channels", 2);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "rate", 48000);
+        test_information_set_string (info,
+                                     TEST_STREAM_AUDIO,
+                                     "stream-format",
+                                     "raw");
+
+        return GUPNP_DLNA_INFORMATION (info);
+}
+
+static GUPnPDLNAInformation *
+round_trip (GUPnPDLNAInformation  *info,
+            const gchar           *profile_name,
+            gchar                **stored_name)
+{
+        GBytes *bytes = gupnp_dlna_information_serialize (info,
+                                                          profile_name);
+        GUPnPDLNAInformation *copy;
+        GError *error = NULL;
+
+        g_assert (bytes != NULL);
+        copy = gupnp_dlna_information_deserialize (bytes,
+                                                   stored_name,
+                                                   &error);
+        g_assert_no_error (error);
+        g_assert (copy != NULL);
+        g_bytes_unref (bytes);
+
+        return copy;
+}
+
+static void
+serialization_values (void)
+{
+        GUPnPDLNAInformation *info = video_information ();
+        GUPnPDLNAInformation *copy;
+        GUPnPDLNAVideoInformation *video_info;
+        GUPnPDLNAAudioInformation *audio_info;
+        GUPnPDLNAContainerInformation *container_info;
+        GUPnPDLNAFractionValue framerate;
+        GUPnPDLNAConstStringValue string;
+        GUPnPDLNAIntValue integer;
+        GUPnPDLNABoolValue boolean;
+        gchar *profile_name = NULL;
+
+        copy = round_trip (info, "MPEG_TS_SD_EU_ISO", &profile_name);
+
+        g_assert_cmpstr (profile_name, ==, "MPEG_TS_SD_EU_ISO");
+        g_assert_cmpstr (gupnp_dlna_information_get_uri (copy),
+                         ==,
+                         "file:///test.ts");
+        g_assert (gupnp_dlna_information_get_profile_name (copy) == NULL);
+        g_assert (gupnp_dlna_information_get_image_information (copy) ==
+                  NULL);
+
+        video_info = gupnp_dlna_information_get_video_information (copy);
+        g_assert (video_info != NULL);
+        string = gupnp_dlna_video_information_peek_mime (video_info);
+        g_assert_cmpint (string.state, ==, GUPNP_DLNA_VALUE_STATE_SET);
+        g_assert_cmpstr (string.value, ==, "video/mpeg");
+        integer = gupnp_dlna_video_information_get_width (video_info);
+        g_assert_cmpint (integer.state, ==, GUPNP_DLNA_VALUE_STATE_SET);
+        g_assert_cmpint (integer.value, ==, 720);
+        framerate = gupnp_dlna_video_information_get_framerate (video_info);
+        g_assert_cmpint (framerate.state, ==, GUPNP_DLNA_VALUE_STATE_SET);
+        g_assert_cmpint (framerate.numerator, ==, 25);
+        g_assert_cmpint (framerate.denominator, ==, 1);
+        boolean = gupnp_dlna_video_information_is_system_stream (video_info);
+        g_assert_cmpint (boolean.state, ==, GUPNP_DLNA_VALUE_STATE_SET);
+        g_assert (!boolean.value);
+        string = gupnp_dlna_video_information_peek_profile (video_info);
+        g_assert_cmpint (string.state,
+                         ==,
+                         GUPNP_DLNA_VALUE_STATE_UNSUPPORTED);
+        string = gupnp_dlna_video_information_peek_level (video_info);
+        g_assert_cmpint (string.state, ==, GUPNP_DLNA_VALUE_STATE_UNSET);
+
+        audio_info = gupnp_dlna_information_get_audio_information (copy);
+        g_assert (audio_info != NULL);
+        string = gupnp_dlna_audio_information_peek_stream_format (audio_info);
+        g_assert_cmpstr (string.value, ==, "raw");
+
+        container_info =
+                      gupnp_dlna_information_get_container_information (copy);
+        g_assert (container_info != NULL);
+        integer = gupnp_dlna_container_information_get_packet_size
+                                        (container_info);
+        g_assert_cmpint (integer.value, ==, 188);
+
+        g_free (profile_name);
+        g_object_unref (copy);
+        g_object_unref (info);
+}
+
+static void
+serialization_guess (void)
+{
+        GUPnPDLNAProfileGuesser *guesser;
+        GUPnPDLNAInformation *info = video_information ();
+        GUPnPDLNAInformation *copy;
+        GUPnPDLNAProfile *expected;
+        GUPnPDLNAProfile *profile;
+
+        guesser = gupnp_dlna_profile_guesser_new (TRUE, TRUE);
+        expected = gupnp_dlna_profile_guesser_guess_profile_from_info (guesser,
+                                                                       info);
+        copy = round_trip (info, NULL, NULL);
+        profile = gupnp_dlna_profile_guesser_guess_profile_from_info (guesser,
+                                                                      copy);
+        g_assert (profile == expected);
+
+        g_object_unref (copy);
+        g_object_unref (info);
+        g_object_unref (guesser);
+}
+
+static void
+serialization_invalid (void)
+{
+        GUPnPDLNAInformation *info = video_information ();
+        GBytes *bytes = gupnp_dlna_information_serialize (info, NULL);
+        GBytes *broken;
+        guint8 *data;
+        gsize size;
+        GError *error = NULL;
+
+        /* the version comes first */
+        data = g_bytes_unref_to_data (bytes, &size);
+        data[0] ^= 0xff;
+        broken = g_bytes_new_take (data, size);
+        g_assert (gupnp_dlna_information_deserialize (broken,
+                                                      NULL,
+                                                      &error) == NULL);
+        g_assert_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED);
+        g_clear_error (&error);
+        g_bytes_unref (broken);
+
+        broken = g_bytes_new_static ("garbage", 7);
+        g_assert (gupnp_dlna_information_deserialize (broken,
+                                                      NULL,
+                                                      &error) == NULL);
+        g_assert (error != NULL);
+        g_clear_error (&error);
+        g_bytes_unref (broken);
+
+        g_object_unref (info);
+}
+
+int
+main (int argc, char **argv)
+{
+        g_test_init (&argc, &argv, NULL);
+
+        g_test_add_func ("/serialization/values", serialization_values);
+        g_test_add_func ("/serialization/guess", serialization_guess);
+        g_test_add_func ("/serialization/invalid", serialization_invalid);
+
+        g_test_run ();
+
+        return 0;
+}
@@ -21,6 +21,7 @@
 
 #include <glib.h>
 
+#include "gupnp-dlna-arena.h"
 #include "gupnp-dlna-value-type.h"
 #include "gupnp-dlna-value-list-private.h"
 #include "gupnp-dlna-restriction-private.h"
@@ -250,7 +251,87 @@ restriction_adding_value_lists (void)
 static void
 restriction_merge (void)
 {
-        /* TODO: Write a test. */
+        GUPnPDLNARestriction *parent = gupnp_dlna_restriction_new ("mime");
+        GUPnPDLNARestriction *child = gupnp_dlna_restriction_new (NULL);
+        GUPnPDLNARestriction *other = gupnp_dlna_restriction_new (NULL);
+        GUPnPDLNAValueList *list;
+        GHashTable *entries;
+
+        list = gupnp_dlna_value_list_new (gupnp_dlna_value_type_int ());
+        gupnp_dlna_value_list_add_single (list, "42");
+        g_assert (gupnp_dlna_restriction_add_value_list (parent, "i", list));
+        list = gupnp_dlna_value_list_new (gupnp_dlna_value_type_bool ());
+        gupnp_dlna_value_list_add_single (list, "true");
+        g_assert (gupnp_dlna_restriction_add_value_list (parent, "b", list));
+        list = gupnp_dlna_value_list_new (gupnp_dlna_value_type_bool ());
+        gupnp_dlna_value_list_add_single (list, "false");
+        g_assert (gupnp_dlna_restriction_add_value_list (child, "b", list));
+
+        /* merging consumes a reference, so parent can be merged twice */
+        gupnp_dlna_restriction_merge (child,
+                                      gupnp_dlna_restriction_ref (parent));
+        gupnp_dlna_restriction_merge (other,
+                                      gupnp_dlna_restriction_ref (parent));
+
+        g_assert_cmpstr (gupnp_dlna_restriction_get_mime (child), ==, "mime");
+        entries = gupnp_dlna_restriction_get_entries (child);
+        g_assert_cmpuint (g_hash_table_size (entries), ==, 2);
+        /* child's own entries override parent's */
+        g_assert (g_hash_table_lookup (entries, "b") == list);
+        /* inherited value lists are shared, not copied */
+        g_assert (g_hash_table_lookup (entries, "i") ==
+                  g_hash_table_lookup
+                          (gupnp_dlna_restriction_get_entries (parent), "i"));
+        g_assert (g_hash_table_lookup (entries, "i") ==
+                  g_hash_table_lookup
+                           (gupnp_dlna_restriction_get_entries (other), "i"));
+
+        /* copies are cheap and share the contents */
+        g_assert (gupnp_dlna_restriction_copy (parent) == parent);
+        gupnp_dlna_restriction_free (parent);
+
+        gupnp_dlna_restriction_free (parent);
+        entries = gupnp_dlna_restriction_get_entries (other);
+        g_assert_cmpuint (g_hash_table_size (entries), ==, 2);
+        gupnp_dlna_restriction_free (other);
+        gupnp_dlna_restriction_free (child);
+}
+
+static void
+restriction_arena (void)
+{
+        GUPnPDLNAArena *arena = gupnp_dlna_arena_new (0);
+        GUPnPDLNARestriction *r = gupnp_dlna_restriction_new_in_arena ("mime",
+                                                                       arena);
+        GUPnPDLNARestriction *copy;
+        GUPnPDLNAValueList *list;
+        gchar *str;
+
+        list = gupnp_dlna_value_list_new_in_arena
+                                        (gupnp_dlna_value_type_string (),
+                                         arena);
+        g_assert (gupnp_dlna_value_list_add_single (list, "bbb"));
+        g_assert (gupnp_dlna_value_list_add_single (list, "aaa"));
+        g_assert (gupnp_dlna_value_list_add_single (list, "ccc"));
+        g_assert (gupnp_dlna_value_list_add_single (list, "abc"));
+        g_assert (gupnp_dlna_value_list_add_range (list, "ccc", "ddd") ==
+                  FALSE);
+        g_assert (gupnp_dlna_restriction_add_value_list (r, "s", list));
+        g_assert_cmpuint (gupnp_dlna_arena_get_used (arena), >, 0);
+
+        /* references to arena-backed restrictions are no-ops */
+        g_assert (gupnp_dlna_restriction_ref (r) == r);
+        gupnp_dlna_restriction_unref (r);
+
+        /* but copies end up on the heap and outlive the arena */
+        copy = gupnp_dlna_restriction_copy (r);
+        g_assert (copy != r);
+        gupnp_dlna_arena_free (arena);
+
+        str = gupnp_dlna_restriction_to_string (copy);
+        g_assert_cmpstr (str, ==, "mime, s=(string){ aaa, abc, bbb, ccc }");
+        g_free (str);
+        gupnp_dlna_restriction_free (copy);
 }
 
 static void
@@ -393,6 +474,154 @@ info_set_fit (void)
         gupnp_dlna_restriction_free (r);
 }
 
+static void
+info_set_fit_ordered (void)
+{
+        GUPnPDLNARestriction *r = gupnp_dlna_restriction_new ("mime");
+        GUPnPDLNAValueList *v;
+        GUPnPDLNAInfoSet *s;
+        GUPnPDLNARestrictionField *fields;
+        guint count;
+        guint comparisons = 0;
+        gboolean unsupported;
+
+        v = gupnp_dlna_value_list_new (gupnp_dlna_value_type_bool ());
+        g_assert (gupnp_dlna_value_list_add_single (v, "true"));
+        g_assert (gupnp_dlna_restriction_add_value_list (r, "b", v));
+        v = gupnp_dlna_value_list_new (gupnp_dlna_value_type_int ());
+        g_assert (gupnp_dlna_value_list_add_range (v, "1", "100"));
+        g_assert (gupnp_dlna_restriction_add_value_list (r, "i1", v));
+        v = gupnp_dlna_value_list_new (gupnp_dlna_value_type_int ());
+        g_assert (gupnp_dlna_value_list_add_single (v, "7"));
+        g_assert (gupnp_dlna_restriction_add_value_list (r, "i2", v));
+
+        g_assert (gupnp_dlna_restriction_get_ordered_fields (r,
+                                                             &count) == NULL);
+        gupnp_dlna_restriction_order_fields (r);
+        fields = gupnp_dlna_restriction_get_ordered_fields (r, &count);
+        g_assert (fields != NULL);
+        g_assert_cmpuint (count, ==, 3);
+        g_assert_cmpstr (fields[0].name, ==, "i2");
+        g_assert_cmpstr (fields[1].name, ==, "i1");
+        g_assert_cmpstr (fields[2].name, ==, "b");
+
+        s = gupnp_dlna_info_set_new ("mime");
+        g_assert (gupnp_dlna_info_set_add_bool (s, "b", TRUE));
+        g_assert (gupnp_dlna_info_set_add_int (s, "i1", 50));
+        g_assert (gupnp_dlna_info_set_add_int (s, "i2", 8));
+
+        /* the most selective field rejects the set right away */
+        g_assert (!gupnp_dlna_info_set_fits_restriction_full (s,
+                                                              r,
+                                                              &unsupported,
+                                                              &comparisons));
+        g_assert_cmpuint (comparisons, ==, 2);
+        gupnp_dlna_info_set_free (s);
+
+        s = gupnp_dlna_info_set_new ("mime");
+        g_assert (gupnp_dlna_info_set_add_bool (s, "b", TRUE));
+        g_assert (gupnp_dlna_info_set_add_int (s, "i1", 50));
+        g_assert (gupnp_dlna_info_set_add_int (s, "i2", 7));
+
+        comparisons = 0;
+        g_assert (gupnp_dlna_info_set_fits_restriction_full (s,
+                                                             r,
+                                                             &unsupported,
+                                                             &comparisons));
+        g_assert (!unsupported);
+        g_assert_cmpuint (comparisons, ==, 4);
+
+        gupnp_dlna_info_set_free (s);
+        gupnp_dlna_restriction_free (r);
+}
+
+static void
+fetch_counted (GUPnPDLNAInfoSet *info_set,
+               const gchar      *name,
+               gpointer          user_data)
+{
+        guint *fetches = user_data;
+
+        ++*fetches;
+        if (!g_strcmp0 (name, "i"))
+                g_assert (gupnp_dlna_info_set_add_int (info_set, name, 50));
+}
+
+static void
+info_set_lazy (void)
+{
+        GUPnPDLNARestriction *r = gupnp_dlna_restriction_new ("mime");
+        GUPnPDLNARestriction *other = gupnp_dlna_restriction_new ("other");
+        GUPnPDLNAValueList *v = gupnp_dlna_value_list_new
+                                           (gupnp_dlna_value_type_int());
+        GUPnPDLNAInfoSet *s;
+        guint fetches = 0;
+
+        g_assert (gupnp_dlna_value_list_add_range (v, "42", "55"));
+        g_assert (gupnp_dlna_restriction_add_value_list (r, "i", v));
+        v = gupnp_dlna_value_list_new (gupnp_dlna_value_type_int());
+        g_assert (gupnp_dlna_value_list_add_single (v, "50"));
+        g_assert (gupnp_dlna_restriction_add_value_list (other, "i", v));
+
+        s = gupnp_dlna_info_set_new_lazy ("mime",
+                                          NULL,
+                                          fetch_counted,
+                                          &fetches);
+
+        /* different mime, nothing is fetched */
+        g_assert (!gupnp_dlna_info_set_fits_restriction (s, other));
+        g_assert_cmpuint (fetches, ==, 0);
+
+        /* fields are fetched once */
+        g_assert (gupnp_dlna_info_set_fits_restriction (s, r));
+        g_assert (gupnp_dlna_info_set_fits_restriction (s, r));
+        g_assert_cmpuint (fetches, ==, 1);
+
+        /* so are the ones without a value */
+        gupnp_dlna_info_set_fetch (s, "missing");
+        gupnp_dlna_info_set_fetch (s, "missing");
+        g_assert_cmpuint (fetches, ==, 2);
+
+        gupnp_dlna_info_set_free (s);
+        gupnp_dlna_restriction_free (other);
+        gupnp_dlna_restriction_free (r);
+}
+
+static void
+info_set_arena (void)
+{
+        GUPnPDLNAArena *arena = gupnp_dlna_arena_new (0);
+        GUPnPDLNARestriction *r = gupnp_dlna_restriction_new ("mime");
+        GUPnPDLNAValueList *v = gupnp_dlna_value_list_new
+                                           (gupnp_dlna_value_type_int());
+        GUPnPDLNAInfoSet *s = gupnp_dlna_info_set_new_in_arena ("mime",
+                                                               arena);
+        gchar *str;
+
+        g_assert (gupnp_dlna_value_list_add_range (v, "42", "55"));
+        g_assert (gupnp_dlna_restriction_add_value_list (r, "i", v));
+
+        g_assert (s != NULL);
+        g_assert (gupnp_dlna_info_set_add_bool (s, "b", TRUE));
+        g_assert (!gupnp_dlna_info_set_add_fraction (s, "f", 1, 0));
+        g_assert (gupnp_dlna_info_set_add_int (s, "i", 50));
+        g_assert (gupnp_dlna_info_set_add_string (s, "s", "str"));
+        g_assert (!gupnp_dlna_info_set_add_int (s, "i", 13));
+        g_assert (gupnp_dlna_info_set_fits_restriction (s, r));
+
+        /* entries keep insertion order */
+        str = gupnp_dlna_info_set_to_string (s);
+        g_assert_cmpstr (str,
+                         ==,
+                         "mime, b=(boolean)true, i=(int)50, s=(string)str");
+        g_free (str);
+
+        /* no-op, the set goes away with the arena */
+        gupnp_dlna_info_set_free (s);
+        gupnp_dlna_arena_free (arena);
+        gupnp_dlna_restriction_free (r);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -406,8 +635,12 @@ main (int argc, char **argv)
         g_test_add_func ("/restriction/adding-value-lists",
                          restriction_adding_value_lists);
         g_test_add_func ("/restriction/merge", restriction_merge);
+        g_test_add_func ("/restriction/arena", restriction_arena);
         g_test_add_func ("/info-set/adding-values", info_set_adding_values);
         g_test_add_func ("/info-set/fit", info_set_fit);
+        g_test_add_func ("/info-set/fit-ordered", info_set_fit_ordered);
+        g_test_add_func ("/info-set/arena", info_set_arena);
+        g_test_add_func ("/info-set/lazy", info_set_lazy);
 
         g_test_run ();
 
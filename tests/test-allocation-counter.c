@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <stdlib.h>
+
+#include "test-allocation-counter.h"
+
+static gboolean counting = FALSE;
+static guint allocations = 0;
+
+#ifdef TEST_COUNT_ALLOCATIONS
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb,
+                            size_t size);
+extern void *__libc_realloc (void   *ptr,
+                             size_t  size);
+
+void *
+malloc (size_t size)
+{
+        if (counting)
+                ++allocations;
+
+        return __libc_malloc (size);
+}
+
+void *
+calloc (size_t nmemb,
+        size_t size)
+{
+        if (counting)
+                ++allocations;
+
+        return __libc_calloc (nmemb, size);
+}
+
+void *
+realloc (void   *ptr,
+         size_t  size)
+{
+        if (counting)
+                ++allocations;
+
+        return __libc_realloc (ptr, size);
+}
+#endif
+
+void
+test_allocation_counter_start (void)
+{
+        allocations = 0;
+        counting = TRUE;
+}
+
+guint
+test_allocation_counter_stop (void)
+{
+        counting = FALSE;
+
+        return allocations;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __TEST_ALLOCATION_COUNTER_H__
+#define __TEST_ALLOCATION_COUNTER_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Heap allocations are counted by interposing malloc and friends,
+ * which needs glibc and does not mix with sanitizers replacing the
+ * allocator themselves. Profile guessing prints a debug message for
+ * every tried profile if debugging is enabled, so the count is
+ * meaningful only when GLib can tell us that the message is going to
+ * be dropped anyway.
+ */
+#if defined (__GLIBC__) && !defined (__SANITIZE_ADDRESS__) &&   \
+        GLIB_CHECK_VERSION (2, 68, 0)
+#define TEST_COUNT_ALLOCATIONS 1
+#endif
+
+/* Starts counting allocations done by the calling thread. */
+void
+test_allocation_counter_start (void);
+
+/* Stops counting and returns the number of allocations done since
+ * the last test_allocation_counter_start(). */
+guint
+test_allocation_counter_stop (void);
+
+G_END_DECLS
+
+#endif /* __TEST_ALLOCATION_COUNTER_H__ */
@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* A metadata backend for tests. Every URI is described as an MP3
+ * file, except that URIs containing "crash" make the extractor
+ * abort, URIs containing "hang" make it never return and URIs
+ * containing "fail" make it report an error. URIs containing "partial"
+ * report a container no profile accepts as progress and fail unless
+ * the extraction is stopped there. URIs containing "slow" take a
+ * while to extract. Asynchronous extraction runs the synchronous one
+ * in a thread.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gio/gio.h>
+#include <gmodule.h>
+
+#include <libgupnp-dlna/metadata/gupnp-dlna-metadata-extractor.h>
+#include "test-information.h"
+
+#define SLOW_EXTRACTION_MS 100
+
+typedef GUPnPDLNAMetadataExtractor TestExtractor;
+typedef GUPnPDLNAMetadataExtractorClass TestExtractorClass;
+
+G_DEFINE_TYPE (TestExtractor,
+               test_extractor,
+               GUPNP_TYPE_DLNA_METADATA_EXTRACTOR)
+
+static GUPnPDLNAInformation *
+mp3_information (const gchar *uri)
+{
+        TestInformation *info = test_information_new (uri);
+
+        test_information_set_string (info,
+                                     TEST_STREAM_AUDIO,
+                                     "mime",
+                                     "audio/mpeg");
+        test_information_set_int (info, TEST_STREAM_AUDIO, "mpegversion", 1);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "layer", 3);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "channels", 2);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "rate", 44100);
+        test_information_set_int (info,
+                                  TEST_STREAM_AUDIO,
+                                  "bitrate",
+                                  128000);
+
+        return GUPNP_DLNA_INFORMATION (info);
+}
+
+static GUPnPDLNAInformation *
+partial_information (const gchar *uri)
+{
+        TestInformation *info = test_information_new (uri);
+
+        test_information_set_string (info,
+                                     TEST_STREAM_CONTAINER,
+                                     "mime",
+                                     "application/x-test-partial");
+
+        return GUPNP_DLNA_INFORMATION (info);
+}
+
+static GUPnPDLNAInformation *
+test_extract_sync (GUPnPDLNAMetadataExtractor  *extractor,
+                   const gchar                 *uri,
+                   guint                        timeout_in_ms G_GNUC_UNUSED,
+                   GError                     **error)
+{
+        if (strstr (uri, "crash") != NULL)
+                abort ();
+        if (strstr (uri, "hang") != NULL)
+                for (;;)
+                        g_usleep (G_USEC_PER_SEC);
+        if (strstr (uri, "slow") != NULL)
+                g_usleep (SLOW_EXTRACTION_MS * G_TIME_SPAN_MILLISECOND);
+        if (strstr (uri, "fail") != NULL) {
+                g_set_error (error,
+                             G_IO_ERROR,
+                             G_IO_ERROR_INVALID_DATA,
+                             "Broken file '%s'",
+                             uri);
+
+                return NULL;
+        }
+        if (strstr (uri, "partial") != NULL) {
+                GUPnPDLNAInformation *info = partial_information (uri);
+
+                if (gupnp_dlna_metadata_extractor_emit_progress (extractor,
+                                                                 info))
+                        return info;
+                g_object_unref (info);
+                g_set_error (error,
+                             G_IO_ERROR,
+                             G_IO_ERROR_FAILED,
+                             "Extraction of '%s' was not stopped",
+                             uri);
+
+                return NULL;
+        } else {
+                GUPnPDLNAInformation *info = mp3_information (uri);
+
+                /* the audio stream is complete, but a video stream
+                 * could still follow, so this must not stop us */
+                if (gupnp_dlna_metadata_extractor_emit_progress (extractor,
+                                                                 info)) {
+                        g_object_unref (info);
+                        g_set_error (error,
+                                     G_IO_ERROR,
+                                     G_IO_ERROR_FAILED,
+                                     "Extraction of '%s' was stopped",
+                                     uri);
+
+                        return NULL;
+                }
+
+                return info;
+        }
+}
+
+typedef struct {
+        gchar *uri;
+        guint  timeout_in_ms;
+} TestAsyncData;
+
+static void
+test_async_data_free (TestAsyncData *data)
+{
+        g_free (data->uri);
+        g_slice_free (TestAsyncData, data);
+}
+
+static void
+extract_in_thread (GTask        *task,
+                   gpointer      source_object,
+                   gpointer      task_data,
+                   GCancellable *cancellable G_GNUC_UNUSED)
+{
+        TestAsyncData *data = task_data;
+        GError *error = NULL;
+        GUPnPDLNAInformation *info = test_extract_sync
+                                        (GUPNP_DLNA_METADATA_EXTRACTOR
+                                        (source_object),
+                                         data->uri,
+                                         data->timeout_in_ms,
+                                         &error);
+
+        if (error != NULL)
+                g_task_return_error (task, error);
+        else
+                g_task_return_pointer (task, info, g_object_unref);
+}
+
+static void
+extract_done (GObject      *source_object,
+              GAsyncResult *result,
+              gpointer      user_data G_GNUC_UNUSED)
+{
+        TestAsyncData *data = g_task_get_task_data (G_TASK (result));
+        GError *error = NULL;
+        GUPnPDLNAInformation *info = g_task_propagate_pointer (G_TASK (result),
+                                                               &error);
+
+        if (info == NULL)
+                info = GUPNP_DLNA_INFORMATION (test_information_new
+                                        (data->uri));
+        gupnp_dlna_metadata_extractor_emit_done
+                                        (GUPNP_DLNA_METADATA_EXTRACTOR
+                                        (source_object),
+                                         info,
+                                         error);
+        g_object_unref (info);
+        g_clear_error (&error);
+}
+
+static gboolean
+test_extract_async (GUPnPDLNAMetadataExtractor  *extractor,
+                    const gchar                 *uri,
+                    guint                        timeout_in_ms,
+                    GError                     **error G_GNUC_UNUSED)
+{
+        TestAsyncData *data = g_slice_new (TestAsyncData);
+        GTask *task = g_task_new (extractor, NULL, extract_done, NULL);
+
+        data->uri = g_strdup (uri);
+        data->timeout_in_ms = timeout_in_ms;
+        g_task_set_task_data (task,
+                              data,
+                              (GDestroyNotify) test_async_data_free);
+        g_task_run_in_thread (task, extract_in_thread);
+        g_object_unref (task);
+
+        return TRUE;
+}
+
+static void
+test_extractor_class_init (TestExtractorClass *extractor_class)
+{
+        extractor_class->extract_async = test_extract_async;
+        extractor_class->extract_sync = test_extract_sync;
+}
+
+static void
+test_extractor_init (TestExtractor *self G_GNUC_UNUSED)
+{
+}
+
+G_MODULE_EXPORT GUPnPDLNAMetadataExtractor *
+gupnp_dlna_get_default_extractor (void)
+{
+        return g_object_new (test_extractor_get_type (), NULL);
+}
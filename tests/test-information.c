@@ -0,0 +1,479 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "test-information.h"
+#include "gupnp-dlna-audio-information.h"
+#include "gupnp-dlna-container-information.h"
+#include "gupnp-dlna-image-information.h"
+#include "gupnp-dlna-video-information.h"
+
+typedef enum {
+        TEST_FIELD_BOOL,
+        TEST_FIELD_FRACTION,
+        TEST_FIELD_INT,
+        TEST_FIELD_STRING,
+        TEST_FIELD_UNSUPPORTED
+} TestFieldType;
+
+typedef struct {
+        TestFieldType  type;
+        gint           first;
+        gint           second;
+        gchar         *string;
+} TestField;
+
+static void
+test_field_free (TestField *field)
+{
+        g_free (field->string);
+        g_slice_free (TestField, field);
+}
+
+static GUPnPDLNABoolValue
+get_bool (GHashTable  *fields,
+          const gchar *name)
+{
+        TestField *field = g_hash_table_lookup (fields, name);
+        GUPnPDLNABoolValue value = GUPNP_DLNA_BOOL_VALUE_UNSET;
+
+        if (field == NULL)
+                return value;
+        if (field->type == TEST_FIELD_UNSUPPORTED)
+                return GUPNP_DLNA_BOOL_VALUE_UNSUPPORTED;
+        g_assert_cmpint (field->type, ==, TEST_FIELD_BOOL);
+        value.value = field->first;
+        value.state = GUPNP_DLNA_VALUE_STATE_SET;
+
+        return value;
+}
+
+static GUPnPDLNAFractionValue
+get_fraction (GHashTable  *fields,
+              const gchar *name)
+{
+        TestField *field = g_hash_table_lookup (fields, name);
+        GUPnPDLNAFractionValue value = GUPNP_DLNA_FRACTION_VALUE_UNSET;
+
+        if (field == NULL)
+                return value;
+        if (field->type == TEST_FIELD_UNSUPPORTED)
+                return GUPNP_DLNA_FRACTION_VALUE_UNSUPPORTED;
+        g_assert_cmpint (field->type, ==, TEST_FIELD_FRACTION);
+        value.numerator = field->first;
+        value.denominator = field->second;
+        value.state = GUPNP_DLNA_VALUE_STATE_SET;
+
+        return value;
+}
+
+static GUPnPDLNAIntValue
+get_int (GHashTable  *fields,
+         const gchar *name)
+{
+        TestField *field = g_hash_table_lookup (fields, name);
+        GUPnPDLNAIntValue value = GUPNP_DLNA_INT_VALUE_UNSET;
+
+        if (field == NULL)
+                return value;
+        if (field->type == TEST_FIELD_UNSUPPORTED)
+                return GUPNP_DLNA_INT_VALUE_UNSUPPORTED;
+        g_assert_cmpint (field->type, ==, TEST_FIELD_INT);
+        value.value = field->first;
+        value.state = GUPNP_DLNA_VALUE_STATE_SET;
+
+        return value;
+}
+
+static GUPnPDLNAStringValue
+get_string (GHashTable  *fields,
+            const gchar *name)
+{
+        TestField *field = g_hash_table_lookup (fields, name);
+        GUPnPDLNAStringValue value = GUPNP_DLNA_STRING_VALUE_UNSET;
+
+        if (field == NULL)
+                return value;
+        if (field->type == TEST_FIELD_UNSUPPORTED)
+                return GUPNP_DLNA_STRING_VALUE_UNSUPPORTED;
+        g_assert_cmpint (field->type, ==, TEST_FIELD_STRING);
+        value.value = g_strdup (field->string);
+        value.state = GUPNP_DLNA_VALUE_STATE_SET;
+
+        return value;
+}
+
+/* Stream information classes. All of them just look up values in the
+ * field table of their stream. */
+
+#define TEST_DEFINE_STREAM_TYPE(Name, name, NAME, PARENT_TYPE)                \
+        typedef struct {                                                \
+                GUPnPDLNA##Name##Information parent;                    \
+                GHashTable *fields;                                     \
+        } Test##Name##Information;                                      \
+                                                                        \
+        typedef struct {                                                \
+                GUPnPDLNA##Name##InformationClass parent_class;         \
+        } Test##Name##InformationClass;                                 \
+                                                                        \
+        GType test_##name##_information_get_type (void);                \
+                                                                        \
+        G_DEFINE_TYPE (Test##Name##Information,                         \
+                       test_##name##_information,                       \
+                       PARENT_TYPE)                                     \
+                                                                        \
+        static void                                                     \
+        test_##name##_information_init (Test##Name##Information *info)  \
+        {                                                               \
+        }                                                               \
+                                                                        \
+        static void                                                     \
+        test_##name##_information_finalize (GObject *object)            \
+        {                                                               \
+                Test##Name##Information *info =                         \
+                                (Test##Name##Information *) object;     \
+                                                                        \
+                g_hash_table_unref (info->fields);                      \
+                G_OBJECT_CLASS                                          \
+                        (test_##name##_information_parent_class)->      \
+                                                finalize (object);      \
+        }                                                               \
+                                                                        \
+        static GHashTable *                                             \
+        name##_fields (GUPnPDLNA##Name##Information *info)              \
+        {                                                               \
+                return ((Test##Name##Information *) info)->fields;      \
+        }                                                               \
+                                                                        \
+        static GUPnPDLNA##Name##Information *                           \
+        test_##name##_information_new (GHashTable *fields)              \
+        {                                                               \
+                Test##Name##Information *info;                          \
+                                                                        \
+                if (fields == NULL)                                     \
+                        return NULL;                                    \
+                info = g_object_new (test_##name##_information_get_type \
+                                                                (),     \
+                                     NULL);                             \
+                info->fields = g_hash_table_ref (fields);               \
+                                                                        \
+                return GUPNP_DLNA_##NAME##_INFORMATION (info);          \
+        }
+
+#define TEST_GETTER(name, Name, Type, vfunc, getter, field)             \
+        static GUPnPDLNA##Type##Value                                   \
+        name##_##vfunc (GUPnPDLNA##Name##Information *info)             \
+        {                                                               \
+                return getter (name##_fields (info), field);            \
+        }
+
+TEST_DEFINE_STREAM_TYPE (Audio, audio, AUDIO, GUPNP_TYPE_DLNA_AUDIO_INFORMATION)
+TEST_GETTER (audio, Audio, Int, get_bitrate, get_int, "bitrate")
+TEST_GETTER (audio, Audio, Int, get_channels, get_int, "channels")
+TEST_GETTER (audio, Audio, Int, get_depth, get_int, "depth")
+TEST_GETTER (audio, Audio, Int, get_layer, get_int, "layer")
+TEST_GETTER (audio, Audio, String, get_level, get_string, "level")
+TEST_GETTER (audio, Audio, Int, get_mpeg_audio_version, get_int,
+             "mpegaudioversion")
+TEST_GETTER (audio, Audio, Int, get_mpeg_version, get_int, "mpegversion")
+TEST_GETTER (audio, Audio, String, get_profile, get_string, "profile")
+TEST_GETTER (audio, Audio, Int, get_rate, get_int, "rate")
+TEST_GETTER (audio, Audio, String, get_stream_format, get_string,
+             "stream-format")
+TEST_GETTER (audio, Audio, Int, get_wma_version, get_int, "wmaversion")
+TEST_GETTER (audio, Audio, String, get_mime, get_string, "mime")
+
+static void
+test_audio_information_class_init (TestAudioInformationClass *test_class)
+{
+        GUPnPDLNAAudioInformationClass *info_class =
+                            GUPNP_DLNA_AUDIO_INFORMATION_CLASS (test_class);
+
+        G_OBJECT_CLASS (test_class)->finalize =
+                                        test_audio_information_finalize;
+        info_class->get_bitrate = audio_get_bitrate;
+        info_class->get_channels = audio_get_channels;
+        info_class->get_depth = audio_get_depth;
+        info_class->get_layer = audio_get_layer;
+        info_class->get_level = audio_get_level;
+        info_class->get_mpeg_audio_version = audio_get_mpeg_audio_version;
+        info_class->get_mpeg_version = audio_get_mpeg_version;
+        info_class->get_profile = audio_get_profile;
+        info_class->get_rate = audio_get_rate;
+        info_class->get_stream_format = audio_get_stream_format;
+        info_class->get_wma_version = audio_get_wma_version;
+        info_class->get_mime = audio_get_mime;
+}
+
+TEST_DEFINE_STREAM_TYPE (Container,
+                         container,
+                         CONTAINER,
+                         GUPNP_TYPE_DLNA_CONTAINER_INFORMATION)
+TEST_GETTER (container, Container, Int, get_mpeg_version, get_int,
+             "mpegversion")
+TEST_GETTER (container, Container, Int, get_packet_size, get_int,
+             "packetsize")
+TEST_GETTER (container, Container, String, get_profile, get_string,
+             "profile")
+TEST_GETTER (container, Container, Bool, is_system_stream, get_bool,
+             "systemstream")
+TEST_GETTER (container, Container, String, get_variant, get_string,
+             "variant")
+TEST_GETTER (container, Container, String, get_mime, get_string, "mime")
+
+static void
+test_container_information_class_init
+                                   (TestContainerInformationClass *test_class)
+{
+        GUPnPDLNAContainerInformationClass *info_class =
+                        GUPNP_DLNA_CONTAINER_INFORMATION_CLASS (test_class);
+
+        G_OBJECT_CLASS (test_class)->finalize =
+                                        test_container_information_finalize;
+        info_class->get_mpeg_version = container_get_mpeg_version;
+        info_class->get_packet_size = container_get_packet_size;
+        info_class->get_profile = container_get_profile;
+        info_class->is_system_stream = container_is_system_stream;
+        info_class->get_variant = container_get_variant;
+        info_class->get_mime = container_get_mime;
+}
+
+TEST_DEFINE_STREAM_TYPE (Image, image, IMAGE, GUPNP_TYPE_DLNA_IMAGE_INFORMATION)
+TEST_GETTER (image, Image, Int, get_depth, get_int, "depth")
+TEST_GETTER (image, Image, Int, get_height, get_int, "height")
+TEST_GETTER (image, Image, Int, get_width, get_int, "width")
+TEST_GETTER (image, Image, String, get_mime, get_string, "mime")
+
+static void
+test_image_information_class_init (TestImageInformationClass *test_class)
+{
+        GUPnPDLNAImageInformationClass *info_class =
+                            GUPNP_DLNA_IMAGE_INFORMATION_CLASS (test_class);
+
+        G_OBJECT_CLASS (test_class)->finalize =
+                                        test_image_information_finalize;
+        info_class->get_depth = image_get_depth;
+        info_class->get_height = image_get_height;
+        info_class->get_width = image_get_width;
+        info_class->get_mime = image_get_mime;
+}
+
+TEST_DEFINE_STREAM_TYPE (Video, video, VIDEO, GUPNP_TYPE_DLNA_VIDEO_INFORMATION)
+TEST_GETTER (video, Video, Int, get_bitrate, get_int, "bitrate")
+TEST_GETTER (video, Video, Fraction, get_framerate, get_fraction,
+             "framerate")
+TEST_GETTER (video, Video, Int, get_height, get_int, "height")
+TEST_GETTER (video, Video, Bool, is_interlaced, get_bool, "interlaced")
+TEST_GETTER (video, Video, String, get_level, get_string, "level")
+TEST_GETTER (video, Video, Int, get_mpeg_version, get_int, "mpegversion")
+TEST_GETTER (video, Video, Fraction, get_pixel_aspect_ratio, get_fraction,
+             "pixel-aspect-ratio")
+TEST_GETTER (video, Video, String, get_profile, get_string, "profile")
+TEST_GETTER (video, Video, Bool, is_system_stream, get_bool,
+             "systemstream")
+TEST_GETTER (video, Video, Int, get_width, get_int, "width")
+TEST_GETTER (video, Video, String, get_mime, get_string, "mime")
+
+static void
+test_video_information_class_init (TestVideoInformationClass *test_class)
+{
+        GUPnPDLNAVideoInformationClass *info_class =
+                            GUPNP_DLNA_VIDEO_INFORMATION_CLASS (test_class);
+
+        G_OBJECT_CLASS (test_class)->finalize =
+                                        test_video_information_finalize;
+        info_class->get_bitrate = video_get_bitrate;
+        info_class->get_framerate = video_get_framerate;
+        info_class->get_height = video_get_height;
+        info_class->is_interlaced = video_is_interlaced;
+        info_class->get_level = video_get_level;
+        info_class->get_mpeg_version = video_get_mpeg_version;
+        info_class->get_pixel_aspect_ratio = video_get_pixel_aspect_ratio;
+        info_class->get_profile = video_get_profile;
+        info_class->is_system_stream = video_is_system_stream;
+        info_class->get_width = video_get_width;
+        info_class->get_mime = video_get_mime;
+}
+
+/* The information itself. */
+
+struct _TestInformation {
+        GUPnPDLNAInformation parent;
+
+        GHashTable *fields[TEST_STREAM_COUNT];
+};
+
+G_DEFINE_TYPE (TestInformation, test_information, GUPNP_TYPE_DLNA_INFORMATION)
+
+static GUPnPDLNAAudioInformation *
+get_audio_information (GUPnPDLNAInformation *info)
+{
+        return test_audio_information_new
+                           (TEST_INFORMATION (info)->fields[TEST_STREAM_AUDIO]);
+}
+
+static GUPnPDLNAContainerInformation *
+get_container_information (GUPnPDLNAInformation *info)
+{
+        return test_container_information_new
+                       (TEST_INFORMATION (info)->fields[TEST_STREAM_CONTAINER]);
+}
+
+static GUPnPDLNAImageInformation *
+get_image_information (GUPnPDLNAInformation *info)
+{
+        return test_image_information_new
+                           (TEST_INFORMATION (info)->fields[TEST_STREAM_IMAGE]);
+}
+
+static GUPnPDLNAVideoInformation *
+get_video_information (GUPnPDLNAInformation *info)
+{
+        return test_video_information_new
+                           (TEST_INFORMATION (info)->fields[TEST_STREAM_VIDEO]);
+}
+
+static const gchar *
+get_profile_name (GUPnPDLNAInformation *info)
+{
+        g_object_set_data (G_OBJECT (info),
+                           TEST_INFORMATION_GUESS_THREAD_KEY,
+                           g_thread_self ());
+
+        return NULL;
+}
+
+static void
+test_information_finalize (GObject *object)
+{
+        TestInformation *info = TEST_INFORMATION (object);
+        guint iter;
+
+        for (iter = 0; iter < TEST_STREAM_COUNT; ++iter)
+                g_clear_pointer (&info->fields[iter], g_hash_table_unref);
+        G_OBJECT_CLASS (test_information_parent_class)->finalize (object);
+}
+
+static void
+test_information_class_init (TestInformationClass *test_class)
+{
+        GUPnPDLNAInformationClass *info_class =
+                                   GUPNP_DLNA_INFORMATION_CLASS (test_class);
+
+        G_OBJECT_CLASS (test_class)->finalize = test_information_finalize;
+        info_class->get_audio_information = get_audio_information;
+        info_class->get_container_information = get_container_information;
+        info_class->get_image_information = get_image_information;
+        info_class->get_video_information = get_video_information;
+        info_class->get_profile_name = get_profile_name;
+}
+
+static void
+test_information_init (TestInformation *info)
+{
+}
+
+TestInformation *
+test_information_new (const gchar *uri)
+{
+        return g_object_new (TEST_TYPE_INFORMATION, "uri", uri, NULL);
+}
+
+static TestField *
+add_field (TestInformation *info,
+           TestStream       stream,
+           const gchar     *name,
+           TestFieldType    type)
+{
+        TestField *field;
+
+        g_return_val_if_fail (TEST_IS_INFORMATION (info), NULL);
+        g_return_val_if_fail (stream < TEST_STREAM_COUNT, NULL);
+
+        if (info->fields[stream] == NULL)
+                info->fields[stream] = g_hash_table_new_full
+                                        (g_str_hash,
+                                         g_str_equal,
+                                         g_free,
+                                         (GDestroyNotify) test_field_free);
+        field = g_slice_new0 (TestField);
+        field->type = type;
+        g_hash_table_replace (info->fields[stream], g_strdup (name), field);
+
+        return field;
+}
+
+void
+test_information_set_bool (TestInformation *info,
+                           TestStream       stream,
+                           const gchar     *name,
+                           gboolean         value)
+{
+        TestField *field = add_field (info, stream, name, TEST_FIELD_BOOL);
+
+        field->first = value;
+}
+
+void
+test_information_set_fraction (TestInformation *info,
+                               TestStream       stream,
+                               const gchar     *name,
+                               gint             numerator,
+                               gint             denominator)
+{
+        TestField *field = add_field (info,
+                                      stream,
+                                      name,
+                                      TEST_FIELD_FRACTION);
+
+        field->first = numerator;
+        field->second = denominator;
+}
+
+void
+test_information_set_int (TestInformation *info,
+                          TestStream       stream,
+                          const gchar     *name,
+                          gint             value)
+{
+        TestField *field = add_field (info, stream, name, TEST_FIELD_INT);
+
+        field->first = value;
+}
+
+void
+test_information_set_string (TestInformation *info,
+                             TestStream       stream,
+                             const gchar     *name,
+                             const gchar     *value)
+{
+        TestField *field = add_field (info, stream, name, TEST_FIELD_STRING);
+
+        field->string = g_strdup (value);
+}
+
+void
+test_information_set_unsupported (TestInformation *info,
+                                  TestStream       stream,
+                                  const gchar     *name)
+{
+        add_field (info, stream, name, TEST_FIELD_UNSUPPORTED);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __TEST_INFORMATION_H__
+#define __TEST_INFORMATION_H__
+
+#include <glib-object.h>
+
+#include "gupnp-dlna-information.h"
+
+G_BEGIN_DECLS
+
+/* A synthetic GUPnPDLNAInformation for tests. It holds whatever
+ * values were set on it, so profile guessing can be exercised
+ * without a metadata backend. A stream exists as soon as any value
+ * is set for it.
+ */
+
+/* Guessing asks the information for a profile name of the backend
+ * before matching it, the thread asking last is kept as the data of
+ * the information under this key. */
+#define TEST_INFORMATION_GUESS_THREAD_KEY "test-guess-thread"
+
+typedef enum {
+        TEST_STREAM_AUDIO,
+        TEST_STREAM_CONTAINER,
+        TEST_STREAM_IMAGE,
+        TEST_STREAM_VIDEO,
+        TEST_STREAM_COUNT
+} TestStream;
+
+#define TEST_TYPE_INFORMATION (test_information_get_type ())
+
+G_DECLARE_FINAL_TYPE (TestInformation,
+                      test_information,
+                      TEST,
+                      INFORMATION,
+                      GUPnPDLNAInformation)
+
+TestInformation *
+test_information_new (const gchar *uri);
+
+void
+test_information_set_bool (TestInformation *info,
+                           TestStream       stream,
+                           const gchar     *name,
+                           gboolean         value);
+
+void
+test_information_set_fraction (TestInformation *info,
+                               TestStream       stream,
+                               const gchar     *name,
+                               gint             numerator,
+                               gint             denominator);
+
+void
+test_information_set_int (TestInformation *info,
+                          TestStream       stream,
+                          const gchar     *name,
+                          gint             value);
+
+void
+test_information_set_string (TestInformation *info,
+                             TestStream       stream,
+                             const gchar     *name,
+                             const gchar     *value);
+
+void
+test_information_set_unsupported (TestInformation *info,
+                                  TestStream       stream,
+                                  const gchar     *name);
+
+G_END_DECLS
+
+#endif /* __TEST_INFORMATION_H__ */
@@ -0,0 +1,405 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include <glib.h>
+
+#include "gupnp-dlna-profile-guesser.h"
+#include "test-information.h"
+
+#define INFO_COUNT 64
+#define THREAD_COUNT 8
+#define ROUNDS 10
+
+static TestInformation *
+image_information (guint index)
+{
+        TestInformation *info = test_information_new ("file:///test.img");
+
+        test_information_set_string (info,
+                                     TEST_STREAM_IMAGE,
+                                     "mime",
+                                     (index % 2) ? "image/png" : "image/jpeg");
+        test_information_set_int (info,
+                                  TEST_STREAM_IMAGE,
+                                  "width",
+                                  16 * (1 + index % 80));
+        test_information_set_int (info,
+                                  TEST_STREAM_IMAGE,
+                                  "height",
+                                  12 * (1 + index % 60));
+        test_information_set_int (info, TEST_STREAM_IMAGE, "depth", 24);
+
+        return info;
+}
+
+static void
+set_mp3_audio (TestInformation *info,
+               guint            index)
+{
+        static const gint rates[] = { 32000, 44100, 48000, 22050 };
+
+        test_information_set_string (info,
+                                     TEST_STREAM_AUDIO,
+                                     "mime",
+                                     "audio/mpeg");
+        test_information_set_int (info, TEST_STREAM_AUDIO, "mpegversion", 1);
+        test_information_set_int (info, TEST_STREAM_AUDIO, "layer", 3);
+        test_information_set_int (info,
+                                  TEST_STREAM_AUDIO,
+                                  "channels",
+                                  1 + index % 2);
+        test_information_set_int (info,
+                                  TEST_STREAM_AUDIO,
+                                  "rate",
+                                  rates[index % G_N_ELEMENTS (rates)]);
+        test_information_set_int (info,
+                                  TEST_STREAM_AUDIO,
+                                  "bitrate",
+                                  32000 * (1 + index % 10));
+}
+
+static TestInformation *
+audio_information (guint index)
+{
+        TestInformation *info = test_information_new ("file:///test.mp3");
+
+        set_mp3_audio (info, index);
+        if (index % 2)
+                test_information_set_string (info,
+                                             TEST_STREAM_CONTAINER,
+                                             "mime",
+                                             "application/x-id3");
+
+        return info;
+}
+
+static TestInformation *
+video_information (guint index)
+{
+        TestInformation *info = test_information_new ("file:///test.ts");
+
+        test_information_set_string (info,
+                                     TEST_STREAM_CONTAINER,
+                                     "mime",
+                                     "video/mpegts");
+        test_information_set_bool (info,
+                                   TEST_STREAM_CONTAINER,
+                                   "systemstream",
+                                   TRUE);
+        test_information_set_int (info,
+                                  TEST_STREAM_CONTAINER,
+                                  "packetsize",
+                                  (index % 2) ? 192 : 188);
+
+        test_information_set_string (info,
+                                     TEST_STREAM_VIDEO,
+                                     "mime",
+                                     "video/mpeg");
+        test_information_set_int (info, TEST_STREAM_VIDEO, "mpegversion", 2);
+        test_information_set_bool (info,
+                                   TEST_STREAM_VIDEO,
+                                   "systemstream",
+                                   FALSE);
+        test_information_set_int (info,
+                                  TEST_STREAM_VIDEO,
+                                  "width",
+                                  (index % 3) ? 720 : 1920);
+        test_information_set_int (info,
+                                  TEST_STREAM_VIDEO,
+                                  "height",
+                                  (index % 3) ? 576 : 1080);
+        test_information_set_fraction (info,
+                                       TEST_STREAM_VIDEO,
+                                       "framerate",
+                                       25,
+                                       1);
+        test_information_set_fraction (info,
+                                       TEST_STREAM_VIDEO,
+                                       "pixel-aspect-ratio",
+                                       1,
+                                       1);
+        test_information_set_int (info,
+                                  TEST_STREAM_VIDEO,
+                                  "bitrate",
+                                  1000000 * (1 + index % 20));
+
+        set_mp3_audio (info, index);
+
+        return info;
+}
+
+static GUPnPDLNAInformation *
+new_information (guint index)
+{
+        TestInformation *info;
+
+        switch (index % 3) {
+        case 0:
+                info = image_information (index / 3);
+
+                break;
+        case 1:
+                info = audio_information (index / 3);
+
+                break;
+        default:
+                info = video_information (index / 3);
+        }
+
+        return GUPNP_DLNA_INFORMATION (info);
+}
+
+typedef struct {
+        GUPnPDLNAProfileGuesser  *guesser;
+        GUPnPDLNAInformation    **infos;
+        GUPnPDLNAProfile        **expected;
+        guint                     offset;
+        gint                      mismatches;
+} GuessData;
+
+static GUPnPDLNAProfile *
+guess (GUPnPDLNAProfileGuesser *guesser,
+       GUPnPDLNAInformation    *info)
+{
+        return gupnp_dlna_profile_guesser_guess_profile_from_info (guesser,
+                                                                   info);
+}
+
+static gpointer
+guess_thread (gpointer user_data)
+{
+        GuessData *data = user_data;
+        guint round;
+        guint iter;
+
+        for (round = 0; round < ROUNDS; ++round) {
+                for (iter = 0; iter < INFO_COUNT; ++iter) {
+                        /* every thread walks the infos in a different
+                         * order, so they collide on different ones */
+                        guint index = (iter * (data->offset * 2 + 1) +
+                                       data->offset) % INFO_COUNT;
+
+                        if (guess (data->guesser, data->infos[index]) !=
+                            data->expected[index])
+                                ++data->mismatches;
+                }
+        }
+
+        return NULL;
+}
+
+static void
+guess_concurrently (gboolean relaxed,
+                    gboolean extended)
+{
+        GUPnPDLNAProfileGuesser *guesser;
+        GUPnPDLNAInformation *infos[INFO_COUNT];
+        GUPnPDLNAProfile *expected[INFO_COUNT];
+        GuessData data[THREAD_COUNT];
+        GThread *threads[THREAD_COUNT];
+        guint matched = 0;
+        guint iter;
+
+        guesser = gupnp_dlna_profile_guesser_new (relaxed, extended);
+        g_assert (gupnp_dlna_profile_guesser_list_profiles (guesser) != NULL);
+
+        /* expected results come from fresh objects guessed in one
+         * thread */
+        for (iter = 0; iter < INFO_COUNT; ++iter) {
+                GUPnPDLNAInformation *info = new_information (iter);
+
+                expected[iter] = guess (guesser, info);
+                if (expected[iter] != NULL)
+                        ++matched;
+                g_object_unref (info);
+        }
+        g_assert_cmpuint (matched, >, 0);
+
+        /* another set of fresh objects, so their lazily created
+         * stream information is raced for too */
+        for (iter = 0; iter < INFO_COUNT; ++iter)
+                infos[iter] = new_information (iter);
+
+        for (iter = 0; iter < THREAD_COUNT; ++iter) {
+                data[iter].guesser = guesser;
+                data[iter].infos = infos;
+                data[iter].expected = expected;
+                data[iter].offset = iter;
+                data[iter].mismatches = 0;
+                threads[iter] = g_thread_new ("guesser",
+                                              guess_thread,
+                                              &data[iter]);
+        }
+
+        for (iter = 0; iter < THREAD_COUNT; ++iter) {
+                g_thread_join (threads[iter]);
+                g_assert_cmpint (data[iter].mismatches, ==, 0);
+        }
+
+        for (iter = 0; iter < INFO_COUNT; ++iter)
+                g_object_unref (infos[iter]);
+        g_object_unref (guesser);
+}
+
+static void
+threads_strict (void)
+{
+        guess_concurrently (FALSE, FALSE);
+}
+
+static void
+threads_relaxed_extended (void)
+{
+        guess_concurrently (TRUE, TRUE);
+}
+
+/* Every guess is counted exactly once, even when they run in
+ * parallel. */
+static void
+check_stats (GUPnPDLNAProfileGuesser *guesser,
+             guint                    count)
+{
+        GList *iter;
+        guint results = gupnp_dlna_profile_guesser_get_no_match_count
+                                        (guesser);
+        guint latencies = 0;
+        guint bucket;
+
+        for (iter = gupnp_dlna_profile_guesser_list_profiles (guesser);
+             iter != NULL;
+             iter = iter->next)
+                results += gupnp_dlna_profile_guesser_get_profile_hits
+                                        (guesser,
+                                         iter->data);
+        for (bucket = 0;
+             bucket < GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS;
+             ++bucket)
+                latencies += gupnp_dlna_profile_guesser_get_latency_count
+                                  (guesser,
+                                   GUPNP_DLNA_PROFILE_GUESSER_LATENCY_MATCHING,
+                                   bucket);
+
+        g_assert_cmpuint (results, ==, count);
+        g_assert_cmpuint (latencies, ==, count);
+        g_assert_cmpuint (gupnp_dlna_profile_guesser_get_error_count (guesser),
+                          ==,
+                          0);
+}
+
+static void
+guess_in_batch (guint n_threads)
+{
+        GUPnPDLNAProfileGuesser *guesser;
+        GPtrArray *infos;
+        GPtrArray *profiles;
+        guint count = INFO_COUNT * 5;
+        guint iter;
+
+        guesser = gupnp_dlna_profile_guesser_new (TRUE, TRUE);
+        infos = g_ptr_array_new_with_free_func (g_object_unref);
+        for (iter = 0; iter < count; ++iter)
+                g_ptr_array_add (infos, new_information (iter));
+
+        profiles = gupnp_dlna_profile_guesser_guess_profiles_from_infos
+                                        (guesser,
+                                         infos,
+                                         n_threads);
+        g_assert (profiles != NULL);
+        g_assert_cmpuint (profiles->len, ==, count);
+        check_stats (guesser, count);
+
+        /* results must be in input order */
+        for (iter = 0; iter < count; ++iter) {
+                GUPnPDLNAInformation *info = new_information (iter);
+
+                g_assert (g_ptr_array_index (profiles, iter) ==
+                          guess (guesser, info));
+                /* only matching is measured when guessing from info */
+                g_assert_cmpint (gupnp_dlna_information_get_phase_time
+                                        (info,
+                                         GUPNP_DLNA_GUESS_PHASE_PROFILE_MATCHING),
+                                 >=,
+                                 0);
+                g_assert_cmpint (gupnp_dlna_information_get_phase_time
+                                        (info,
+                                         GUPNP_DLNA_GUESS_PHASE_PREROLL),
+                                 ==,
+                                 -1);
+                g_assert_cmpuint
+                          (gupnp_dlna_information_get_profiles_evaluated (info),
+                           >,
+                           0);
+                g_object_unref (info);
+        }
+
+        g_ptr_array_unref (profiles);
+        g_ptr_array_unref (infos);
+        g_object_unref (guesser);
+}
+
+static void
+batch_one_thread (void)
+{
+        guess_in_batch (1);
+}
+
+static void
+batch_many_threads (void)
+{
+        guess_in_batch (THREAD_COUNT);
+}
+
+static void
+batch_empty (void)
+{
+        GUPnPDLNAProfileGuesser *guesser;
+        GPtrArray *infos = g_ptr_array_new ();
+        GPtrArray *profiles;
+
+        guesser = gupnp_dlna_profile_guesser_new (FALSE, FALSE);
+        profiles = gupnp_dlna_profile_guesser_guess_profiles_from_infos
+                                        (guesser,
+                                         infos,
+                                         0);
+        g_assert_cmpuint (profiles->len, ==, 0);
+
+        g_ptr_array_unref (profiles);
+        g_ptr_array_unref (infos);
+        g_object_unref (guesser);
+}
+
+int
+main (int argc, char **argv)
+{
+        g_test_init (&argc, &argv, NULL);
+
+        g_test_add_func ("/guesser/threads/strict", threads_strict);
+        g_test_add_func ("/guesser/threads/relaxed-extended",
+                         threads_relaxed_extended);
+        g_test_add_func ("/guesser/batch/one-thread", batch_one_thread);
+        g_test_add_func ("/guesser/batch/many-threads", batch_many_threads);
+        g_test_add_func ("/guesser/batch/empty", batch_empty);
+
+        g_test_run ();
+
+        return 0;
+}
@@ -0,0 +1,339 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Authors: agent <agent@local>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* A daemon keeping guessers of all four modes, with their profiles
+ * and the metadata backend, loaded. It serves guesses to guessers
+ * created with gupnp_dlna_profile_guesser_new_for_daemon() over a
+ * Unix socket, so short-lived processes do not pay for loading them
+ * on every start.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <locale.h>
+#include <signal.h>
+#include <stdlib.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-unix.h>
+#include <gio/gio.h>
+#include <gio/gunixsocketaddress.h>
+
+#include <libgupnp-dlna/gupnp-dlna-profile-guesser.h>
+#include "gupnp-dlna-daemon-protocol-private.h"
+
+static GUPnPDLNAProfileGuesser *guessers[2][2];
+
+static GVariant *
+empty_data (void)
+{
+        return g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, NULL, 0, 1);
+}
+
+static GVariant *
+describe_profile (GUPnPDLNAProfile *profile)
+{
+        const gchar *digest = (profile != NULL ?
+                               gupnp_dlna_profile_get_digest (profile) :
+                               NULL);
+
+        return g_variant_new
+                     (GUPNP_DLNA_DAEMON_PROFILE_TYPE,
+                      profile != NULL ? gupnp_dlna_profile_get_name (profile) :
+                                        "",
+                      profile != NULL ? gupnp_dlna_profile_get_mime (profile) :
+                                        "",
+                      digest != NULL ? digest : "",
+                      profile != NULL ?
+                      gupnp_dlna_profile_get_extended (profile) :
+                      FALSE);
+}
+
+static GVariant *
+list_profiles (GUPnPDLNAProfileGuesser *guesser)
+{
+        GVariantBuilder builder;
+        GList *iter;
+
+        g_variant_builder_init
+                        (&builder,
+                         G_VARIANT_TYPE (GUPNP_DLNA_DAEMON_PROFILE_LIST_TYPE));
+        for (iter = gupnp_dlna_profile_guesser_list_profiles (guesser);
+             iter != NULL;
+             iter = iter->next)
+                g_variant_builder_add_value (&builder,
+                                             describe_profile (iter->data));
+
+        return g_variant_builder_end (&builder);
+}
+
+static GVariant *
+handle_request (GVariant *request)
+{
+        guchar kind;
+        gboolean relaxed_mode;
+        gboolean extended_mode;
+        guint timeout_in_ms;
+        const gchar *uri;
+        GVariant *data;
+        GUPnPDLNAProfileGuesser *guesser;
+        GUPnPDLNAInformation *info = NULL;
+        GUPnPDLNAProfile *profile = NULL;
+        GError *error = NULL;
+        GVariant *reply_data;
+        GVariant *profiles;
+        GVariant *reply;
+
+        g_variant_get (request,
+                       "(ybbu&s@ay)",
+                       &kind,
+                       &relaxed_mode,
+                       &extended_mode,
+                       &timeout_in_ms,
+                       &uri,
+                       &data);
+        guesser = guessers[relaxed_mode ? 1 : 0][extended_mode ? 1 : 0];
+
+        if (kind == GUPNP_DLNA_DAEMON_REQUEST_LIST_PROFILES) {
+                reply_data = empty_data ();
+                profiles = list_profiles (guesser);
+        } else if (g_variant_get_size (data) > 0) {
+                GBytes *serialized = g_variant_get_data_as_bytes (data);
+
+                info = gupnp_dlna_information_deserialize (serialized,
+                                                           NULL,
+                                                           &error);
+                g_bytes_unref (serialized);
+                if (info != NULL)
+                        profile =
+                            gupnp_dlna_profile_guesser_guess_profile_from_info
+                                        (guesser,
+                                         info);
+                reply_data = empty_data ();
+                profiles = NULL;
+        } else {
+                profile = gupnp_dlna_profile_guesser_guess_profile_sync
+                                        (guesser,
+                                         uri,
+                                         timeout_in_ms,
+                                         &info,
+                                         &error);
+                if (error == NULL && info != NULL) {
+                        GBytes *serialized = gupnp_dlna_information_serialize
+                                        (info,
+                                         NULL);
+
+                        reply_data = g_variant_new_from_bytes
+                                        (G_VARIANT_TYPE_BYTESTRING,
+                                         serialized,
+                                         TRUE);
+                        g_bytes_unref (serialized);
+                } else {
+                        reply_data = empty_data ();
+                }
+                profiles = NULL;
+        }
+        if (profiles == NULL)
+                profiles = g_variant_new_array
+                           (G_VARIANT_TYPE (GUPNP_DLNA_DAEMON_PROFILE_TYPE),
+                            NULL,
+                            0);
+
+        /* the client recreates the error from its domain and code */
+        reply = g_variant_new
+                     ("(bsis@(sssb)@ay@a(sssb))",
+                      error == NULL,
+                      error != NULL ? g_quark_to_string (error->domain) : "",
+                      error != NULL ? error->code : 0,
+                      error != NULL ? error->message : "",
+                      describe_profile (profile),
+                      reply_data,
+                      profiles);
+        g_clear_error (&error);
+        g_clear_object (&info);
+        g_variant_unref (data);
+
+        return g_variant_ref_sink (reply);
+}
+
+/* Runs in a thread of its own for each client connection. */
+static gboolean
+run_cb (GThreadedSocketService *service G_GNUC_UNUSED,
+        GSocketConnection      *connection,
+        GObject                *source_object G_GNUC_UNUSED,
+        gpointer                user_data G_GNUC_UNUSED)
+{
+        GIOStream *stream = G_IO_STREAM (connection);
+        const GVariantType *type =
+                           G_VARIANT_TYPE (GUPNP_DLNA_DAEMON_REQUEST_TYPE);
+        GError *error = NULL;
+        GVariant *request;
+
+        while ((request = gupnp_dlna_daemon_read_frame
+                                  (g_io_stream_get_input_stream (stream),
+                                   type,
+                                   &error)) != NULL) {
+                GVariant *reply = handle_request (request);
+                gboolean written = gupnp_dlna_daemon_write_frame
+                                        (g_io_stream_get_output_stream (stream),
+                                         reply,
+                                         &error);
+
+                g_variant_unref (reply);
+                g_variant_unref (request);
+                if (!written)
+                        break;
+        }
+        if (error != NULL) {
+                g_debug ("Dropping client: %s", error->message);
+                g_error_free (error);
+        }
+
+        return TRUE;
+}
+
+/* Refuses to take over a socket some other daemon still listens
+ * on, otherwise removes the stale one. */
+static gboolean
+claim_socket_path (const gchar *path)
+{
+        GSocketClient *client;
+        GSocketAddress *address;
+        GSocketConnection *connection;
+
+        if (!g_file_test (path, G_FILE_TEST_EXISTS))
+                return TRUE;
+
+        client = g_socket_client_new ();
+        address = g_unix_socket_address_new (path);
+        connection = g_socket_client_connect (client,
+                                              G_SOCKET_CONNECTABLE (address),
+                                              NULL,
+                                              NULL);
+        g_object_unref (address);
+        g_object_unref (client);
+        if (connection != NULL) {
+                g_object_unref (connection);
+
+                return FALSE;
+        }
+
+        g_unlink (path);
+
+        return TRUE;
+}
+
+static gboolean
+quit_cb (GMainLoop *loop)
+{
+        g_main_loop_quit (loop);
+
+        return G_SOURCE_REMOVE;
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+        gchar *socket_path = NULL;
+        GOptionEntry options[] = {
+                {"socket", 'S', 0, G_OPTION_ARG_FILENAME, &socket_path,
+                 "Path of the socket to listen on", "PATH"},
+                {NULL}
+        };
+        GOptionContext *ctx;
+        GError *err = NULL;
+        GSocketService *service;
+        GSocketAddress *address;
+        GMainLoop *loop;
+        guint iter;
+
+        setlocale (LC_ALL, "");
+
+        ctx = g_option_context_new (" - daemon guessing DLNA profiles");
+        g_option_context_add_main_entries (ctx, options, NULL);
+        if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+                g_printerr ("Error initializing: %s\n", err->message);
+                g_error_free (err);
+                exit (1);
+        }
+        g_option_context_free (ctx);
+
+        if (socket_path == NULL)
+                socket_path = gupnp_dlna_daemon_get_default_socket_path ();
+        if (!claim_socket_path (socket_path)) {
+                g_printerr ("Another daemon listens on %s\n", socket_path);
+                exit (1);
+        }
+
+        /* load all profiles up front */
+        for (iter = 0; iter < 4; ++iter) {
+                gboolean relaxed = (iter > 1); /* F,F,T,T */
+                gboolean extended = ((iter) % 2 != 0); /* F,T,F,T */
+                GUPnPDLNAProfileGuesser *guesser =
+                                        gupnp_dlna_profile_guesser_new
+                                        (relaxed,
+                                         extended);
+
+                gupnp_dlna_profile_guesser_list_profiles (guesser);
+                guessers[relaxed ? 1 : 0][extended ? 1 : 0] = guesser;
+        }
+
+        /* every connection keeps its thread while it is open */
+        service = g_threaded_socket_service_new (-1);
+        address = g_unix_socket_address_new (socket_path);
+        if (!g_socket_listener_add_address (G_SOCKET_LISTENER (service),
+                                            address,
+                                            G_SOCKET_TYPE_STREAM,
+                                            G_SOCKET_PROTOCOL_DEFAULT,
+                                            NULL,
+                                            NULL,
+                                            &err)) {
+                g_printerr ("Failed to listen on %s: %s\n",
+                            socket_path,
+                            err->message);
+                g_error_free (err);
+                exit (1);
+        }
+        g_object_unref (address);
+        g_signal_connect (service, "run", G_CALLBACK (run_cb), NULL);
+        g_socket_service_start (service);
+
+        loop = g_main_loop_new (NULL, FALSE);
+        g_unix_signal_add (SIGINT, (GSourceFunc) quit_cb, loop);
+        g_unix_signal_add (SIGTERM, (GSourceFunc) quit_cb, loop);
+        g_main_loop_run (loop);
+
+        g_socket_service_stop (service);
+        g_socket_listener_close (G_SOCKET_LISTENER (service));
+        g_unlink (socket_path);
+        g_object_unref (service);
+        g_main_loop_unref (loop);
+        for (iter = 0; iter < 4; ++iter)
+                g_object_unref (guessers[iter / 2][iter % 2]);
+        g_free (socket_path);
+
+        return 0;
+}
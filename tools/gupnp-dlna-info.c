@@ -44,6 +44,7 @@
 
 
 static gboolean async = FALSE;
+static gboolean stats = FALSE;
 static gint timeout = 10;
 static guint files_to_guess = 0;
 
@@ -222,6 +223,72 @@ async_idle_loop (PrivStruct *ps)
         return FALSE;
 }
 
+static void
+print_latency_histogram (GUPnPDLNAProfileGuesser        *guesser,
+                         GUPnPDLNAProfileGuesserLatency  latency,
+                         const gchar                    *name)
+{
+        guint bucket;
+
+        g_print ("%s latency:\n", name);
+        for (bucket = 0;
+             bucket < GUPNP_DLNA_PROFILE_GUESSER_LATENCY_BUCKETS;
+             ++bucket) {
+                guint count = gupnp_dlna_profile_guesser_get_latency_count
+                                        (guesser,
+                                         latency,
+                                         bucket);
+                gint64 limit =
+                           gupnp_dlna_profile_guesser_get_latency_bucket_limit
+                                        (bucket);
+
+                if (limit == G_MAXINT64)
+                        g_print ("  > %" G_GINT64_FORMAT " us: %u\n",
+                                 gupnp_dlna_profile_guesser_get_latency_bucket_limit
+                                        (bucket - 1),
+                                 count);
+                else
+                        g_print ("  <= %" G_GINT64_FORMAT " us: %u\n",
+                                 limit,
+                                 count);
+        }
+}
+
+static void
+print_stats (GUPnPDLNAProfileGuesser *guesser)
+{
+        GList *iter;
+
+        g_print ("\nStatistics\n");
+        g_print ("Profile hits:\n");
+        for (iter = gupnp_dlna_profile_guesser_list_profiles (guesser);
+             iter != NULL;
+             iter = iter->next) {
+                GUPnPDLNAProfile *profile = GUPNP_DLNA_PROFILE (iter->data);
+                guint hits = gupnp_dlna_profile_guesser_get_profile_hits
+                                        (guesser,
+                                         profile);
+
+                if (hits > 0)
+                        g_print ("  %s: %u\n",
+                                 gupnp_dlna_profile_get_name (profile),
+                                 hits);
+        }
+        g_print ("No match: %u\n",
+                 gupnp_dlna_profile_guesser_get_no_match_count (guesser));
+        g_print ("Errors: %u\n",
+                 gupnp_dlna_profile_guesser_get_error_count (guesser));
+        g_print ("Matches with unsupported values: %u\n",
+                 gupnp_dlna_profile_guesser_get_unsupported_match_count
+                                        (guesser));
+        print_latency_histogram (guesser,
+                                 GUPNP_DLNA_PROFILE_GUESSER_LATENCY_EXTRACTION,
+                                 "Extraction");
+        print_latency_histogram (guesser,
+                                 GUPNP_DLNA_PROFILE_GUESSER_LATENCY_MATCHING,
+                                 "Matching");
+}
+
 /* Main */
 int
 main (int argc,
@@ -230,6 +297,7 @@ main (int argc,
         GUPnPDLNAProfileGuesser *guesser;
         gboolean relaxed_mode = FALSE;
         gboolean extended_mode = FALSE;
+        gboolean use_daemon = FALSE;
         GError *err = NULL;
 
         GOptionEntry options[] = {
@@ -241,6 +309,10 @@ main (int argc,
                  "Enable Relaxed mode", NULL},
                 {"extended mode", 'e', 0, G_OPTION_ARG_NONE, &extended_mode,
                  "Enable extended mode", NULL},
+                {"stats", 's', 0, G_OPTION_ARG_NONE, &stats,
+                 "Print guessing statistics at the end", NULL},
+                {"daemon", 'd', 0, G_OPTION_ARG_NONE, &use_daemon,
+                 "Guess through a running gupnp-dlna-daemon", NULL},
                 {NULL}
         };
 
@@ -269,8 +341,14 @@ main (int argc,
            miliseconds. */
         timeout *= 1000;
 
-        guesser = gupnp_dlna_profile_guesser_new (relaxed_mode,
-                                                  extended_mode);
+        if (use_daemon)
+                guesser = gupnp_dlna_profile_guesser_new_for_daemon
+                                        (relaxed_mode,
+                                         extended_mode,
+                                         NULL);
+        else
+                guesser = gupnp_dlna_profile_guesser_new (relaxed_mode,
+                                                          extended_mode);
         if (guesser == NULL) {
                 g_print ("Failed to create meta-data guesser\n");
                 exit (1);
@@ -299,6 +377,8 @@ main (int argc,
                 g_main_loop_unref (ml);
                 g_slice_free (PrivStruct, ps);
         }
+        if (stats)
+                print_stats (guesser);
         g_object_unref (guesser);
         gupnp_dlna_profile_guesser_cleanup ();
         return 0;
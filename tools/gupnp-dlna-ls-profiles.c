@@ -36,7 +36,12 @@
 #include <libgupnp-dlna/gupnp-dlna-profile.h>
 #include <libgupnp-dlna/gupnp-dlna-profile-guesser.h>
 
+#include "gupnp-dlna-profile-db.h"
+#include "gupnp-dlna-profile-loader.h"
+
 static gboolean relaxed = FALSE;
+static gboolean analyze = FALSE;
+static gchar *analysis_file = NULL;
 
 static void
 print_profile (GUPnPDLNAProfile *profile, gpointer user_data)
@@ -47,6 +52,98 @@ print_profile (GUPnPDLNAProfile *profile, gpointer user_data)
                  gupnp_dlna_profile_get_mime (profile));
 }
 
+static void
+print_analysis (GUPnPDLNAProfileDB *db)
+{
+        GList *profiles = gupnp_dlna_profile_db_get_profiles (db);
+        guint count = g_list_length (profiles);
+        GUPnPDLNAProfile **array = g_new (GUPnPDLNAProfile *, count);
+        guint *groups;
+        guint group_count;
+        guint shadowed = 0;
+        guint pairs = 0;
+        guint i;
+        guint j;
+
+        for (i = 0; profiles != NULL; profiles = profiles->next)
+                array[i++] = profiles->data;
+
+        g_print ("Shadowed profiles (never returned, as an earlier "
+                 "profile matches all their media):\n");
+        for (i = 0; i < count; ++i) {
+                guint by;
+
+                if (gupnp_dlna_profile_db_is_shadowed (db, i, &by)) {
+                        g_print ("  %-30s by %s\n",
+                                 gupnp_dlna_profile_get_name (array[i]),
+                                 gupnp_dlna_profile_get_name (array[by]));
+                        ++shadowed;
+                }
+        }
+        g_print ("%u shadowed profiles\n\n", shadowed);
+
+        g_print ("Overlapping pairs (may match the same media):\n");
+        for (i = 0; i < count; ++i)
+                for (j = i + 1; j < count; ++j)
+                        if (gupnp_dlna_profile_db_may_overlap (db, i, j)) {
+                                g_print ("  %-30s %s\n",
+                                         gupnp_dlna_profile_get_name
+                                                (array[i]),
+                                         gupnp_dlna_profile_get_name
+                                                (array[j]));
+                                ++pairs;
+                        }
+        g_print ("%u overlapping pairs\n\n", pairs);
+
+        groups = gupnp_dlna_profile_db_get_groups (db, &group_count);
+        g_print ("Mutually exclusive groups (profiles from different "
+                 "groups never match the same media):\n");
+        for (i = 0; i < group_count; ++i) {
+                g_print ("  %3u:", i + 1);
+                for (j = 0; j < count; ++j)
+                        if (groups[j] == i)
+                                g_print (" %s",
+                                         gupnp_dlna_profile_get_name
+                                                (array[j]));
+                g_print ("\n");
+        }
+        g_print ("%u groups\n", group_count);
+
+        g_free (groups);
+        g_free (array);
+}
+
+/* Analyses profiles of all the modes, so the loader finds the
+ * analysis for whichever mode a guesser uses. */
+static gboolean
+write_analysis (const gchar  *filename,
+                GError      **error)
+{
+        GKeyFile *analysis = g_key_file_new ();
+        gboolean written;
+        guint iter;
+
+        g_key_file_set_comment (analysis,
+                                NULL,
+                                NULL,
+                                " Generated by gupnp-dlna-ls-profiles, "
+                                "do not edit.",
+                                NULL);
+        for (iter = 0; iter < 4; ++iter) {
+                GUPnPDLNAProfileDB *db = gupnp_dlna_profile_db_new_full
+                                        (iter > 1,
+                                         iter % 2 != 0,
+                                         FALSE);
+
+                gupnp_dlna_profile_db_save_analysis (db, analysis);
+                gupnp_dlna_profile_db_unref (db);
+        }
+        written = g_key_file_save_to_file (analysis, filename, error);
+        g_key_file_unref (analysis);
+
+        return written;
+}
+
 int
 main (int argc, char **argv)
 {
@@ -57,6 +154,13 @@ main (int argc, char **argv)
         GOptionEntry options[] = {
                 {"relaxed", 'r', 0, G_OPTION_ARG_NONE, &relaxed,
                  "Read profiles in relaxed mode", NULL},
+                {"analyze", 'a', 0, G_OPTION_ARG_NONE, &analyze,
+                 "Report shadowed and overlapping profiles", NULL},
+                {"write-analysis", 'w', 0, G_OPTION_ARG_FILENAME,
+                 &analysis_file,
+                 "Write the overlaps of profiles to FILE, install it "
+                 "as " GUPNP_DLNA_PROFILE_ANALYSIS_FILE " next to the "
+                 "profiles to speed up loading them", "FILE"},
                 {NULL}
         };
 
@@ -75,6 +179,29 @@ main (int argc, char **argv)
 
         g_option_context_free (ctx);
 
+        if (analysis_file != NULL) {
+                if (!write_analysis (analysis_file, &err)) {
+                        g_print ("Failed to write %s: %s\n",
+                                 analysis_file,
+                                 err->message);
+                        g_error_free (err);
+                        exit (1);
+                }
+                g_free (analysis_file);
+        }
+
+        if (analyze) {
+                GUPnPDLNAProfileDB *db = gupnp_dlna_profile_db_new_full
+                                        (relaxed,
+                                         TRUE,
+                                         FALSE);
+
+                print_analysis (db);
+                gupnp_dlna_profile_db_unref (db);
+
+                return 0;
+        }
+
         guesser = gupnp_dlna_profile_guesser_new (relaxed, TRUE);
         profiles = gupnp_dlna_profile_guesser_list_profiles (guesser);
 